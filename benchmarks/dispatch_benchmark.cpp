@@ -0,0 +1,237 @@
+/*
+
+Dispatch benchmark program. Compare how fast the virtual machine executes the same bytecode with switch dispatch and
+with threaded dispatch, with and without superinstructions, and how fast the same bytecode runs compiled to machine code.
+Output the times to stdout.
+
+The benchmarked program is generated: it reads a runtime integer 'x' and float 'y', then repeats a group of statements
+that add constants, branch on comparisons and choose values with ternary operators, the sequences superinstructions fuse.
+Usage: 'dispatch_benchmark [groups] [repetitions]'. Build with CMAKE_BUILD_TYPE=Release for meaningful times.
+
+*/
+
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+
+#include "inc_interpreter/lexer.hpp"
+#include "inc_interpreter/parser.hpp"
+#include "inc_interpreter/semantic_analysis.hpp"
+#include "inc_interpreter/optimization.hpp"
+#include "inc_runtime/bytecode_compiler.hpp"
+#include "inc_runtime/virtual_machine.hpp"
+#include "inc_runtime/native_compiler.hpp"
+
+// Standard library aliases
+using std::string, std::list, std::map, std::shared_ptr, std::exception, std::cout, std::cerr, std::make_shared, std::fixed, std::setprecision,
+      std::setw, std::flush;
+
+// Standard library namespace
+using namespace std::chrono;
+
+// interp_utils namespaces
+using namespace TokenDef;
+using namespace CodeTree;
+using namespace TypingUtils;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// bytecode namespace
+using namespace Bytecode;
+
+
+// Number of times every configuration is timed, the fastest time is kept.
+constexpr int TRIALS = 5;
+
+
+/*
+Generate a Regal program that repeats a group of statements reading the runtime variables 'x' and 'y'.
+Every group adds and subtracts constants, branches on comparisons and chooses values with ternary operators,
+and the values stay small so no operation overflows.
+
+Parameters:
+    groups: number of statement groups (input)
+
+Return the program's text.
+*/
+string generate_program(const int groups) noexcept {
+    string text = "let a = x + 1\nlet b = y * 2.5\nlet c = 0\nlet d = 0.0\n";
+
+    for (int group_index = 0; group_index < groups; group_index++) {
+        const string step = std::to_string(group_index % 7 + 1);
+        text += "a = a + " + step + "\n"
+                "if a > 1000\n"
+                "    a = a - 1000\n"
+                "else\n"
+                "    a = a + 3\n"
+                "c = (a if a < c else c - " + step + ")\n"
+                "d = (b if d <= b else d)\n"
+                "b = b + 0.5\n";
+    }
+
+    return text;
+}
+
+/*
+Parse and analyze a program with the runtime variables 'x' and 'y' declared.
+
+Parameters:
+    text: the program's text (input)
+    env: environment to analyze the program in (output)
+
+Return the analyzed AST.
+*/
+shared_ptr<dataNode> analyze_program(string& text, shared_ptr<environment>& env) {
+    declare_runtime_variable(env, "x", dataType::Int64T);
+    declare_runtime_variable(env, "y", dataType::Float64T);
+
+    list<token> token_list = lex_string(text);
+    shared_ptr<dataNode> parsed_code = parse_file(token_list);
+    analyze_data_node(parsed_code, env);
+    eliminate_dead_stores(parsed_code, env);
+
+    return parsed_code;
+}
+
+/*
+Time executing a compiled program.
+This function depends on a typename template for the function executing the program once.
+
+Parameters:
+    execute: function executing the program, returning the values of its variables (input)
+    repetitions: number of executions per trial (input)
+    result: the values of the variables after the last execution (output)
+
+Return the fastest time in nanoseconds of one execution.
+*/
+template <typename F>
+double time_program(const F& execute, const int repetitions, map<string, typedValue>& result) {
+    double best_time = 0;
+
+    for (int trial_index = 0; trial_index < TRIALS; trial_index++) {
+        const auto start_time = steady_clock::now();
+        for (int repetition_index = 0; repetition_index < repetitions; repetition_index++) {
+            result = execute();
+        }
+        const double trial_time = duration_cast<nanoseconds>(steady_clock::now() - start_time).count() / static_cast<double>(repetitions);
+
+        if ((trial_index == 0) || (trial_time < best_time)) {
+            best_time = trial_time;
+        }
+    }
+
+    return best_time;
+}
+
+/*
+Check that two executions gave every variable the same value.
+
+Parameters:
+    expected/actual: values of the variables after each execution (input)
+
+Return true if the values are the same.
+*/
+bool same_values(const map<string, typedValue>& expected, const map<string, typedValue>& actual) noexcept {
+    if (expected.size() != actual.size()) {
+        return false;
+    }
+
+    for (const auto& [variable, value] : expected) {
+        const map<string, typedValue>::const_iterator other = actual.find(variable);
+        if ((other == actual.end()) || (other->second.type != value.type) || (display_value(other->second) != display_value(value))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+Time the generated program under every dispatch, with and without superinstructions, then compiled to machine code.
+Output the time per execution, the time per compiled instruction, and the speedup over switch dispatch without superinstructions.
+*/
+int main(int argc, char* argv[]) {
+    const int groups = (argc > 1) ? std::atoi(argv[1]) : 2000;
+    const int repetitions = (argc > 2) ? std::atoi(argv[2]) : 200;
+    if ((groups <= 0) || (repetitions <= 0)) {
+        cerr << "usage: " << argv[0] << " [groups] [repetitions]" << flush;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        string text = generate_program(groups);
+        shared_ptr<environment> env = make_shared<environment>();
+        const shared_ptr<dataNode> parsed_code = analyze_program(text, env);
+
+        map<string, typedValue> inputs;
+        inputs["x"] = typedValue{dataType::Int64T, valueSlot{}};
+        inputs["x"].value.int64 = 5;
+        inputs["y"] = typedValue{dataType::Float64T, valueSlot{}};
+        inputs["y"].value.float64 = 0.25;
+
+        if (!threaded_dispatch) {
+            cout << "threaded dispatch was not built, it falls back to switch dispatch\n";
+        }
+        cout << groups << " statement groups, " << repetitions << " executions per trial\n";
+
+        map<string, typedValue> expected;
+        double base_time = 0;
+
+        for (const bool superinstructions : {false, true}) {
+            const program compiled = compile_program(parsed_code, env, superinstructions);
+
+            for (const dispatchMode dispatch : {dispatchMode::Switch, dispatchMode::Threaded}) {
+                map<string, typedValue> result;
+                const double time = time_program([&] { return execute_program(compiled, inputs, dispatch); }, repetitions, result);
+
+//              Every configuration executes the same program, so they must agree.
+                if (expected.empty()) {
+                    expected = result;
+                    base_time = time;
+                } else if (!same_values(expected, result)) {
+                    cerr << "configurations disagree on the program's result" << flush;
+                    return EXIT_FAILURE;
+                }
+
+                cout << setw(8) << ((dispatch == dispatchMode::Switch) ? "switch" : "threaded")
+                     << setw(20) << (superinstructions ? "superinstructions" : "plain")
+                     << setw(8) << compiled.code.size() << " instructions  "
+                     << fixed << setprecision(1) << setw(10) << time / 1e3 << " us/run  "
+                     << setprecision(2) << setw(6) << time / compiled.code.size() << " ns/instruction  "
+                     << setprecision(2) << base_time / time << "x\n";
+            }
+        }
+
+//      Machine code is compiled from the bytecode with superinstructions, and has one template per instruction.
+        const program compiled = compile_program(parsed_code, env);
+        const std::unique_ptr<Native::nativeProgram> native = compile_native(compiled);
+        if (!native) {
+            cout << "machine code is not supported on this platform\n";
+        } else {
+            map<string, typedValue> result;
+            const double time = time_program([&] { return execute_native(*native, inputs); }, repetitions, result);
+            if (!same_values(expected, result)) {
+                cerr << "machine code disagrees with the virtual machine on the program's result" << flush;
+                return EXIT_FAILURE;
+            }
+
+            cout << setw(8) << "native" << setw(20) << "superinstructions"
+                 << setw(8) << compiled.code.size() << " instructions  "
+                 << fixed << setprecision(1) << setw(10) << time / 1e3 << " us/run  "
+                 << setprecision(2) << setw(6) << time / compiled.code.size() << " ns/instruction  "
+                 << setprecision(2) << base_time / time << "x\n";
+        }
+
+    } catch (const exception& e) {
+        cerr << e.what() << flush;
+        return EXIT_FAILURE;
+    }
+
+    cout << flush;
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+
+Running and measuring the phases of the front end, for benchmarks.
+
+*/
+
+#include <algorithm>
+
+#include "inc_interpreter/lexer.hpp"
+#include "inc_interpreter/parser.hpp"
+#include "inc_interpreter/semantic_analysis.hpp"
+#include "inc_interpreter/optimization.hpp"
+#include "phase_runner.hpp"
+
+// Standard library aliases
+using std::string, std::list, std::vector, std::shared_ptr, std::make_shared, std::uint64_t, std::size_t;
+
+// interp_utils namespaces
+using namespace TokenDef;
+using namespace CodeTree;
+using namespace TypingUtils;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// metrics namespace
+using namespace Metrics;
+
+// phase_runner namespace
+using namespace PhaseRunning;
+
+
+void run_phases(const string& text, phaseSet& phases, nodeMemoryCounts& node_memory, size_t& token_count) {
+    string code = text;
+    shared_ptr<environment> env = make_shared<environment>();
+    declare_runtime_variable(env, "x", dataType::Int64T);
+    declare_runtime_variable(env, "y", dataType::Float64T);
+
+    restart_counters();
+    const uint64_t start_allocations = counters.allocations, start_bytes = counters.allocated_bytes, start_live_bytes = live_bytes.load();
+    {
+        const nodeMemoryAccounting node_accounting;
+        phaseClock clock;
+
+        list<token> token_list = lex_string(code);
+        phases[static_cast<size_t>(benchPhase::Lex)] = clock.lap(PHASE_NAMES[0]);
+        token_count = token_list.size();
+        shared_ptr<dataNode> parsed_code = parse_file(token_list);
+        phases[static_cast<size_t>(benchPhase::Parse)] = clock.lap(PHASE_NAMES[1]);
+        analyze_data_node(parsed_code, env);
+        phases[static_cast<size_t>(benchPhase::Analyze)] = clock.lap(PHASE_NAMES[2]);
+        eliminate_dead_stores(parsed_code, env);
+        phases[static_cast<size_t>(benchPhase::EliminateDeadStores)] = clock.lap(PHASE_NAMES[3]);
+
+        node_memory = node_accounting.counts();
+    }
+
+//  Peaks are counted from the bytes live before the front end, which peaks when one of its phases does.
+    phaseMetrics& total = phases[PHASE_COUNT];
+    total = {"total", 0, 0, counters.allocations - start_allocations, counters.allocated_bytes - start_bytes, 0};
+    for (size_t phase_index = 0; phase_index < PHASE_COUNT; phase_index++) {
+        phaseMetrics& phase = phases[phase_index];
+        phase.peak_live_bytes -= std::min(phase.peak_live_bytes, start_live_bytes);
+        total.wall_ns += phase.wall_ns;
+        total.cpu_ns += phase.cpu_ns;
+        total.peak_live_bytes = std::max(total.peak_live_bytes, phase.peak_live_bytes);
+    }
+}
+
+double percentile(const vector<double>& sorted_samples, const double fraction) noexcept {
+    const size_t rank = static_cast<size_t>(fraction * static_cast<double>(sorted_samples.size()) + 0.999999);
+    return sorted_samples[std::min(std::max<size_t>(rank, 1), sorted_samples.size()) - 1];
+}
@@ -0,0 +1,75 @@
+/*
+
+Structures and function declarations for running and measuring the phases of the front end on a program, for benchmarks.
+
+Memory is only counted in executables that include counting_new.hpp.
+
+*/
+
+#ifndef PHASE_RUNNER_HPP
+#define PHASE_RUNNER_HPP
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "inc_internal/metrics.hpp"
+
+
+// Structures for running the phases of the front end.
+namespace PhaseRunning {
+
+//  Phases of the front end, in the order they run.
+    enum class benchPhase {
+        Lex, Parse, Analyze, EliminateDeadStores
+    };
+
+//  Number of phases, the name of each phase, and its key in budgets and baselines, followed by the whole front end's.
+    constexpr std::size_t PHASE_COUNT = 4;
+    constexpr std::array<const char*, PHASE_COUNT> PHASE_NAMES = {"lex", "parse", "analyze", "dead stores"};
+    constexpr std::array<const char*, PHASE_COUNT + 1> PHASE_KEYS = {"lex", "parse", "analyze", "dead_stores", "total"};
+
+//  Time and memory of each phase, followed by the whole front end.
+    using phaseSet = std::array<Metrics::phaseMetrics, PHASE_COUNT + 1>;
+
+//  Generated program of a corpus: its name, and the description of the shape it is generated from.
+    struct corpusProgram {
+        const char* name;
+        const char* shape;
+    };
+
+//  Corpus of generated programs, each stressing one part of the front end.
+    constexpr std::array<corpusProgram, 5> CORPUS = {{
+        {"straight_line", "statements=8000,expression_depth=2,if_ratio=0,comment_ratio=0,seed=11"},
+        {"nested_ifs", "statements=3000,if_nesting=12,if_ratio=0.6,seed=12"},
+        {"long_expressions", "statements=1000,expression_depth=9,if_ratio=0.05,seed=13"},
+        {"runtime_values", "statements=4000,runtime_ratio=0.3,seed=14"},
+        {"commented", "statements=3000,comment_ratio=0.8,seed=15"}
+    }};
+
+}
+
+/*
+Run every phase of the front end once on a program, with the runtime variables 'x' (64-bit integer) and 'y' (64-bit
+float) declared. Peaks of live bytes are counted from the bytes live before the front end.
+
+Parameters:
+    text: the program's text (input)
+    phases: time and memory of each phase, with the whole front end after the phases (output)
+    node_memory: memory of each type of AST node (output)
+    token_count: number of tokens lexed (output)
+*/
+void run_phases(const std::string& text, PhaseRunning::phaseSet& phases, Metrics::nodeMemoryCounts& node_memory, std::size_t& token_count);
+
+/*
+Retrieve a percentile of sorted samples, as the nearest-rank sample.
+
+Parameters:
+    sorted_samples: samples in increasing order, at least one (input)
+    fraction: fraction of samples at or below the percentile, between 0 and 1 (input)
+
+Return the percentile.
+*/
+double percentile(const std::vector<double>& sorted_samples, const double fraction) noexcept;
+
+#endif
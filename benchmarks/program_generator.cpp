@@ -0,0 +1,379 @@
+/*
+
+Generator of synthetic Regal programs for benchmarks.
+
+*/
+
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <array>
+
+#include "program_generator.hpp"
+
+// Standard library aliases
+using std::string, std::vector, std::to_string, std::invalid_argument;
+
+// program_generator namespace
+using namespace ProgramGeneration;
+
+
+namespace {
+
+//  Largest magnitude of a folded value, far below the largest 64-bit integer.
+    constexpr double _MAX_BOUND = 1e15;
+//  Largest magnitude of a variable read by later expressions, so values do not compound along chains of variables.
+    constexpr double _MAX_READ_BOUND = 1e9;
+//  Magnitude assumed for the runtime variables, which the benchmarks give small values.
+    constexpr double _RUNTIME_BOUND = 10;
+//  Indent of each nested block.
+    const string _INDENT = "    ";
+
+//  Numeric variable in scope, with a bound on the magnitude of its value.
+    struct _numberVariable {
+        string name;
+        double bound;
+    };
+
+//  State of the generation of one program.
+    struct _generatorState {
+//      shape of the program
+        const programShape& shape;
+//      state of the pseudo-random sequence
+        std::uint64_t random_state;
+//      generated text
+        string text;
+//      variables in scope, one list per nested block
+        vector<vector<_numberVariable>> numbers;
+        vector<vector<string>> booleans;
+//      statements left to generate, and number of variables declared
+        std::uint32_t remaining;
+        std::uint32_t variable_count;
+    };
+
+/*
+    Draw the next number of the pseudo-random sequence (splitmix64), the same on every platform.
+
+    Parameters:
+        state: generation state (input/output)
+
+    Return the drawn number.
+*/
+    inline std::uint64_t _next(_generatorState& state) noexcept {
+        std::uint64_t bits = (state.random_state += 0x9E37'79B9'7F4A'7C15);
+        bits = (bits ^ (bits >> 30)) * 0xBF58'476D'1CE4'E5B9;
+        bits = (bits ^ (bits >> 27)) * 0x94D0'49BB'1331'11EB;
+        return bits ^ (bits >> 31);
+    }
+
+//  Draw true with the given probability.
+    inline bool _chance(_generatorState& state, const double probability) noexcept {
+        return static_cast<double>(_next(state) >> 11) * 0x1.0p-53 < probability;
+    }
+
+//  Draw an integer between 0 and the given count, excluded.
+    inline std::uint64_t _below(_generatorState& state, const std::uint64_t count) noexcept {
+        return _next(state) % count;
+    }
+
+    string _boolean_expression(_generatorState& state, const std::uint32_t depth, const bool root);
+
+/*
+    Generate a number leaf: a runtime variable, a variable in scope or a literal of the shape's literal mix.
+
+    Parameters:
+        state: generation state (input/output)
+        bound: bound on the magnitude of the leaf's value (output)
+
+    Return the leaf's text.
+*/
+    string _number_leaf(_generatorState& state, double& bound) {
+        if (_chance(state, state.shape.runtime_ratio)) {
+            bound = _RUNTIME_BOUND;
+            return _chance(state, 0.5) ? "x" : "y";
+        }
+
+//      Only variables small enough to read are candidates.
+        vector<const _numberVariable*> readable;
+        for (const vector<_numberVariable>& scope : state.numbers) {
+            for (const _numberVariable& variable : scope) {
+                if (variable.bound <= _MAX_READ_BOUND) {
+                    readable.push_back(&variable);
+                }
+            }
+        }
+        if (!readable.empty() && _chance(state, 0.5)) {
+            const _numberVariable* const variable = readable[_below(state, readable.size())];
+            bound = variable->bound;
+            return variable->name;
+        }
+
+        if (_chance(state, state.shape.float_ratio)) {
+            bound = 100;
+            return to_string(_below(state, 100)) + "." + to_string(_below(state, 10));
+        }
+        if (_chance(state, state.shape.wide_ratio)) {
+            bound = 4e9;
+            return to_string(3'000'000'000 + _below(state, 1'000'000'000));
+        }
+        bound = 100;
+        return to_string(_below(state, 100));
+    }
+
+/*
+    Generate a number expression of at most the given depth, whose folded value stays within the maximum bound.
+
+    Parameters:
+        state: generation state (input/output)
+        depth: maximum depth of operators (input)
+        root: true if the expression is not a subexpression, which then always has the full depth (input)
+        bound: bound on the magnitude of the expression's value (output)
+
+    Return the expression's text.
+*/
+    string _number_expression(_generatorState& state, const std::uint32_t depth, const bool root, double& bound) {
+        if ((depth == 0) || (!root && _chance(state, 0.25))) {
+            return _number_leaf(state, bound);
+        }
+
+        double left_bound, right_bound;
+        const string left = _number_expression(state, depth - 1, false, left_bound);
+        const std::uint64_t kind = _below(state, 20);
+
+//      Add or subtract, dropping the right operand if the sum could exceed the bound.
+        if (kind < 11) {
+            const string right = _number_expression(state, depth - 1, false, right_bound);
+            if (left_bound + right_bound > _MAX_BOUND) {
+                bound = left_bound;
+                return left;
+            }
+
+            bound = left_bound + right_bound;
+            return "(" + left + (_chance(state, 0.5) ? " + " : " - ") + right + ")";
+        }
+
+//      Multiply by a small literal, or divide where the product could exceed the bound.
+        const std::uint64_t factor = 1 + _below(state, 3);
+        if ((kind < 15) && (left_bound * static_cast<double>(factor) <= _MAX_BOUND)) {
+            bound = left_bound * static_cast<double>(factor);
+            return "(" + left + " * " + to_string(factor) + ")";
+        }
+        if (kind < 18) {
+            bound = left_bound;
+            return "(" + left + " / " + to_string(factor + 1) + ")";
+        }
+
+//      Choose between two operands.
+        const string condition = _boolean_expression(state, depth - 1, false);
+        const string right = _number_expression(state, depth - 1, false, right_bound);
+        bound = std::max(left_bound, right_bound);
+        return "(" + left + " if " + condition + " else " + right + ")";
+    }
+
+/*
+    Generate a boolean expression of at most the given depth.
+
+    Parameters:
+        state: generation state (input/output)
+        depth: maximum depth of operators (input)
+        root: true if the expression is not a subexpression, which then always has the full depth (input)
+
+    Return the expression's text.
+*/
+    string _boolean_expression(_generatorState& state, const std::uint32_t depth, const bool root) {
+        if ((depth == 0) || (!root && _chance(state, 0.25))) {
+            vector<const string*> variables;
+            for (const vector<string>& scope : state.booleans) {
+                for (const string& variable : scope) {
+                    variables.push_back(&variable);
+                }
+            }
+
+            if (!variables.empty() && _chance(state, 0.5)) {
+                return *variables[_below(state, variables.size())];
+            }
+            return _chance(state, 0.5) ? "true" : "false";
+        }
+
+        static const std::array<string, 5> comparisons = {" > ", " < ", " >= ", " <= ", " == "};
+        static const std::array<string, 3> logic = {" and ", " or ", " xor "};
+        const std::uint64_t kind = _below(state, 10);
+        double bound;
+
+//      Operands are generated in sequence, so the program does not depend on the order the compiler evaluates them.
+        if (kind < 5) {
+            const string left = _number_expression(state, depth - 1, false, bound);
+            const string& comparison = comparisons[_below(state, comparisons.size())];
+            return "(" + left + comparison + _number_expression(state, depth - 1, false, bound) + ")";
+        }
+        if (kind < 8) {
+            const string left = _boolean_expression(state, depth - 1, false);
+            const string& operation = logic[_below(state, logic.size())];
+            return "(" + left + operation + _boolean_expression(state, depth - 1, false) + ")";
+        }
+        return "(not " + _boolean_expression(state, depth - 1, false) + ")";
+    }
+
+/*
+    Generate a block of statements at the given nesting, in its own scope.
+
+    Parameters:
+        state: generation state (input/output)
+        indent: indent of the block's statements (input)
+        nesting: number of 'if' blocks the block is nested in (input)
+        budget: maximum number of statements of the block, at least one is generated if any are left (input)
+*/
+    void _block(_generatorState& state, const string& indent, const std::uint32_t nesting, const std::uint32_t budget) {
+        const programShape& shape = state.shape;
+        state.numbers.emplace_back();
+        state.booleans.emplace_back();
+
+        for (std::uint32_t statement_index = 0; (statement_index < budget) && (state.remaining > 0); statement_index++) {
+            if (_chance(state, shape.comment_ratio / 2)) {
+                state.text += indent + "# generated comment\n";
+            }
+            state.remaining--;
+
+//          Open an 'if' block, with an 'else' block half of the time, when statements are left for their contents.
+            if ((nesting < shape.if_nesting) && (state.remaining > 0) && _chance(state, shape.if_ratio)) {
+                state.text += indent + "if " + _boolean_expression(state, shape.expression_depth, true) + "\n";
+                _block(state, indent + _INDENT, nesting + 1, 1 + static_cast<std::uint32_t>(_below(state, 4)));
+
+                if ((state.remaining > 1) && _chance(state, 0.5)) {
+                    state.remaining--;
+                    state.text += indent + "else\n";
+                    _block(state, indent + _INDENT, nesting + 1, 1 + static_cast<std::uint32_t>(_below(state, 4)));
+                }
+                continue;
+            }
+
+            double bound;
+            const std::uint64_t kind = _below(state, 20);
+            if (kind < 3) {
+                const string name = "b" + to_string(state.variable_count++);
+                state.text += indent + "let " + name + " = " + _boolean_expression(state, shape.expression_depth, true);
+                state.booleans.back().push_back(name);
+            } else if ((kind < 10) && std::any_of(state.numbers.begin(), state.numbers.end(), [](const auto& scope) { return !scope.empty(); })) {
+//              Reassign a numeric variable in scope, its bound covers every value it takes.
+                vector<_numberVariable*> variables;
+                for (vector<_numberVariable>& scope : state.numbers) {
+                    for (_numberVariable& variable : scope) {
+                        variables.push_back(&variable);
+                    }
+                }
+
+                _numberVariable* const variable = variables[_below(state, variables.size())];
+                const string expression = _number_expression(state, shape.expression_depth, true, bound);
+                state.text += indent + variable->name + " = " + expression;
+                variable->bound = std::max(variable->bound, bound);
+            } else {
+                const string name = "v" + to_string(state.variable_count++);
+                const string expression = _number_expression(state, shape.expression_depth, true, bound);
+                state.text += indent + "let " + name + " = " + expression;
+                state.numbers.back().push_back({name, bound});
+            }
+
+            state.text += _chance(state, shape.comment_ratio / 2) ? "  # generated comment\n" : "\n";
+        }
+
+        state.numbers.pop_back();
+        state.booleans.pop_back();
+    }
+
+/*
+    Read an unsigned integer field of a program shape.
+
+    Parameters:
+        field: name of the field (input)
+        value: text of the value (input)
+
+    Return the value.
+*/
+    std::uint64_t _unsigned_field(const string& field, const string& value) {
+        if (value.empty() || (value.size() > 18) || !std::all_of(value.begin(), value.end(), [](const char digit) { return (digit >= '0') && (digit <= '9'); })) {
+            throw invalid_argument("program shape field \'" + field + "\' expected an unsigned integer");
+        }
+
+        return std::stoull(value);
+    }
+
+/*
+    Read a ratio field of a program shape, between 0 and 1.
+
+    Parameters:
+        field: name of the field (input)
+        value: text of the value (input)
+
+    Return the value.
+*/
+    double _ratio_field(const string& field, const string& value) {
+        std::size_t parsed = 0;
+        double ratio = -1;
+        try {
+            ratio = std::stod(value, &parsed);
+        } catch (const std::exception&) {
+        }
+
+        if ((parsed != value.size()) || !(ratio >= 0) || (ratio > 1)) {
+            throw invalid_argument("program shape field \'" + field + "\' expected a ratio between 0 and 1");
+        }
+        return ratio;
+    }
+
+}
+
+
+string generate_program(const programShape& shape) {
+    _generatorState state = {shape, shape.seed, "", {}, {}, shape.statements, 0};
+
+    _block(state, "", 0, shape.statements);
+    return state.text;
+}
+
+void parse_program_shape(const string& description, programShape& shape) {
+    std::istringstream pairs(description);
+    string pair;
+
+    while (std::getline(pairs, pair, ',')) {
+        const string::size_type bind_index = pair.find('=');
+        if (bind_index == string::npos) {
+            throw invalid_argument("program shape field \'" + pair + "\' expected the form field=value");
+        }
+
+        const string field = pair.substr(0, bind_index);
+        const string value = pair.substr(bind_index + 1);
+        if ((field == "statements") || (field == "expression_depth") || (field == "if_nesting")) {
+            const std::uint64_t number = _unsigned_field(field, value);
+            if (number > UINT32_MAX) {
+                throw invalid_argument("program shape field \'" + field + "\' is too large");
+            }
+
+            std::uint32_t& target = (field == "statements") ? shape.statements : ((field == "expression_depth") ? shape.expression_depth : shape.if_nesting);
+            target = static_cast<std::uint32_t>(number);
+        } else if (field == "seed") {
+            shape.seed = _unsigned_field(field, value);
+        } else if (field == "if_ratio") {
+            shape.if_ratio = _ratio_field(field, value);
+        } else if (field == "float_ratio") {
+            shape.float_ratio = _ratio_field(field, value);
+        } else if (field == "wide_ratio") {
+            shape.wide_ratio = _ratio_field(field, value);
+        } else if (field == "runtime_ratio") {
+            shape.runtime_ratio = _ratio_field(field, value);
+        } else if (field == "comment_ratio") {
+            shape.comment_ratio = _ratio_field(field, value);
+        } else {
+            throw invalid_argument("unknown program shape field \'" + field + "\'");
+        }
+    }
+}
+
+string describe_program_shape(const programShape& shape) {
+    std::ostringstream description;
+
+    description << "statements=" << shape.statements << ",expression_depth=" << shape.expression_depth << ",if_nesting=" << shape.if_nesting
+                << ",if_ratio=" << shape.if_ratio << ",float_ratio=" << shape.float_ratio << ",wide_ratio=" << shape.wide_ratio
+                << ",runtime_ratio=" << shape.runtime_ratio << ",comment_ratio=" << shape.comment_ratio << ",seed=" << shape.seed;
+    return description.str();
+}
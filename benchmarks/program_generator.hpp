@@ -0,0 +1,79 @@
+/*
+
+Structures and function declarations for generating synthetic Regal programs of a given shape, for benchmarks.
+
+Programs are generated from a seed with a fixed pseudo-random sequence, so a shape and seed give the same program on
+every platform. Every generated program is valid: it parses, and analysis never overflows since the magnitude of every
+folded value is bounded while generating.
+
+*/
+
+#ifndef PROGRAM_GENERATOR_HPP
+#define PROGRAM_GENERATOR_HPP
+
+#include <cstdint>
+#include <string>
+
+
+// Structures for generating programs.
+namespace ProgramGeneration {
+
+//  Shape of a generated program.
+    struct programShape {
+//      number of statements, counting 'if' and 'else' lines but not comments
+        std::uint32_t statements = 1000;
+//      maximum depth of operators in an expression
+        std::uint32_t expression_depth = 3;
+//      maximum depth of nested 'if' blocks
+        std::uint32_t if_nesting = 2;
+//      fraction of statements that open an 'if' block, where nesting allows
+        double if_ratio = 0.15;
+//      fraction of number literals that are floats, and of integer literals that are 64-bit
+        double float_ratio = 0.3;
+        double wide_ratio = 0.1;
+//      fraction of expression leaves that read the runtime variables 'x' (64-bit integer) and 'y' (64-bit float),
+//      which analysis can not fold
+        double runtime_ratio = 0.0;
+//      fraction of statements with a comment, on its own line or after the statement
+        double comment_ratio = 0.1;
+//      seed of the pseudo-random sequence
+        std::uint64_t seed = 1;
+    };
+
+}
+
+/*
+Generate a Regal program of the given shape. Statements declare numeric and boolean variables, reassign them and branch
+on comparisons, with expressions mixing literals, variables in scope, arithmetic, comparisons, 'and'/'or'/'not' and
+ternary operators.
+
+Parameters:
+    shape: shape of the program (input)
+
+Return the program's text.
+*/
+std::string generate_program(const ProgramGeneration::programShape& shape);
+
+/*
+Parse a program shape from its description, a comma-separated list of 'field=value' pairs over the fields of
+programShape (e.g. 'statements=5000,expression_depth=6'). Fields that are not listed keep their value.
+
+Throw an std::invalid_argument if a pair is malformed or names no field.
+
+Parameters:
+    description: the shape's description (input)
+    shape: shape to set the listed fields of (input/output)
+*/
+void parse_program_shape(const std::string& description, ProgramGeneration::programShape& shape);
+
+/*
+Describe a program shape as a comma-separated list of every 'field=value' pair, the inverse of parse_program_shape.
+
+Parameters:
+    shape: shape to describe (input)
+
+Return the shape's description.
+*/
+std::string describe_program_shape(const ProgramGeneration::programShape& shape);
+
+#endif
@@ -0,0 +1,213 @@
+/*
+
+Front-end benchmark program. Generate a Regal program of a given shape, then time lexing, parsing, semantic analysis and
+dead store elimination as separate phases over many repetitions. Output each phase's time percentiles to stdout, then
+the memory of each phase and of each type of AST node.
+
+Usage: 'regal_bench [--shape field=value,...] [--warmup count] [--repetitions count] [--budget phase.measure=limit,...]
+[--print]'. The shape lists fields of programShape (e.g. '--shape statements=20000,expression_depth=5,if_nesting=4'),
+'--print' outputs the generated program instead of timing it. Build with CMAKE_BUILD_TYPE=Release for meaningful times.
+
+A budget limits the memory of a phase (lex, parse, analyze or dead_stores) or of the whole front end (total), measured
+as its 'allocations', allocated 'bytes' or 'peak' bytes live (e.g. '--budget parse.allocations=50000,total.peak=8000000').
+The benchmark fails if a repetition exceeds a limit, so memory regressions fail it.
+
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+
+#include "inc_internal/counting_new.hpp"
+#include "program_generator.hpp"
+#include "phase_runner.hpp"
+
+// Standard library aliases
+using std::string, std::vector, std::exception, std::cout, std::cerr, std::fixed, std::setprecision, std::setw, std::flush;
+
+// interp_utils namespace
+using namespace CodeTree;
+
+// metrics namespace
+using namespace Metrics;
+
+// program_generator namespace
+using namespace ProgramGeneration;
+
+// phase_runner namespace
+using namespace PhaseRunning;
+
+
+// Names of the node types, in the order of nodeType.
+constexpr std::array<const char*, node_type_count> NODE_TYPE_NAMES = {
+    "DataNode", "ScopeInitializer", "ValueData", "IrreducibleData", "CodeScope", "IfBlock", "AssignOp", "ReassignOp",
+    "UnaryOp", "BinaryOp", "TernaryOp", "VarContainer", "Int32Container", "Int64Container", "Float32Container",
+    "Float64Container", "BoolContainer"
+};
+
+// Memory limit of a phase of the front end, or of the whole front end.
+struct memoryBudget {
+//  name of the limit as given, e.g. 'parse.allocations'
+    string name;
+//  index of the phase, or PHASE_COUNT for the whole front end
+    std::size_t phase_index;
+//  measure limited: 0 for allocations, 1 for allocated bytes, 2 for peak live bytes
+    std::size_t measure;
+    std::uint64_t limit;
+};
+
+
+/*
+Parse memory budgets from their description, a comma-separated list of 'phase.measure=limit' triples.
+
+Throw an std::invalid_argument if a triple is malformed, or names no phase or measure.
+
+Parameters:
+    description: the budgets' description (input)
+    budgets: budgets to add the described budgets to (input/output)
+*/
+void parse_budgets(const string& description, vector<memoryBudget>& budgets) {
+    const std::map<string, std::size_t> measures = {{"allocations", 0}, {"bytes", 1}, {"peak", 2}};
+    std::istringstream pairs(description);
+
+    for (string pair; std::getline(pairs, pair, ',');) {
+        const std::size_t dot_index = pair.find('.'), equal_index = pair.find('=');
+        if ((dot_index == string::npos) || (equal_index == string::npos) || (dot_index > equal_index)
+                || (pair.find_first_not_of("0123456789", equal_index + 1) != string::npos) || (equal_index + 1 == pair.size())) {
+            throw std::invalid_argument("budget '" + pair + "' is not of the form 'phase.measure=limit'");
+        }
+
+        const string phase = pair.substr(0, dot_index), measure = pair.substr(dot_index + 1, equal_index - dot_index - 1);
+        const auto phase_key = std::find(PHASE_KEYS.begin(), PHASE_KEYS.end(), phase);
+        if ((phase_key == PHASE_KEYS.end()) || !measures.contains(measure)) {
+            throw std::invalid_argument("budget '" + pair + "' names no phase (lex, parse, analyze, dead_stores, total) or measure (allocations, bytes, peak)");
+        }
+
+        budgets.push_back({pair.substr(0, equal_index), static_cast<std::size_t>(phase_key - PHASE_KEYS.begin()), measures.at(measure),
+                           std::stoull(pair.substr(equal_index + 1))});
+    }
+}
+
+/*
+Generate a program of the shape given as arguments, and time each phase of the front end on it.
+Output the program's size, then each phase's minimum, median, 90th and 99th percentile, maximum and mean time, and its
+median throughput.
+*/
+int main(int argc, char* argv[]) {
+    programShape shape;
+    long warmup = 3, repetitions = 30;
+    bool print = false;
+    vector<memoryBudget> budgets;
+
+    try {
+        for (int arg_index = 1; arg_index < argc; arg_index++) {
+            const string argument = argv[arg_index];
+
+            if (argument == "--print") {
+                print = true;
+            } else if ((argument == "--shape") && (arg_index + 1 < argc)) {
+                parse_program_shape(argv[++arg_index], shape);
+            } else if ((argument == "--budget") && (arg_index + 1 < argc)) {
+                parse_budgets(argv[++arg_index], budgets);
+            } else if ((argument == "--warmup") && (arg_index + 1 < argc) && ((warmup = std::atol(argv[++arg_index])) >= 0)) {
+                continue;
+            } else if ((argument == "--repetitions") && (arg_index + 1 < argc) && ((repetitions = std::atol(argv[++arg_index])) > 0)) {
+                continue;
+            } else {
+                cerr << "usage: " << argv[0] << " [--shape field=value,...] [--warmup count] [--repetitions count] [--budget phase.measure=limit,...] [--print]" << flush;
+                return EXIT_FAILURE;
+            }
+        }
+
+        const string text = generate_program(shape);
+        if (print) {
+            cout << text << flush;
+            return 0;
+        }
+
+//      Warm the caches and the allocator, then time every repetition, keeping the largest memory of each phase.
+        phaseSet phases, max_phases{};
+        std::array<vector<double>, PHASE_COUNT> samples;
+        nodeMemoryCounts node_memory;
+        std::size_t token_count = 0;
+        for (long repetition_index = 0; repetition_index < warmup + repetitions; repetition_index++) {
+            run_phases(text, phases, node_memory, token_count);
+            for (std::size_t phase_index = 0; (repetition_index >= warmup) && (phase_index < PHASE_COUNT); phase_index++) {
+                samples[phase_index].push_back(static_cast<double>(phases[phase_index].wall_ns));
+            }
+            for (std::size_t phase_index = 0; phase_index <= PHASE_COUNT; phase_index++) {
+                phaseMetrics& max_phase = max_phases[phase_index];
+                max_phase.allocations = std::max(max_phase.allocations, phases[phase_index].allocations);
+                max_phase.allocated_bytes = std::max(max_phase.allocated_bytes, phases[phase_index].allocated_bytes);
+                max_phase.peak_live_bytes = std::max(max_phase.peak_live_bytes, phases[phase_index].peak_live_bytes);
+            }
+        }
+
+        cout << "shape: " << describe_program_shape(shape) << "\n"
+             << "program: " << text.size() << " bytes, " << std::count(text.begin(), text.end(), '\n') << " lines, " << token_count << " tokens\n"
+             << warmup << " warmup and " << repetitions << " timed repetitions, times in ms\n"
+             << setw(12) << "phase" << setw(10) << "min" << setw(10) << "p50" << setw(10) << "p90" << setw(10) << "p99"
+             << setw(10) << "max" << setw(10) << "mean" << setw(14) << "MB/s (p50)" << "\n";
+
+        for (std::size_t phase_index = 0; phase_index < PHASE_COUNT; phase_index++) {
+            vector<double>& phase_samples = samples[phase_index];
+            std::sort(phase_samples.begin(), phase_samples.end());
+            const double mean = std::accumulate(phase_samples.begin(), phase_samples.end(), 0.0) / static_cast<double>(phase_samples.size());
+
+            cout << setw(12) << PHASE_NAMES[phase_index] << fixed << setprecision(3);
+            for (const double fraction : {0.0, 0.5, 0.9, 0.99, 1.0}) {
+                cout << setw(10) << percentile(phase_samples, fraction) / 1e6;
+            }
+            cout << setw(10) << mean / 1e6 << setw(14) << setprecision(1)
+                 << static_cast<double>(text.size()) / std::max(percentile(phase_samples, 0.5), 1.0) * 1e3 << "\n";
+        }
+
+//      Memory does not vary between repetitions of the same program, the largest of each measure is output.
+        cout << "\nmemory, counted by the replaced global operator new\n"
+             << setw(12) << "phase" << setw(14) << "allocations" << setw(16) << "bytes" << setw(16) << "peak bytes" << "\n";
+        for (std::size_t phase_index = 0; phase_index <= PHASE_COUNT; phase_index++) {
+            const phaseMetrics& max_phase = max_phases[phase_index];
+            cout << setw(12) << ((phase_index < PHASE_COUNT) ? PHASE_NAMES[phase_index] : PHASE_KEYS[PHASE_COUNT]) << setw(14) << max_phase.allocations
+                 << setw(16) << max_phase.allocated_bytes << setw(16) << max_phase.peak_live_bytes << "\n";
+        }
+
+        cout << "\nAST node memory, of the last repetition\n"
+             << setw(18) << "node type" << setw(12) << "nodes" << setw(16) << "bytes" << setw(16) << "peak bytes" << "\n";
+        for (std::size_t type_index = 0; type_index < node_type_count; type_index++) {
+            const nodeMemory& type_memory = node_memory[type_index];
+            if (type_memory.allocations != 0) {
+                cout << setw(18) << NODE_TYPE_NAMES[type_index] << setw(12) << type_memory.allocations << setw(16)
+                     << type_memory.allocated_bytes << setw(16) << type_memory.peak_live_bytes << "\n";
+            }
+        }
+
+//      Fail if any repetition exceeded a budget.
+        bool over_budget = false;
+        for (const memoryBudget& budget : budgets) {
+            const phaseMetrics& max_phase = max_phases[budget.phase_index];
+            const std::uint64_t measured = (budget.measure == 0) ? max_phase.allocations
+                                         : ((budget.measure == 1) ? max_phase.allocated_bytes : max_phase.peak_live_bytes);
+            if (measured > budget.limit) {
+                cerr << "over budget: " << budget.name << " is " << measured << ", the limit is " << budget.limit << "\n";
+                over_budget = true;
+            }
+        }
+        if (over_budget) {
+            cout << flush;
+            cerr << flush;
+            return EXIT_FAILURE;
+        }
+
+    } catch (const exception& e) {
+        cerr << e.what() << flush;
+        return EXIT_FAILURE;
+    }
+
+    cout << flush;
+    return 0;
+}
@@ -0,0 +1,402 @@
+/*
+
+Performance regression check. Run the front end on a fixed corpus of generated programs (long straight-line files,
+deeply nested if-chains, long expressions, ...) and compare each phase's median time and allocations with a checked-in
+baseline. Exit with failure if any of them regressed beyond the baseline's thresholds.
+
+Usage: 'regal_perf_check [--baseline path] [--warmup count] [--repetitions count] [--allocations-only] [--update]'.
+The baseline defaults to benchmarks/perf_baseline.json of the source tree. '--update' measures the corpus and writes it
+as the new baseline, keeping the thresholds. Times depend on the machine and build, so compare against a baseline
+recorded on the same machine with CMAKE_BUILD_TYPE=Release, or only compare allocations with '--allocations-only'.
+
+The baseline is a JSON object with
+    "thresholds": object with
+        "time_tolerance": relative increase of a median time that is allowed (e.g. 0.25 for 25%),
+        "noise_factor": times the larger scaled median absolute deviation that an increase must also exceed,
+        "min_time_delta_ms": increase in milliseconds that an increase must also exceed, below timer noise, and
+        "allocation_tolerance": relative increase of an allocation count that is allowed, and
+    "programs": object with, for each program of the corpus, an object with, for each phase (lex, parse, analyze,
+                dead_stores) and the whole front end (total), an object with its "p50_ms", "mad_ms" and "allocations".
+
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <variant>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "inc_internal/counting_new.hpp"
+#include "program_generator.hpp"
+#include "phase_runner.hpp"
+
+// Standard library aliases
+using std::string, std::vector, std::map, std::exception, std::cout, std::cerr, std::fixed, std::setprecision, std::setw,
+      std::flush, std::size_t;
+
+// metrics namespace
+using namespace Metrics;
+
+// program_generator namespace
+using namespace ProgramGeneration;
+
+// phase_runner namespace
+using namespace PhaseRunning;
+
+// Baseline used when none is given, in the source tree.
+#ifndef REGAL_PERF_BASELINE
+#define REGAL_PERF_BASELINE "benchmarks/perf_baseline.json"
+#endif
+
+
+// Thresholds of a regression, as described in the baseline.
+struct regressionThresholds {
+    double time_tolerance = 0.25;
+    double noise_factor = 3.0;
+    double min_time_delta_ms = 0.05;
+    double allocation_tolerance = 0.01;
+};
+
+// Measurement of a phase on one program: its median time, median absolute deviation, and allocations.
+struct phaseMeasurement {
+    double p50_ms = 0;
+    double mad_ms = 0;
+    double allocations = 0;
+};
+
+// Measurements of each phase of each program, by program name then phase key.
+using corpusMeasurements = map<string, map<string, phaseMeasurement>>;
+
+// Value of the JSON subset that baselines are written in: numbers, strings and objects.
+struct jsonValue {
+    std::variant<double, string, map<string, jsonValue>> value;
+};
+
+
+namespace {
+
+/*
+    Skip whitespace in JSON text, then check that the next character is the expected one and skip it.
+
+    Throw an std::invalid_argument if the next character is not the expected one.
+
+    Parameters:
+        text: the JSON text (input)
+        index: index of the next character, moved past the expected character (input/output)
+        expected: the expected character, or '\0' to only skip whitespace (input)
+*/
+    void _expect(const string& text, size_t& index, const char expected) {
+        while ((index < text.size()) && std::isspace(static_cast<unsigned char>(text[index]))) {
+            index++;
+        }
+        if (expected == '\0') {
+            return;
+        }
+        if ((index == text.size()) || (text[index] != expected)) {
+            throw std::invalid_argument(string("baseline is not valid JSON: expected '") + expected + "' at offset " + std::to_string(index));
+        }
+        index++;
+    }
+
+/*
+    Parse a JSON value of the subset baselines are written in.
+
+    Throw an std::invalid_argument if the text is not a value of the subset.
+
+    Parameters:
+        text: the JSON text (input)
+        index: index of the value, moved past the value (input/output)
+
+    Return the value.
+*/
+    jsonValue _parse_json(const string& text, size_t& index) {
+        _expect(text, index, '\0');
+
+        if ((index < text.size()) && (text[index] == '"')) {
+            const size_t end_index = text.find('"', index + 1);
+            if (end_index == string::npos) {
+                throw std::invalid_argument("baseline is not valid JSON: unterminated string at offset " + std::to_string(index));
+            }
+            const string value = text.substr(index + 1, end_index - index - 1);
+            index = end_index + 1;
+            return {value};
+        }
+
+        if ((index < text.size()) && (text[index] == '{')) {
+            map<string, jsonValue> members;
+            index++;
+            _expect(text, index, '\0');
+            if ((index < text.size()) && (text[index] == '}')) {
+                index++;
+                return {members};
+            }
+            do {
+                const jsonValue key = _parse_json(text, index);
+                if (!std::holds_alternative<string>(key.value)) {
+                    throw std::invalid_argument("baseline is not valid JSON: expected a key at offset " + std::to_string(index));
+                }
+                _expect(text, index, ':');
+                members[std::get<string>(key.value)] = _parse_json(text, index);
+                _expect(text, index, '\0');
+            } while ((index < text.size()) && (text[index] == ',') && (++index != 0));
+            _expect(text, index, '}');
+            return {members};
+        }
+
+        char* end = nullptr;
+        const double number = std::strtod(text.c_str() + index, &end);
+        if (end == text.c_str() + index) {
+            throw std::invalid_argument("baseline is not valid JSON: unexpected character at offset " + std::to_string(index));
+        }
+        index = end - text.c_str();
+        return {number};
+    }
+
+/*
+    Retrieve a member of a JSON object.
+
+    Throw an std::invalid_argument if the value is not an object or has no such member.
+
+    Parameters:
+        object: the JSON object (input)
+        key: key of the member (input)
+
+    Return the member's value.
+*/
+    const jsonValue& _member(const jsonValue& object, const string& key) {
+        if (!std::holds_alternative<map<string, jsonValue>>(object.value)) {
+            throw std::invalid_argument("baseline has a value that is not an object where '" + key + "' is expected");
+        }
+        const map<string, jsonValue>& members = std::get<map<string, jsonValue>>(object.value);
+        const auto member = members.find(key);
+        if (member == members.end()) {
+            throw std::invalid_argument("baseline has no '" + key + "'");
+        }
+        return member->second;
+    }
+
+/*
+    Retrieve a number member of a JSON object.
+
+    Throw an std::invalid_argument if the value is not an object or has no such number member.
+
+    Parameters:
+        object: the JSON object (input)
+        key: key of the member (input)
+
+    Return the member's number.
+*/
+    double _number(const jsonValue& object, const string& key) {
+        const jsonValue& member = _member(object, key);
+        if (!std::holds_alternative<double>(member.value)) {
+            throw std::invalid_argument("baseline's '" + key + "' is not a number");
+        }
+        return std::get<double>(member.value);
+    }
+
+}
+
+
+/*
+Read a baseline's thresholds and measurements.
+
+Throw an std::invalid_argument if the file can not be read or is not a baseline.
+
+Parameters:
+    path: path of the baseline (input)
+    thresholds: the baseline's thresholds (output)
+    baseline: the baseline's measurements (output)
+*/
+void read_baseline(const string& path, regressionThresholds& thresholds, corpusMeasurements& baseline) {
+    std::ifstream file(path);
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    if (!file) {
+        throw std::invalid_argument("could not read the baseline '" + path + "'");
+    }
+
+    const string text = buffer.str();
+    size_t index = 0;
+    const jsonValue root = _parse_json(text, index);
+
+    const jsonValue& threshold_values = _member(root, "thresholds");
+    thresholds = {_number(threshold_values, "time_tolerance"), _number(threshold_values, "noise_factor"),
+                  _number(threshold_values, "min_time_delta_ms"), _number(threshold_values, "allocation_tolerance")};
+
+    const jsonValue& programs = _member(root, "programs");
+    for (const corpusProgram& program : CORPUS) {
+        const jsonValue& phases = _member(programs, program.name);
+        for (const char* const phase_key : PHASE_KEYS) {
+            const jsonValue& phase = _member(phases, phase_key);
+            baseline[program.name][phase_key] = {_number(phase, "p50_ms"), _number(phase, "mad_ms"), _number(phase, "allocations")};
+        }
+    }
+}
+
+/*
+Write thresholds and measurements as a baseline.
+
+Throw an std::invalid_argument if the file can not be written.
+
+Parameters:
+    path: path of the baseline (input)
+    thresholds: the thresholds (input)
+    measurements: the measurements (input)
+*/
+void write_baseline(const string& path, const regressionThresholds& thresholds, const corpusMeasurements& measurements) {
+    std::ofstream file(path);
+
+    file << "{\n  \"thresholds\": {\"time_tolerance\": " << thresholds.time_tolerance << ", \"noise_factor\": " << thresholds.noise_factor
+         << ", \"min_time_delta_ms\": " << thresholds.min_time_delta_ms << ", \"allocation_tolerance\": " << thresholds.allocation_tolerance
+         << "},\n  \"programs\": {";
+    for (size_t program_index = 0; program_index < CORPUS.size(); program_index++) {
+        const map<string, phaseMeasurement>& phases = measurements.at(CORPUS[program_index].name);
+        file << (program_index == 0 ? "\n" : ",\n") << "    \"" << CORPUS[program_index].name << "\": {";
+        for (size_t phase_index = 0; phase_index < PHASE_KEYS.size(); phase_index++) {
+            const phaseMeasurement& phase = phases.at(PHASE_KEYS[phase_index]);
+            file << (phase_index == 0 ? "\n" : ",\n") << "      \"" << PHASE_KEYS[phase_index] << "\": {\"p50_ms\": " << fixed
+                 << setprecision(4) << phase.p50_ms << ", \"mad_ms\": " << phase.mad_ms << ", \"allocations\": " << setprecision(0)
+                 << phase.allocations << "}";
+        }
+        file << "\n    }";
+    }
+    file << "\n  }\n}\n";
+
+    if (!file) {
+        throw std::invalid_argument("could not write the baseline '" + path + "'");
+    }
+}
+
+/*
+Measure each phase of a program over many repetitions.
+
+Parameters:
+    text: the program's text (input)
+    warmup: repetitions run before measuring (input)
+    repetitions: repetitions measured, at least one (input)
+
+Return the measurement of each phase and of the whole front end, by phase key.
+*/
+map<string, phaseMeasurement> measure_program(const string& text, const long warmup, const long repetitions) {
+    phaseSet phases;
+    nodeMemoryCounts node_memory;
+    size_t token_count = 0;
+    std::array<vector<double>, PHASE_COUNT + 1> samples;
+    std::array<std::uint64_t, PHASE_COUNT + 1> allocations{};
+
+    for (long repetition_index = 0; repetition_index < warmup + repetitions; repetition_index++) {
+        run_phases(text, phases, node_memory, token_count);
+        for (size_t phase_index = 0; (repetition_index >= warmup) && (phase_index <= PHASE_COUNT); phase_index++) {
+            samples[phase_index].push_back(static_cast<double>(phases[phase_index].wall_ns) / 1e6);
+            allocations[phase_index] = std::max(allocations[phase_index], phases[phase_index].allocations);
+        }
+    }
+
+//  The median absolute deviation estimates the timer and scheduling noise without being thrown off by outliers.
+    map<string, phaseMeasurement> measurement;
+    for (size_t phase_index = 0; phase_index <= PHASE_COUNT; phase_index++) {
+        vector<double>& phase_samples = samples[phase_index];
+        std::sort(phase_samples.begin(), phase_samples.end());
+        const double median = percentile(phase_samples, 0.5);
+
+        vector<double> deviations;
+        for (const double sample : phase_samples) {
+            deviations.push_back(std::abs(sample - median));
+        }
+        std::sort(deviations.begin(), deviations.end());
+
+        measurement[PHASE_KEYS[phase_index]] = {median, percentile(deviations, 0.5), static_cast<double>(allocations[phase_index])};
+    }
+
+    return measurement;
+}
+
+/*
+Measure the corpus, then compare it with the baseline, or write it as the new baseline.
+Output each phase's baseline and measured median time and allocations, and whether it regressed.
+*/
+int main(int argc, char* argv[]) {
+    string baseline_path = REGAL_PERF_BASELINE;
+    long warmup = 3, repetitions = 15;
+    bool allocations_only = false, update = false;
+
+    try {
+        for (int arg_index = 1; arg_index < argc; arg_index++) {
+            const string argument = argv[arg_index];
+
+            if (argument == "--allocations-only") {
+                allocations_only = true;
+            } else if (argument == "--update") {
+                update = true;
+            } else if ((argument == "--baseline") && (arg_index + 1 < argc)) {
+                baseline_path = argv[++arg_index];
+            } else if ((argument == "--warmup") && (arg_index + 1 < argc) && ((warmup = std::atol(argv[++arg_index])) >= 0)) {
+                continue;
+            } else if ((argument == "--repetitions") && (arg_index + 1 < argc) && ((repetitions = std::atol(argv[++arg_index])) > 0)) {
+                continue;
+            } else {
+                cerr << "usage: " << argv[0] << " [--baseline path] [--warmup count] [--repetitions count] [--allocations-only] [--update]" << flush;
+                return EXIT_FAILURE;
+            }
+        }
+
+//      An update keeps the thresholds of the current baseline, if there is one.
+        regressionThresholds thresholds;
+        corpusMeasurements baseline, measurements;
+        if (!update || std::ifstream(baseline_path)) {
+            read_baseline(baseline_path, thresholds, baseline);
+        }
+
+        for (const corpusProgram& program : CORPUS) {
+            programShape shape;
+            parse_program_shape(program.shape, shape);
+            measurements[program.name] = measure_program(generate_program(shape), warmup, repetitions);
+        }
+
+        if (update) {
+            write_baseline(baseline_path, thresholds, measurements);
+            cout << "baseline written to " << baseline_path << "\n" << flush;
+            return 0;
+        }
+
+        cout << "baseline: " << baseline_path << "\n" << warmup << " warmup and " << repetitions << " timed repetitions per program"
+             << (allocations_only ? ", only allocations compared" : "") << "\n"
+             << setw(18) << "program" << setw(13) << "phase" << setw(12) << "base ms" << setw(12) << "ms" << setw(9) << "change"
+             << setw(14) << "base allocs" << setw(12) << "allocs" << "  status\n";
+
+        size_t regressions = 0;
+        for (const corpusProgram& program : CORPUS) {
+            for (const char* const phase_key : PHASE_KEYS) {
+                const phaseMeasurement& base = baseline[program.name][phase_key];
+                const phaseMeasurement& measured = measurements[program.name][phase_key];
+
+//              A time regresses when its median increases by more than the tolerance, the noise, and the timer's noise.
+                const double time_limit = std::max({thresholds.time_tolerance * base.p50_ms,
+                                                    thresholds.noise_factor * 1.4826 * std::max(base.mad_ms, measured.mad_ms),
+                                                    thresholds.min_time_delta_ms});
+                const bool time_regressed = !allocations_only && (measured.p50_ms - base.p50_ms > time_limit);
+                const bool time_improved = !allocations_only && (base.p50_ms - measured.p50_ms > time_limit);
+                const bool allocations_regressed = measured.allocations > std::ceil(base.allocations * (1 + thresholds.allocation_tolerance));
+
+                regressions += time_regressed + allocations_regressed;
+                cout << setw(18) << program.name << setw(13) << phase_key << fixed << setprecision(3) << setw(12) << base.p50_ms
+                     << setw(12) << measured.p50_ms << setw(8) << setprecision(1) << (measured.p50_ms / std::max(base.p50_ms, 1e-9) - 1) * 100
+                     << "%" << setprecision(0) << setw(14) << base.allocations << setw(12) << measured.allocations << "  "
+                     << (time_regressed ? "TIME REGRESSED " : "") << (allocations_regressed ? "ALLOCATIONS REGRESSED" : "")
+                     << ((!time_regressed && !allocations_regressed) ? (time_improved ? "improved" : "ok") : "") << "\n";
+            }
+        }
+
+        cout << "\n" << regressions << " regression" << ((regressions == 1) ? "" : "s") << "\n" << flush;
+        return (regressions == 0) ? 0 : EXIT_FAILURE;
+
+    } catch (const exception& e) {
+        cerr << e.what() << flush;
+        return EXIT_FAILURE;
+    }
+}
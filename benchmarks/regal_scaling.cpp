@@ -0,0 +1,389 @@
+/*
+
+Scaling benchmark of the front end. Sweep the size of programs over orders of magnitude, for each shape of the corpus
+and for pathological programs that stress code paths which may not scale linearly, and time each phase at each size.
+Fit each phase's complexity exponent, the slope of its median time (and allocations) over its input size on a log-log
+scale, and flag any phase that scales worse than O(n log n).
+
+Usage: 'regal_scaling [--family name]... [--sizes count,...] [--warmup count] [--repetitions count] [--tolerance slope]'.
+Sizes are numbers of statements (250 to 8000 by default). A phase's input size is the program's bytes for lexing and its
+tokens for the other phases. A phase is flagged when its exponent exceeds the exponent of n log n over the same sizes
+by more than the tolerance (0.25 by default), and the benchmark then fails. Build with CMAKE_BUILD_TYPE=Release for
+meaningful times.
+
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "inc_internal/counting_new.hpp"
+#include "program_generator.hpp"
+#include "phase_runner.hpp"
+
+// Standard library aliases
+using std::string, std::vector, std::exception, std::ostringstream, std::cout, std::cerr, std::fixed, std::setprecision,
+      std::setw, std::flush, std::uint32_t, std::size_t;
+
+// metrics namespace
+using namespace Metrics;
+
+// program_generator namespace
+using namespace ProgramGeneration;
+
+// phase_runner namespace
+using namespace PhaseRunning;
+
+
+// Family of programs of increasing size.
+struct scalingFamily {
+    string name;
+//  code paths the family stresses
+    string stresses;
+//  description of the program shape to generate, with its statements set to the size, or empty if generate is set
+    string shape;
+//  generator of the family's program with the given number of statements, or nullptr if shape is set
+    string (*generate)(const uint32_t);
+};
+
+
+namespace {
+
+//  Phases whose median time at the largest size is below this are too fast to fit, in milliseconds.
+    constexpr double _MIN_FIT_MS = 0.05;
+
+/*
+    Generate a program with a single expression adding as many terms as statements, alternating the runtime variable
+    'x' and literals so that analysis can not fold it.
+
+    Parameters:
+        statements: number of terms (input)
+
+    Return the program's text.
+*/
+    string _flat_expression(const uint32_t statements) {
+        ostringstream text;
+        text << "let a = x";
+        for (uint32_t term_index = 1; term_index < statements; term_index++) {
+            text << ((term_index % 2 == 0) ? " + x" : " + ") << ((term_index % 2 == 0) ? "" : std::to_string(term_index));
+        }
+        text << "\n";
+        return text.str();
+    }
+
+/*
+    Generate a program of 'if' blocks nested as deep as an eighth of its statements, on conditions only known at runtime,
+    with each block declaring variables from a variable of the outermost scope.
+
+    Parameters:
+        statements: number of statements (input)
+
+    Return the program's text.
+*/
+    string _deep_nesting(const uint32_t statements) {
+        ostringstream text;
+        text << "let a = 1\n";
+        for (uint32_t depth = 0; depth < statements / 8; depth++) {
+            const string indent(4 * depth, ' ');
+            text << indent << "if x > " << depth << "\n";
+            for (uint32_t declaration_index = 0; declaration_index < 7; declaration_index++) {
+                text << indent << "    let v" << depth << "_" << declaration_index << " = a + " << declaration_index << "\n";
+            }
+        }
+        return text.str();
+    }
+
+/*
+    Generate a program of 'if' blocks on constant conditions nested as deep as a seventh of its statements, each with
+    an 'else' block, so that analysis replaces every 'if' with its block and only typechecks its 'else'.
+
+    Parameters:
+        statements: number of statements (input)
+
+    Return the program's text.
+*/
+    string _constant_branches(const uint32_t statements) {
+        const uint32_t depth_count = statements / 7;
+        ostringstream text;
+
+        for (uint32_t depth = 0; depth < depth_count; depth++) {
+            const string indent(4 * depth, ' ');
+            text << indent << "if " << ((depth % 2 == 0) ? "true" : "1 < 2") << "\n"
+                 << indent << "    let c" << depth << "_0 = " << depth << "\n"
+                 << indent << "    let c" << depth << "_1 = c" << depth << "_0 + 1\n";
+        }
+//      Close the levels from the innermost, each with its 'else' block.
+        for (uint32_t depth = depth_count; depth-- > 0;) {
+            const string indent(4 * depth, ' ');
+            text << indent << "else\n"
+                 << indent << "    let e" << depth << "_0 = " << depth << "\n"
+                 << indent << "    let e" << depth << "_1 = e" << depth << "_0 * 2\n"
+                 << indent << "    let e" << depth << "_2 = e" << depth << "_1 - 1\n";
+        }
+        return text.str();
+    }
+
+/*
+    Generate a program declaring as many variables as statements in a single scope, each from two earlier variables.
+
+    Parameters:
+        statements: number of statements (input)
+
+    Return the program's text.
+*/
+    string _many_variables(const uint32_t statements) {
+        ostringstream text;
+        text << "let v0 = x\n";
+        for (uint32_t variable_index = 1; variable_index < statements; variable_index++) {
+            text << "let v" << variable_index << " = v" << variable_index / 2 << " + v" << variable_index - 1 << "\n";
+        }
+        return text.str();
+    }
+
+/*
+    Generate a program reassigning a single variable from the runtime variable 'x' in every statement, all but the
+    last reassignment being dead stores.
+
+    Parameters:
+        statements: number of statements (input)
+
+    Return the program's text.
+*/
+    string _reassign_chain(const uint32_t statements) {
+        ostringstream text;
+        text << "let a = 0\n";
+        for (uint32_t statement_index = 1; statement_index < statements; statement_index++) {
+            text << "a = x + " << statement_index << "\n";
+        }
+        return text.str();
+    }
+
+/*
+    Fit the slope of a line through points by least squares.
+
+    Parameters:
+        xs: first coordinates of the points, not all equal (input)
+        ys: second coordinates of the points (input)
+
+    Return the slope.
+*/
+    double _fit_slope(const vector<double>& xs, const vector<double>& ys) {
+        const double count = static_cast<double>(xs.size());
+        double x_mean = 0, y_mean = 0;
+        for (size_t point_index = 0; point_index < xs.size(); point_index++) {
+            x_mean += xs[point_index] / count;
+            y_mean += ys[point_index] / count;
+        }
+
+        double covariance = 0, variance = 0;
+        for (size_t point_index = 0; point_index < xs.size(); point_index++) {
+            covariance += (xs[point_index] - x_mean) * (ys[point_index] - y_mean);
+            variance += (xs[point_index] - x_mean) * (xs[point_index] - x_mean);
+        }
+        return covariance / variance;
+    }
+
+/*
+    Fit the complexity exponent of costs over input sizes, the slope of the costs over the sizes on a log-log scale.
+
+    Parameters:
+        sizes: input sizes, at least two different ones (input)
+        costs: cost at each size (input)
+
+    Return the exponent.
+*/
+    double _fit_exponent(const vector<double>& sizes, const vector<double>& costs) {
+        vector<double> log_sizes, log_costs;
+        for (size_t point_index = 0; point_index < sizes.size(); point_index++) {
+            log_sizes.push_back(std::log(sizes[point_index]));
+            log_costs.push_back(std::log(std::max(costs[point_index], 1e-9)));
+        }
+        return _fit_slope(log_sizes, log_costs);
+    }
+
+/*
+    Fit the exponent of n log n over input sizes, the largest exponent that is not flagged before the tolerance.
+
+    Parameters:
+        sizes: input sizes, at least two different ones greater than one (input)
+
+    Return the exponent.
+*/
+    double _n_log_n_exponent(const vector<double>& sizes) {
+        vector<double> costs;
+        for (const double size : sizes) {
+            costs.push_back(size * std::log(size));
+        }
+        return _fit_exponent(sizes, costs);
+    }
+
+/*
+    Parse sizes from their description, a comma-separated list of at least two different numbers of statements.
+
+    Throw an std::invalid_argument if a size is not a number of at least 8 statements, or fewer than two sizes differ.
+
+    Parameters:
+        description: the sizes' description (input)
+
+    Return the sizes in increasing order.
+*/
+    vector<uint32_t> _parse_sizes(const string& description) {
+        vector<uint32_t> sizes;
+        std::istringstream sizes_text(description);
+
+        for (string size; std::getline(sizes_text, size, ',');) {
+            if (size.empty() || (size.size() > 9) || (size.find_first_not_of("0123456789") != string::npos) || (std::stoul(size) < 8)) {
+                throw std::invalid_argument("size '" + size + "' is not a number of at least 8 statements");
+            }
+            sizes.push_back(static_cast<uint32_t>(std::stoul(size)));
+        }
+
+        std::sort(sizes.begin(), sizes.end());
+        sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+        if (sizes.size() < 2) {
+            throw std::invalid_argument("sizes '" + description + "' do not list two different sizes to fit");
+        }
+        return sizes;
+    }
+
+}
+
+
+/*
+Sweep the sizes of the families given as arguments, or of every family, and time each phase of the front end at each size.
+Output each size's program size and median phase times, then each phase's fitted exponents of time and allocations.
+*/
+int main(int argc, char* argv[]) {
+    vector<uint32_t> sizes = {250, 500, 1000, 2000, 4000, 8000};
+    long warmup = 1, repetitions = 7;
+    double tolerance = 0.25;
+    vector<string> selected_families;
+
+//  Families of the corpus's shapes, then pathological families.
+    vector<scalingFamily> families;
+    for (const corpusProgram& program : CORPUS) {
+        families.push_back({program.name, "generated program", program.shape, nullptr});
+    }
+    families.push_back({"flat_expression", "one expression as long as the program (parser lookahead, operator recursion)", "", _flat_expression});
+    families.push_back({"deep_nesting", "scopes nested as deep as the program is long (declarations and lookups walking the scope chain)", "", _deep_nesting});
+    families.push_back({"constant_branches", "nested 'if'/'else' on constant conditions (both blocks analyzed, 'if' replaced by its block)", "", _constant_branches});
+    families.push_back({"many_variables", "every statement declaring a variable in one scope (environment growth)", "", _many_variables});
+    families.push_back({"reassign_chain", "every statement reassigning one variable (code scope recursion, dead stores)", "", _reassign_chain});
+
+    try {
+        for (int arg_index = 1; arg_index < argc; arg_index++) {
+            const string argument = argv[arg_index];
+
+            if ((argument == "--family") && (arg_index + 1 < argc)) {
+                selected_families.push_back(argv[++arg_index]);
+                if (std::none_of(families.begin(), families.end(), [&](const scalingFamily& family) { return family.name == selected_families.back(); })) {
+                    throw std::invalid_argument("there is no family '" + selected_families.back() + "'");
+                }
+            } else if ((argument == "--sizes") && (arg_index + 1 < argc)) {
+                sizes = _parse_sizes(argv[++arg_index]);
+            } else if ((argument == "--warmup") && (arg_index + 1 < argc) && ((warmup = std::atol(argv[++arg_index])) >= 0)) {
+                continue;
+            } else if ((argument == "--repetitions") && (arg_index + 1 < argc) && ((repetitions = std::atol(argv[++arg_index])) > 0)) {
+                continue;
+            } else if ((argument == "--tolerance") && (arg_index + 1 < argc) && ((tolerance = std::atof(argv[++arg_index])) >= 0)) {
+                continue;
+            } else {
+                cerr << "usage: " << argv[0] << " [--family name]... [--sizes count,...] [--warmup count] [--repetitions count] [--tolerance slope]" << flush;
+                return EXIT_FAILURE;
+            }
+        }
+
+        cout << warmup << " warmup and " << repetitions << " timed repetitions per size, times in ms, flagged above the "
+             << "n log n exponent + " << tolerance << "\n";
+
+        size_t flagged_count = 0;
+        for (const scalingFamily& family : families) {
+            if (!selected_families.empty() && (std::find(selected_families.begin(), selected_families.end(), family.name) == selected_families.end())) {
+                continue;
+            }
+
+            cout << "\n" << family.name << ": " << family.stresses << "\n"
+                 << setw(12) << "statements" << setw(12) << "bytes" << setw(10) << "tokens";
+            for (const char* const phase_name : PHASE_NAMES) {
+                cout << setw(14) << phase_name;
+            }
+            cout << "\n";
+
+//          Measure every size, keeping each phase's median time and allocations.
+            vector<double> byte_counts, token_counts;
+            std::array<vector<double>, PHASE_COUNT> medians, allocations;
+            for (const uint32_t size : sizes) {
+                string text;
+                if (family.generate != nullptr) {
+                    text = family.generate(size);
+                } else {
+                    programShape shape;
+                    parse_program_shape(family.shape + ",statements=" + std::to_string(size), shape);
+                    text = generate_program(shape);
+                }
+
+                phaseSet phases;
+                nodeMemoryCounts node_memory;
+                size_t token_count = 0;
+                std::array<vector<double>, PHASE_COUNT> samples;
+                for (long repetition_index = 0; repetition_index < warmup + repetitions; repetition_index++) {
+                    run_phases(text, phases, node_memory, token_count);
+                    for (size_t phase_index = 0; (repetition_index >= warmup) && (phase_index < PHASE_COUNT); phase_index++) {
+                        samples[phase_index].push_back(static_cast<double>(phases[phase_index].wall_ns) / 1e6);
+                    }
+                }
+
+                byte_counts.push_back(static_cast<double>(text.size()));
+                token_counts.push_back(static_cast<double>(token_count));
+                cout << setw(12) << size << setw(12) << text.size() << setw(10) << token_count << fixed << setprecision(3);
+                for (size_t phase_index = 0; phase_index < PHASE_COUNT; phase_index++) {
+                    std::sort(samples[phase_index].begin(), samples[phase_index].end());
+                    medians[phase_index].push_back(percentile(samples[phase_index], 0.5));
+                    allocations[phase_index].push_back(static_cast<double>(std::max<std::uint64_t>(phases[phase_index].allocations, 1)));
+                    cout << setw(14) << medians[phase_index].back();
+                }
+                cout << "\n" << flush;
+            }
+
+//          Fit each phase over its own input: the text for lexing, and the tokens for the phases after it.
+            std::array<string, PHASE_COUNT> verdicts;
+            cout << setw(34) << "time exponent" << setprecision(2);
+            for (size_t phase_index = 0; phase_index < PHASE_COUNT; phase_index++) {
+                const vector<double>& input_sizes = (phase_index == static_cast<size_t>(benchPhase::Lex)) ? byte_counts : token_counts;
+                const double limit = _n_log_n_exponent(input_sizes) + tolerance;
+                const double time_exponent = _fit_exponent(input_sizes, medians[phase_index]);
+                const double allocation_exponent = _fit_exponent(input_sizes, allocations[phase_index]);
+
+                if (medians[phase_index].back() < _MIN_FIT_MS) {
+                    cout << setw(14) << "-";
+                    verdicts[phase_index] = "too fast";
+                    continue;
+                }
+                cout << setw(14) << time_exponent;
+                verdicts[phase_index] = ((time_exponent > limit) || (allocation_exponent > limit)) ? "FLAGGED" : "ok";
+                flagged_count += (verdicts[phase_index] == "FLAGGED");
+            }
+            cout << "\n" << setw(34) << "allocation exponent";
+            for (size_t phase_index = 0; phase_index < PHASE_COUNT; phase_index++) {
+                const vector<double>& input_sizes = (phase_index == static_cast<size_t>(benchPhase::Lex)) ? byte_counts : token_counts;
+                cout << setw(14) << _fit_exponent(input_sizes, allocations[phase_index]);
+            }
+            cout << "\n" << setw(34) << "";
+            for (const string& verdict : verdicts) {
+                cout << setw(14) << verdict;
+            }
+            cout << "\n" << flush;
+        }
+
+        cout << "\n" << flagged_count << " phase" << ((flagged_count == 1) ? "" : "s") << " scaling worse than O(n log n)\n" << flush;
+        return (flagged_count == 0) ? 0 : EXIT_FAILURE;
+
+    } catch (const exception& e) {
+        cerr << e.what() << flush;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,112 @@
+/*
+
+Embedding API of the Regal interpreter, the public interface of the regal_core library.
+
+A program is compiled once from its source: lexed, parsed, analyzed and, for the compiled engines, compiled to bytecode
+or machine code. The compiled program can then be queried for its variables and run any number of times with different
+values of its runtime variables, without compiling it again. Values are exchanged as typed values, not display strings.
+
+This header does not expose the interpreter's internal structures, so it stays the same as they change. e.g.
+
+    const RegalCore::compiledProgram program("let y = x * 2", {{"x", RegalCore::valueType::Int64}});
+    const std::map<std::string, RegalCore::value> values = program.run({{"x", std::int64_t{21}}});
+    std::get<std::int64_t>(values.at("y"));    // 42
+
+*/
+
+#ifndef REGAL_CORE_HPP
+#define REGAL_CORE_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+
+// Embedding API of the interpreter.
+namespace RegalCore {
+
+//  Types of values.
+    enum class valueType {
+        Int32, Int64, Float32, Float64, Bool
+    };
+
+//  Value of a variable, holding the alternative of its type, in the order of valueType.
+    using value = std::variant<std::int32_t, std::int64_t, float, double, bool>;
+
+//  Engines that execute the code not known pre-runtime, as the interpreter's '--engine' option.
+    enum class executionEngine {
+//      walk the analyzed AST
+        Tree,
+//      compile the analyzed AST to bytecode once and run it on the virtual machine
+        Bytecode,
+//      compile the bytecode to machine code once and run it, or walk the analyzed AST if machine code is not supported
+        Native
+    };
+
+//  Global variable of a compiled program.
+    struct programVariable {
+//      the variable's type, as analysis gave it
+        valueType type;
+//      the variable's value if analysis knows it pre-runtime, no value if only a run knows it
+        std::optional<value> constant;
+    };
+
+//  Program compiled from Regal source, ready to run. Copies share the compiled program, which runs never change.
+    class compiledProgram {
+        private:
+//          analyzed AST, environment and compiled code of the program
+            struct compiledState;
+            std::shared_ptr<const compiledState> state;
+
+        public:
+/*
+            Compile Regal source, with the given runtime variables declared, for the given engine.
+
+            Throw an std::runtime_error with the error's message if the source does not lex, parse or analyze, or a
+            runtime variable is declared twice.
+
+            Parameters:
+                source: the program's source (input)
+                runtime_variables: type of each runtime variable, whose values are given to each run (input)
+                engine: engine that runs the program (input)
+*/
+            explicit compiledProgram(const std::string_view source, const std::map<std::string, valueType>& runtime_variables = {},
+                                     const executionEngine engine = executionEngine::Bytecode);
+
+/*
+            Retrieve the global variables of the program, including its runtime variables.
+
+            Return each global variable, mapped by name.
+*/
+            const std::map<std::string, programVariable>& variables() const noexcept;
+
+/*
+            Determine whether runs execute code, false if analysis knows every variable pre-runtime.
+
+            Return true if runs execute code.
+*/
+            bool needs_execution() const noexcept;
+
+/*
+            Run the program with the given values of its runtime variables. A value of a different number type than its
+            variable's is converted as in the interpreter's '--input'.
+
+            Throw an std::runtime_error with the error's message if a runtime variable has no value or a value of a type
+            that does not combine with its type, a value is given to a variable that is not a runtime variable, or the
+            program fails (e.g. an operation overflows).
+
+            Parameters:
+                inputs: value of each runtime variable, mapped by name (input)
+
+            Return the final value of every global variable, mapped by name.
+*/
+            std::map<std::string, value> run(const std::map<std::string, value>& inputs = {}) const;
+    };
+
+}
+
+#endif
@@ -0,0 +1,227 @@
+/*
+
+Compact 8-byte value representation shared by constant folding and the runtime.
+
+Values are NaN-boxed: a 64-bit float is stored as its own bit pattern, and every other value is stored in the bit patterns
+of negative quiet NaNs, which no float takes since NaNs are boxed as a single positive NaN. The 3 bits below the quiet bit
+tag the kind of value and the low 48 bits hold its payload:
+    32-bit integers, 32-bit floats and booleans directly,
+    64-bit integers directly while they fit in 48 bits (sign-extended), otherwise a pointer to the full integer, and
+    pointers to heap objects, reserved for values larger than a number (e.g. strings or arrays).
+Pointers fit in 48 bits since user-space addresses of 64-bit platforms (x86-64, AArch64) are at most 47 bits.
+
+Boxed values do not own what they point to: a wide integer points into a container or an integer arena that outlives it.
+An arena is reserved for every wide integer it can hold before any is boxed, so boxing never allocates.
+
+*/
+
+#ifndef BOXED_VALUE_HPP
+#define BOXED_VALUE_HPP
+
+#include <bit>
+#include <vector>
+
+#include "inc_internal/error_handling.hpp"
+
+
+// Structures for boxing values into 64 bits.
+namespace ValueBoxing {
+
+//  Arena of the 64-bit integers too wide to box directly. Its capacity is reserved before boxing and never grows,
+//  so its elements never move and boxed values pointing into it stay valid until it is destroyed.
+    using wideIntegers = std::vector<std::int64_t>;
+
+//  Kinds of values held in the payload of a NaN, 0 is left to the NaN itself.
+    enum class boxTag : std::uint8_t {
+        Int32 = 1, Float32, Bool, Int64, WideInt64, Pointer
+    };
+
+//  Value of any data type in 64 bits, whose type is known from its bits alone.
+    class boxedValue {
+        private:
+//          bit pattern of the value
+            std::uint64_t bits;
+
+//          bits set in every tagged value: the sign, the exponent and the quiet bit of a NaN
+            static constexpr std::uint64_t _NAN_BITS = 0xFFF8'0000'0000'0000;
+//          the single NaN of floats, positive so it is never read as a tagged value
+            static constexpr std::uint64_t _CANONICAL_NAN = 0x7FF8'0000'0000'0000;
+//          position of the tag, and mask of the payload below it
+            static constexpr int _TAG_SHIFT = 48;
+            static constexpr std::uint64_t _PAYLOAD_MASK = (std::uint64_t{1} << _TAG_SHIFT) - 1;
+//          smallest tagged bit pattern, every smaller bit pattern is a float
+            static constexpr std::uint64_t _TAGGED_MIN = _NAN_BITS | (std::uint64_t{1} << _TAG_SHIFT);
+//          bounds of the 64-bit integers boxed directly
+            static constexpr std::int64_t _MAX_INLINE_INT64 = (std::int64_t{1} << (_TAG_SHIFT - 1)) - 1;
+            static constexpr std::int64_t _MIN_INLINE_INT64 = -(std::int64_t{1} << (_TAG_SHIFT - 1));
+
+//          Initialize the value from its bit pattern.
+            explicit constexpr boxedValue(const std::uint64_t bits) noexcept
+                : bits(bits) {}
+
+//          Create a tagged value from its tag and payload.
+            static constexpr boxedValue _tagged(const boxTag tag, const std::uint64_t payload) noexcept {
+                return boxedValue(_NAN_BITS | (static_cast<std::uint64_t>(tag) << _TAG_SHIFT) | (payload & _PAYLOAD_MASK));
+            }
+
+//          Retrieve the payload of a tagged value.
+            constexpr std::uint64_t _payload() const noexcept {
+                return bits & _PAYLOAD_MASK;
+            }
+
+        public:
+//          Default constructor, initialize the value to the float 0.0.
+            constexpr boxedValue() noexcept
+                : bits(0) {}
+
+/*
+            Box a value of each type.
+
+            Throw a FatalError if a 64-bit integer is too wide to box directly and the arena holding it is full.
+
+            Parameters:
+                number/boolean/object: the value (input)
+                wide: arena to hold the integer if it is too wide to box directly (input/output)
+
+            Return the boxed value.
+*/
+            static constexpr boxedValue from_int32(const std::int32_t number) noexcept {
+                return _tagged(boxTag::Int32, static_cast<std::uint32_t>(number));
+            }
+            static inline boxedValue from_int64(const std::int64_t number, wideIntegers& wide) {
+                if (fits_inline(number)) {
+                    return _tagged(boxTag::Int64, static_cast<std::uint64_t>(number));
+                }
+
+                if (wide.size() == wide.capacity()) {
+                    throw FatalError("no reserved space to box a wide integer", 0);
+                }
+                wide.push_back(number);
+                return from_int64(&wide.back());
+            }
+//          An integer too wide to box directly is pointed to, and must outlive the boxed value.
+            static inline boxedValue from_int64(const std::int64_t* const number) noexcept {
+                return fits_inline(*number) ? _tagged(boxTag::Int64, static_cast<std::uint64_t>(*number))
+                                            : _tagged(boxTag::WideInt64, reinterpret_cast<std::uintptr_t>(number));
+            }
+            static constexpr boxedValue from_float32(const float number) noexcept {
+                return _tagged(boxTag::Float32, std::bit_cast<std::uint32_t>(number));
+            }
+            static constexpr boxedValue from_float64(const double number) noexcept {
+                return (number != number) ? boxedValue(_CANONICAL_NAN) : boxedValue(std::bit_cast<std::uint64_t>(number));
+            }
+            static constexpr boxedValue from_bool(const bool boolean) noexcept {
+                return _tagged(boxTag::Bool, boolean ? 1 : 0);
+            }
+            static inline boxedValue from_pointer(const void* const object) noexcept {
+                return _tagged(boxTag::Pointer, reinterpret_cast<std::uintptr_t>(object));
+            }
+
+//          Determine if a 64-bit integer is boxed directly, otherwise it is boxed as a pointer to it.
+            static constexpr bool fits_inline(const std::int64_t number) noexcept {
+                return (number >= _MIN_INLINE_INT64) && (number <= _MAX_INLINE_INT64);
+            }
+
+//          Determine if the value is tagged, otherwise it is a 64-bit float.
+            constexpr bool tagged() const noexcept {
+                return bits >= _TAGGED_MIN;
+            }
+
+//          Retrieve the tag of a tagged value.
+            constexpr boxTag tag() const noexcept {
+                return static_cast<boxTag>((bits >> _TAG_SHIFT) & 0x7);
+            }
+
+//          Retrieve the data type of a value, pointers have no data type yet and are never read as one.
+            constexpr TypingUtils::dataType type() const noexcept {
+                if (!tagged()) {
+                    return TypingUtils::dataType::Float64T;
+                }
+
+                switch (tag()) {
+                    case boxTag::Int32:
+                        return TypingUtils::dataType::Int32T;
+                    case boxTag::Float32:
+                        return TypingUtils::dataType::Float32T;
+                    case boxTag::Int64:
+                    case boxTag::WideInt64:
+                        return TypingUtils::dataType::Int64T;
+                    default:
+                        return TypingUtils::dataType::BoolT;
+                }
+            }
+
+//          Retrieve the value held, of the type of the accessor.
+            constexpr std::int32_t int32() const noexcept {
+                return static_cast<std::int32_t>(static_cast<std::uint32_t>(_payload()));
+            }
+            inline std::int64_t int64() const noexcept {
+                return (tag() == boxTag::Int64) ? (static_cast<std::int64_t>(bits << (64 - _TAG_SHIFT)) >> (64 - _TAG_SHIFT))
+                                                : *reinterpret_cast<const std::int64_t*>(_payload());
+            }
+            constexpr float float32() const noexcept {
+                return std::bit_cast<float>(static_cast<std::uint32_t>(_payload()));
+            }
+            constexpr double float64() const noexcept {
+                return std::bit_cast<double>(bits);
+            }
+            constexpr bool boolean() const noexcept {
+                return _payload() != 0;
+            }
+            inline const void* pointer() const noexcept {
+                return reinterpret_cast<const void*>(_payload());
+            }
+
+/*
+            Retrieve the number held by a number value, converted to the given typename template.
+
+            Return the converted number.
+*/
+            template <typename T>
+            inline T number() const noexcept {
+                switch (type()) {
+                    case TypingUtils::dataType::Int32T:
+                        return static_cast<T>(int32());
+                    case TypingUtils::dataType::Int64T:
+                        return static_cast<T>(int64());
+                    case TypingUtils::dataType::Float32T:
+                        return static_cast<T>(float32());
+                    default:
+                        return static_cast<T>(float64());
+                }
+            }
+
+/*
+            Determine if two values have the same type and value. Numbers are compared by value, not by bit pattern,
+            so wide integers in different places are the same and so are 0.0 and -0.0.
+
+            Parameters:
+                other: value to compare with (input)
+
+            Return true if the values are the same.
+*/
+            inline bool same(const boxedValue other) const noexcept {
+                if (type() != other.type()) {
+                    return false;
+                }
+
+                switch (type()) {
+                    case TypingUtils::dataType::Int32T:
+                        return int32() == other.int32();
+                    case TypingUtils::dataType::Int64T:
+                        return int64() == other.int64();
+                    case TypingUtils::dataType::Float32T:
+                        return float32() == other.float32();
+                    case TypingUtils::dataType::Float64T:
+                        return float64() == other.float64();
+                    default:
+                        return bits == other.bits;
+                }
+            }
+    };
+
+    static_assert(sizeof(boxedValue) == sizeof(std::uint64_t), "boxed values must fit in 64 bits");
+
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*
+
+Checked arithmetic shared by every part of the interpreter that computes numbers (constant folding and runtime).
+Each operation computes its result and reports whether the result is exact in its type, using the
+hardware overflow flags for integers.
+
+Integers are symmetric: the smallest value of an integer type is the negated largest value, as in interp_utils.hpp.
+Floats are exact while every whole number up to their magnitude is representable, i.e. within the accurate float limits.
+
+*/
+
+#ifndef CHECKED_ARITHMETIC_HPP
+#define CHECKED_ARITHMETIC_HPP
+
+#include <type_traits>
+
+#include "inc_interpreter/interp_utils.hpp"
+
+
+// Arithmetic operations that detect overflow.
+namespace CheckedArithmetic {
+
+//  Numbers the checked operations are defined for.
+    template <typename T>
+    constexpr bool checked_number = std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t> ||
+                                    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+//  Largest accurate magnitude of each number type.
+    template <typename T>
+    constexpr T max_magnitude = std::is_floating_point_v<T>
+                                    ? static_cast<T>(std::is_same_v<T, float> ? InterpreterUtils::MAX_ACCURATE_FLOAT32 : InterpreterUtils::MAX_ACCURATE_FLOAT64)
+                                    : std::numeric_limits<T>::max();
+
+/*
+    Determine if the given number is exact in its type: a float within the accurate float limits (never infinite or NaN),
+    or an integer other than the unused smallest value of its type.
+
+    Parameters:
+        number: number to check (input)
+
+    Return true if the number is exact.
+*/
+    template <typename T>
+    constexpr bool exact(const T number) noexcept {
+        static_assert(checked_number<T>, "checked arithmetic is only defined for 32 and 64-bit integers and floats");
+
+//      NaN fails both comparisons.
+        return (number >= -max_magnitude<T>) && (number <= max_magnitude<T>);
+    }
+
+/*
+    Add two numbers.
+
+    Parameters:
+        num1: first number (input)
+        num2: second number (input)
+        result: the sum (output)
+
+    Return true if the sum is exact.
+*/
+    template <typename T>
+    constexpr bool checked_add(const T num1, const T num2, T& result) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            return !__builtin_add_overflow(num1, num2, &result) && exact(result);
+        } else {
+            result = num1 + num2;
+            return exact(result);
+        }
+    }
+
+/*
+    Subtract the second number from the first.
+
+    Parameters:
+        num1: first number (input)
+        num2: second number (input)
+        result: the difference (output)
+
+    Return true if the difference is exact.
+*/
+    template <typename T>
+    constexpr bool checked_sub(const T num1, const T num2, T& result) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            return !__builtin_sub_overflow(num1, num2, &result) && exact(result);
+        } else {
+            result = num1 - num2;
+            return exact(result);
+        }
+    }
+
+/*
+    Multiply two numbers. Integer products are computed in 128 bits, so they are never truncated before the check.
+
+    Parameters:
+        num1: first number (input)
+        num2: second number (input)
+        result: the product (output)
+
+    Return true if the product is exact.
+*/
+    template <typename T>
+    constexpr bool checked_mul(const T num1, const T num2, T& result) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            const __int128 product = static_cast<__int128>(num1) * static_cast<__int128>(num2);
+            if ((product < -static_cast<__int128>(max_magnitude<T>)) || (product > static_cast<__int128>(max_magnitude<T>))) {
+                return false;
+            }
+
+            result = static_cast<T>(product);
+            return true;
+        } else {
+            result = num1 * num2;
+            return exact(result);
+        }
+    }
+
+/*
+    Negate a number.
+
+    Parameters:
+        number: number to negate (input)
+        result: the negation (output)
+
+    Return true if the negation is exact.
+*/
+    template <typename T>
+    constexpr bool checked_neg(const T number, T& result) noexcept {
+        if (!exact(number)) {
+            return false;
+        }
+
+        result = -number;
+        return true;
+    }
+
+/*
+    Divide the first number by the second. Division is only defined for floats.
+
+    Parameters:
+        num1: dividend (input)
+        num2: divisor (input)
+        result: the quotient (output)
+
+    Return true if the divisor is not 0 and the quotient is exact.
+*/
+    template <typename T>
+    constexpr bool checked_div(const T num1, const T num2, T& result) noexcept {
+        static_assert(std::is_floating_point_v<T>, "division always results in a float");
+
+        if (num2 == 0) {
+            return false;
+        }
+
+        result = num1 / num2;
+        return exact(result);
+    }
+
+/*
+    Raise an integer to a non-negative integer power by squaring, so the result is exact and
+    overflow is detected at the step it happens.
+
+    Parameters:
+        base: the base (input)
+        exponent: the exponent (input)
+        result: the power (output)
+
+    Return true if the exponent is not negative and the power is exact.
+*/
+    template <typename T>
+    constexpr bool checked_pow(T base, T exponent, T& result) noexcept {
+        static_assert(std::is_integral_v<T>, "float powers are computed by checked_float_pow");
+
+        if (exponent < 0) {
+            return false;
+        }
+
+        T power = 1;
+        while (exponent != 0) {
+            if (((exponent & 1) != 0) && !checked_mul(power, base, power)) {
+                return false;
+            }
+
+            exponent >>= 1;
+//          The base is only squared if another bit uses it, squaring it once too often could overflow.
+            if ((exponent != 0) && !checked_mul(base, base, base)) {
+                return false;
+            }
+        }
+
+        result = power;
+        return true;
+    }
+
+/*
+    Raise a float to a float power. Whole-number powers of whole numbers are computed exactly by squaring.
+
+    Parameters:
+        base: the base (input)
+        exponent: the exponent (input)
+        result: the power (output)
+
+    Return true if the power is a real number and exact,
+    false for negative bases with fractional exponents and 0 with negative exponents.
+*/
+    inline bool checked_float_pow(const double base, const double exponent, double& result) noexcept {
+        const bool whole_exponent = std::trunc(exponent) == exponent;
+
+        if (((base < 0.0) && !whole_exponent) || ((base == 0.0) && (exponent < 0.0))) {
+            return false;
+        }
+
+//      Both numbers fit 64-bit integers here, and an overflowing integer power is never an exact float.
+        if (whole_exponent && (exponent >= 0.0) && (exponent < static_cast<double>(InterpreterUtils::MAX_INT64)) && (std::trunc(base) == base) && exact(base)) {
+            std::int64_t power;
+            if (!checked_pow(static_cast<std::int64_t>(base), static_cast<std::int64_t>(exponent), power)) {
+                return false;
+            }
+
+            result = static_cast<double>(power);
+            return exact(result);
+        }
+
+        result = std::pow(base, exponent);
+        return exact(result);
+    }
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+
+Replacement of the global operator new and operator delete that counts the allocations and bytes allocated of the
+current thread in the pipeline's counters, and the bytes live (allocated and not freed yet) of the process.
+Allocations are otherwise the default ones, from malloc or aligned_alloc, with the size of each allocation stored just
+before it so that freeing it can be counted. Allocations of an extended alignment are counted as the others.
+
+Include this header in exactly one translation unit of an executable that measures its allocations, never in the
+pipeline's sources. The interpreter program only includes it when built with REGAL_COUNT_ALLOCATIONS.
+
+*/
+
+#ifndef COUNTING_NEW_HPP
+#define COUNTING_NEW_HPP
+
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#include "inc_internal/metrics.hpp"
+
+
+namespace CountingNew {
+
+/*
+    Allocate memory and count it, with the size stored in the header before the returned memory. The header is as
+    large as the alignment, so the returned memory keeps it.
+
+    Parameters:
+        size: bytes requested (input)
+        alignment: alignment of the returned memory, at least malloc's (input)
+
+    Return the allocated memory, or nullptr if there is not enough memory.
+*/
+    [[gnu::noinline]] inline void* allocate(const std::size_t size, const std::size_t alignment) noexcept {
+        std::byte* block;
+        if (alignment == alignof(std::max_align_t)) {
+            block = static_cast<std::byte*>(std::malloc(size + alignment));
+        } else {
+//          aligned_alloc needs a size that is a multiple of the alignment
+            block = static_cast<std::byte*>(std::aligned_alloc(alignment, (size + 2 * alignment - 1) / alignment * alignment));
+        }
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        std::byte* const memory = block + alignment;
+        std::memcpy(memory - sizeof(std::size_t), &size, sizeof(std::size_t));
+        Metrics::counters.allocations++;
+        Metrics::counters.allocated_bytes += size;
+        Metrics::add_live_bytes(size);
+        return memory;
+    }
+
+/*
+    Free memory allocated by allocate with the same alignment, and stop counting it as live.
+
+    Parameters:
+        memory: the allocated memory, or nullptr (input)
+        alignment: alignment the memory was allocated with (input)
+*/
+    [[gnu::noinline]] inline void deallocate(void* const memory, const std::size_t alignment) noexcept {
+        if (memory != nullptr) {
+            std::byte* const block = static_cast<std::byte*>(memory) - alignment;
+            std::size_t size;
+            std::memcpy(&size, block + alignment - sizeof(std::size_t), sizeof(std::size_t));
+            Metrics::live_bytes.fetch_sub(size, std::memory_order_relaxed);
+            std::free(block);
+        }
+    }
+
+//  Alignment the allocations of an alignment are made with, at least malloc's.
+    constexpr std::size_t header_alignment(const std::align_val_t alignment) noexcept {
+        return std::max(static_cast<std::size_t>(alignment), alignof(std::max_align_t));
+    }
+
+}
+
+
+void* operator new(const std::size_t size) {
+    void* const memory = CountingNew::allocate(size, alignof(std::max_align_t));
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    void* const memory = CountingNew::allocate(size, CountingNew::header_alignment(alignment));
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* const memory) noexcept {
+    CountingNew::deallocate(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* const memory, const std::size_t) noexcept {
+    CountingNew::deallocate(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* const memory, const std::align_val_t alignment) noexcept {
+    CountingNew::deallocate(memory, CountingNew::header_alignment(alignment));
+}
+
+void operator delete(void* const memory, const std::size_t, const std::align_val_t alignment) noexcept {
+    CountingNew::deallocate(memory, CountingNew::header_alignment(alignment));
+}
+
+#endif
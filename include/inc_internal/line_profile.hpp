@@ -0,0 +1,171 @@
+/*
+
+Structures and function declarations for attributing the time and allocations of analysis and execution to the lines of
+the code, and reporting them as a heat report next to the code.
+
+A line profile records while it is the thread's active profile. Each statement entered switches the line that the time
+and allocations since the last switch are charged to, so every line is charged its own cost, without the cost of the
+statements nested in it. Costs outside any statement (e.g. walking scopes) are charged to line 0, unattributed.
+
+*/
+
+#ifndef LINE_PROFILE_HPP
+#define LINE_PROFILE_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include "inc_interpreter/interp_utils.hpp"
+
+
+// Structures for profiling lines of code.
+namespace Metrics {
+
+//  Costs charged to one line of code.
+    struct lineCost {
+//      time in nanoseconds and allocations during analysis and during execution
+        std::int64_t analysis_ns = 0;
+        std::int64_t execution_ns = 0;
+        std::uint64_t analysis_allocations = 0;
+        std::uint64_t execution_allocations = 0;
+//      times a statement of the line was executed
+        std::uint64_t executions = 0;
+//      operators of the line left after analysis, that could not be folded
+        std::uint64_t runtime_operations = 0;
+    };
+
+//  Phases that a line profile records.
+    enum class profilePhase : std::uint8_t {
+        Analysis, Execution
+    };
+
+//  Costs of each line of code, indexed by line number.
+    class lineProfile {
+        private:
+//          costs of each line, line 0 holds the unattributed costs
+            std::vector<lineCost> costs = std::vector<lineCost>(1);
+//          phase being recorded, line being charged, and the time and allocation counter when it was last charged
+            profilePhase phase = profilePhase::Analysis;
+            std::uint32_t current_line = 0;
+            std::int64_t last_ns = 0;
+            std::uint64_t last_allocations = 0;
+
+//          Charge the time and allocations since the last charge to the current line, then switch to the given line.
+            void switch_line(const std::uint32_t line_number);
+
+        public:
+//          Start recording the given phase, charging line 0.
+            void start(const profilePhase recorded_phase);
+
+//          Stop recording, charging the current line.
+            inline void stop() {
+                switch_line(0);
+            }
+
+//          Enter a statement of the given line, returning the line to restore when it exits.
+            inline std::uint32_t enter_line(const std::uint32_t line_number) {
+                const std::uint32_t previous_line = current_line;
+                switch_line(line_number);
+                costs[line_number].executions += (phase == profilePhase::Execution);
+                return previous_line;
+            }
+
+//          Exit a statement, restoring the line that was charged before it.
+            inline void exit_line(const std::uint32_t previous_line) {
+                switch_line(previous_line);
+            }
+
+//          Count an operator of the given line that is left after analysis.
+            void add_runtime_operation(const std::uint32_t line_number);
+
+//          Retrieve the costs of each line.
+            inline const std::vector<lineCost>& line_costs() const noexcept {
+                return costs;
+            }
+    };
+
+//  Profile of the current thread's lines, nullptr when not profiling.
+    inline thread_local lineProfile* active_profile = nullptr;
+
+//  Recording of a profile's phases as the thread's active profile, stopped when destroyed. Records nothing without a profile.
+    class lineRecording {
+        private:
+            lineProfile* const profile;
+
+        public:
+            inline explicit lineRecording(lineProfile* const profile) noexcept
+                : profile(profile) {}
+
+//          Start recording the given phase.
+            inline void start(const profilePhase phase) {
+                if (profile != nullptr) {
+                    profile->start(phase);
+                    active_profile = profile;
+                }
+            }
+
+//          Stop recording.
+            inline void stop() {
+                if ((profile != nullptr) && (active_profile == profile)) {
+                    profile->stop();
+                    active_profile = nullptr;
+                }
+            }
+
+            inline ~lineRecording() {
+                stop();
+            }
+
+            lineRecording(const lineRecording&) = delete;
+            lineRecording& operator=(const lineRecording&) = delete;
+    };
+
+//  Statement of a line of code, charged its costs in the active profile until it exits. Line 0 is not a statement.
+    class lineScope {
+        private:
+            lineProfile* const profile;
+            std::uint32_t previous_line = 0;
+
+        public:
+            inline explicit lineScope(const std::uint32_t line_number)
+                : profile((line_number != 0) ? active_profile : nullptr) {
+                if (profile != nullptr) {
+                    previous_line = profile->enter_line(line_number);
+                }
+            }
+
+            inline ~lineScope() {
+                if (profile != nullptr) {
+                    profile->exit_line(previous_line);
+                }
+            }
+
+            lineScope(const lineScope&) = delete;
+            lineScope& operator=(const lineScope&) = delete;
+    };
+
+}
+
+/*
+Count the operators left in an analyzed AST on each line, those that analysis could not fold.
+
+Parameters:
+    data_node: root of the analyzed AST, or nullptr for an empty AST (input)
+    profile: profile to count the operators of each line in (input/output)
+*/
+void count_runtime_operations(const CodeTree::dataNode* const data_node, Metrics::lineProfile& profile);
+
+/*
+Format a line profile as a heat report: a header with the totals, then one row per line of code with its costs, a bar
+of its share of the most expensive line's time, and the line itself. Costs that are not attributed to a line follow.
+
+Parameters:
+    profile: the profile to format (input)
+    text: the profiled code (input)
+
+Return the report's text.
+*/
+std::string line_profile_report(const Metrics::lineProfile& profile, const std::string& text);
+
+#endif
@@ -0,0 +1,202 @@
+/*
+
+Structures and function declarations for measuring the interpreter's pipeline: the wall and CPU time of each phase,
+counters of the work done, and a machine-readable report of them.
+
+Counters are incremented where the work is done and are cheap enough to always count. Allocations are only counted by
+executables that replace the global operator new to count them (see counting_new.hpp), the pipeline itself never
+replaces it. The memory of each type of AST node is accounted for by memory resources plugged into the node allocation.
+Only AST nodes are attributed this way: tokens, environments and their maps use the global allocator, so they only
+appear in the allocations of the phase that makes them.
+
+*/
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <vector>
+#include <memory_resource>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+
+#include "inc_interpreter/interp_utils.hpp"
+#include "inc_internal/line_profile.hpp"
+
+
+// Structures for measuring the pipeline.
+namespace Metrics {
+
+//  Counters of the work done by the pipeline.
+    struct pipelineCounters {
+//      tokens produced by the lexer
+        std::uint64_t tokens = 0;
+//      operators replaced during analysis by a constant or by one of their expressions
+        std::uint64_t folded_nodes = 0;
+//      algebraic identities applied during analysis (e.g. x * 1)
+        std::uint64_t identities = 0;
+//      environments created
+        std::uint64_t environments = 0;
+//      allocations and bytes allocated, counted by executables that replace the global operator new
+        std::uint64_t allocations = 0;
+        std::uint64_t allocated_bytes = 0;
+    };
+
+//  Counters of the current thread. Constant-initialized, so counting never initializes them, even from operator new.
+    inline thread_local pipelineCounters counters;
+
+//  Bytes allocated and not freed yet by the whole process, and their peak since the current phase started, counted by
+//  executables that replace the global operator new. They are the process's rather than a thread's, since memory can
+//  be freed by another thread than the one that allocated it.
+    inline std::atomic<std::uint64_t> live_bytes{0};
+    inline std::atomic<std::uint64_t> peak_live_bytes{0};
+
+//  Count bytes allocated and not freed yet, raising their peak if they exceed it.
+    inline void add_live_bytes(const std::uint64_t bytes) noexcept {
+        const std::uint64_t live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::uint64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+        while ((live > peak) && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+
+//  Restart the counters of the current thread, and the peak of the bytes live from the bytes still live.
+    inline void restart_counters() noexcept {
+        counters = {};
+        peak_live_bytes.store(live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+//  Number of AST nodes of each type.
+    using nodeCounts = std::array<std::uint64_t, CodeTree::node_type_count>;
+
+//  Memory of the AST nodes of one type.
+    struct nodeMemory {
+//      nodes allocated and their bytes, including the shared pointers' control blocks
+        std::uint64_t allocations = 0;
+        std::uint64_t allocated_bytes = 0;
+//      bytes of the nodes not freed yet, and their peak
+        std::uint64_t live_bytes = 0;
+        std::uint64_t peak_live_bytes = 0;
+    };
+    using nodeMemoryCounts = std::array<nodeMemory, CodeTree::node_type_count>;
+
+//  Memory resource that accounts for the memory of one type of AST node, allocated by the global operator new.
+    class nodeAccounting : public std::pmr::memory_resource {
+        private:
+            nodeMemory& memory;
+
+            void* do_allocate(const std::size_t bytes, const std::size_t alignment) override;
+            void do_deallocate(void* const pointer, const std::size_t bytes, const std::size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        public:
+            inline explicit nodeAccounting(nodeMemory& memory) noexcept
+                : memory(memory) {}
+    };
+
+//  Accounting of the memory of each type of AST node allocated by the current thread while it exists.
+//  The counts start at zero, nodes allocated before are not accounted for.
+    class nodeMemoryAccounting {
+        public:
+            nodeMemoryAccounting();
+            ~nodeMemoryAccounting();
+
+//          Retrieve the memory of each type of node.
+            const nodeMemoryCounts& counts() const noexcept;
+
+            nodeMemoryAccounting(const nodeMemoryAccounting&) = delete;
+            nodeMemoryAccounting& operator=(const nodeMemoryAccounting&) = delete;
+    };
+
+//  Wall time, CPU time and allocations of one phase of the pipeline.
+    struct phaseMetrics {
+//      name of the phase
+        const char* name;
+//      wall time and process CPU time in nanoseconds
+        std::int64_t wall_ns;
+        std::int64_t cpu_ns;
+//      allocations and bytes allocated during the phase, and the peak of the bytes allocated and not freed yet
+        std::uint64_t allocations;
+        std::uint64_t allocated_bytes;
+        std::uint64_t peak_live_bytes;
+    };
+
+//  Clock of consecutive phases, from the time and allocation counters when the current phase started.
+    class phaseClock {
+        private:
+//          wall time, CPU time and allocation counters at the start of the current phase
+            std::chrono::steady_clock::time_point wall_start;
+            std::clock_t cpu_start;
+            std::uint64_t allocations_start;
+            std::uint64_t bytes_start;
+
+        public:
+//          Initialize the clock, starting the first phase.
+            inline phaseClock() noexcept {
+                restart();
+            }
+
+//          Start a new phase.
+            inline void restart() noexcept {
+                wall_start = std::chrono::steady_clock::now();
+                cpu_start = std::clock();
+                allocations_start = counters.allocations;
+                bytes_start = counters.allocated_bytes;
+                peak_live_bytes.store(live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+
+//          Measure the current phase under the given name, then start the next phase.
+            inline phaseMetrics lap(const char* const name) noexcept {
+                const phaseMetrics phase = {name, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wall_start).count(),
+                                            static_cast<std::int64_t>(static_cast<double>(std::clock() - cpu_start) * 1e9 / CLOCKS_PER_SEC),
+                                            counters.allocations - allocations_start, counters.allocated_bytes - bytes_start,
+                                            peak_live_bytes.load(std::memory_order_relaxed)};
+                restart();
+                return phase;
+            }
+    };
+
+//  Measurements of one run of the pipeline.
+    struct pipelineReport {
+//      measurements of each phase, in the order they ran
+        std::vector<phaseMetrics> phases;
+//      work done over the run
+        pipelineCounters counters;
+//      AST nodes of each type after parsing, and after analysis
+        nodeCounts parsed_nodes{};
+        nodeCounts analyzed_nodes{};
+//      memory of each type of AST node over the run, when accounted for
+        nodeMemoryCounts node_memory{};
+//      costs of each line of code, when profiled
+        lineProfile lines;
+    };
+
+}
+
+/*
+Count the nodes of each type in an AST.
+
+Parameters:
+    data_node: root of the AST, or nullptr for an empty AST (input)
+
+Return the number of nodes of each type.
+*/
+Metrics::nodeCounts count_nodes(const CodeTree::dataNode* const data_node);
+
+/*
+Format a pipeline report as a JSON object:
+    "phases": array of objects with the "name", "wall_ns", "cpu_ns", "allocations", "allocated_bytes" and
+              "peak_live_bytes" of each phase,
+    "counters": object with the "tokens", "folded_nodes", "identities", "environments", "allocations" and
+                "allocated_bytes" of the run,
+    "parsed_nodes"/"analyzed_nodes": objects with the number of AST nodes of each type, by the name of the type, and
+    "node_memory": object with the "allocations", "allocated_bytes" and "peak_live_bytes" of each type of AST node,
+                   which only cover the nodes themselves.
+
+Parameters:
+    report: the report to format (input)
+
+Return the JSON text.
+*/
+std::string report_json(const Metrics::pipelineReport& report);
+
+#endif
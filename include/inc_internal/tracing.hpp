@@ -0,0 +1,124 @@
+/*
+
+Structures, macros and function declarations for tracing the interpreter as Chrome trace events, which chrome://tracing
+and Perfetto display as a timeline of nested spans on each thread.
+
+Spans are only built when REGAL_TRACING is defined, otherwise REGAL_TRACE_SPAN expands to nothing and costs nothing.
+When built, a span records nothing until tracing starts, then records into a buffer owned by its thread, without locks.
+
+*/
+
+#ifndef TRACING_HPP
+#define TRACING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+
+// Structures for tracing the interpreter.
+namespace Tracing {
+
+//  True if the spans were built.
+#ifdef REGAL_TRACING
+    constexpr bool tracing_built = true;
+#else
+    constexpr bool tracing_built = false;
+#endif
+
+//  A span that ended: its name, start and duration in nanoseconds, and the line of code it covers (0 if none).
+    struct traceEvent {
+        const char* name;
+        std::int64_t start_ns;
+        std::int64_t duration_ns;
+        std::uint32_t line_number;
+    };
+
+//  Spans recorded by one thread. Each buffer is linked into a list of every thread's buffer when its thread first
+//  records, and outlives its thread so that the spans can be written after the thread ends.
+    struct threadBuffer {
+        std::vector<traceEvent> events;
+        std::uint32_t thread_id;
+        threadBuffer* next;
+    };
+
+//  True while tracing, false otherwise.
+    inline std::atomic<bool> recording = false;
+
+//  Current time of the trace's clock in nanoseconds.
+    inline std::int64_t trace_clock() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+/*
+    Record a span that ended in the current thread's buffer. A span that can not be recorded is dropped.
+
+    Parameters:
+        event: the span (input)
+*/
+    void record_span(const traceEvent& event) noexcept;
+
+//  Span of the enclosing C++ scope, recorded when the scope exits if tracing when it was entered.
+    class traceSpan {
+        private:
+            const char* const name;
+            const std::uint32_t line_number;
+            const bool active;
+            std::int64_t start_ns = 0;
+
+        public:
+//          Start a span with the given name, and optionally the line of code it covers.
+            inline explicit traceSpan(const char* const name, const std::uint32_t line_number = 0) noexcept
+                : name(name),
+                  line_number(line_number),
+                  active(recording.load(std::memory_order_relaxed)) {
+                if (active) {
+                    start_ns = trace_clock();
+                }
+            }
+
+//          End the span.
+            inline ~traceSpan() {
+                if (active) {
+                    record_span({name, start_ns, trace_clock() - start_ns, line_number});
+                }
+            }
+
+            traceSpan(const traceSpan&) = delete;
+            traceSpan& operator=(const traceSpan&) = delete;
+    };
+
+}
+
+// Trace the enclosing scope under a name, and optionally the line of code it covers (e.g. REGAL_TRACE_SPAN("parse_file")).
+#ifdef REGAL_TRACING
+#define REGAL_TRACE_JOIN_(prefix, line) prefix##line
+#define REGAL_TRACE_JOIN(prefix, line) REGAL_TRACE_JOIN_(prefix, line)
+#define REGAL_TRACE_SPAN(...) const Tracing::traceSpan REGAL_TRACE_JOIN(_trace_span_, __LINE__)(__VA_ARGS__)
+#else
+#define REGAL_TRACE_SPAN(...) static_cast<void>(0)
+#endif
+
+/*
+Discard the spans recorded so far and start tracing. No other thread may be recording.
+*/
+void start_tracing();
+
+/*
+Stop tracing, spans that already started are still recorded when they end.
+*/
+void stop_tracing() noexcept;
+
+/*
+Write every thread's recorded spans as a Chrome trace: a JSON object whose "traceEvents" are complete ('X') events with
+timestamps in microseconds, and the span's line of code in "args" if it covers one. No thread may be recording.
+The stream's format flags and precision are left as they were.
+
+Parameters:
+    output: stream to write the trace to (output)
+*/
+void write_trace(std::ostream& output);
+
+#endif
@@ -0,0 +1,105 @@
+/*
+
+Structures for interning the constant values produced by semantic analysis.
+
+*/
+
+#ifndef CONSTANT_POOL_HPP
+#define CONSTANT_POOL_HPP
+
+#include <unordered_map>
+
+#include "inc_interpreter/interp_utils.hpp"
+#include "inc_internal/boxed_value.hpp"
+
+
+// Structures involving interpreted data storage.
+namespace DataStorage {
+
+//  Pool of the irreducible values of one compilation, holding a single shared container for each type and bit pattern.
+//  Pooled containers are shared by every use, so they are never modified after creation. Since they have many uses,
+//  they have no line number of their own (0): the pool keeps the line of each use in a side table, mapped by the AST field
+//  holding the container, so diagnostics about a constant in an expression spanning several lines name its own line.
+//  Most expressions are on the line of their statement, so only uses on another line are kept.
+    class constantPool {
+        private:
+//          pooled containers of each data type, mapped by their bit patterns
+            std::array<std::unordered_map<std::uint64_t, std::shared_ptr<CodeTree::valueData>>, TypingUtils::number_type_count + 1> pooled;
+//          number of containers requested from the pool
+            std::size_t requests;
+//          line of each use of a pooled container that is not on the line of its statement, mapped by the AST field holding it
+            std::unordered_map<const std::shared_ptr<CodeTree::valueData>*, std::uint32_t> use_lines;
+//          line of the statement being analyzed
+            std::uint32_t statement_line;
+
+        public:
+//          Default constructor, initialize the pool and its line table to empty.
+            inline constantPool() noexcept
+                : pooled(),
+                  requests(0),
+                  use_lines(),
+                  statement_line(0) {}
+
+/*
+            Retrieve the pooled container holding the given number or boolean, creating it on first use.
+
+            Parameters:
+                number/boolean: value of the container (input)
+
+            Return the pooled container.
+*/
+            std::shared_ptr<CodeTree::valueData> int32(const std::int32_t number);
+            std::shared_ptr<CodeTree::valueData> int64(const std::int64_t number);
+            std::shared_ptr<CodeTree::valueData> float32(const float number);
+            std::shared_ptr<CodeTree::valueData> float64(const double number);
+            std::shared_ptr<CodeTree::valueData> boolean(const bool boolean);
+
+//          Set the line of the statement being analyzed, the line of every use not recorded otherwise.
+            inline void set_statement_line(const std::uint32_t line_number) noexcept {
+                statement_line = line_number;
+            }
+
+/*
+            Record the line of a use of a pooled container, replacing the line recorded for an earlier container in the same field.
+
+            Parameters:
+                use: AST field holding the container (input)
+                line_number: line of the use (input)
+*/
+            void record_line(const std::shared_ptr<CodeTree::valueData>& use, const std::uint32_t line_number);
+
+/*
+            Retrieve the line of an expression: its own line, or the line recorded for the use of a pooled container.
+
+            Parameters:
+                use: AST field holding the expression (input)
+
+            Return the expression's line number.
+*/
+            std::uint32_t line_number(const std::shared_ptr<CodeTree::valueData>& use) const noexcept;
+
+//          Retrieve the number of distinct containers in the pool.
+            std::size_t size() const noexcept;
+
+//          Retrieve the number of containers requested from the pool, each request after the first for a value shares its container.
+            inline std::size_t request_count() const noexcept {
+                return requests;
+            }
+    };
+
+}
+
+/*
+Box the value of an irreducible data container without copying it. A wide 64-bit integer points to the container's number,
+so its boxed value is only valid while the container lives.
+
+Throw a FatalError if the given data is not an irreducible data container.
+
+Parameters:
+    value_data: container to box (input)
+
+Return the boxed value.
+*/
+ValueBoxing::boxedValue box_constant(const CodeTree::valueData* const value_data);
+
+#endif
@@ -14,10 +14,14 @@ The first namespace is general usage.
 #include <tuple>
 #include <variant>
 #include <memory>
+#include <memory_resource>
 #include <utility>
 #include <limits>
 #include <cstdint>
 #include <cmath>
+#include <charconv>
+#include <algorithm>
+#include <type_traits>
 
 
 // Utility functions and constants used throughout the interpreter.
@@ -82,6 +86,41 @@ namespace InterpreterUtils {
         return relative_error >= FLOAT_PROMOTION_THRESHOLD;
     }
 
+//  Largest number of characters that format_number writes, at least the 327 of the negative 64-bit floats nearest 0
+//  in fixed notation (e.g. -5e-324 is written with 323 zeros after the decimal point).
+    constexpr std::size_t MAX_NUMBER_CHARS = 330;
+
+/*
+    Write the normalized display string of a given number to a character buffer, without allocating.
+    Integers are written in full. Floating-point numbers are written in fixed notation with the fewest decimals that
+    read back as the same number of their type, with at least one decimal (e.g. 2.5 becomes "2.5", 3.0 becomes "3.0",
+    1e6 becomes "1000000.0", the 32-bit float 0.1 becomes "0.1"), so 64-bit floats keep their full precision.
+    This function depends on a typename template.
+
+    This function assumes that the typename used by the caller is a number type.
+
+    Parameters:
+        first: buffer to write to, at least MAX_NUMBER_CHARS long (output)
+        number: template type value to write (input)
+
+    Return a pointer past the last character written.
+*/
+    template <typename T>
+    char* format_number(char* const first, const T number) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            return std::to_chars(first, first + MAX_NUMBER_CHARS, number).ptr;
+        } else {
+//          The shortest round-trip digits in fixed notation, completed with a decimal for whole numbers.
+            char* last = std::to_chars(first, first + MAX_NUMBER_CHARS, number, std::chars_format::fixed).ptr;
+            if (std::isfinite(number) && (std::find(first, last, '.') == last)) {
+                *last++ = '.';
+                *last++ = '0';
+            }
+
+            return last;
+        }
+    }
+
 /*
     Create a normalized display string for a given number.
     This function depends on a typename template.
@@ -90,17 +129,13 @@ namespace InterpreterUtils {
 
     Parameters:
         number: template type value to create a string for (input)
-        is_float: true if the given number is a floating-point number (input)
 
     Return the display string of the number.
 */
     template <typename T>
-    const std::string num_to_string(const T number, const bool is_float) noexcept {
-//      Retrieve the basic number string and normalize it.
-        std::string number_str = std::to_string(number);
-        normalize_number_str(number_str, is_float);
-
-        return number_str;
+    const std::string num_to_string(const T number) noexcept {
+        char number_chars[MAX_NUMBER_CHARS];
+        return std::string(number_chars, format_number<T>(number_chars, number));
     }
 
 }
@@ -120,6 +155,23 @@ namespace TypingUtils {
     constexpr std::array<dataType, number_type_count> number_types = 
         {dataType::Int32T, dataType::Int64T, dataType::Float32T, dataType::Float64T};
 
+//  Determine if the given type is an integer type.
+    constexpr bool integer_type(const dataType type) noexcept {
+        return (type == dataType::Int32T) || (type == dataType::Int64T);
+    }
+
+//  Type of an arithmetic result computed at runtime, where the size of the result is unknown.
+//  Integer operands give a 64-bit integer, any float operand gives a 64-bit float.
+    constexpr dataType runtime_arithmetic_type(const dataType type1, const dataType type2) noexcept {
+        return (integer_type(type1) && integer_type(type2)) ? dataType::Int64T : dataType::Float64T;
+    }
+
+//  Type of a value that may come from either of two number types at runtime (e.g. different branches of an 'if').
+//  Matching types are kept, otherwise the types combine as in arithmetic.
+    constexpr dataType runtime_merged_type(const dataType type1, const dataType type2) noexcept {
+        return (type1 == type2) ? type1 : runtime_arithmetic_type(type1, type2);
+    }
+
 }
 
 
@@ -451,13 +503,15 @@ namespace CodeTree {
         public:
 //          Variable name string
             std::string variable;
+//          Slot of the variable's value at runtime, given by semantic analysis
+            std::uint32_t slot;
 //          Shared pointer to expressional data to assign to the variable
             std::shared_ptr<valueData> expression;
 
-//          Default constructor, initialize the line number to 0, variable name to the empty string, and the expression pointer to nullptr. 
+//          Default constructor, initialize the line number and slot to 0, variable name to the empty string, and the expression pointer to nullptr. 
             assignOp();
 
-//          Initialize the line number, variable name, expression pointer respectively.
+//          Initialize the line number, variable name, expression pointer respectively, and the slot to 0.
             explicit assignOp(const std::uint32_t line_number, const std::string& var, std::shared_ptr<valueData> expr);
 
 //          Move constructor
@@ -469,13 +523,15 @@ namespace CodeTree {
         public:
 //          Variable name string
             std::string variable;
+//          Slot of the variable's value at runtime, given by semantic analysis
+            std::uint32_t slot;
 //          Shared pointer to expressional data to assign to the variable
             std::shared_ptr<valueData> expression;
 
-//          Default constructor, initialize the line number to 0, variable name to the empty string, and the expression pointer to nullptr.
+//          Default constructor, initialize the line number and slot to 0, variable name to the empty string, and the expression pointer to nullptr.
             reassignOp();
 
-//          Initialize the line number, variable name, and expression pointer respectively.
+//          Initialize the line number, variable name, and expression pointer respectively, and the slot to 0.
             explicit reassignOp(const std::uint32_t line_number, const std::string& var, std::shared_ptr<valueData> expr);
 
 //          Move constructor
@@ -546,11 +602,13 @@ namespace CodeTree {
         public:
 //          Variable name
             std::string variable;
+//          Slot of the variable's value at runtime, given by semantic analysis
+            std::uint32_t slot;
 
-//          Default constructor, initialize the line number to 0 and variable to the empty string.
+//          Default constructor, initialize the line number and slot to 0 and variable to the empty string.
             varContainer();
 
-//          Initialize the line number and variable.
+//          Initialize the line number and variable, and the slot to 0.
             explicit varContainer(const std::uint32_t line_number, const std::string& var);
 
 //          Move constructor
@@ -680,6 +738,52 @@ namespace CodeTree {
             std::string disp() const noexcept override;
     };
 
+
+                    /*              NODE ALLOCATION             */
+
+//  Number of node types.
+    constexpr std::size_t node_type_count = static_cast<std::size_t>(nodeType::BoolContainer) + 1;
+
+//  Memory resource that the current thread allocates AST nodes of each type from, nullptr for the default allocation.
+//  Resources are pluggable, e.g. to account for the memory of each type of node or to pool nodes, and must outlive
+//  the nodes allocated from them.
+    inline thread_local std::array<std::pmr::memory_resource*, node_type_count> node_resources{};
+
+//  Node type of each concrete node class.
+    template <typename T> struct nodeTypeOf;
+    template <> struct nodeTypeOf<codeScope> { static constexpr nodeType type = nodeType::CodeScope; };
+    template <> struct nodeTypeOf<ifBlock> { static constexpr nodeType type = nodeType::IfBlock; };
+    template <> struct nodeTypeOf<assignOp> { static constexpr nodeType type = nodeType::AssignOp; };
+    template <> struct nodeTypeOf<reassignOp> { static constexpr nodeType type = nodeType::ReassignOp; };
+    template <> struct nodeTypeOf<unaryOp> { static constexpr nodeType type = nodeType::UnaryOp; };
+    template <> struct nodeTypeOf<binaryOp> { static constexpr nodeType type = nodeType::BinaryOp; };
+    template <> struct nodeTypeOf<ternaryOp> { static constexpr nodeType type = nodeType::TernaryOp; };
+    template <> struct nodeTypeOf<varContainer> { static constexpr nodeType type = nodeType::VarContainer; };
+    template <> struct nodeTypeOf<int32Container> { static constexpr nodeType type = nodeType::Int32Container; };
+    template <> struct nodeTypeOf<int64Container> { static constexpr nodeType type = nodeType::Int64Container; };
+    template <> struct nodeTypeOf<float32Container> { static constexpr nodeType type = nodeType::Float32Container; };
+    template <> struct nodeTypeOf<float64Container> { static constexpr nodeType type = nodeType::Float64Container; };
+    template <> struct nodeTypeOf<boolContainer> { static constexpr nodeType type = nodeType::BoolContainer; };
+
+/*
+    Allocate an AST node from the current thread's resource for its type, as std::make_shared does by default.
+    This function depends on a typename template for the node class.
+
+    Parameters:
+        arguments: arguments of the node's constructor (input)
+
+    Return a shared pointer to the node.
+*/
+    template <typename T, typename... Args>
+    inline std::shared_ptr<T> make_node(Args&&... arguments) {
+        std::pmr::memory_resource* const resource = node_resources[static_cast<std::size_t>(nodeTypeOf<T>::type)];
+
+        if (resource == nullptr) {
+            return std::make_shared<T>(std::forward<Args>(arguments)...);
+        }
+        return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource), std::forward<Args>(arguments)...);
+    }
+
 }
 
 
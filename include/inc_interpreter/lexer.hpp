@@ -11,6 +11,7 @@ The lex_string function declaration and lexing-related constants.
 
 #include "inc_interpreter/interp_utils.hpp"
 #include "inc_internal/error_handling.hpp"
+#include "inc_internal/metrics.hpp"
 
 
 // Width of current environment tab character in spaces, for checking indent amounts.
@@ -0,0 +1,68 @@
+/*
+
+Structures and function declarations for optimization passes that run over an already analyzed AST.
+
+*/
+
+#ifndef OPTIMIZATION_HPP
+#define OPTIMIZATION_HPP
+
+#include <set>
+
+#include "inc_interpreter/semantic_analysis.hpp"
+
+
+// Structures describing the results of post-analysis optimization.
+namespace Optimization {
+
+//  A variable store removed by dead-store elimination.
+    struct deadStore {
+//      the variable that was stored to
+        std::string variable;
+//      line number of the removed assignment
+        std::uint32_t line_number;
+//      true if the stored value is overwritten on every path before it could be read,
+//      false if the value is simply never read
+        bool overwritten;
+    };
+
+}
+
+/*
+Determine whether evaluating the given expression at runtime could raise an error.
+Numerical operators left in an analyzed AST were not folded, so they could still overflow or divide by 0.
+
+Parameters:
+    value_data: expression to check (input)
+
+Return true if the expression contains a numerical operator.
+*/
+const bool expression_may_raise(const CodeTree::valueData* const value_data) noexcept;
+
+/*
+Remove dead stores from an analyzed AST. A store is dead when the variable is not read before it is overwritten
+or before its scope ends. Variables in the given global environment are the observable result of a program, so their
+final stores are always kept. Assignments whose expressions could raise an error at runtime (e.g. an unfolded division)
+are kept even when dead so that eliminating them never hides an error.
+'if' blocks left with no code are removed, and variables whose stores were all removed are erased from the
+inner scopes of the given environment.
+
+After analysis an explicit assignment is just a store, so a dead explicit assignment is removed
+even if later reassignments of the same variable are kept.
+An operation list or block that has every operation removed is replaced with an empty code scope,
+i.e. a code scope whose current operation and remainder are both nullptr.
+
+This function assumes that the given AST was analyzed with the given environment, so every variable
+referenced in the AST was declared.
+
+Parameters:
+    data_node: shared pointer to the root of the analyzed AST (input/output)
+    global_env: environment the AST was analyzed in (input/output)
+    report: optional collection to append a record of each removed store to, in program order (output)
+
+Return the number of removed stores.
+*/
+const std::uint32_t eliminate_dead_stores(std::shared_ptr<CodeTree::dataNode>& data_node, std::shared_ptr<DataStorage::environment>& global_env,
+                                          std::vector<Optimization::deadStore>* const report = nullptr);
+
+#endif
@@ -9,6 +9,7 @@ Structures and function declarations for pre-runtime code optimization and typec
 
 #include <list>
 #include <map>
+#include <set>
 #include <vector>
 #include <algorithm>
 #include <type_traits>
@@ -17,6 +18,10 @@ Structures and function declarations for pre-runtime code optimization and typec
 // interp_utils.hpp is included in both of the following includes.
 #include "inc_internal/error_handling.hpp"
 #include "inc_internal/display_utils.hpp"
+#include "inc_internal/checked_arithmetic.hpp"
+#include "inc_internal/metrics.hpp"
+#include "inc_interpreter/type_rules.hpp"
+#include "inc_interpreter/constant_pool.hpp"
 
 
 // Structures involving interpreted data storage.
@@ -30,6 +35,8 @@ namespace DataStorage {
         std::shared_ptr<CodeTree::valueData> value;
 //      true if the value has been optimized pre-runtime
         bool optimize_value;
+//      slot of the variable's value at runtime, unique to its declaration in a compilation
+        std::uint32_t slot;
     };
 
 //  Structure to store variables in distinct scopes.
@@ -37,29 +44,62 @@ namespace DataStorage {
         public:
 //          collection of variables mapped to their values in the current scope
             std::map<std::string, variableInfo> locals;
+//          values of outer variables reassigned in the current scope while it is conditional,
+//          kept apart until the paths through an 'if' block are merged
+            std::map<std::string, variableInfo> shadows;
+//          collection of variables declared with values only known at runtime, mapped to their declared types
+            std::map<std::string, TypingUtils::dataType> inputs;
 //          collection of sibling scopes below the current scope
             std::vector<std::shared_ptr<environment>> inner_scopes;
 //          reference to the parent scope
             std::shared_ptr<environment> parent_scope;
-
-//          Default constructor, initialize the locals to an empty map, the inner scopes to an empty vector, and the parent scope to nullptr.
-            inline environment() noexcept
+//          true if code in the current scope runs on only some paths, i.e. it is under an 'if' or 'else'
+//          that is not known pre-runtime, or it never runs
+            bool conditional;
+//          pool of the constants produced during analysis, shared by every scope of a compilation
+            std::shared_ptr<constantPool> constants;
+//          number of runtime slots given to declared variables, counted in the outermost scope of a compilation
+            std::uint32_t slot_count;
+
+//          Default constructor, initialize the locals, shadows, and inputs to empty maps, the inner scopes to an empty vector,
+//          the parent scope to nullptr, the scope to unconditional, the constants to a new pool, and the slot count to 0.
+            inline environment()
                 : locals({}), 
+                  shadows({}),
+                  inputs({}),
                   inner_scopes(), 
-                  parent_scope(nullptr) {}
-
-//          Initialize the locals to an empty map, the inner scopes to an empty vector, and the parent scope to its given value.
-            inline explicit environment(std::shared_ptr<environment> parent)
+                  parent_scope(nullptr),
+                  conditional(false),
+                  constants(std::make_shared<constantPool>()),
+                  slot_count(0) {
+                Metrics::counters.environments++;
+            }
+
+//          Initialize the locals, shadows, and inputs to empty maps, the inner scopes to an empty vector, 
+//          the parent scope and conditional status to their given values, the constants to the parent's pool, and the slot count to 0.
+            inline explicit environment(std::shared_ptr<environment> parent, const bool is_conditional = false)
                 : locals({}), 
+                  shadows({}),
+                  inputs({}),
                   inner_scopes(), 
-                  parent_scope(parent) {}
+                  parent_scope(parent),
+                  conditional(is_conditional),
+                  constants(parent->constants),
+                  slot_count(0) {
+                Metrics::counters.environments++;
+            }
     };
 
 }
 
 /*
 Optimize and typecheck on a given AST. Typecheck all of its operations and optimize any constant operations including simple variable assignments.
-Update the given data node with the optimized tree structure and update the given environment object with variable updates/assignments if the given boolean is true.
+Update the given data node with the optimized tree structure and update the given environment object with variable updates/assignments.
+
+When an 'if' condition is not known pre-runtime, both blocks are analyzed with the variables they reassign kept
+in their own scopes, then the value of each reassigned variable is merged where the blocks meet. A variable
+that holds the same constant after either block remains constant, otherwise its value is only known at runtime
+and its type is the runtime merged type of both values.
 
 This function assumes that the given data node is a child class member and not an actual instance of the data node class.
 This function also assumes that any data node object's type variable accurately represents the child class member that object is.
@@ -74,13 +114,11 @@ Throw a fatal error if an operator, data type, or data node class is not recogni
 Parameters:
     data_node: shared pointer to the root of the given AST (input/output)
     scope_env: environment object referencing the current scope in recursive execution (input/output)
-    update_env: true if the current recursive execution should update the given environment
-                false if the current recursive execution is just to typecheck (input)
 
 Return true if the given data node was completely optimized down to a single node, 
 i.e. the entire program was executable before runtime.
 */
-const bool analyze_data_node(std::shared_ptr<CodeTree::dataNode>& data_node, std::shared_ptr<DataStorage::environment>& scope_env, const bool update_env);
+const bool analyze_data_node(std::shared_ptr<CodeTree::dataNode>& data_node, std::shared_ptr<DataStorage::environment>& scope_env);
 
 /*
 Optimize and typecheck on a given expressional AST. Typecheck all of its operations and optimize any constant aoperations.
@@ -106,4 +144,17 @@ Return a pair containing
 */
 std::pair<bool, TypingUtils::dataType> analyze_value_data(std::shared_ptr<CodeTree::valueData>& value_data, std::shared_ptr<DataStorage::environment>& scope_env);
 
+/*
+Declare a variable whose value is only known at runtime (e.g. a program input) in the given environment.
+Analysis treats the variable like any other variable that could not be optimized.
+
+Throw an exception if the variable is already declared in the given environment.
+
+Parameters:
+    scope_env: environment to declare the variable in (input/output)
+    variable: name of the variable (input)
+    type: type of the variable's runtime value (input)
+*/
+void declare_runtime_variable(std::shared_ptr<DataStorage::environment>& scope_env, const std::string& variable, const TypingUtils::dataType type);
+
 #endif
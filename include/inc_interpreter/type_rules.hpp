@@ -0,0 +1,165 @@
+/*
+
+Compile-time tables of the type rules for binary operators.
+The rules follow NumberConversions.txt: numbers combine implicitly, arithmetic on two integers gives an integer,
+arithmetic with any float gives a float, and division and exponentiation always give a float.
+
+*/
+
+#ifndef TYPE_RULES_HPP
+#define TYPE_RULES_HPP
+
+#include "inc_interpreter/interp_utils.hpp"
+
+
+// Type rules of operators, indexed by operator and operand types.
+namespace TypeRules {
+
+//  Number of data types, the data types index the rule tables.
+    constexpr std::size_t type_count = static_cast<std::size_t>(TypingUtils::dataType::BoolT) + 1;
+
+//  Binary operators. Keyword operators (e.g. 'and') share the rules of their symbols.
+    enum class binaryOperator : std::uint8_t {
+        Add, Sub, Mult, Div, Exp, And, Or, Xor, Greater, Less, Equal, GrEqual, LessEqual
+    };
+    constexpr std::size_t binary_operator_count = static_cast<std::size_t>(binaryOperator::LessEqual) + 1;
+
+//  Kinds of binary operators that share type rules.
+    enum class operatorKind : std::uint8_t {
+//      numbers to a number, integers stay integers
+        Arithmetic,
+//      numbers to a float
+        FloatArithmetic,
+//      booleans to a boolean
+        Logical,
+//      numbers to a boolean
+        Ordering,
+//      combinable types to a boolean
+        Equality
+    };
+
+//  Result of applying a binary operator to two types.
+    struct typeRule {
+//      true if the operator accepts the types
+        bool valid;
+//      type of the result when computed at runtime
+        TypingUtils::dataType result;
+    };
+
+//  Binary operator of each binary operator token, in the order of the tokens from Plus to LessEqual.
+    constexpr std::array<binaryOperator, 17> token_operators = {
+        binaryOperator::Add, binaryOperator::Sub, binaryOperator::Mult, binaryOperator::Div, binaryOperator::Exp,
+        binaryOperator::And, binaryOperator::And, binaryOperator::Or, binaryOperator::Or, binaryOperator::Xor, binaryOperator::Xor,
+        binaryOperator::Greater, binaryOperator::Less, binaryOperator::Equal, binaryOperator::Equal, binaryOperator::GrEqual, binaryOperator::LessEqual
+    };
+
+//  Determine if the given token is a binary operator.
+    constexpr bool binary_token(const TokenDef::tokenKey token) noexcept {
+        return (token >= TokenDef::tokenKey::Plus) && (token <= TokenDef::tokenKey::LessEqual);
+    }
+
+//  Retrieve the binary operator of the given token, which must be a binary operator token.
+    constexpr binaryOperator binary_operator(const TokenDef::tokenKey token) noexcept {
+        return token_operators[static_cast<std::size_t>(token) - static_cast<std::size_t>(TokenDef::tokenKey::Plus)];
+    }
+
+//  Retrieve the kind of the given binary operator.
+    constexpr operatorKind operator_kind(const binaryOperator op) noexcept {
+        switch (op) {
+            case binaryOperator::Add:
+            case binaryOperator::Sub:
+            case binaryOperator::Mult:
+                return operatorKind::Arithmetic;
+            case binaryOperator::Div:
+            case binaryOperator::Exp:
+                return operatorKind::FloatArithmetic;
+            case binaryOperator::And:
+            case binaryOperator::Or:
+            case binaryOperator::Xor:
+                return operatorKind::Logical;
+            case binaryOperator::Equal:
+                return operatorKind::Equality;
+            default:
+                return operatorKind::Ordering;
+        }
+    }
+
+//  Determine if the given type is a number type.
+    constexpr bool number_type(const TypingUtils::dataType type) noexcept {
+        return type != TypingUtils::dataType::BoolT;
+    }
+
+//  Compute the rule for a binary operator and two types, used to generate the rule table.
+    constexpr typeRule compute_binary_rule(const binaryOperator op, const TypingUtils::dataType type1, const TypingUtils::dataType type2) noexcept {
+        const bool numbers = number_type(type1) && number_type(type2);
+
+        switch (operator_kind(op)) {
+            case operatorKind::Arithmetic:
+                return typeRule{numbers, TypingUtils::runtime_arithmetic_type(type1, type2)};
+            case operatorKind::FloatArithmetic:
+                return typeRule{numbers, TypingUtils::dataType::Float64T};
+            case operatorKind::Logical:
+                return typeRule{(type1 == TypingUtils::dataType::BoolT) && (type2 == TypingUtils::dataType::BoolT), TypingUtils::dataType::BoolT};
+            case operatorKind::Ordering:
+                return typeRule{numbers, TypingUtils::dataType::BoolT};
+            default:
+                return typeRule{numbers || (type1 == type2), TypingUtils::dataType::BoolT};
+        }
+    }
+
+//  Table of type rules indexed by [operator][type1][type2].
+    using binaryRuleTable = std::array<std::array<std::array<typeRule, type_count>, type_count>, binary_operator_count>;
+
+//  Generate the table of type rules at compile time.
+    constexpr binaryRuleTable generate_binary_rules() noexcept {
+        binaryRuleTable table{};
+
+        for (std::size_t op = 0; op < binary_operator_count; op++) {
+            for (std::size_t type1 = 0; type1 < type_count; type1++) {
+                for (std::size_t type2 = 0; type2 < type_count; type2++) {
+                    table[op][type1][type2] = compute_binary_rule(static_cast<binaryOperator>(op), static_cast<TypingUtils::dataType>(type1),
+                                                                  static_cast<TypingUtils::dataType>(type2));
+                }
+            }
+        }
+
+        return table;
+    }
+
+    constexpr binaryRuleTable binary_rules = generate_binary_rules();
+
+//  Retrieve the rule for a binary operator and two types.
+    constexpr const typeRule& binary_rule(const binaryOperator op, const TypingUtils::dataType type1, const TypingUtils::dataType type2) noexcept {
+        return binary_rules[static_cast<std::size_t>(op)][static_cast<std::size_t>(type1)][static_cast<std::size_t>(type2)];
+    }
+
+//  Determine if the given types combine implicitly, e.g. in a reassignment or the values of a ternary 'if'.
+    constexpr bool combinable_types(const TypingUtils::dataType type1, const TypingUtils::dataType type2) noexcept {
+        return binary_rule(binaryOperator::Equal, type1, type2).valid;
+    }
+
+
+//  Checks of the rules in NumberConversions.txt.
+    static_assert(binary_operator(TokenDef::tokenKey::LessEqual) == binaryOperator::LessEqual, "token operators are out of order");
+    static_assert(binary_operator(TokenDef::tokenKey::OrW) == binaryOperator::Or, "token operators are out of order");
+    static_assert(binary_rule(binaryOperator::Add, TypingUtils::dataType::Int32T, TypingUtils::dataType::Int32T).result == TypingUtils::dataType::Int64T,
+                  "integer arithmetic gives a 64-bit integer at runtime");
+    static_assert(binary_rule(binaryOperator::Mult, TypingUtils::dataType::Int64T, TypingUtils::dataType::Float32T).result == TypingUtils::dataType::Float64T,
+                  "arithmetic with a float gives a 64-bit float at runtime");
+    static_assert(binary_rule(binaryOperator::Div, TypingUtils::dataType::Int32T, TypingUtils::dataType::Int32T).result == TypingUtils::dataType::Float64T,
+                  "division always gives a float");
+    static_assert(binary_rule(binaryOperator::Exp, TypingUtils::dataType::Int64T, TypingUtils::dataType::Int32T).result == TypingUtils::dataType::Float64T,
+                  "exponentiation always gives a float");
+    static_assert(!binary_rule(binaryOperator::Sub, TypingUtils::dataType::BoolT, TypingUtils::dataType::Int32T).valid,
+                  "booleans are not numbers");
+    static_assert(!binary_rule(binaryOperator::And, TypingUtils::dataType::Int32T, TypingUtils::dataType::Int32T).valid,
+                  "logical operators take booleans");
+    static_assert(binary_rule(binaryOperator::Less, TypingUtils::dataType::Float32T, TypingUtils::dataType::Int64T).result == TypingUtils::dataType::BoolT,
+                  "comparisons give a boolean");
+    static_assert(combinable_types(TypingUtils::dataType::BoolT, TypingUtils::dataType::BoolT) &&
+                  !combinable_types(TypingUtils::dataType::BoolT, TypingUtils::dataType::Float64T),
+                  "only matching types and numbers combine");
+
+}
+
+#endif
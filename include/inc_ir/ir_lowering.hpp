@@ -0,0 +1,35 @@
+/*
+
+Function declarations for lowering an analyzed AST into the SSA intermediate representation.
+
+*/
+
+#ifndef IR_LOWERING_HPP
+#define IR_LOWERING_HPP
+
+#include "inc_ir/ssa.hpp"
+#include "inc_interpreter/semantic_analysis.hpp"
+
+
+/*
+Lower an analyzed AST into an SSA function.
+'if' blocks become branches to separate basic blocks, and variables reassigned in either block are merged
+with phi instructions where the blocks meet. Values carry the type they have at runtime: numbers of different types
+are converted explicitly, and arithmetic that was not folded during analysis produces 64-bit results.
+Ternary operators and 'and'/'or' operators whose later operands could raise an error are lowered to branches,
+so those operands are only evaluated when they decide the result.
+
+Variables read in the AST before being assigned are runtime variables, lowered to input instructions with the type
+they were declared with in the given environment. The final value of every variable in the given environment is an
+output of the function.
+Throw a FatalError if the AST contains an unrecognized node or reads a variable that is neither assigned nor a runtime variable.
+
+Parameters:
+    data_node: root of the analyzed AST (input)
+    global_env: environment the AST was analyzed in (input)
+
+Return the lowered function.
+*/
+IR::function lower_to_ir(const std::shared_ptr<CodeTree::dataNode>& data_node, const std::shared_ptr<DataStorage::environment>& global_env);
+
+#endif
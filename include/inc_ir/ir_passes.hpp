@@ -0,0 +1,49 @@
+/*
+
+Function declarations for optimization passes over the SSA intermediate representation.
+Every pass returns true if it changed the function, so passes can be repeated until none applies.
+
+*/
+
+#ifndef IR_PASSES_HPP
+#define IR_PASSES_HPP
+
+#include "inc_ir/ssa.hpp"
+#include "inc_internal/checked_arithmetic.hpp"
+
+
+/*
+Fold instructions whose operands are all constants, and simplify phi and select instructions that always produce
+the same value. Branches on constant conditions become jumps, and blocks that can no longer be reached are removed.
+Instructions are only folded when computing them cannot raise an error, so runtime errors are never hidden.
+
+Parameters:
+    ir_function: function to optimize (input/output)
+
+Return true if the function changed.
+*/
+const bool propagate_constants(IR::function& ir_function);
+
+/*
+Global value numbering: replace an instruction with an identical instruction that dominates it,
+i.e. one with the same opcode, type, and operands (in either order for commutative operators).
+
+Parameters:
+    ir_function: function to optimize (input/output)
+
+Return true if the function changed.
+*/
+const bool number_values(IR::function& ir_function);
+
+/*
+Remove instructions whose values do not reach an output or a branch condition.
+Instructions that may raise an error are kept.
+
+Parameters:
+    ir_function: function to optimize (input/output)
+
+Return true if the function changed.
+*/
+const bool eliminate_dead_code(IR::function& ir_function);
+
+#endif
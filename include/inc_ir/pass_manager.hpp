@@ -0,0 +1,64 @@
+/*
+
+Structures for scheduling optimization passes over the SSA intermediate representation.
+
+*/
+
+#ifndef PASS_MANAGER_HPP
+#define PASS_MANAGER_HPP
+
+#include <functional>
+
+#include "inc_ir/ssa.hpp"
+
+
+// Structures for the SSA intermediate representation.
+namespace IR {
+
+//  Statistics for a single scheduled pass.
+    struct passRecord {
+//      name of the pass
+        std::string name;
+//      number of times the pass ran
+        std::uint32_t runs;
+//      number of runs that changed the function
+        std::uint32_t changes;
+    };
+
+//  Ordered collection of passes, run in rounds until the function stops changing.
+    class passManager {
+        private:
+//          each pass, returning true if it changed the function
+            std::vector<std::function<const bool(function&)>> passes;
+
+        public:
+//          statistics for each pass, in scheduling order
+            std::vector<passRecord> records;
+
+//          Schedule a pass after every pass already added.
+            void add_pass(const std::string& name, std::function<const bool(function&)> pass);
+
+/*
+            Run every pass in order, repeating rounds until a round changes nothing or the round limit is reached.
+            In debug builds, the function is verified after every pass that changed it.
+
+            Parameters:
+                ir_function: function to optimize (input/output)
+                max_rounds: maximum number of rounds (input)
+
+            Return the number of rounds run.
+*/
+            const std::uint32_t run(function& ir_function, const std::uint32_t max_rounds = 4);
+    };
+
+}
+
+/*
+Create a pass manager with the standard optimization pipeline:
+constant propagation, global value numbering, type narrowing, and dead code elimination.
+
+Return the pass manager.
+*/
+IR::passManager standard_pipeline();
+
+#endif
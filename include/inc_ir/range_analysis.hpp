@@ -0,0 +1,43 @@
+/*
+
+Structures and function declarations for value-range analysis over the SSA intermediate representation.
+
+*/
+
+#ifndef RANGE_ANALYSIS_HPP
+#define RANGE_ANALYSIS_HPP
+
+#include "inc_ir/ssa.hpp"
+
+
+// Structures for the SSA intermediate representation.
+namespace IR {
+
+//  Closed interval containing every value an instruction can produce at runtime.
+    struct valueRange {
+//      smallest possible value, negative infinity if unbounded
+        double low;
+//      largest possible value, infinity if unbounded
+        double high;
+//      true if every possible value is a whole number
+        bool integral;
+    };
+
+}
+
+/*
+Compute the range of every value from constants, input types, and the conditions of the branches that
+dominate it (e.g. under 'if x > 0', x is at least 1). Then give each 64-bit value the 32-bit type when its range
+proves the 32-bit type holds it exactly: integers within the 32-bit limits, and whole-number floats within the
+accurate 32-bit float limits. Operands are converted where their new types no longer match, and conversions
+created here never lose a value. Inputs keep their declared types, and values that are not whole numbers
+(e.g. division results) keep their 64-bit float type.
+
+Parameters:
+    ir_function: function to optimize (input/output)
+
+Return true if the function changed.
+*/
+const bool narrow_types(IR::function& ir_function);
+
+#endif
@@ -0,0 +1,194 @@
+/*
+
+Structures and function declarations for the static single assignment (SSA) intermediate representation.
+Every value in the IR is defined by exactly one instruction and carries its data type.
+Control flow is a graph of basic blocks, and values of a variable assigned in different blocks
+are merged by phi instructions where those blocks meet.
+
+*/
+
+#ifndef SSA_HPP
+#define SSA_HPP
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include "inc_interpreter/interp_utils.hpp"
+
+
+// Structures for the SSA intermediate representation.
+namespace IR {
+
+//  Values and blocks are referred to by their index in a function.
+    using valueId = std::uint32_t;
+    using blockId = std::uint32_t;
+
+//  Placeholder for a missing value or block.
+    constexpr valueId NO_VALUE = std::numeric_limits<valueId>::max();
+    constexpr blockId NO_BLOCK = std::numeric_limits<blockId>::max();
+
+//  All possible instructions.
+    enum class opcode {
+//      Values
+        Const, Input, Phi,
+
+//      Conversion of a number to the instruction's type, only narrowing where the number is known to fit
+        Convert,
+
+//      Unary operators
+        Not,
+
+//      Binary operators
+        Add, Sub, Mul, Div, Exp, And, Or, Xor, Eq, Gt, Lt, Ge, Le,
+
+//      Choose between two values (condition, true value, false value) without branching
+        Select,
+
+//      Instruction removed by an optimization pass
+        Nop
+    };
+
+//  Value of a constant instruction, the field used depends on the instruction's type.
+    struct constantValue {
+//      value of an integer or boolean constant
+        std::int64_t int_value;
+//      value of a float constant, 32-bit floats are stored exactly as 64-bit floats
+        double float_value;
+    };
+
+//  A single instruction, which defines one value.
+    struct instruction {
+//      the operation performed
+        opcode op;
+//      the type of the defined value
+        TypingUtils::dataType type;
+//      values the operation reads, phi operands are ordered like the predecessors of their block
+        std::vector<valueId> operands;
+//      value of a constant instruction
+        constantValue constant;
+//      name of the variable read by an input instruction
+        std::string variable;
+//      block containing the instruction
+        blockId block;
+//      source line the instruction was lowered from
+        std::uint32_t line_number;
+    };
+
+//  Ways a basic block can end.
+    enum class terminatorType {
+        Jump, Branch, Return
+    };
+
+//  A sequence of instructions with a single entry and a single exit.
+    struct basicBlock {
+//      instructions in execution order, phi instructions come first
+        std::vector<valueId> instructions;
+//      blocks that end by transferring control to this block
+        std::vector<blockId> predecessors;
+//      how the block ends
+        terminatorType terminator;
+//      boolean value deciding a branch
+        valueId condition;
+//      target of a jump, or of a branch whose condition is true
+        blockId true_target;
+//      target of a branch whose condition is false
+        blockId false_target;
+//      false once the block can no longer be reached from the entry block
+        bool reachable;
+    };
+
+//  A whole program in SSA form. Block 0 is the entry, and the program ends at its only return block.
+    class function {
+        public:
+//          every instruction, indexed by the value it defines
+            std::vector<instruction> values;
+//          every basic block, indexed by block ID
+            std::vector<basicBlock> blocks;
+//          the final value of each global variable, which is the observable result of the program
+            std::map<std::string, valueId> outputs;
+
+//          Append a new block that returns until its terminator is set, return its ID.
+            blockId add_block();
+
+//          Append the given instruction to the end of the given block (before its terminator), return the defined value.
+            valueId append(const blockId block, instruction&& new_instruction);
+
+//          Retrieve the blocks the given block transfers control to.
+            std::vector<blockId> successors(const blockId block) const;
+
+//          Retrieve the reachable blocks in reverse postorder, so every block comes after its dominators.
+            std::vector<blockId> reverse_postorder() const;
+
+//          Retrieve the immediate dominator of each block, NO_BLOCK for the entry and unreachable blocks.
+            std::vector<blockId> immediate_dominators() const;
+
+//          Remove the control flow edge between the given blocks, including the matching phi operands.
+            void remove_edge(const blockId from, const blockId to);
+
+//          Rewrite every use of a value to its entry in the given replacement table (NO_VALUE keeps the value).
+            void replace_values(std::vector<valueId>& replacements);
+
+//          Remove the given instruction from its block and mark it as a no-op.
+            void remove_instruction(const valueId value);
+    };
+
+}
+
+/*
+Create a constant instruction.
+
+Parameters:
+    type: type of the constant (input)
+    int_value: value of an integer or boolean constant (input)
+    float_value: value of a float constant (input)
+    line_number: line number of the constant (input)
+
+Return the constant instruction.
+*/
+IR::instruction make_constant(const TypingUtils::dataType type, const std::int64_t int_value, const double float_value, const std::uint32_t line_number);
+
+/*
+Determine whether the given instruction could raise an error at runtime.
+Arithmetic can overflow or divide by 0, so instructions that may raise are never removed unless their
+result is known pre-runtime.
+
+Parameters:
+    value: instruction to check (input)
+
+Return true if the instruction may raise an error.
+*/
+const bool may_raise(const IR::instruction& value) noexcept;
+
+/*
+Determine whether the given instruction reads only its operands, so two instructions with the same
+opcode, type, and operands always define the same value.
+
+Parameters:
+    value: instruction to check (input)
+
+Return true if the instruction is pure.
+*/
+const bool pure_instruction(const IR::instruction& value) noexcept;
+
+/*
+Check that the given function is well formed: every operand is defined before it is used,
+phi instructions match the predecessors of their block, and operand types match their instruction.
+Throw a FatalError if the function is malformed.
+
+Parameters:
+    ir_function: function to check (input)
+*/
+void verify_function(const IR::function& ir_function);
+
+/*
+Create a readable listing of the given function.
+
+Parameters:
+    ir_function: function to display (input)
+
+Return the listing.
+*/
+const std::string display_function(const IR::function& ir_function);
+
+#endif
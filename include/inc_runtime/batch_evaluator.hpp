@@ -0,0 +1,139 @@
+/*
+
+Structures and function declarations for evaluating an analyzed AST over many rows of runtime variables at once.
+
+A batch binds each runtime variable to a column: an array holding one value per row, stored contiguously as the C++ type
+of the variable's type (booleans as bytes). Columns are read and written in place, typically in files mapped into memory,
+so rows are never copied into per-row values.
+
+*/
+
+#ifndef BATCH_EVALUATOR_HPP
+#define BATCH_EVALUATOR_HPP
+
+#include "inc_runtime/runtime_value.hpp"
+
+// Column files are mapped into memory where POSIX mmap is available, and read into memory elsewhere.
+#if defined(__unix__) || defined(__APPLE__)
+#define REGAL_MAPPED_COLUMNS
+#endif
+
+
+// Structures for batch evaluation.
+namespace Batch {
+
+//  View of a column of values of one type, one value per row. The column does not own its values.
+    struct column {
+//      the values' type
+        TypingUtils::dataType type;
+//      the values, as an array of the type's C++ type
+        void* data;
+//      number of rows
+        std::size_t rows;
+    };
+
+//  Size in bytes of one value of a column of each type.
+    constexpr std::array<std::size_t, TypingUtils::number_type_count + 1> value_sizes = {4, 8, 4, 8, 1};
+
+//  File extension of a column file of each type, also the name of the type in column arguments.
+    constexpr std::array<std::string_view, TypingUtils::number_type_count + 1> column_extensions = {"i32", "i64", "f32", "f64", "bool"};
+
+//  Column stored in a file, mapped into memory while the column lives.
+//  The memory is unmapped (and a written column is saved) when the column is destroyed, so the column can not be copied.
+    class columnFile {
+        private:
+//          view of the column's values
+            column values;
+//          mapped memory, or memory holding the file's contents where files can not be mapped
+            void* memory;
+//          size of the mapped memory in bytes
+            std::size_t memory_size;
+//          path of the file, saved on destruction if written where files can not be mapped
+            std::string path;
+//          true if the column is written
+            bool writable;
+
+        public:
+//          Initialize the column and take ownership of its memory.
+            inline columnFile(const column& values, void* const memory, const std::size_t memory_size, const std::string& path, const bool writable) noexcept
+                : values(values),
+                  memory(memory),
+                  memory_size(memory_size),
+                  path(path),
+                  writable(writable) {}
+
+//          Unmap the memory, or save and free it.
+            ~columnFile();
+
+            columnFile(const columnFile&) = delete;
+            columnFile& operator=(const columnFile&) = delete;
+
+//          Retrieve the view of the column's values.
+            inline const column& view() const noexcept {
+                return values;
+            }
+    };
+
+}
+
+/*
+Map a column file into memory for reading. The file holds the raw values of its type, with no header.
+
+Throw an IncorrectInputError if the file can not be read or its size is not a whole number of values.
+
+Parameters:
+    path: path of the file (input)
+    type: type of the column's values (input)
+
+Return the mapped column.
+*/
+std::unique_ptr<Batch::columnFile> open_column_file(const std::string& path, const TypingUtils::dataType type);
+
+/*
+Create a column file of the given size and map it into memory for writing.
+
+Throw an IncorrectInputError if the file can not be created.
+
+Parameters:
+    path: path of the file (input)
+    type: type of the column's values (input)
+    rows: number of rows of the column (input)
+
+Return the mapped column.
+*/
+std::unique_ptr<Batch::columnFile> create_column_file(const std::string& path, const TypingUtils::dataType type, const std::size_t rows);
+
+/*
+Execute an analyzed AST once for every row of its runtime variables' columns, writing the final value of every variable
+not known pre-runtime to its output column.
+
+Rows are executed in blocks, one node of the AST at a time for every row of the block, so each operator is one loop over
+the rows that the compiler vectorizes. Types follow the variables exactly as during evaluation. Rows only execute the
+paths they take: each 'if' block, ternary operator and 'and'/'or' operand runs under a mask of the rows it applies to,
+variables are only written for those rows, and only those rows' operations are checked. Where the blocks of an 'if'
+meet, each block's rows of the variables assigned in both blocks are converted to their runtime merged type.
+
+Each row gives the same values as evaluating the AST with that row's values. An error is the error of the first failing
+operation, in the order the AST executes, in the first block of rows with an error, and is the error that evaluating the
+AST with the failing row's values would throw.
+Throw an exception if
+    a runtime variable declared in the given environment has no column, or a column of a different type,
+    the columns or outputs do not all have the same number of rows,
+    an operation overflows, or
+    an operator takes invalid operands (e.g. 2 / 0).
+Throw a FatalError if the AST contains an unrecognized node or reads a variable that is neither assigned nor a runtime variable.
+
+Parameters:
+    data_node: root of the analyzed AST (input)
+    global_env: environment the AST was analyzed in (input)
+    inputs: column of each runtime variable, mapped by name (input)
+    outputs: column of each variable not known pre-runtime, with the type analysis gave it, mapped by name (input)
+    failed_row: the row whose error was thrown, unchanged if no operation failed (output)
+
+Return the number of row operations executed: the number of rows each operator, conversion and assignment ran for.
+*/
+std::uint64_t evaluate_batch(const std::shared_ptr<CodeTree::dataNode>& data_node, const std::shared_ptr<DataStorage::environment>& global_env,
+                             const std::map<std::string, Batch::column>& inputs, const std::map<std::string, Batch::column>& outputs,
+                             std::size_t& failed_row);
+
+#endif
@@ -0,0 +1,219 @@
+/*
+
+Structures and function declarations for register-based bytecode, the compiled form of an analyzed AST.
+
+Every instruction is typed: analysis resolves the type of every value before compilation, so an instruction
+only names the registers it reads and writes, and the virtual machine never checks the type of a register.
+Superinstructions fuse the sequences the compiler would otherwise emit most often: adding a small constant,
+comparing and branching on the result, and choosing between two registers for a ternary operator.
+Compiled programs can be serialized to bytes and read back, so they can be cached between runs.
+
+*/
+
+#ifndef BYTECODE_HPP
+#define BYTECODE_HPP
+
+#include <string_view>
+
+#include "inc_runtime/runtime_value.hpp"
+
+
+// Structures for register-based bytecode.
+namespace Bytecode {
+
+//  Operation codes of bytecode instructions, named by operation and operand type.
+//  Runtime arithmetic gives a 64-bit integer or float (see type_rules.hpp), unless range analysis narrowed it to 32 bits
+//  because its operands and every possible result fit (see range_analysis.hpp). Comparisons are ordered as their binary
+//  operators, one group per number type.
+    enum class opcode : std::uint8_t {
+//      copy a register
+        Move,
+//      convert a register to a wider type
+        ConvI32I64, ConvI32F64, ConvI64F64, ConvF32F64,
+//      convert a register to a 32-bit type, which holds the value exactly since its range fits that type
+        ConvI64I32, ConvI32F32, ConvI64F32, ConvF64F32,
+//      checked arithmetic
+        AddI64, SubI64, MulI64, AddF64, SubF64, MulF64, DivF64, ExpF64,
+//      checked arithmetic narrowed to 32 bits
+        AddI32, SubI32, MulI32, AddF32, SubF32, MulF32,
+//      number comparisons
+        GreaterI32, LessI32, EqualI32, GrEqualI32, LessEqualI32,
+        GreaterI64, LessI64, EqualI64, GrEqualI64, LessEqualI64,
+        GreaterF32, LessF32, EqualF32, GrEqualF32, LessEqualF32,
+        GreaterF64, LessF64, EqualF64, GrEqualF64, LessEqualF64,
+//      boolean operations
+        EqualBool, XorBool, Not,
+//      control flow
+        Jump, JumpIfFalse, JumpIfTrue, Halt,
+//      superinstructions: checked arithmetic with a 32-bit immediate second operand
+        AddImmI64, SubImmI64,
+//      superinstructions: comparisons that jump when they are false, one group per number type as the comparisons
+        JumpUnlessGreaterI32, JumpUnlessLessI32, JumpUnlessEqualI32, JumpUnlessGrEqualI32, JumpUnlessLessEqualI32,
+        JumpUnlessGreaterI64, JumpUnlessLessI64, JumpUnlessEqualI64, JumpUnlessGrEqualI64, JumpUnlessLessEqualI64,
+        JumpUnlessGreaterF32, JumpUnlessLessF32, JumpUnlessEqualF32, JumpUnlessGrEqualF32, JumpUnlessLessEqualF32,
+        JumpUnlessGreaterF64, JumpUnlessLessF64, JumpUnlessEqualF64, JumpUnlessGrEqualF64, JumpUnlessLessEqualF64,
+//      superinstruction: the destination holds a condition and is replaced by the first source if it is true, otherwise the second
+        Select
+    };
+    constexpr std::size_t opcode_count = static_cast<std::size_t>(opcode::Select) + 1;
+
+//  Kinds of instruction operands.
+    enum class operandKind : std::uint8_t {
+//      operand is unused
+        None,
+//      index of a register
+        Register,
+//      index of an instruction to jump to
+        Target,
+//      32-bit signed integer stored in the operand
+        Immediate
+    };
+
+//  Description of an operation code: its display name and the kinds of its operands.
+    struct opcodeInfo {
+        std::string_view name;
+        operandKind dst;
+        operandKind src1;
+        operandKind src2;
+    };
+
+//  Description of each operation code, in the order of the operation codes.
+    constexpr std::array<opcodeInfo, opcode_count> opcode_infos = [] {
+        constexpr operandKind none = operandKind::None, reg = operandKind::Register, target = operandKind::Target, imm = operandKind::Immediate;
+        return std::array<opcodeInfo, opcode_count>{{
+            {"MOVE", reg, reg, none},
+            {"CONV_I32_I64", reg, reg, none}, {"CONV_I32_F64", reg, reg, none}, {"CONV_I64_F64", reg, reg, none}, {"CONV_F32_F64", reg, reg, none},
+            {"CONV_I64_I32", reg, reg, none}, {"CONV_I32_F32", reg, reg, none}, {"CONV_I64_F32", reg, reg, none}, {"CONV_F64_F32", reg, reg, none},
+            {"ADD_I64", reg, reg, reg}, {"SUB_I64", reg, reg, reg}, {"MUL_I64", reg, reg, reg},
+            {"ADD_F64", reg, reg, reg}, {"SUB_F64", reg, reg, reg}, {"MUL_F64", reg, reg, reg}, {"DIV_F64", reg, reg, reg}, {"EXP_F64", reg, reg, reg},
+            {"ADD_I32", reg, reg, reg}, {"SUB_I32", reg, reg, reg}, {"MUL_I32", reg, reg, reg},
+            {"ADD_F32", reg, reg, reg}, {"SUB_F32", reg, reg, reg}, {"MUL_F32", reg, reg, reg},
+            {"CMP_GT_I32", reg, reg, reg}, {"CMP_LT_I32", reg, reg, reg}, {"CMP_EQ_I32", reg, reg, reg}, {"CMP_GE_I32", reg, reg, reg}, {"CMP_LE_I32", reg, reg, reg},
+            {"CMP_GT_I64", reg, reg, reg}, {"CMP_LT_I64", reg, reg, reg}, {"CMP_EQ_I64", reg, reg, reg}, {"CMP_GE_I64", reg, reg, reg}, {"CMP_LE_I64", reg, reg, reg},
+            {"CMP_GT_F32", reg, reg, reg}, {"CMP_LT_F32", reg, reg, reg}, {"CMP_EQ_F32", reg, reg, reg}, {"CMP_GE_F32", reg, reg, reg}, {"CMP_LE_F32", reg, reg, reg},
+            {"CMP_GT_F64", reg, reg, reg}, {"CMP_LT_F64", reg, reg, reg}, {"CMP_EQ_F64", reg, reg, reg}, {"CMP_GE_F64", reg, reg, reg}, {"CMP_LE_F64", reg, reg, reg},
+            {"CMP_EQ_BOOL", reg, reg, reg}, {"XOR_BOOL", reg, reg, reg}, {"NOT", reg, reg, none},
+            {"JMP", target, none, none}, {"JMP_IF_FALSE", target, reg, none}, {"JMP_IF_TRUE", target, reg, none}, {"HALT", none, none, none},
+            {"ADD_I64_IMM", reg, reg, imm}, {"SUB_I64_IMM", reg, reg, imm},
+            {"JMP_UNLESS_GT_I32", target, reg, reg}, {"JMP_UNLESS_LT_I32", target, reg, reg}, {"JMP_UNLESS_EQ_I32", target, reg, reg},
+            {"JMP_UNLESS_GE_I32", target, reg, reg}, {"JMP_UNLESS_LE_I32", target, reg, reg},
+            {"JMP_UNLESS_GT_I64", target, reg, reg}, {"JMP_UNLESS_LT_I64", target, reg, reg}, {"JMP_UNLESS_EQ_I64", target, reg, reg},
+            {"JMP_UNLESS_GE_I64", target, reg, reg}, {"JMP_UNLESS_LE_I64", target, reg, reg},
+            {"JMP_UNLESS_GT_F32", target, reg, reg}, {"JMP_UNLESS_LT_F32", target, reg, reg}, {"JMP_UNLESS_EQ_F32", target, reg, reg},
+            {"JMP_UNLESS_GE_F32", target, reg, reg}, {"JMP_UNLESS_LE_F32", target, reg, reg},
+            {"JMP_UNLESS_GT_F64", target, reg, reg}, {"JMP_UNLESS_LT_F64", target, reg, reg}, {"JMP_UNLESS_EQ_F64", target, reg, reg},
+            {"JMP_UNLESS_GE_F64", target, reg, reg}, {"JMP_UNLESS_LE_F64", target, reg, reg},
+            {"SELECT", reg, reg, reg}
+        }};
+    }();
+
+//  Retrieve the description of an operation code.
+    constexpr const opcodeInfo& opcode_info(const opcode op) noexcept {
+        return opcode_infos[static_cast<std::size_t>(op)];
+    }
+
+//  Number of comparison operators, the size of each group of typed comparisons.
+    constexpr std::size_t comparison_count = static_cast<std::size_t>(TypeRules::binaryOperator::LessEqual)
+                                             - static_cast<std::size_t>(TypeRules::binaryOperator::Greater) + 1;
+
+//  Retrieve the operation code of a comparison for the given number type, from the first operation code of the comparison's groups.
+    constexpr opcode comparison_opcode(const opcode first, const TypeRules::binaryOperator op, const TypingUtils::dataType type) noexcept {
+        return static_cast<opcode>(static_cast<std::size_t>(first) + comparison_count * static_cast<std::size_t>(type)
+                                   + static_cast<std::size_t>(op) - static_cast<std::size_t>(TypeRules::binaryOperator::Greater));
+    }
+
+    static_assert(opcode_infos.back().name == "SELECT", "every operation code needs a description");
+    static_assert(comparison_opcode(opcode::GreaterI32, TypeRules::binaryOperator::LessEqual, TypingUtils::dataType::Float64T) == opcode::LessEqualF64,
+                  "typed comparisons are out of order");
+    static_assert(comparison_opcode(opcode::JumpUnlessGreaterI32, TypeRules::binaryOperator::Less, TypingUtils::dataType::Int64T) == opcode::JumpUnlessLessI64,
+                  "typed comparison jumps are out of order");
+
+//  Bytecode instruction. A jump keeps its target in the destination operand and its condition in the first source.
+    struct instruction {
+        opcode op;
+        std::uint32_t dst;
+        std::uint32_t src1;
+        std::uint32_t src2;
+    };
+
+//  Register holding a runtime variable, with the type of its value.
+    struct variableRegister {
+        std::uint32_t index;
+        TypingUtils::dataType type;
+    };
+
+//  Register holding the final value of a variable, with the type of its value and the type analysis gave the variable.
+    struct outputRegister {
+        std::uint32_t index;
+        TypingUtils::dataType register_type;
+        TypingUtils::dataType type;
+    };
+
+//  Compiled program. The constants are loaded into the first registers before execution, the code ends with a halt.
+    struct program {
+//      instructions to execute
+        std::vector<instruction> code;
+//      line number of each instruction, for error messages
+        std::vector<std::uint32_t> line_numbers;
+//      values of the constant registers
+        std::vector<Runtime::typedValue> constants;
+//      number of registers, including the constant registers
+        std::uint32_t register_count = 0;
+//      registers to load the runtime variables into, mapped by name
+        std::map<std::string, variableRegister> inputs;
+//      registers holding the final value of every global variable, mapped by name
+        std::map<std::string, outputRegister> outputs;
+    };
+
+//  Identification and version of serialized bytecode. The version changes whenever the serialized layout or the opcodes change.
+    constexpr std::string_view BYTECODE_MAGIC = "RGLB";
+    constexpr std::uint32_t BYTECODE_VERSION = 3;
+
+}
+
+/*
+Retrieve the bits of a runtime value, which hold exactly the member its type uses, so equal values of a type have equal bits.
+
+Parameters:
+    value: the runtime value (input)
+
+Return the value's bits.
+*/
+std::uint64_t value_bits(const Runtime::typedValue& value) noexcept;
+
+/*
+Serialize a compiled program to bytes. Numbers are stored in little-endian order, so the bytes are the same on every platform.
+
+Parameters:
+    compiled: the program to serialize (input)
+
+Return the serialized bytes.
+*/
+std::string serialize_program(const Bytecode::program& compiled) noexcept;
+
+/*
+Read a compiled program from serialized bytes, checking that every instruction can run safely.
+
+Throw an IncorrectInputError if
+    the bytes are not serialized bytecode of the current version, or are truncated,
+    an instruction has an unknown operation code, or an operand outside the registers or the code, or
+    the code does not end with a halt.
+
+Parameters:
+    bytes: the serialized bytes (input)
+
+Return the read program.
+*/
+Bytecode::program deserialize_program(const std::string& bytes);
+
+/*
+Create a display string for a compiled program, listing its constants and instructions.
+
+Parameters:
+    compiled: the program to display (input)
+
+Return the created display string.
+*/
+const std::string display_program(const Bytecode::program& compiled) noexcept;
+
+#endif
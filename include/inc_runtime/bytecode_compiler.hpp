@@ -0,0 +1,35 @@
+/*
+
+Function declarations for compiling an analyzed AST into register-based bytecode, through the optimized SSA intermediate representation.
+
+*/
+
+#ifndef BYTECODE_COMPILER_HPP
+#define BYTECODE_COMPILER_HPP
+
+#include "inc_runtime/bytecode.hpp"
+
+
+/*
+Compile an analyzed AST into bytecode with the same behaviour as evaluating the AST.
+The AST is lowered to the SSA intermediate representation and optimized by the standard pipeline, so arithmetic that
+range analysis narrowed runs in 32 bits, and each instruction is chosen for the types of its operands.
+Blocks are laid out so the true target of a branch follows it, and phis become moves at the end of their predecessors.
+Every constant has a constant register, every runtime variable a register of its own, and every other value a temporary
+reused once the value is last read. A value only read by a phi is written straight to the phi's register.
+Superinstructions replace the sequences compiled most often when enabled: adding or subtracting a 32-bit integer constant,
+comparing numbers to branch, and choosing between two values for a ternary, 'and' or 'or' operator that does not branch.
+
+Throw a FatalError if the AST contains an unrecognized node or reads a variable that is neither assigned nor a runtime variable.
+
+Parameters:
+    data_node: root of the analyzed AST (input)
+    global_env: environment the AST was analyzed in (input)
+    superinstructions: true to fuse common instruction sequences into superinstructions (input)
+
+Return the compiled program.
+*/
+Bytecode::program compile_program(const std::shared_ptr<CodeTree::dataNode>& data_node, const std::shared_ptr<DataStorage::environment>& global_env,
+                                  const bool superinstructions = true);
+
+#endif
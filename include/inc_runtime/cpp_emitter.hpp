@@ -0,0 +1,41 @@
+/*
+
+Function declarations for transpiling an analyzed AST into a standalone C++ translation unit.
+
+*/
+
+#ifndef CPP_EMITTER_HPP
+#define CPP_EMITTER_HPP
+
+#include "inc_runtime/runtime_value.hpp"
+
+
+/*
+Transpile an analyzed AST into a standalone C++20 translation unit with the same behaviour as evaluating the AST.
+Every variable has one typed local per type it takes at runtime (e.g. 'v_a_i64' for 'a' as a 64-bit integer), since its
+type can change as it is reassigned, and 'if' blocks become native 'if' statements. Types follow the variables exactly as
+during evaluation: where the blocks of an 'if' meet, the variables assigned in both blocks are converted to their runtime
+merged type at the end of each block.
+
+Arithmetic calls checked functions defined in the translation unit, which apply the same overflow rules as analysis and
+throw a std::runtime_error with the interpreter's message on an error. Operands that can fail are computed into
+temporaries in evaluation order, so the first error is the same error the interpreter reports.
+
+The translation unit only depends on the standard library (and the GCC/Clang overflow builtins). It defines
+    regal_inputs: the runtime variables with their declared types,
+    regal_outputs: the final values of the variables not known pre-runtime, with the types analysis gave them,
+    regal_run: the program, from inputs to outputs, and
+    main: read each runtime variable from an argument of the form 'name=value', run the program and output the same
+          display of the variables as the interpreter, or the error message and exit with a failure.
+
+Throw a FatalError if the AST contains an unrecognized node or reads a variable that is neither assigned nor a runtime variable.
+
+Parameters:
+    data_node: root of the analyzed AST (input)
+    global_env: environment the AST was analyzed in (input)
+
+Return the translation unit's source code.
+*/
+std::string emit_cpp(const std::shared_ptr<CodeTree::dataNode>& data_node, const std::shared_ptr<DataStorage::environment>& global_env);
+
+#endif
@@ -0,0 +1,39 @@
+/*
+
+Structures and function declarations for evaluating an analyzed AST at runtime.
+
+*/
+
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include "inc_runtime/runtime_value.hpp"
+
+
+/*
+Execute an analyzed AST by walking its nodes, starting from the given values of its runtime variables.
+Every variable has one slot holding its current value, since analysis never has two variables of the same name in scope
+at once. Values carry the type they have at runtime, exactly as in IR lowering: arithmetic that was not folded produces
+64-bit results, and where the blocks of an 'if' meet, the variables assigned in both blocks are converted to their
+runtime merged type. 'and'/'or' and ternary operators only evaluate the operands that decide their result.
+
+Operators are checked as they are during analysis, so a runtime error has the same message it would have had if the
+operation had been folded.
+Throw an exception if
+    a runtime variable declared in the given environment has no given value, or a value of a type that does not combine with its declared type,
+    an operation overflows, or
+    an operator takes invalid operands (e.g. 2 / 0).
+Throw a FatalError if the AST contains an unrecognized node or reads a variable that is neither assigned nor a runtime variable.
+
+Parameters:
+    data_node: root of the analyzed AST (input)
+    global_env: environment the AST was analyzed in (input)
+    inputs: values of the runtime variables, mapped by name (input)
+
+Return the final value of every variable in the given environment, with the type analysis gave it.
+*/
+std::map<std::string, Runtime::typedValue> evaluate_program(const std::shared_ptr<CodeTree::dataNode>& data_node,
+                                                            const std::shared_ptr<DataStorage::environment>& global_env,
+                                                            const std::map<std::string, Runtime::typedValue>& inputs);
+
+#endif
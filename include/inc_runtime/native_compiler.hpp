@@ -0,0 +1,112 @@
+/*
+
+Structures and function declarations for compiling register-based bytecode into x86-64 machine code.
+
+Every bytecode instruction is translated into a fixed template of machine instructions that reads and writes the same
+registers as the virtual machine, held in memory, so the machine code behaves exactly as the bytecode: arithmetic is
+checked with the hardware flags and the accurate limits, and an error leaves the registers of the failing instruction
+unchanged for the runtime to report it. The machine code is written to memory mapped with mmap, which is made
+executable (and no longer writable) before it runs.
+
+*/
+
+#ifndef NATIVE_COMPILER_HPP
+#define NATIVE_COMPILER_HPP
+
+#include "inc_runtime/bytecode.hpp"
+
+// Machine code is only emitted for x86-64, and only where executable memory can be mapped (Linux).
+// Elsewhere compiling never succeeds, so programs always fall back to another engine.
+#if defined(__x86_64__) && defined(__linux__)
+#define REGAL_NATIVE_CODE
+#endif
+
+
+// Structures for executing native machine code.
+namespace Native {
+
+//  True if machine code can be compiled.
+#ifdef REGAL_NATIVE_CODE
+    constexpr bool native_code = true;
+#else
+    constexpr bool native_code = false;
+#endif
+
+//  Compiled bytecode together with the executable memory holding its machine code.
+//  The memory is unmapped when the program is destroyed, so the program can not be copied.
+    class nativeProgram {
+        private:
+//          the compiled bytecode, whose registers the machine code reads and writes
+            Bytecode::program compiled;
+//          executable memory holding the machine code
+            void* code;
+//          size of the executable memory in bytes
+            std::size_t code_size;
+
+        public:
+//          Initialize the bytecode and take ownership of the executable memory.
+            inline nativeProgram(const Bytecode::program& compiled, void* const code, const std::size_t code_size) noexcept
+                : compiled(compiled),
+                  code(code),
+                  code_size(code_size) {}
+
+//          Unmap the executable memory.
+            ~nativeProgram();
+
+            nativeProgram(const nativeProgram&) = delete;
+            nativeProgram& operator=(const nativeProgram&) = delete;
+
+//          Retrieve the compiled bytecode.
+            inline const Bytecode::program& bytecode() const noexcept {
+                return compiled;
+            }
+
+//          Retrieve the size of the machine code in bytes.
+            inline std::size_t size() const noexcept {
+                return code_size;
+            }
+
+/*
+            Run the machine code on the given registers until it halts or an instruction fails.
+
+            Parameters:
+                registers: the registers, with the constants and runtime variables loaded (input/output)
+
+            Return 0 if the program halted, otherwise the index of the failing instruction plus 1.
+*/
+            std::uint32_t run(Runtime::valueSlot* const registers) const noexcept;
+    };
+
+}
+
+/*
+Compile bytecode into x86-64 machine code.
+Jumps are translated to the machine code of their target instructions, and each instruction that can fail jumps to
+a stub returning its index, placed after the code so the common path falls through.
+
+Parameters:
+    compiled: the bytecode to compile (input)
+
+Return the compiled program, or nullptr if machine code is not supported on this platform or the program does not fit
+the machine code's addressing (more than 2^28 registers), so the caller falls back to another engine.
+*/
+std::unique_ptr<Native::nativeProgram> compile_native(const Bytecode::program& compiled);
+
+/*
+Execute a natively compiled program, starting from the given values of its runtime variables.
+Errors have the same messages as the virtual machine's.
+
+Throw an exception if
+    a runtime variable of the program has no given value, or a value of a type that does not combine with its declared type,
+    an operation overflows, or
+    an operator takes invalid operands (e.g. 2 / 0).
+
+Parameters:
+    native: the program to execute (input)
+    inputs: values of the runtime variables, mapped by name (input)
+
+Return the final value of every global variable of the program, with the type analysis gave it.
+*/
+std::map<std::string, Runtime::typedValue> execute_native(const Native::nativeProgram& native, const std::map<std::string, Runtime::typedValue>& inputs);
+
+#endif
@@ -0,0 +1,134 @@
+/*
+
+Structures and function declarations for values at runtime, shared by every execution engine.
+
+*/
+
+#ifndef RUNTIME_VALUE_HPP
+#define RUNTIME_VALUE_HPP
+
+#include "inc_interpreter/semantic_analysis.hpp"
+#include "inc_stdlib/output_buffer.hpp"
+
+
+// Structures for runtime evaluation.
+namespace Runtime {
+
+//  Unboxed runtime value. The member in use is given by the type of the value, which analysis knows statically.
+    union valueSlot {
+        std::int32_t int32;
+        std::int64_t int64;
+        float float32;
+        double float64;
+        bool boolean;
+    };
+
+//  Runtime value together with its type, stored in a variable slot or produced by an expression without allocating.
+    struct typedValue {
+//      the value's type
+        TypingUtils::dataType type;
+//      the value itself
+        valueSlot value;
+    };
+
+}
+
+/*
+Retrieve the runtime value of an irreducible data container.
+
+Throw a FatalError if the given data is not an irreducible data container.
+
+Parameters:
+    value_data: container to read (input)
+
+Return the container's value.
+*/
+Runtime::typedValue constant_value(const CodeTree::valueData* const value_data);
+
+/*
+Create a display string for a runtime value, matching the display of the irreducible data container holding the same value.
+
+Parameters:
+    value: value to display (input)
+
+Return the created display string.
+*/
+const std::string display_value(const Runtime::typedValue& value) noexcept;
+
+/*
+Append the display string of a runtime value to an output buffer, as display_value creates it, without allocating.
+
+Parameters:
+    output: buffer to append to (output)
+    value: value to display (input)
+
+Return the output buffer.
+*/
+StandardIO::outputBuffer& write_value(StandardIO::outputBuffer& output, const Runtime::typedValue& value);
+
+/*
+Convert a runtime value to the given type. Booleans are never converted, since they do not combine with numbers.
+
+Parameters:
+    value: value to convert (input)
+    type: type to convert to (input)
+
+Return the converted value.
+*/
+Runtime::typedValue convert_value(const Runtime::typedValue& value, const TypingUtils::dataType type) noexcept;
+
+/*
+Box a runtime value, or unbox a boxed value into a runtime value, at the boundary between engines keeping their types
+statically and engines keeping them in each value.
+
+Parameters:
+    value: value to box or unbox (input)
+    wide: arena to hold a 64-bit integer too wide to box directly (input/output)
+
+Return the boxed or unboxed value.
+*/
+ValueBoxing::boxedValue box_value(const Runtime::typedValue& value, ValueBoxing::wideIntegers& wide);
+Runtime::typedValue unbox_value(const ValueBoxing::boxedValue value) noexcept;
+
+/*
+Convert a boxed value to the given type, as convert_value converts runtime values.
+
+Parameters:
+    value: value to convert (input)
+    type: type to convert to (input)
+    wide: arena to hold a 64-bit integer too wide to box directly (input/output)
+
+Return the converted value.
+*/
+ValueBoxing::boxedValue convert_boxed(const ValueBoxing::boxedValue value, const TypingUtils::dataType type, ValueBoxing::wideIntegers& wide);
+
+/*
+Retrieve the given value of a runtime variable, converted to the type it was declared with.
+
+Throw an exception if the variable has no given value, or its value has a type that does not combine with its declared type.
+
+Parameters:
+    inputs: values of the runtime variables, mapped by name (input)
+    variable: name of the runtime variable (input)
+    declared_type: type the variable was declared with (input)
+
+Return the variable's value.
+*/
+Runtime::typedValue input_value(const std::map<std::string, Runtime::typedValue>& inputs, const std::string& variable,
+                                const TypingUtils::dataType declared_type);
+
+/*
+Throw the error of an arithmetic operation whose checked computation failed, with the message analysis gives the same error.
+This function depends on a typename template for the operands, a 32 or 64-bit integer or float.
+
+Throw an ExecutionError for a division by 0 or a negative base with a non-integer exponent, otherwise an OverflowError.
+
+Parameters:
+    op: the arithmetic operator (input)
+    num1/2: the operands (input)
+    line_number: line number of the operator (input)
+*/
+template <typename T>
+[[noreturn]] void raise_arithmetic_error(const TypeRules::binaryOperator op, const T num1, const T num2, const std::uint32_t line_number);
+
+#endif
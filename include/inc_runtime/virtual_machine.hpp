@@ -0,0 +1,84 @@
+/*
+
+Function declarations for executing register-based bytecode.
+
+*/
+
+#ifndef VIRTUAL_MACHINE_HPP
+#define VIRTUAL_MACHINE_HPP
+
+#include "inc_runtime/bytecode.hpp"
+
+// Threaded dispatch jumps through a table of label addresses (computed goto), a GNU extension.
+// Define REGAL_SWITCH_DISPATCH to only build the portable switch dispatch.
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(REGAL_SWITCH_DISPATCH)
+#define REGAL_THREADED_DISPATCH
+#endif
+
+
+// Structures for executing bytecode.
+namespace Bytecode {
+
+//  Ways the virtual machine dispatches instructions.
+    enum class dispatchMode : std::uint8_t {
+//      one switch over every operation code
+        Switch,
+//      each instruction's handler jumps straight to the next instruction's handler
+        Threaded
+    };
+
+//  True if threaded dispatch was built.
+#ifdef REGAL_THREADED_DISPATCH
+    constexpr bool threaded_dispatch = true;
+#else
+    constexpr bool threaded_dispatch = false;
+#endif
+
+}
+
+/*
+Create the registers of a compiled program, with its constants and the given values of its runtime variables loaded.
+
+Throw an exception if a runtime variable of the program has no given value, or a value of a type that does not combine with its declared type.
+
+Parameters:
+    compiled: the program to create the registers of (input)
+    inputs: values of the runtime variables, mapped by name (input)
+
+Return the loaded registers.
+*/
+std::vector<Runtime::valueSlot> load_registers(const Bytecode::program& compiled, const std::map<std::string, Runtime::typedValue>& inputs);
+
+/*
+Read the final value of every global variable from the registers of an executed program.
+
+Parameters:
+    compiled: the executed program (input)
+    registers: the registers after execution (input)
+
+Return the value of every global variable, with the type analysis gave it.
+*/
+std::map<std::string, Runtime::typedValue> read_outputs(const Bytecode::program& compiled, const std::vector<Runtime::valueSlot>& registers) noexcept;
+
+/*
+Execute a compiled program, starting from the given values of its runtime variables.
+The registers hold unboxed values and every instruction reads the members of its registers that its types name,
+without checking them. Arithmetic is checked as it is during analysis, so a runtime error has the same message it
+would have had if the operation had been folded.
+
+Throw an exception if
+    a runtime variable of the program has no given value, or a value of a type that does not combine with its declared type,
+    an operation overflows, or
+    an operator takes invalid operands (e.g. 2 / 0).
+
+Parameters:
+    compiled: the program to execute (input)
+    inputs: values of the runtime variables, mapped by name (input)
+    dispatch: how to dispatch instructions, threaded dispatch uses the switch if it was not built (input)
+
+Return the final value of every global variable of the program, with the type analysis gave it.
+*/
+std::map<std::string, Runtime::typedValue> execute_program(const Bytecode::program& compiled, const std::map<std::string, Runtime::typedValue>& inputs,
+                                                           const Bytecode::dispatchMode dispatch = Bytecode::dispatchMode::Threaded);
+
+#endif
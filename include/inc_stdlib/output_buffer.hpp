@@ -0,0 +1,78 @@
+/*
+
+Structures for buffered output. Text and values are formatted directly into a reusable buffer, which is written to its
+stream only when it fills up or is flushed, so printing many values costs neither a write nor an allocation per value.
+
+*/
+
+#ifndef OUTPUT_BUFFER_HPP
+#define OUTPUT_BUFFER_HPP
+
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "inc_interpreter/interp_utils.hpp"
+
+
+// Structures for standard input and output.
+namespace StandardIO {
+
+//  Default capacity of an output buffer, in bytes.
+    constexpr std::size_t OUTPUT_BUFFER_CAPACITY = 1 << 16;
+
+//  Buffer of text for an output stream. The stream is only written when the buffer is full or flushed, and only
+//  flushed itself by flush(). The buffer is flushed when destroyed. Write failures are left in the stream's state.
+    class outputBuffer {
+        private:
+//          stream the buffered text is written to
+            std::ostream& sink;
+//          buffered text, of which the first 'used' characters are pending
+            std::vector<char> buffer;
+            std::size_t used = 0;
+
+//          Write the pending text to the stream, without flushing the stream.
+            void spill();
+
+//          Retrieve space for the given number of characters at the end of the pending text, at most the capacity.
+            inline char* reserve(const std::size_t count) {
+                if (buffer.size() - used < count) {
+                    spill();
+                }
+                return buffer.data() + used;
+            }
+
+        public:
+            explicit outputBuffer(std::ostream& sink, const std::size_t capacity = OUTPUT_BUFFER_CAPACITY);
+            outputBuffer(const outputBuffer&) = delete;
+            outputBuffer& operator=(const outputBuffer&) = delete;
+            ~outputBuffer() noexcept;
+
+//          Append text, written straight to the stream if it does not fit in the buffer.
+            outputBuffer& write(const std::string_view text);
+
+//          Append a character.
+            inline outputBuffer& write(const char character) {
+                *reserve(1) = character;
+                used++;
+                return *this;
+            }
+
+//          Append the display string of a number, as num_to_string in InterpreterUtils.
+            template <typename T>
+            inline outputBuffer& write_number(const T number) {
+                char* const first = reserve(InterpreterUtils::MAX_NUMBER_CHARS);
+                used += InterpreterUtils::format_number<T>(first, number) - first;
+                return *this;
+            }
+
+//          Append the display string of an irreducible data container, as its disp().
+            outputBuffer& write_value(const CodeTree::irreducibleData* const data);
+
+//          Write the pending text to the stream, then flush the stream.
+            void flush();
+    };
+
+}
+
+#endif
@@ -12,6 +12,7 @@ Standard I/O function declarations.
 
 #include "inc_internal/display_utils.hpp"
 #include "inc_internal/error_handling.hpp"
+#include "inc_stdlib/output_buffer.hpp"
 
 /*
 Convert a piece of irredicible data to a string.
@@ -25,13 +26,21 @@ inline const std::string to_string(const CodeTree::irreducibleData* data) noexce
     return data->disp();
 }
 
-// Prints a piece of irreducible data with optional prefix and suffix.
-//      data_node: data to print (input)
-//      prefix: string to prepend to the data (default empty) (input)
-//      suffix: string to append to the data (default "\033[0m") (input)
+/*
+Retrieve the buffer of standard output that print writes to. It is flushed by flush_output and when the program exits.
+
+Return the buffer.
+*/
+StandardIO::outputBuffer& standard_output();
+
+/*
+Write the text printed so far to standard output and flush it, an explicit flush point for print.
+*/
+void flush_output();
 
 /*
-Print a display string for a piece of irreducible data to standard output.
+Print a display string for a piece of irreducible data to the buffer of standard output, formatted in place.
+The text reaches standard output when the buffer fills up or is flushed, see flush_output.
 
 Parameters:
     data: piece of data to print (input)
@@ -39,6 +48,6 @@ Parameters:
     suffix: string to append to the display string (default "\033[0m") (input)
             the default string turns future printed text white automatically
 */
-void print(const CodeTree::irreducibleData* const data, const std::string prefix = "", const std::string suffix = "\033[0m") noexcept;
+void print(const CodeTree::irreducibleData* const data, const std::string_view prefix = "", const std::string_view suffix = "\033[0m");
 
-#endif
\ No newline at end of file
+#endif
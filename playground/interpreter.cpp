@@ -3,21 +3,80 @@
 Text interpreter program. Take text from stdin and interpret it as Regal code.
 Output error messages and interpretation times to stdout.
 
+Values of runtime variables can be given as arguments, each as '--input name=value' where the value is a constant
+Regal expression (e.g. '--input x=-4.5'). Code that reads them is not known pre-runtime, so it is executed after analysis,
+by compiling it to bytecode for the virtual machine ('--engine bytecode', the default), by compiling the bytecode to x86-64
+machine code ('--engine jit', which walks the AST where machine code is not supported) or by walking the AST ('--engine tree').
+'--emit-bytecode path' writes the compiled bytecode to a file, so it can be cached, and '--emit-cpp path' writes the
+program transpiled to a standalone C++ translation unit, which reads the runtime variables as 'name=value' arguments.
+'--dump-ir path' writes the listing of the program lowered to the SSA intermediate representation and optimized by the
+standard pipeline of passes, followed by how many times each pass ran and changed it.
+'--metrics path' writes a JSON report of the wall and CPU time and allocations of each phase, and counters of the work
+done: tokens, AST nodes of each type after parsing and after analysis, folded nodes, identities applied, environments.
+Each phase reports the peak of the bytes allocated and not freed yet, and each type of AST node the memory of its nodes.
+Allocations and bytes are only counted in an interpreter built with REGAL_COUNT_ALLOCATIONS defined (the default of the
+CMake build), which replaces the global operator new, and are otherwise reported as 0. The AST nodes' memory is always
+accounted for, and only AST nodes are attributed to a type: tokens, environments and their maps use the global
+allocator, so they are only counted in the allocations of the phase that makes them.
+'--trace path' writes a Chrome trace of the spans of the lexer, parser, analysis and execution, in an interpreter built
+with REGAL_TRACING defined.
+'--profile path' writes a heat report of the time and allocations of analysis and execution charged to each line of
+code, next to the code, with the operators left on each line after analysis. Execution is only charged to lines by the
+tree engine ('--engine tree'), the compiled engines' execution is not attributed to a line.
+
+Runtime variables can instead be given a column of values each, as '--column name:type=path' where the type is one of
+i32, i64, f32, f64 or bool and the file holds the raw values. The code then runs once per row, in batches, and every
+variable not known pre-runtime is written to the column file '<dir>/<name>.<type>' of the '--batch-output dir' directory.
+
+'--server' instead keeps one process running to answer many requests, so each one skips process startup and runs warm.
+Requests and responses are frames: the byte count of the payload in decimal, a newline, then the payload. They are read
+from stdin and written to stdout, or exchanged with the clients of a Unix domain socket with '--server path'. A request
+is a command line ('run', or 'edit offset count' to edit the previous request's text), the arguments of the run one per
+line, an empty line, then the text. A response is 'ok' or 'error' with the seconds taken to answer it, a newline, then
+the output of the run or its error message. A frame larger than 64 MiB is answered with an error and its payload skipped.
+Clients of a socket can not give the options that read or write files.
+
 */
 
 #include <sstream>
+#include <fstream>
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <optional>
 
 #include "inc_interpreter/lexer.hpp"
 #include "inc_interpreter/parser.hpp"
 #include "inc_interpreter/semantic_analysis.hpp"
+#include "inc_interpreter/optimization.hpp"
+#include "inc_runtime/evaluator.hpp"
+#include "inc_runtime/bytecode_compiler.hpp"
+#include "inc_runtime/virtual_machine.hpp"
+#include "inc_runtime/native_compiler.hpp"
+#include "inc_runtime/cpp_emitter.hpp"
+#include "inc_runtime/batch_evaluator.hpp"
+#include "inc_ir/ir_lowering.hpp"
+#include "inc_ir/pass_manager.hpp"
 #include "inc_stdlib/stdio.hpp"
+#include "inc_internal/tracing.hpp"
+#ifdef REGAL_COUNT_ALLOCATIONS
+#include "inc_internal/counting_new.hpp"
+#endif
+
+// The server listens on Unix domain sockets where POSIX sockets are available, and only on stdin elsewhere.
+#if defined(__unix__) || defined(__APPLE__)
+#define REGAL_UNIX_SOCKETS
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 // Standard library aliases
-using std::string, std::list, std::shared_ptr, std::ostringstream, std::exception, std::pair, std::cin, std::cout, std::cerr,
-      std::make_shared, std::static_pointer_cast, std::fixed, std::make_pair, std::flush, std::tie;
+using std::string, std::list, std::map, std::vector, std::shared_ptr, std::unique_ptr, std::uint64_t, std::move, std::ostringstream, std::ofstream, std::istream, std::ostream, std::get, std::exception, std::tuple, std::cin, std::cout, std::cerr,
+      std::make_shared, std::static_pointer_cast, std::fixed, std::make_tuple, std::flush, std::tie;
 
 // Standard library namespace
 using namespace std::chrono;
@@ -25,52 +84,212 @@ using namespace std::chrono;
 // interp_utils namespaces
 using namespace TokenDef;
 using namespace CodeTree;
+using namespace TypingUtils;
 
 // semantic_analysis namespace
 using namespace DataStorage;
 
+// runtime_value namespace
+using namespace Runtime;
+
+// batch_evaluator namespace
+using namespace Batch;
+
+// metrics namespace
+using namespace Metrics;
+
+// tracing namespace
+using namespace Tracing;
+
+// output_buffer namespace
+using namespace StandardIO;
+
+
+// Engines that execute the code not known pre-runtime.
+enum class executionEngine {
+//  walk the analyzed AST
+    Tree,
+//  compile the analyzed AST to bytecode and run it on the virtual machine
+    Bytecode,
+//  compile the bytecode to machine code and run it, or walk the analyzed AST if machine code is not supported
+    Native
+};
+
+// Options of one run of the interpreter, read from its arguments.
+struct runOptions {
+//  environment with the runtime variables declared
+    shared_ptr<environment> env = make_shared<environment>();
+//  values of the runtime variables
+    map<string, typedValue> inputs;
+//  columns of the runtime variables executed in batches, and the files holding them
+    map<string, column> columns;
+    map<string, unique_ptr<columnFile>> column_files;
+//  engine to execute the code with
+    executionEngine engine = executionEngine::Bytecode;
+//  files to write the compiled bytecode, the transpiled C++ and the optimized IR to, and directory to write the columns
+//  of a batch to
+    string bytecode_path, cpp_path, ir_path, batch_path;
+//  file to write the JSON report of the run's phases and counters to
+    string metrics_path;
+//  file to write the Chrome trace of the run to
+    string trace_path;
+//  file to write the heat report of each line's costs to
+    string profile_path;
+};
+
+// Largest payload of a frame of the server protocol, and the size of the chunks a payload is read in.
+constexpr std::size_t MAX_FRAME_BYTES = std::size_t{1} << 26;
+constexpr std::size_t FRAME_CHUNK_BYTES = std::size_t{1} << 16;
+
+// Options of a run that read or write files, refused to the clients of a socket and never answered from a session.
+const vector<string> FILE_OPTIONS = {"--emit-bytecode", "--emit-cpp", "--dump-ir", "--column", "--batch-output", "--metrics", "--profile", "--trace"};
+
+// State the server keeps between the requests of a client.
+struct serverSession {
+//  text of the session, replaced or edited by each request
+    string text;
+//  arguments and text of the last request answered by interpreting, if it can be answered again from the session
+    vector<string> arguments;
+    string answered_text;
+//  output of the last request, and whether it was an error message
+    string output;
+    bool failed = false;
+};
+
+#ifdef REGAL_UNIX_SOCKETS
+// Stream buffer reading from and writing to a connected socket, so the server protocol runs over streams either way.
+class socketBuffer : public std::streambuf {
+    private:
+//      the connected socket
+        int socket_fd;
+//      buffers of bytes received and of bytes to send
+        std::array<char, 1 << 16> input_buffer, output_buffer;
+
+    protected:
+//      Receive more bytes once every received byte was read.
+        int_type underflow() override {
+            const ssize_t received = recv(socket_fd, input_buffer.data(), input_buffer.size(), 0);
+            if (received <= 0) {
+                return traits_type::eof();
+            }
+
+            setg(input_buffer.data(), input_buffer.data(), input_buffer.data() + received);
+            return traits_type::to_int_type(input_buffer[0]);
+        }
+
+//      Send the buffered bytes once the buffer is full, then buffer the given byte.
+        int_type overflow(const int_type byte) override {
+            if (sync() != 0) {
+                return traits_type::eof();
+            }
+            if (!traits_type::eq_int_type(byte, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(byte);
+                pbump(1);
+            }
+
+            return traits_type::not_eof(byte);
+        }
+
+//      Send every buffered byte, a closed socket does not raise SIGPIPE.
+        int sync() override {
+            for (const char* byte = pbase(); byte < pptr();) {
+                const ssize_t sent = send(socket_fd, byte, static_cast<std::size_t>(pptr() - byte), MSG_NOSIGNAL);
+                if (sent <= 0) {
+                    return -1;
+                }
+                byte += sent;
+            }
+
+            setp(output_buffer.data(), output_buffer.data() + output_buffer.size());
+            return 0;
+        }
+
+    public:
+//      Initialize the buffer on a connected socket, which it does not close.
+        explicit socketBuffer(const int socket_fd) noexcept
+            : socket_fd(socket_fd) {
+            setg(input_buffer.data(), input_buffer.data(), input_buffer.data());
+            setp(output_buffer.data(), output_buffer.data() + output_buffer.size());
+        }
+};
+#endif
+
 
 /*
-Output a display string for the local variables in the given environment.
+Output a display string for the local variables in the given environment, formatted directly into an output buffer.
 
 Parameters: 
     env: environment to display (input)
+    runtime_values: values of the variables after execution, empty if the program was not executed (input)
+    batch_path: directory the columns of a batch were written to, empty if the program was not executed in batches (input)
+    output: buffer to write the display to (output)
 */
-void _display_locals(const environment* const env) noexcept {
-    string display_str = "Constants:";
+void _display_locals(const environment* const env, const map<string, typedValue>& runtime_values, const string& batch_path, outputBuffer& output) {
+    output.write("Constants:");
 //  Iterate over the current scope_stack's variables.
     for (const auto& [var, expr] : env->locals) {
+        const map<string, typedValue>::const_iterator runtime_value = runtime_values.find(var);
+
 //      Ensure the variable was reduced at interpretation-time (pre-runtime).
         if (expr.optimize_value) {
-            const irreducibleData* const curr_data = static_cast<irreducibleData*>(expr.value.get());
-
 //          Add the variable's display.
-            display_str += "\n   " + display_type(expr.type, 0) + " " + var + ": " + to_string(curr_data);
-//      If the variable was not reduced pre-runtime, display a default message.
+            output.write("\n   ").write(display_type(expr.type, 0)).write(' ').write(var).write(": ")
+                  .write_value(static_cast<irreducibleData*>(expr.value.get()));
+//      Otherwise display the variable's value after execution.
+        } else if (runtime_value != runtime_values.end()) {
+            write_value(output.write("\n   ").write(display_type(runtime_value->second.type, 0)).write(' ').write(var).write(": "),
+                        runtime_value->second);
+//      Otherwise display the column the variable's value in every row was written to.
+        } else if (!batch_path.empty()) {
+            output.write("\n   ").write(display_type(expr.type, 0)).write(' ').write(var).write(": column \'").write(batch_path)
+                  .write('/').write(var).write('.').write(column_extensions[static_cast<std::size_t>(expr.type)]).write('\'');
+//      If the variable has no value, display a default message.
         } else {
-            display_str += "\n   cannot display variable \'" + var + "\'";
+            output.write("\n   cannot display variable \'").write(var).write('\'');
         }
     }
 
-//  Print the display to stdout.
-    cout << display_str;
-
     return;
 }
 
 /*
-Output a dispolay string for the given parsing and analysis times.
+Output a dispolay string for the given parsing, analysis, and execution times.
 
 Parameters:
     parsing_time: time in nanoseconds taken for parsing (input)
     analysis_time: time in nanoseconds taken for semantic analysis (input)
+    execution_time: time in nanoseconds taken to execute the code not known pre-runtime (input)
+    output: stream to write the display to (output)
 */
-inline void _display_time(const double parsing_time, const double analysis_time) noexcept {
-    cout << "Parsing: " << fixed << parsing_time / 1e9 << " s\n" 
-         << "Semantic Analysis: " << fixed << analysis_time / 1e9 << " s"
+inline void _display_time(const double parsing_time, const double analysis_time, const double execution_time, ostream& output) {
+    output << "Parsing: " << fixed << parsing_time / 1e9 << " s\n" 
+         << "Semantic Analysis: " << fixed << analysis_time / 1e9 << " s\n"
+         << "Execution: " << fixed << execution_time / 1e9 << " s"
          << flush;
 }
 
+/*
+Lower an analyzed AST to the SSA intermediate representation and optimize it with the standard pipeline of passes.
+
+Parameters:
+    parsed_code: root of the analyzed AST (input)
+    env: environment the AST was analyzed in (input)
+
+Return the listing of the optimized function, followed by the rounds run and each pass's runs and changes.
+*/
+string _dump_ir(const shared_ptr<dataNode>& parsed_code, const shared_ptr<environment>& env) {
+    IR::function ir_function = lower_to_ir(parsed_code, env);
+    IR::passManager pipeline = standard_pipeline();
+    const std::uint32_t rounds = pipeline.run(ir_function);
+
+    string listing = display_function(ir_function) + "passes (" + std::to_string(rounds) + " rounds):\n";
+    for (const IR::passRecord& record : pipeline.records) {
+        listing += "    " + record.name + ": " + std::to_string(record.runs) + " runs, " + std::to_string(record.changes) + " changes\n";
+    }
+
+    return listing;
+}
+
 /*
 Store text from stdin in the given text parameter.
 
@@ -85,71 +304,601 @@ inline void read_text(string& text) noexcept {
 }
 
 /*
-Interpret the given text as Regal code and update the given environment.
-Output an error message if the code was not valid.
+Read the value of a runtime variable from an argument of the form 'name=value', where the value is a constant expression.
+
+Throw an exception if the argument is malformed or its value is not a constant.
+
+Parameters:
+    argument: the argument to read (input)
+    variable: name of the runtime variable (output)
+
+Return the variable's value.
+*/
+typedValue read_input(const string& argument, string& variable) {
+    const string::size_type bind_index = argument.find(BIND_TOKEN);
+
+    if ((bind_index == string::npos) || (bind_index == 0)) {
+        throw IncorrectInputError("runtime variable input \'" + argument + "\' expected the form name=value", 0);
+    }
+    variable = argument.substr(0, bind_index);
+
+//  Analyze the value as the assignment of the variable, which also checks that the name is a variable.
+    string assignment = string(ASSIGN_TOKEN) + " " + variable + " " + BIND_TOKEN + " " + argument.substr(bind_index + 1);
+    list<token> token_list = lex_string(assignment);
+    shared_ptr<dataNode> parsed_value = parse_file(token_list);
+    shared_ptr<environment> value_env = make_shared<environment>();
+    analyze_data_node(parsed_value, value_env);
+
+    const map<string, variableInfo>::const_iterator value = value_env->locals.find(variable);
+    if ((value == value_env->locals.end()) || !value->second.optimize_value) {
+        throw IncorrectInputError("runtime variable \'" + variable + "\' expected a constant value", 0);
+    }
+
+    return constant_value(value->second.value.get());
+}
+
+/*
+Execute the code not known pre-runtime once per row of the runtime variables' columns, writing every variable not known
+pre-runtime to a column file named after it.
+
+Throw an exception if a column file can not be created, or the code fails for a row, with the row before its message.
+
+Parameters:
+    parsed_code: the analyzed code (input)
+    env: environment the code was analyzed in (input)
+    columns: columns of the runtime variables (input)
+    batch_path: directory to write the column files to (input)
+
+Return the number of row operations executed.
+*/
+uint64_t execute_batch(const shared_ptr<dataNode>& parsed_code, const shared_ptr<environment>& env, const map<string, column>& columns,
+                       const string& batch_path) {
+    const std::size_t rows = columns.begin()->second.rows;
+    vector<unique_ptr<columnFile>> output_files;
+    map<string, column> outputs;
+
+    for (const auto& [variable, info] : env->locals) {
+        if (!info.optimize_value) {
+            const string path = batch_path + "/" + variable + "." + string(column_extensions[static_cast<std::size_t>(info.type)]);
+            output_files.push_back(create_column_file(path, info.type, rows));
+            outputs[variable] = output_files.back()->view();
+        }
+    }
+
+    std::size_t failed_row = 0;
+    try {
+        return evaluate_batch(parsed_code, env, columns, outputs, failed_row);
+    } catch (const ExecutionError& e) {
+        throw std::runtime_error("row " + std::to_string(failed_row) + ": " + e.what());
+    }
+}
+
+/*
+Open the column file of a runtime variable from an argument of the form 'name:type=path'.
+
+Throw an exception if the argument is malformed or the file can not be read.
+
+Parameters:
+    argument: the argument to read (input)
+    variable: name of the runtime variable (output)
+
+Return the opened column.
+*/
+unique_ptr<columnFile> read_column(const string& argument, string& variable) {
+    const string::size_type type_index = argument.find(':');
+    const string::size_type bind_index = argument.find(BIND_TOKEN);
+
+    if ((type_index == string::npos) || (type_index == 0) || (bind_index == string::npos) || (bind_index < type_index)) {
+        throw IncorrectInputError("runtime variable column \'" + argument + "\' expected the form name:type=path", 0);
+    }
+    variable = argument.substr(0, type_index);
+
+    const string type_name = argument.substr(type_index + 1, bind_index - type_index - 1);
+    const auto extension = std::find(column_extensions.begin(), column_extensions.end(), type_name);
+    if (extension == column_extensions.end()) {
+        throw IncorrectInputError("column type \'" + type_name + "\' expected one of i32, i64, f32, f64 or bool", 0);
+    }
+
+    return open_column_file(argument.substr(bind_index + 1), static_cast<dataType>(extension - column_extensions.begin()));
+}
+
+/*
+Interpret the given text as Regal code and update the environment of the given options, then execute the code that is not
+known pre-runtime with the given options.
 
-Exit the program if the given text throws an error from parsing or analysis.
+Throw an exception if the given text throws an error from parsing, analysis, or execution, or an output can not be written.
 
 Parameters:
     text: text to interpret (input)
-    env: environment pointer to fillduring analysis (output)
-    
-Return a pair containing
-    first: time in nanoseconds taken to parse the code
-    second: time in nanoseconds taken to analyze the code
+    options: options of the run, whose environment is filled during analysis (input/output)
+    runtime_values: values of the variables after execution, left empty if every value was known pre-runtime (output)
+    row_operations: number of row operations executed once per row (output)
+    report: measurements of each phase and counters of the work done, with the AST's nodes counted if the options
+            write the report, and the lines of code profiled if the options write their profile (output)
+
+Return a 3-tuple containing
+    <0>: time in nanoseconds taken to parse the code
+    <1>: time in nanoseconds taken to analyze the code
+    <2>: time in nanoseconds taken to execute the code
 */
-const pair<double, double> interpret_text(string& text, shared_ptr<environment>& env) {
-    _V2::system_clock::time_point start_time, parsing_time, end_time;
+const tuple<double, double, double> interpret_text(string& text, runOptions& options, map<string, typedValue>& runtime_values,
+                                                   uint64_t& row_operations, pipelineReport& report) {
+    REGAL_TRACE_SPAN("interpret_text");
+    shared_ptr<environment>& env = options.env;
+    const map<string, typedValue>& inputs = options.inputs;
+    const executionEngine engine = options.engine;
+    const bool count = !options.metrics_path.empty();
+    lineRecording line_recording(options.profile_path.empty() ? nullptr : &report.lines);
+
+//  Count the work of this run only, with the memory of each type of node if it is reported, and start timing.
+    restart_counters();
+    std::optional<nodeMemoryAccounting> node_accounting;
+    if (count) {
+        node_accounting.emplace();
+    }
+    phaseClock clock;
+
+//  Lex the code. An empty text is an empty program, the parser does not return for it.
+    list<token> token_list = lex_string(text);
+    report.phases.push_back(clock.lap("lex"));
+    if ((token_list.size() == 1) && (get<0>(token_list.front()) == tokenKey::Newline)) {
+        runtime_values = inputs;
+        report.counters = Metrics::counters;
+        return make_tuple(0, 0, 0);
+    }
+
+//  Parse the code.
+    shared_ptr<dataNode> parsed_code = parse_file(token_list);
+    report.phases.push_back(clock.lap("parse"));
+    if (count) {
+        report.parsed_nodes = count_nodes(parsed_code.get());
+        clock.restart();
+    }
+
+//  Perform semantic analysis, then remove stores that are never read.
+    line_recording.start(profilePhase::Analysis);
+    const bool optimized = analyze_data_node(parsed_code, env);
+    eliminate_dead_stores(parsed_code, env);
+    line_recording.stop();
+    report.phases.push_back(clock.lap("analysis"));
+
+//  Execute whatever analysis could not, the runtime variables themselves are only known by executing.
+//  Bytecode is compiled whenever it is written, even if there is nothing to execute, and so are C++ and IR.
+    const bool execute = (!optimized || !inputs.empty()) && options.columns.empty();
+    line_recording.start(profilePhase::Execution);
+    if (!options.columns.empty()) {
+        row_operations = execute_batch(parsed_code, env, options.columns, options.batch_path);
+    }
+    if (execute && (engine == executionEngine::Tree)) {
+        runtime_values = evaluate_program(parsed_code, env, inputs);
+    }
+    if (!options.cpp_path.empty()) {
+        ofstream cpp_file(options.cpp_path);
+        cpp_file << emit_cpp(parsed_code, env);
+        if (!cpp_file) {
+            throw IncorrectInputError("could not write C++ to \'" + options.cpp_path + "\'", 0);
+        }
+    }
+    if (!options.ir_path.empty()) {
+        ofstream ir_file(options.ir_path);
+        ir_file << _dump_ir(parsed_code, env);
+        if (!ir_file) {
+            throw IncorrectInputError("could not write IR to \'" + options.ir_path + "\'", 0);
+        }
+    }
+    if ((execute && (engine != executionEngine::Tree)) || !options.bytecode_path.empty()) {
+        const Bytecode::program compiled = compile_program(parsed_code, env);
+
+        if (!options.bytecode_path.empty()) {
+            ofstream bytecode_file(options.bytecode_path, std::ios::binary);
+            bytecode_file << serialize_program(compiled);
+            if (!bytecode_file) {
+                throw IncorrectInputError("could not write bytecode to \'" + options.bytecode_path + "\'", 0);
+            }
+        }
+        if (execute && (engine == executionEngine::Bytecode)) {
+            runtime_values = execute_program(compiled, inputs);
+        } else if (execute && (engine == executionEngine::Native)) {
+            const std::unique_ptr<Native::nativeProgram> native = compile_native(compiled);
+            runtime_values = native ? execute_native(*native, inputs) : evaluate_program(parsed_code, env, inputs);
+        }
+    }
+
+    line_recording.stop();
+    report.phases.push_back(clock.lap("execution"));
+    report.counters = Metrics::counters;
+    if (count) {
+        report.analyzed_nodes = count_nodes(parsed_code.get());
+        report.node_memory = node_accounting->counts();
+    }
+    if (!options.profile_path.empty()) {
+        count_runtime_operations(parsed_code.get(), report.lines);
+    }
+
+//  Return a 3-tuple containing the nanosecond times taken, parsing includes lexing.
+    return make_tuple(report.phases[0].wall_ns + report.phases[1].wall_ns, report.phases[2].wall_ns, report.phases[3].wall_ns);
+}
+
+/*
+Read the options of a run from its command line arguments, declaring each runtime variable with the type of its value
+or column.
+
+Throw an exception if an argument is invalid, with the usage as its message if an option is not recognized.
+
+Parameters:
+    arguments: the program's name followed by the run's arguments, as on the command line (input)
+
+Return the options of the run.
+*/
+runOptions read_options(const vector<string>& arguments) {
+    runOptions options;
+
+    for (std::size_t arg_index = 1; arg_index < arguments.size(); arg_index++) {
+        const string& argument = arguments[arg_index];
+        const string option_value = (arg_index + 1 < arguments.size()) ? arguments[arg_index + 1] : "";
+
+        if ((argument == "--engine") && ((option_value == "tree") || (option_value == "bytecode") || (option_value == "jit"))) {
+            options.engine = (option_value == "tree") ? executionEngine::Tree : ((option_value == "jit") ? executionEngine::Native : executionEngine::Bytecode);
+            arg_index++;
+            continue;
+        } else if ((argument == "--emit-bytecode") && !option_value.empty()) {
+            options.bytecode_path = option_value;
+            arg_index++;
+            continue;
+        } else if ((argument == "--emit-cpp") && !option_value.empty()) {
+            options.cpp_path = option_value;
+            arg_index++;
+            continue;
+        } else if ((argument == "--dump-ir") && !option_value.empty()) {
+            options.ir_path = option_value;
+            arg_index++;
+            continue;
+        } else if ((argument == "--batch-output") && !option_value.empty()) {
+            options.batch_path = option_value;
+            arg_index++;
+            continue;
+        } else if ((argument == "--metrics") && !option_value.empty()) {
+            options.metrics_path = option_value;
+            arg_index++;
+            continue;
+        } else if ((argument == "--profile") && !option_value.empty()) {
+            options.profile_path = option_value;
+            arg_index++;
+            continue;
+        } else if ((argument == "--trace") && !option_value.empty()) {
+            if (!tracing_built) {
+                throw std::invalid_argument("tracing needs an interpreter built with REGAL_TRACING defined");
+            }
+            options.trace_path = option_value;
+            arg_index++;
+            continue;
+        } else if (((argument != "--input") && (argument != "--column")) || (arg_index + 1 == arguments.size())) {
+            throw std::invalid_argument("usage: " + arguments[0] + " [--input name=value]... [--engine tree|bytecode|jit] [--emit-bytecode path] "
+                                        + "[--emit-cpp path] [--dump-ir path] [--column name:type=path... --batch-output dir] [--metrics path] [--profile path] [--trace path] | --server [socket path]");
+        }
 
+//      Runtime variables are declared with the type of their value, or of their column.
+        string variable;
+        typedValue value{};
+        if (argument == "--input") {
+            value = read_input(arguments[++arg_index], variable);
+            options.inputs[variable] = value;
+        } else {
+            unique_ptr<columnFile> column_file = read_column(arguments[++arg_index], variable);
+            value.type = column_file->view().type;
+            options.columns[variable] = column_file->view();
+            options.column_files[variable] = move(column_file);
+        }
+        declare_runtime_variable(options.env, variable, value.type);
+    }
+
+//  Rows are executed in batches only when every runtime variable is a column.
+    if ((!options.columns.empty() || !options.batch_path.empty()) && (options.columns.empty() || options.batch_path.empty() || !options.inputs.empty())) {
+        throw std::invalid_argument("runtime variables executed in batches must all be given as columns, with a batch output directory");
+    }
+
+    return options;
+}
+
+/*
+Interpret text as Regal code with the given options, then output the environment status and interpretation time.
+
+Throw an exception if the code is invalid or fails, nothing is output then.
+
+Parameters:
+    text: text to interpret (input)
+    options: options of the run (input/output)
+    output: stream to write the environment status and interpretation time to (output)
+*/
+void run_interpreter(string& text, runOptions& options, ostream& output) {
+    map<string, typedValue> runtime_values;
+    uint64_t row_operations = 0;
+    pipelineReport report;
+    double parsing_time, analysis_time, execution_time;
+
+//  Interpret the code and update the environment, tracing it if requested.
+    if (!options.trace_path.empty()) {
+        start_tracing();
+    }
     try {
-//      Start time.
-        start_time = high_resolution_clock::now();
+        tie(parsing_time, analysis_time, execution_time) = interpret_text(text, options, runtime_values, row_operations, report);
+    } catch (...) {
+        stop_tracing();
+        throw;
+    }
+    stop_tracing();
+
+//  Write the report and the trace of the run if requested.
+    if (!options.metrics_path.empty()) {
+        ofstream metrics_file(options.metrics_path);
+        metrics_file << report_json(report);
+        if (!metrics_file) {
+            throw IncorrectInputError("could not write metrics to \'" + options.metrics_path + "\'", 0);
+        }
+    }
+    if (!options.profile_path.empty()) {
+        ofstream profile_file(options.profile_path);
+        profile_file << line_profile_report(report.lines, text);
+        if (!profile_file) {
+            throw IncorrectInputError("could not write the line profile to \'" + options.profile_path + "\'", 0);
+        }
+    }
+    if (!options.trace_path.empty()) {
+        ofstream trace_file(options.trace_path);
+        write_trace(trace_file);
+        if (!trace_file) {
+            throw IncorrectInputError("could not write the trace to \'" + options.trace_path + "\'", 0);
+        }
+    }
+
+//  Display the environment through a buffer, flushed once the delimeter separating it from the time display is written.
+    outputBuffer display(output);
+    _display_locals(options.env.get(), runtime_values, options.columns.empty() ? "" : options.batch_path, display);
+    display.write("$$$").flush();
+
+//  Display the time taken to interpret.
+    _display_time(parsing_time, analysis_time, execution_time, output);
+    if (!options.columns.empty()) {
+        output << "\nBatch: " << options.columns.begin()->second.rows << " rows, " << row_operations << " row operations, "
+               << fixed << std::setprecision(0) << row_operations / std::max(execution_time / 1e9, 1e-9) << " row operations/s" << flush;
+    }
+}
+
+/*
+Read a frame of the server protocol: the byte count of its payload in decimal, a newline, then the payload.
+The payload is read in chunks, so a byte count larger than the stream holds allocates no more than the stream holds.
+
+Throw an IncorrectInputError if the header is not a byte count, or the byte count is larger than MAX_FRAME_BYTES,
+in which case the payload is skipped so the next frame can be read.
+
+Parameters:
+    input: stream to read the frame from (input/output)
+    payload: the frame's payload (output)
+
+Return true if a whole frame was read, false if the stream ended.
+*/
+bool _read_frame(istream& input, string& payload) {
+    string header;
+    if (!std::getline(input, header)) {
+        return false;
+    } else if (header.empty() || (header.size() > 18)
+               || !std::all_of(header.begin(), header.end(), [](const char digit) { return (digit >= '0') && (digit <= '9'); })) {
+        input.setstate(std::ios::failbit);
+        throw IncorrectInputError("malformed frame header '" + header.substr(0, 32) + "', expected the byte count of the payload", 0);
+    }
+
+    const std::size_t size = std::stoull(header);
+    if (size > MAX_FRAME_BYTES) {
+        input.ignore(static_cast<std::streamsize>(size));
+        throw IncorrectInputError("frame of " + header + " bytes is larger than the limit of " + std::to_string(MAX_FRAME_BYTES) + " bytes", 0);
+    }
+
+    payload.clear();
+    while (payload.size() < size) {
+        const std::size_t offset = payload.size();
+        payload.resize(offset + std::min(FRAME_CHUNK_BYTES, size - offset));
+        input.read(payload.data() + offset, static_cast<std::streamsize>(payload.size() - offset));
+        if (static_cast<std::size_t>(input.gcount()) != payload.size() - offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+Write a frame of the server protocol and flush it.
+
+Parameters:
+    output: stream to write the frame to (output)
+    payload: the frame's payload (input)
+*/
+inline void _write_frame(ostream& output, const string& payload) {
+    output << payload.size() << '\n' << payload << flush;
+}
 
-//      Parse the code.
-        list<token> token_list = lex_string(text);
-        shared_ptr<dataNode> parsed_code = parse_file(token_list);
+/*
+Answer a request of the server protocol. The payload of a request is
+    a command line: 'run' to interpret the text of the request, or 'edit offset count' to replace the count bytes at the
+        offset of the session's text with the text of the request and interpret the result,
+    the run's arguments, one per line, as on the command line,
+    an empty line, and
+    the text.
+The payload of the response is a status line, 'ok' or 'error' followed by the seconds taken to answer the request, then
+what the interpreter outputs for the run: the environment status and interpretation time, or the error message.
+
+A request identical to the session's previous one (same arguments and text) is answered from the session, unless it
+reads or writes files, since the interpreter's output only depends on the arguments and text otherwise. Options that read
+or write files are refused unless they are allowed, since a client of a socket may not be allowed the server's files.
+
+Parameters:
+    session: state kept between the requests of a client (input/output)
+    program: the program's name (input)
+    request: the request's payload (input)
+    file_options: true if the run may give the options that read or write files (input)
 
-//      End time for parsing, start time for analysis.
-        parsing_time = high_resolution_clock::now();
+Return the response's payload.
+*/
+string answer_request(serverSession& session, const string& program, const string& request, const bool file_options) {
+    const _V2::system_clock::time_point start_time = high_resolution_clock::now();
+
+    try {
+        std::istringstream request_stream(request);
+        string command, argument;
+        vector<string> arguments = {program};
 
-//      Perform semantic analysis.
-        analyze_data_node(parsed_code, env, true);
+        std::getline(request_stream, command);
+        while (std::getline(request_stream, argument) && !argument.empty()) {
+            arguments.push_back(argument);
+        }
+        const string text = request.substr(std::min(static_cast<std::size_t>(request_stream.tellg()), request.size()));
+
+//      Apply the request's text to the session's text.
+        std::size_t offset, count;
+        if (command == "run") {
+            session.text = text;
+        } else if ((std::sscanf(command.c_str(), "edit %zu %zu", &offset, &count) == 2) && (offset <= session.text.size())
+                   && (count <= session.text.size() - offset)) {
+            session.text.replace(offset, count, text);
+        } else {
+            throw std::invalid_argument("invalid request \'" + command + "\', expected \'run\' or \'edit offset count\' within the text");
+        }
 
-//      Stop time.
-        end_time = high_resolution_clock::now();
+        const vector<string>::const_iterator file_option = std::find_first_of(arguments.begin() + 1, arguments.end(), FILE_OPTIONS.begin(), FILE_OPTIONS.end());
+        if ((file_option != arguments.end()) && !file_options) {
+            throw std::invalid_argument("option '" + *file_option + "' reads or writes files, which clients of a socket can not do");
+        }
+        const bool cacheable = file_option == arguments.end();
+        if (!cacheable || (arguments != session.arguments) || (session.text != session.answered_text)) {
+            ostringstream output;
+            runOptions options = read_options(arguments);
+            string code = session.text;
+
+            run_interpreter(code, options, output);
+            session.output = output.str();
+            session.failed = false;
+        }
+        session.arguments = cacheable ? arguments : vector<string>{};
+        session.answered_text = session.text;
 
-//  Catch exceptions, print their error messages to stdout and exit.
+//  Catch exceptions, the error message is the response.
     } catch (const exception& e) {
-        cerr << e.what() << flush;
-        exit(EXIT_FAILURE);
+        session.output = e.what();
+        session.failed = true;
+        session.arguments.clear();
     }
 
-//  Return a pair containing the nanosecond times taken.
-    return make_pair(duration_cast<nanoseconds>(parsing_time - start_time).count(),
-                     duration_cast<nanoseconds>(end_time - parsing_time).count());
+    ostringstream response;
+    response << (session.failed ? "error " : "ok ") << fixed
+             << duration_cast<nanoseconds>(high_resolution_clock::now() - start_time).count() / 1e9 << '\n' << session.output;
+    return response.str();
 }
 
 /*
-Interpret text from stdin as Regal code. Output an error message if the code was invalid
-or output the environment status and interpretation time.
+Answer requests of the server protocol as a session, until the input ends or a frame header is malformed.
+A frame that can not be read is answered with an error response.
+
+Parameters:
+    input: stream to read requests from (input/output)
+    output: stream to write responses to (output)
+    program: the program's name (input)
+    file_options: true if runs may give the options that read or write files (input)
 */
-int main() {
-    string code;
-    shared_ptr<environment> env = make_shared<environment>();
-    double parsing_time, analysis_time;
+void serve(istream& input, ostream& output, const string& program, const bool file_options) {
+    serverSession session;
+    string request;
+
+    while (input) {
+        try {
+            if (!_read_frame(input, request)) {
+                return;
+            }
+            _write_frame(output, answer_request(session, program, request, file_options));
+        } catch (const exception& e) {
+            _write_frame(output, string("error 0.000000\n") + e.what());
+        }
+    }
+}
 
-//  Store code in the string variable.
-    read_text(code);
-//  Interpret the code and update the environment.
-    tie(parsing_time, analysis_time) = interpret_text(code, env);
-//  Display the environment.
-    _display_locals(env.get());
+#ifdef REGAL_UNIX_SOCKETS
+/*
+Answer requests of the server protocol on a Unix domain socket, one client at a time, each client as a session.
+A socket already at the path is replaced.
 
-//  Output a delimeter to separate the environment display from the time display.
-    cout << "$$$";
+Throw an exception if the socket can not be created.
 
-//  Display the time taken to interpret.
-    _display_time(parsing_time, analysis_time);
+Parameters:
+    path: path of the socket (input)
+    program: the program's name (input)
+*/
+void serve_socket(const string& path, const string& program) {
+    sockaddr_un address{};
+    struct stat existing;
+
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw IncorrectInputError("socket path \'" + path + "\' is too long", 0);
+    }
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((lstat(path.c_str(), &existing) == 0) && S_ISSOCK(existing.st_mode)) {
+        unlink(path.c_str());
+    }
+    if ((listener < 0) || (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) || (listen(listener, 8) != 0)) {
+        throw IncorrectInputError("could not listen on socket \'" + path + "\'", 0);
+    }
+
+    while (true) {
+        const int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+
+        socketBuffer buffer(client);
+        istream input(&buffer);
+        ostream output(&buffer);
+        serve(input, output, program, false);
+        close(client);
+    }
+}
+#endif
+
+/*
+Interpret text from stdin as Regal code, with the runtime variables given as arguments.
+Output an error message if the code or arguments were invalid, or output the environment status and interpretation time.
+
+With '--server', answer requests of the server protocol from stdin to stdout instead, or from a Unix domain socket at
+the path given after it, in one process that stays warm between requests.
+*/
+int main(int argc, char* argv[]) {
+    const vector<string> arguments(argv, argv + argc);
+
+    try {
+        if ((argc > 1) && (arguments[1] == "--server") && (argc <= 3)) {
+            std::ios::sync_with_stdio(false);
+            if (argc == 2) {
+                serve(cin, cout, arguments[0], true);
+                return 0;
+            }
+#ifdef REGAL_UNIX_SOCKETS
+            serve_socket(arguments[2], arguments[0]);
+#else
+            throw IncorrectInputError("Unix domain sockets are not supported on this platform", 0);
+#endif
+        }
+
+        string code;
+        runOptions options = read_options(arguments);
+
+//      Store code in the string variable, then interpret it and output the result.
+        read_text(code);
+        run_interpreter(code, options, cout);
+
+//  Catch exceptions, print their error messages to stderr and exit.
+    } catch (const exception& e) {
+        cerr << e.what() << flush;
+        exit(EXIT_FAILURE);
+    }
 
     return 0;
 }
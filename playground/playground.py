@@ -40,6 +40,8 @@ class Playground:
         self._init_stack_display()
 #       Initialize the frame to display error messages and interpretation time.
         self._init_error_display()
+#       Initialize the interpreter server, started on the first interpretation.
+        self._init_server()
 
         return
 
@@ -118,6 +120,54 @@ class Playground:
         self.error_display.pack(fill="x", side="bottom")
         return
 
+    def _init_server(self):
+        """
+        Initialize the state of the interpreter server, a single interpreter process answering every interpretation.
+        """
+
+        self.server = None
+#       Text the server last interpreted, so only the edited part of the text is sent.
+        self.server_text = None
+
+        return
+
+    def _request_server(self, text_bytes):
+        """
+        Send the given text to the interpreter server as an edit of its previous text, start the server if it is not running.
+            text_bytes: UTF-8 encoded text to interpret (input)
+        Return the status line and the output of the interpreter.
+        """
+
+        if self.server is None or self.server.poll() is not None:
+            base_path = os.path.join(os.path.dirname(os.path.abspath(__file__ )), "..", "bin")
+            exe_path = os.path.join(base_path, "interpreter.exe")
+            self.server = subprocess.Popen([exe_path, "--server"], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+            self.server_text = None
+
+#       Send only the bytes between the text's common prefix and suffix with the server's text, or the whole text.
+        if self.server_text is None:
+            command, payload_text = b"run", text_bytes
+        else:
+            old_text = self.server_text
+            prefix = 0
+            while prefix < min(len(old_text), len(text_bytes)) and old_text[prefix] == text_bytes[prefix]:
+                prefix += 1
+            suffix = 0
+            while suffix < min(len(old_text), len(text_bytes)) - prefix and old_text[-suffix - 1] == text_bytes[-suffix - 1]:
+                suffix += 1
+            command = f"edit {prefix} {len(old_text) - prefix - suffix}".encode()
+            payload_text = text_bytes[prefix:len(text_bytes) - suffix]
+
+#       A request is its command, no arguments and the text, framed by its byte count.
+        payload = command + b"\n\n" + payload_text
+        self.server.stdin.write(str(len(payload)).encode() + b"\n" + payload)
+        self.server.stdin.flush()
+        self.server_text = text_bytes
+
+        size = int(self.server.stdout.readline())
+        status, _, output = self.server.stdout.read(size).decode().partition("\n")
+        return status, output
+
     def delay_event(self, time, frame, fun, event=None):
         """
         Delay the given function on the implied event by the given time. 
@@ -143,18 +193,18 @@ class Playground:
 #       Retrieve tect input from the text region.
         text_input = self.text_region.get("1.0", tk.END)
 
-        base_path = os.path.join(os.path.dirname(os.path.abspath(__file__ )), "..", "bin")
-        exe_path = os.path.join(base_path, "interpreter.exe")
-
-#       Capture all output from the interpeter.
-        output = subprocess.run([exe_path], input=text_input, capture_output=True, text=True)
+#       Capture all output from the interpeter server, restarting it once if it stopped.
+        try:
+            status, output_text = self._request_server(text_input.encode())
+        except (OSError, ValueError):
+            self.server = None
+            status, output_text = self._request_server(text_input.encode())
 
 #       If an error occurred, display the error message.
-        if output.stderr:
-            self.write_error(output.stderr)
+        if status.startswith("error"):
+            self.write_error(output_text)
 #       Otherwise, display the stack and interpretation time.
         else:
-            output_text = output.stdout
 #           Separate the stack output from the interpretation output using the delimeter "$$$".
             output_delimeter = "$$$"
             index = output_text.find(output_delimeter)
@@ -0,0 +1,202 @@
+/*
+
+Embedding API implementations, on top of the interpreter's pipeline as the interpreter program runs it.
+
+*/
+
+#include "inc_core/regal_core.hpp"
+#include "inc_interpreter/lexer.hpp"
+#include "inc_interpreter/parser.hpp"
+#include "inc_interpreter/semantic_analysis.hpp"
+#include "inc_interpreter/optimization.hpp"
+#include "inc_runtime/evaluator.hpp"
+#include "inc_runtime/bytecode_compiler.hpp"
+#include "inc_runtime/virtual_machine.hpp"
+#include "inc_runtime/native_compiler.hpp"
+#include "inc_internal/tracing.hpp"
+
+// Standard library aliases
+using std::string, std::string_view, std::list, std::map, std::shared_ptr, std::unique_ptr, std::make_shared, std::optional,
+      std::get;
+
+// interp_utils namespaces
+using namespace TokenDef;
+using namespace CodeTree;
+using namespace TypingUtils;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// regal_core namespace
+using namespace RegalCore;
+
+
+// Analyzed AST, environment and compiled code of a program, never changed once compiled.
+struct compiledProgram::compiledState {
+//  analyzed AST, nullptr for a program without statements, and the environment it was analyzed in
+    shared_ptr<dataNode> parsed_code;
+    shared_ptr<environment> env;
+//  engine that runs the program
+    executionEngine engine;
+//  true if runs execute code
+    bool execute = false;
+//  bytecode of the program for the compiled engines, and its machine code if the native engine supports it
+    optional<Bytecode::program> bytecode;
+    unique_ptr<Native::nativeProgram> native;
+//  global variables of the program
+    map<string, programVariable> variables;
+};
+
+
+namespace {
+
+//  The types of the API are in the order of the interpreter's types.
+    static_assert(static_cast<int>(valueType::Float64) == static_cast<int>(dataType::Float64T)
+                  && static_cast<int>(valueType::Bool) == static_cast<int>(dataType::BoolT));
+
+/*
+    Convert an API value to a runtime value.
+
+    Parameters:
+        api_value: the value to convert (input)
+
+    Return the runtime value.
+*/
+    typedValue _typed_value(const value& api_value) noexcept {
+        typedValue result{static_cast<dataType>(api_value.index()), {}};
+        switch (result.type) {
+            case dataType::Int32T:
+                result.value.int32 = get<std::int32_t>(api_value);
+                break;
+            case dataType::Int64T:
+                result.value.int64 = get<std::int64_t>(api_value);
+                break;
+            case dataType::Float32T:
+                result.value.float32 = get<float>(api_value);
+                break;
+            case dataType::Float64T:
+                result.value.float64 = get<double>(api_value);
+                break;
+            default:
+                result.value.boolean = get<bool>(api_value);
+                break;
+        }
+
+        return result;
+    }
+
+/*
+    Convert a runtime value to an API value.
+
+    Parameters:
+        runtime_value: the value to convert (input)
+
+    Return the API value.
+*/
+    value _api_value(const typedValue& runtime_value) noexcept {
+        switch (runtime_value.type) {
+            case dataType::Int32T:
+                return runtime_value.value.int32;
+            case dataType::Int64T:
+                return runtime_value.value.int64;
+            case dataType::Float32T:
+                return runtime_value.value.float32;
+            case dataType::Float64T:
+                return runtime_value.value.float64;
+            default:
+                return runtime_value.value.boolean;
+        }
+    }
+
+}
+
+
+compiledProgram::compiledProgram(const string_view source, const map<string, valueType>& runtime_variables, const executionEngine engine) {
+    REGAL_TRACE_SPAN("compiledProgram");
+    const shared_ptr<compiledState> compiled = make_shared<compiledState>();
+    compiled->env = make_shared<environment>();
+    compiled->engine = engine;
+    for (const auto& [variable, type] : runtime_variables) {
+        declare_runtime_variable(compiled->env, variable, static_cast<dataType>(type));
+    }
+
+//  Lex the source. An empty source is an empty program, the parser does not return for it.
+//  The runtime variables themselves are only known by executing.
+    compiled->execute = !runtime_variables.empty();
+    string text(source);
+    list<token> token_list = lex_string(text);
+    if ((token_list.size() != 1) || (get<0>(token_list.front()) != tokenKey::Newline)) {
+//      Parse and analyze the code, then remove stores that are never read.
+        compiled->parsed_code = parse_file(token_list);
+        const bool optimized = analyze_data_node(compiled->parsed_code, compiled->env);
+        eliminate_dead_stores(compiled->parsed_code, compiled->env);
+        compiled->execute = compiled->execute || !optimized;
+    }
+
+//  Compile the code once for the compiled engines, the native engine walks the AST where machine code is not supported.
+    if (compiled->execute && compiled->parsed_code && (engine != executionEngine::Tree)) {
+        compiled->bytecode = compile_program(compiled->parsed_code, compiled->env);
+        if (engine == executionEngine::Native) {
+            compiled->native = compile_native(*compiled->bytecode);
+        }
+    }
+
+    for (const auto& [variable, info] : compiled->env->locals) {
+        compiled->variables[variable] = {static_cast<valueType>(info.type),
+                                         info.optimize_value ? optional<value>(_api_value(constant_value(info.value.get()))) : std::nullopt};
+    }
+
+    state = compiled;
+}
+
+const map<string, programVariable>& compiledProgram::variables() const noexcept {
+    return state->variables;
+}
+
+bool compiledProgram::needs_execution() const noexcept {
+    return state->execute;
+}
+
+map<string, value> compiledProgram::run(const map<string, value>& inputs) const {
+    REGAL_TRACE_SPAN("compiledProgram::run");
+    map<string, typedValue> runtime_inputs;
+    for (const auto& [variable, input] : inputs) {
+        if (!state->env->inputs.contains(variable)) {
+            throw IncorrectInputError("\'" + variable + "\' is not a runtime variable of the program", 0);
+        }
+        runtime_inputs.emplace(variable, _typed_value(input));
+    }
+
+//  Without code to execute, every variable is a constant.
+    map<string, value> result;
+    if (!state->execute) {
+        for (const auto& [variable, info] : state->variables) {
+            result.emplace(variable, *info.constant);
+        }
+        return result;
+    }
+
+    map<string, typedValue> runtime_values;
+    if (state->native) {
+        runtime_values = execute_native(*state->native, runtime_inputs);
+    } else if (state->bytecode && (state->engine == executionEngine::Bytecode)) {
+        runtime_values = execute_program(*state->bytecode, runtime_inputs);
+    } else if (state->parsed_code) {
+        runtime_values = evaluate_program(state->parsed_code, state->env, runtime_inputs);
+    }
+
+//  A program without statements only has its runtime variables, which keep their given values.
+    for (const auto& [variable, declared_type] : state->env->inputs) {
+        if (!runtime_values.contains(variable)) {
+            runtime_values.emplace(variable, input_value(runtime_inputs, variable, declared_type));
+        }
+    }
+
+    for (const auto& [variable, runtime_value] : runtime_values) {
+        result.emplace(variable, _api_value(runtime_value));
+    }
+    return result;
+}
@@ -29,7 +29,7 @@ const string display_token(const token& disp_token, const bool literal) {
         case tokenKey::Int32:
             if (literal) {
 //              Retrieve the stored 32-bit integer and result +=  its normalized string.
-                result += num_to_string<int32_t>(get<uint32_t>(get<1>(disp_token)), false);
+                result += num_to_string<int32_t>(get<uint32_t>(get<1>(disp_token)));
             } else {
 //              Otherwise, result +=  the string for the relevant type.
                 result += display_type(dataType::Int32T, get<2>(disp_token));
@@ -40,7 +40,7 @@ const string display_token(const token& disp_token, const bool literal) {
         case tokenKey::Int64:
             if (literal) {
 //              Retrieve the stored 64-bit integer and result +=  its normalized string.
-                result += num_to_string<int64_t>(get<uint64_t>(get<1>(disp_token)), false);
+                result += num_to_string<int64_t>(get<uint64_t>(get<1>(disp_token)));
             } else {
 //              Otherwise, result +=  the string for the relevant type.
                 result += display_type(dataType::Int64T, get<2>(disp_token));
@@ -51,7 +51,7 @@ const string display_token(const token& disp_token, const bool literal) {
         case tokenKey::Float32:
             if (literal) {
 //              Retrieve the stored 32-bit float and result +=  its normalized string.
-                result += num_to_string<float>(get<float>(get<1>(disp_token)), true);
+                result += num_to_string<float>(get<float>(get<1>(disp_token)));
             } else {
 //              Otherwise, result +=  the string for the relevant type.
                 result += display_type(dataType::Float32T, get<2>(disp_token));
@@ -62,7 +62,7 @@ const string display_token(const token& disp_token, const bool literal) {
         case tokenKey::Float64:
             if (literal) {
 //              Retrieve the stored 64-bit float and result +=  its normalized string.
-                result += num_to_string<double>(get<double>(get<1>(disp_token)), true);
+                result += num_to_string<double>(get<double>(get<1>(disp_token)));
             } else {
 //              Otherwise, result +=  the string for the relevant type.
                 result += display_type(dataType::Float64T, get<2>(disp_token));
@@ -0,0 +1,185 @@
+/*
+
+Recording and reporting of line profiles.
+
+*/
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "inc_internal/metrics.hpp"
+
+// Standard library aliases
+using std::string, std::vector, std::ostringstream, std::istringstream, std::uint32_t, std::int64_t, std::uint64_t,
+      std::size_t, std::setw, std::fixed, std::setprecision;
+
+// interp_utils namespace
+using namespace CodeTree;
+
+// metrics namespace
+using namespace Metrics;
+
+
+namespace {
+
+//  Width of the bar of a line's share of the most expensive line's time.
+    constexpr size_t _HEAT_WIDTH = 10;
+
+/*
+    Format a time in nanoseconds as microseconds.
+
+    Parameters:
+        time_ns: the time (input)
+
+    Return the formatted time.
+*/
+    string _microseconds(const int64_t time_ns) {
+        ostringstream formatted;
+        formatted << fixed << setprecision(1) << static_cast<double>(time_ns) / 1e3;
+        return formatted.str();
+    }
+
+}
+
+
+void lineProfile::switch_line(const uint32_t line_number) {
+    const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    lineCost& cost = costs[current_line];
+
+    if (phase == profilePhase::Analysis) {
+        cost.analysis_ns += now_ns - last_ns;
+        cost.analysis_allocations += counters.allocations - last_allocations;
+    } else {
+        cost.execution_ns += now_ns - last_ns;
+        cost.execution_allocations += counters.allocations - last_allocations;
+    }
+
+//  Growing the costs is the profile's own work, so its allocations are charged to no line.
+    if (line_number >= costs.size()) {
+        costs.resize(static_cast<size_t>(line_number) + 1);
+    }
+    current_line = line_number;
+    last_ns = now_ns;
+    last_allocations = counters.allocations;
+}
+
+void lineProfile::start(const profilePhase recorded_phase) {
+    phase = recorded_phase;
+    current_line = 0;
+    last_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    last_allocations = counters.allocations;
+}
+
+void lineProfile::add_runtime_operation(const uint32_t line_number) {
+    if (line_number >= costs.size()) {
+        costs.resize(static_cast<size_t>(line_number) + 1);
+    }
+    costs[line_number].runtime_operations++;
+}
+
+void count_runtime_operations(const dataNode* const data_node, lineProfile& profile) {
+//  Walk the AST with an explicit stack, since chains of statements are as deep as the program is long.
+    vector<const dataNode*> pending = {data_node};
+    while (!pending.empty()) {
+        const dataNode* const node = pending.back();
+        pending.pop_back();
+        if (node == nullptr) {
+            continue;
+        }
+
+        switch (node->type) {
+            case nodeType::CodeScope: {
+                const codeScope* const code_scope = static_cast<const codeScope*>(node);
+                pending.push_back(code_scope->remainder.get());
+                pending.push_back(code_scope->curr_operation.get());
+                break;
+            }
+            case nodeType::IfBlock: {
+                const ifBlock* const if_block = static_cast<const ifBlock*>(node);
+                pending.push_back(if_block->else_block.get());
+                pending.push_back(if_block->code_block.get());
+                pending.push_back(if_block->bool_condition.get());
+                break;
+            }
+            case nodeType::AssignOp:
+                pending.push_back(static_cast<const assignOp*>(node)->expression.get());
+                break;
+            case nodeType::ReassignOp:
+                pending.push_back(static_cast<const reassignOp*>(node)->expression.get());
+                break;
+            case nodeType::UnaryOp:
+                profile.add_runtime_operation(node->line_number);
+                pending.push_back(static_cast<const unaryOp*>(node)->expression.get());
+                break;
+            case nodeType::BinaryOp: {
+                const binaryOp* const binary_op = static_cast<const binaryOp*>(node);
+                profile.add_runtime_operation(node->line_number);
+                pending.push_back(binary_op->expression2.get());
+                pending.push_back(binary_op->expression1.get());
+                break;
+            }
+            case nodeType::TernaryOp: {
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(node);
+                profile.add_runtime_operation(node->line_number);
+                pending.push_back(ternary_op->expression3.get());
+                pending.push_back(ternary_op->expression2.get());
+                pending.push_back(ternary_op->expression1.get());
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+string line_profile_report(const lineProfile& profile, const string& text) {
+    const vector<lineCost>& costs = profile.line_costs();
+    ostringstream report;
+
+//  Split the code into lines, the first line is line 1.
+    vector<string> code_lines = {""};
+    istringstream code(text);
+    for (string code_line; std::getline(code, code_line);) {
+        code_lines.push_back(code_line);
+    }
+
+//  Total the costs, and find the most expensive line's time to scale the bars by.
+    lineCost total;
+    int64_t max_line_ns = 1;
+    for (size_t line_index = 0; line_index < costs.size(); line_index++) {
+        const lineCost& cost = costs[line_index];
+        total.analysis_ns += cost.analysis_ns;
+        total.execution_ns += cost.execution_ns;
+        total.analysis_allocations += cost.analysis_allocations;
+        total.execution_allocations += cost.execution_allocations;
+        total.runtime_operations += cost.runtime_operations;
+        if (line_index != 0) {
+            max_line_ns = std::max(max_line_ns, cost.analysis_ns + cost.execution_ns);
+        }
+    }
+
+    report << "Line profile: analysis " << _microseconds(total.analysis_ns) << " us, " << total.analysis_allocations
+           << " allocations; execution " << _microseconds(total.execution_ns) << " us, " << total.execution_allocations
+           << " allocations; " << total.runtime_operations << " operators left after analysis\n"
+           << setw(6) << "line" << setw(13) << "analysis us" << setw(8) << "allocs" << setw(14) << "execution us" << setw(8)
+           << "allocs" << setw(8) << "runs" << setw(6) << "ops" << "  " << string(_HEAT_WIDTH, ' ') << "  code\n";
+
+//  Every line of code gets a row, even the lines without statements, so the report lines up with the code.
+    const size_t line_count = std::max(code_lines.size(), costs.size());
+    for (size_t line_index = 1; line_index < line_count; line_index++) {
+        const lineCost cost = (line_index < costs.size()) ? costs[line_index] : lineCost{};
+        const size_t heat = static_cast<size_t>((cost.analysis_ns + cost.execution_ns) * static_cast<int64_t>(_HEAT_WIDTH) / max_line_ns);
+
+        report << setw(6) << line_index << setw(13) << _microseconds(cost.analysis_ns) << setw(8) << cost.analysis_allocations
+               << setw(14) << _microseconds(cost.execution_ns) << setw(8) << cost.execution_allocations << setw(8)
+               << cost.executions << setw(6) << cost.runtime_operations << "  " << string(heat, '#')
+               << string(_HEAT_WIDTH - heat, ' ') << "  " << ((line_index < code_lines.size()) ? code_lines[line_index] : "") << "\n";
+    }
+
+    report << setw(6) << "-" << setw(13) << _microseconds(costs[0].analysis_ns) << setw(8) << costs[0].analysis_allocations
+           << setw(14) << _microseconds(costs[0].execution_ns) << setw(8) << costs[0].execution_allocations
+           << "  (not attributed to a line)\n";
+
+    return report.str();
+}
@@ -0,0 +1,214 @@
+/*
+
+Measurement of the interpreter's pipeline.
+
+*/
+
+#include <sstream>
+#include <algorithm>
+
+#include "inc_internal/metrics.hpp"
+
+// Standard library aliases
+using std::string, std::vector, std::ostringstream;
+
+// interp_utils namespace
+using namespace CodeTree;
+
+// metrics namespace
+using namespace Metrics;
+
+
+namespace {
+
+//  Name of each node type, in the order of nodeType.
+    constexpr std::array<const char*, node_type_count> _NODE_TYPE_NAMES = {
+        "DataNode", "ScopeInitializer", "ValueData", "IrreducibleData",
+        "CodeScope", "IfBlock", "AssignOp", "ReassignOp",
+        "UnaryOp", "BinaryOp", "TernaryOp", "VarContainer",
+        "Int32Container", "Int64Container", "Float32Container", "Float64Container", "BoolContainer"
+    };
+
+//  Memory of each type of node accounted for by the current thread, and the resources that account for it.
+    struct _nodeAccountingState {
+        nodeMemoryCounts memory{};
+        vector<nodeAccounting> resources;
+
+        _nodeAccountingState() {
+            resources.reserve(node_type_count);
+            for (nodeMemory& type_memory : memory) {
+                resources.emplace_back(type_memory);
+            }
+        }
+    };
+    thread_local _nodeAccountingState _node_accounting;
+
+/*
+    Write the node counts of an AST as a JSON object, skipping the types without nodes.
+
+    Parameters:
+        json: stream to write the object to (output)
+        counts: number of nodes of each type (input)
+*/
+    void _write_node_counts(ostringstream& json, const nodeCounts& counts) {
+        bool first = true;
+
+        json << "{";
+        for (std::size_t type_index = 0; type_index < node_type_count; type_index++) {
+            if (counts[type_index] != 0) {
+                json << (first ? "" : ", ") << "\"" << _NODE_TYPE_NAMES[type_index] << "\": " << counts[type_index];
+                first = false;
+            }
+        }
+        json << "}";
+    }
+
+/*
+    Write the memory of each type of AST node as a JSON object, skipping the types without allocations.
+
+    Parameters:
+        json: stream to write the object to (output)
+        memory: memory of each type of node (input)
+*/
+    void _write_node_memory(ostringstream& json, const nodeMemoryCounts& memory) {
+        bool first = true;
+
+        json << "{";
+        for (std::size_t type_index = 0; type_index < node_type_count; type_index++) {
+            const nodeMemory& type_memory = memory[type_index];
+            if (type_memory.allocations != 0) {
+                json << (first ? "\n" : ",\n") << "    \"" << _NODE_TYPE_NAMES[type_index] << "\": {\"allocations\": " << type_memory.allocations
+                     << ", \"allocated_bytes\": " << type_memory.allocated_bytes << ", \"peak_live_bytes\": " << type_memory.peak_live_bytes << "}";
+                first = false;
+            }
+        }
+        json << (first ? "}" : "\n  }");
+    }
+
+}
+
+
+void* nodeAccounting::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+//  Allocate as the default operator new does for the alignment, so that executables counting allocations count nodes.
+    void* const pointer = (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ? ::operator new(bytes, std::align_val_t(alignment)) : ::operator new(bytes);
+
+    memory.allocations++;
+    memory.allocated_bytes += bytes;
+    memory.live_bytes += bytes;
+    memory.peak_live_bytes = std::max(memory.peak_live_bytes, memory.live_bytes);
+    return pointer;
+}
+
+void nodeAccounting::do_deallocate(void* const pointer, const std::size_t bytes, const std::size_t alignment) {
+    memory.live_bytes -= bytes;
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        ::operator delete(pointer, std::align_val_t(alignment));
+    } else {
+        ::operator delete(pointer);
+    }
+}
+
+bool nodeAccounting::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+nodeMemoryAccounting::nodeMemoryAccounting() {
+//  Nodes still live from before are freed through their resources, so only the counts of new nodes restart.
+    for (std::size_t type_index = 0; type_index < node_type_count; type_index++) {
+        nodeMemory& type_memory = _node_accounting.memory[type_index];
+        type_memory.allocations = 0;
+        type_memory.allocated_bytes = 0;
+        type_memory.peak_live_bytes = type_memory.live_bytes;
+        node_resources[type_index] = &_node_accounting.resources[type_index];
+    }
+}
+
+nodeMemoryAccounting::~nodeMemoryAccounting() {
+    node_resources.fill(nullptr);
+}
+
+const nodeMemoryCounts& nodeMemoryAccounting::counts() const noexcept {
+    return _node_accounting.memory;
+}
+
+nodeCounts count_nodes(const dataNode* const data_node) {
+    nodeCounts counts{};
+
+//  Walk the AST with an explicit stack, since chains of statements are as deep as the program is long.
+    vector<const dataNode*> pending = {data_node};
+    while (!pending.empty()) {
+        const dataNode* const node = pending.back();
+        pending.pop_back();
+        if (node == nullptr) {
+            continue;
+        }
+
+        counts[static_cast<std::size_t>(node->type)]++;
+        switch (node->type) {
+            case nodeType::CodeScope: {
+                const codeScope* const code_scope = static_cast<const codeScope*>(node);
+                pending.push_back(code_scope->remainder.get());
+                pending.push_back(code_scope->curr_operation.get());
+                break;
+            }
+            case nodeType::IfBlock: {
+                const ifBlock* const if_block = static_cast<const ifBlock*>(node);
+                pending.push_back(if_block->else_block.get());
+                pending.push_back(if_block->code_block.get());
+                pending.push_back(if_block->bool_condition.get());
+                break;
+            }
+            case nodeType::AssignOp:
+                pending.push_back(static_cast<const assignOp*>(node)->expression.get());
+                break;
+            case nodeType::ReassignOp:
+                pending.push_back(static_cast<const reassignOp*>(node)->expression.get());
+                break;
+            case nodeType::UnaryOp:
+                pending.push_back(static_cast<const unaryOp*>(node)->expression.get());
+                break;
+            case nodeType::BinaryOp: {
+                const binaryOp* const binary_op = static_cast<const binaryOp*>(node);
+                pending.push_back(binary_op->expression2.get());
+                pending.push_back(binary_op->expression1.get());
+                break;
+            }
+            case nodeType::TernaryOp: {
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(node);
+                pending.push_back(ternary_op->expression3.get());
+                pending.push_back(ternary_op->expression2.get());
+                pending.push_back(ternary_op->expression1.get());
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    return counts;
+}
+
+string report_json(const pipelineReport& report) {
+    ostringstream json;
+    const pipelineCounters& counters = report.counters;
+
+    json << "{\n  \"phases\": [";
+    for (std::size_t phase_index = 0; phase_index < report.phases.size(); phase_index++) {
+        const phaseMetrics& phase = report.phases[phase_index];
+        json << (phase_index == 0 ? "\n" : ",\n") << "    {\"name\": \"" << phase.name << "\", \"wall_ns\": " << phase.wall_ns
+             << ", \"cpu_ns\": " << phase.cpu_ns << ", \"allocations\": " << phase.allocations << ", \"allocated_bytes\": " << phase.allocated_bytes
+             << ", \"peak_live_bytes\": " << phase.peak_live_bytes << "}";
+    }
+
+    json << "\n  ],\n  \"counters\": {\"tokens\": " << counters.tokens << ", \"folded_nodes\": " << counters.folded_nodes
+         << ", \"identities\": " << counters.identities << ", \"environments\": " << counters.environments
+         << ", \"allocations\": " << counters.allocations << ", \"allocated_bytes\": " << counters.allocated_bytes << "},\n  \"parsed_nodes\": ";
+    _write_node_counts(json, report.parsed_nodes);
+    json << ",\n  \"analyzed_nodes\": ";
+    _write_node_counts(json, report.analyzed_nodes);
+    json << ",\n  \"node_memory\": ";
+    _write_node_memory(json, report.node_memory);
+    json << "\n}\n";
+
+    return json.str();
+}
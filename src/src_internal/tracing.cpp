@@ -0,0 +1,86 @@
+/*
+
+Recording and writing of the interpreter's trace.
+
+*/
+
+#include <iomanip>
+
+#include "inc_internal/tracing.hpp"
+
+// Standard library aliases
+using std::uint32_t, std::ostream, std::ios_base, std::streamsize, std::atomic, std::fixed, std::setprecision;
+
+// tracing namespace
+using namespace Tracing;
+
+
+namespace {
+
+//  First buffer of the list of every thread's buffer, and the identifier of the next thread to record.
+    atomic<threadBuffer*> _first_buffer = nullptr;
+    atomic<uint32_t> _next_thread_id = 1;
+
+//  Buffer of the current thread, nullptr until it first records.
+    thread_local threadBuffer* _thread_buffer = nullptr;
+
+/*
+    Retrieve the current thread's buffer, creating it and pushing it on the list of buffers if the thread never recorded.
+
+    Return the buffer.
+*/
+    threadBuffer& _current_buffer() {
+        if (_thread_buffer == nullptr) {
+            threadBuffer* const buffer = new threadBuffer{{}, _next_thread_id.fetch_add(1, std::memory_order_relaxed), nullptr};
+            buffer->next = _first_buffer.load(std::memory_order_relaxed);
+            while (!_first_buffer.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed)) {}
+            _thread_buffer = buffer;
+        }
+        return *_thread_buffer;
+    }
+
+}
+
+
+void Tracing::record_span(const traceEvent& event) noexcept {
+    try {
+        _current_buffer().events.push_back(event);
+    } catch (...) {}
+}
+
+void start_tracing() {
+    for (threadBuffer* buffer = _first_buffer.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+        buffer->events.clear();
+    }
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void stop_tracing() noexcept {
+    recording.store(false, std::memory_order_relaxed);
+}
+
+void write_trace(ostream& output) {
+    bool first = true;
+
+//  Times are written in fixed point, restoring the caller's format once the trace is written.
+    const ios_base::fmtflags flags = output.flags();
+    const streamsize precision = output.precision();
+
+    output << "{\"traceEvents\": [" << fixed << setprecision(3);
+    for (const threadBuffer* buffer = _first_buffer.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+        for (const traceEvent& event : buffer->events) {
+            output << (first ? "\n" : ",\n") << "{\"name\": \"" << event.name << "\", \"cat\": \"regal\", \"ph\": \"X\", \"ts\": "
+                   << static_cast<double>(event.start_ns) / 1e3 << ", \"dur\": " << static_cast<double>(event.duration_ns) / 1e3
+                   << ", \"pid\": 1, \"tid\": " << buffer->thread_id;
+            if (event.line_number != 0) {
+                output << ", \"args\": {\"line\": " << event.line_number << "}";
+            }
+            output << "}";
+            first = false;
+        }
+    }
+    output << "\n], \"displayTimeUnit\": \"ns\"}\n";
+
+    output.flags(flags);
+    output.precision(precision);
+}
@@ -0,0 +1,135 @@
+/*
+
+Function implementations for interning constant values.
+
+*/
+
+#include "inc_interpreter/constant_pool.hpp"
+
+#include <bit>
+
+#include "inc_internal/error_handling.hpp"
+
+// Standard library aliases
+using std::shared_ptr, std::unordered_map, std::bit_cast, std::uint64_t, std::uint32_t, std::int32_t, std::int64_t, std::size_t;
+
+// interp_utils namespaces
+using namespace TypingUtils;
+using namespace CodeTree;
+
+// constant_pool namespace
+using namespace DataStorage;
+
+// boxed_value namespace
+using namespace ValueBoxing;
+
+
+// Constant pool helper functions.
+namespace {
+
+/*
+    Retrieve the container for the given bit pattern from a pool of one data type, creating it on first use.
+    This function depends on a typename template for the container class and the type of its value.
+
+    Parameters:
+        pool: containers of the data type, mapped by bit pattern (input/output)
+        bits: bit pattern of the value (input)
+        value: value of the container (input)
+
+    Return the pooled container.
+*/
+    template <typename Container, typename T>
+    shared_ptr<valueData> _intern(unordered_map<uint64_t, shared_ptr<valueData>>& pool, const uint64_t bits, const T value) {
+        shared_ptr<valueData>& pooled = pool[bits];
+
+        if (pooled == nullptr) {
+            pooled = make_node<Container>(0, value);
+        }
+
+        return pooled;
+    }
+
+//  Index of each data type's pool.
+    constexpr size_t _pool_index(const dataType type) noexcept {
+        return static_cast<size_t>(type);
+    }
+
+}
+
+
+shared_ptr<valueData> constantPool::int32(const int32_t number) {
+    requests++;
+    return _intern<int32Container>(pooled[_pool_index(dataType::Int32T)], static_cast<uint64_t>(static_cast<int64_t>(number)), number);
+}
+
+shared_ptr<valueData> constantPool::int64(const int64_t number) {
+    requests++;
+    return _intern<int64Container>(pooled[_pool_index(dataType::Int64T)], static_cast<uint64_t>(number), number);
+}
+
+shared_ptr<valueData> constantPool::float32(const float number) {
+    requests++;
+    return _intern<float32Container>(pooled[_pool_index(dataType::Float32T)], bit_cast<std::uint32_t>(number), number);
+}
+
+shared_ptr<valueData> constantPool::float64(const double number) {
+    requests++;
+    return _intern<float64Container>(pooled[_pool_index(dataType::Float64T)], bit_cast<uint64_t>(number), number);
+}
+
+shared_ptr<valueData> constantPool::boolean(const bool boolean) {
+    requests++;
+    return _intern<boolContainer>(pooled[_pool_index(dataType::BoolT)], boolean ? 1 : 0, boolean);
+}
+
+void constantPool::record_line(const shared_ptr<valueData>& use, const uint32_t line_number) {
+//  A use on the line of its statement needs no entry, but may replace the entry of a freed field at the same address.
+    if (line_number == statement_line) {
+        if (!use_lines.empty()) {
+            use_lines.erase(&use);
+        }
+        return;
+    }
+
+    use_lines[&use] = line_number;
+}
+
+uint32_t constantPool::line_number(const shared_ptr<valueData>& use) const noexcept {
+    if (use->line_number != 0) {
+        return use->line_number;
+    }
+
+    const unordered_map<const shared_ptr<valueData>*, uint32_t>::const_iterator recorded = use_lines.find(&use);
+    return (recorded != use_lines.end()) ? recorded->second : statement_line;
+}
+
+size_t constantPool::size() const noexcept {
+    size_t total = 0;
+
+    for (const unordered_map<uint64_t, shared_ptr<valueData>>& pool : pooled) {
+        total += pool.size();
+    }
+
+    return total;
+}
+
+boxedValue box_constant(const valueData* const value_data) {
+    switch (value_data->type) {
+        case nodeType::Int32Container:
+            return boxedValue::from_int32(static_cast<const int32Container*>(value_data)->number);
+        case nodeType::Float32Container:
+            return boxedValue::from_float32(static_cast<const float32Container*>(value_data)->number);
+        case nodeType::Float64Container:
+            return boxedValue::from_float64(static_cast<const float64Container*>(value_data)->number);
+        case nodeType::BoolContainer:
+            return boxedValue::from_bool(static_cast<const boolContainer*>(value_data)->boolean);
+
+//      A wide 64-bit integer points to the container's number.
+        case nodeType::Int64Container:
+            return boxedValue::from_int64(&static_cast<const int64Container*>(value_data)->number);
+
+//      Throw an exception when the data is not an irreducible data container.
+        default:
+            throw FatalError("expected irreducible data to box", value_data->line_number);
+    }
+}
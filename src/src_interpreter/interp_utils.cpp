@@ -111,16 +111,19 @@ namespace CodeTree {
     assignOp::assignOp() 
         : dataNode(nodeType::AssignOp),
           variable(""), 
+          slot(0),
           expression(nullptr) {}
 
     assignOp::assignOp(const uint32_t line_number, const string& var, shared_ptr<valueData> expr) 
         : dataNode(nodeType::AssignOp, line_number),
           variable(var), 
+          slot(0),
           expression(move(expr)) {}
 
     inline assignOp::assignOp(assignOp&& other) noexcept
         : dataNode(other),
           variable(move(other.variable)), 
+          slot(other.slot),
           expression(move(other.expression)) {}
 
 
@@ -129,16 +132,19 @@ namespace CodeTree {
     reassignOp::reassignOp() 
         : dataNode(nodeType::ReassignOp),
           variable(""), 
+          slot(0),
           expression(nullptr) {}
 
     reassignOp::reassignOp(const uint32_t line_number, const string& var, shared_ptr<valueData> expr) 
         : dataNode(nodeType::ReassignOp, line_number),
           variable(var), 
+          slot(0),
           expression(move(expr)) {}
 
     inline reassignOp::reassignOp(reassignOp&& other) noexcept
         : dataNode(other),
           variable(move(other.variable)), 
+          slot(other.slot),
           expression(move(other.expression)) {}
 
 
@@ -211,15 +217,18 @@ namespace CodeTree {
 
     varContainer::varContainer() 
         : valueData(nodeType::VarContainer),
-          variable("") {}
+          variable(""),
+          slot(0) {}
 
     varContainer::varContainer(const uint32_t line_number, const string& var) 
         : valueData(nodeType::VarContainer, line_number),
-          variable(var) {}
+          variable(var),
+          slot(0) {}
 
     inline varContainer::varContainer(varContainer&& other) noexcept 
         : valueData(other),
-          variable(move(other.variable)) {}
+          variable(move(other.variable)),
+          slot(other.slot) {}
 
 
             /*              IRREDUCIBLE (PRIMITIVE) DATA                */
@@ -236,7 +245,7 @@ namespace CodeTree {
 
     inline string int32Container::disp() const noexcept {
 //      Pass the second parameter as false since the number is not floating-point.
-        return num_to_string<int32_t>(number, false);
+        return num_to_string<int32_t>(number);
     }
 
 
@@ -252,7 +261,7 @@ namespace CodeTree {
 
     inline string int64Container::disp() const noexcept {
 //      Pass the second parameter as false since the number is not floating-point.
-        return num_to_string<int64_t>(number, false);
+        return num_to_string<int64_t>(number);
     }
 
     
@@ -268,7 +277,7 @@ namespace CodeTree {
 
     inline string float32Container::disp() const noexcept {
 //      Pass the second parameter as true since the number is floating-point.
-        return num_to_string<float>(number, true);
+        return num_to_string<float>(number);
     }
 
 
@@ -284,7 +293,7 @@ namespace CodeTree {
 
     inline string float64Container::disp() const noexcept {
 //      Pass the second parameter as true since the number is floating-point.
-        return num_to_string<double>(number, true);
+        return num_to_string<double>(number);
     }
 
 
@@ -5,6 +5,7 @@ The lex_string function and any helper functions or structures.
 */
 
 #include "inc_interpreter/lexer.hpp"
+#include "inc_internal/tracing.hpp"
 
 // Standard library aliases
 using std::string, std::pair, std::tuple, std::list, std::array, std::out_of_range, std::int32_t, std::uint32_t,
@@ -244,8 +245,8 @@ namespace {
 
 //              Inline comment case
                 } else {
-//                  Ignore all text until the next line.
-                    while (input[trivia_index] != NEWLINE_TOKEN) { trivia_index++; }
+//                  Ignore all text until the next line, stopping before the newline so the loop counts its line.
+                    while ((trivia_index + 1 < input_size) && (input[trivia_index + 1] != NEWLINE_TOKEN)) { trivia_index++; }
                     indent_count = 0;
                 }
 
@@ -462,6 +463,7 @@ namespace {
 
 
 const list<token> lex_string(string& input) {
+    REGAL_TRACE_SPAN("lex_string");
     list<token> token_list;
     uint32_t curr_index, matched_index, trivia_index;
     int32_t curr_indent;
@@ -707,6 +709,7 @@ const list<token> lex_string(string& input) {
     }
 
     token_list.push_back(make_tuple(tokenKey::Newline, GLOBAL_INDENT, line_number));
+    Metrics::counters.tokens += token_list.size();
 
     return token_list;
 }
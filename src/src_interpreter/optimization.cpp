@@ -0,0 +1,493 @@
+/*
+
+Function implementations for post-analysis optimization passes.
+
+*/
+
+#include "inc_interpreter/optimization.hpp"
+#include "inc_internal/tracing.hpp"
+
+#include <unordered_map>
+
+// Standard library aliases
+using std::set, std::map, std::unordered_map, std::vector, std::pair, std::shared_ptr, std::string, std::uint8_t, std::uint32_t,
+      std::size_t, std::move, std::next, std::reverse, std::remove_if;
+
+// interp_utils namespaces
+using namespace TokenDef;
+using namespace CodeTree;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// optimization namespace
+using namespace Optimization;
+
+
+// Dead-store elimination helper functions.
+namespace {
+
+//  Flags of a variable's slot: its current value may be read later, and it is overwritten on every path after.
+    constexpr uint8_t _LIVE = 1;
+    constexpr uint8_t _OVERWRITTEN = 2;
+
+//  Liveness of every variable, indexed by slot. Changes made inside the blocks of an 'if' are logged with the flags
+//  they replaced, so each block is undone to start the next one from the same state instead of copying every flag.
+    struct _slotState {
+//      current flags of the slot
+        uint8_t flags = 0;
+//      flags of the slot after an 'if' block, while the slot is marked merging the blocks
+        uint8_t branch_flags = 0;
+//      last mark given to the slot, to visit it once per pass over the changes
+        uint32_t mark = 0;
+    };
+
+    struct _livenessState {
+//      slot of each variable, mapped by name
+        unordered_map<string, uint32_t> slots;
+//      state of each slot
+        vector<_slotState> slot_states;
+//      slot and previous flags of each change made inside an 'if' block, in order
+        vector<pair<uint32_t, uint8_t>> changes;
+//      slot and flags of each slot changed by the blocks of the 'if' blocks being merged, as a stack
+        vector<pair<uint32_t, uint8_t>> outcomes;
+//      number of 'if' blocks being processed, changes are only logged inside one
+        uint32_t branch_depth = 0;
+//      last mark given
+        uint32_t last_mark = 0;
+//      optional collection of removed stores, and counter of removed stores
+        vector<deadStore>* report = nullptr;
+        uint32_t removed = 0;
+    };
+
+/*
+    Retrieve the slot of a variable, creating it on first use.
+
+    Parameters:
+        state: liveness state (input/output)
+        variable: name of the variable (input)
+
+    Return the variable's slot.
+*/
+    uint32_t _slot(_livenessState& state, const string& variable) {
+        const auto [slot, created] = state.slots.emplace(variable, static_cast<uint32_t>(state.slot_states.size()));
+        if (created) {
+            state.slot_states.emplace_back();
+        }
+
+        return slot->second;
+    }
+
+/*
+    Set the flags of a slot, logging the change inside an 'if' block.
+
+    Parameters:
+        state: liveness state (input/output)
+        slot: the slot (input)
+        flags: the slot's new flags (input)
+*/
+    inline void _set_flags(_livenessState& state, const uint32_t slot, const uint8_t flags) {
+        uint8_t& slot_flags = state.slot_states[slot].flags;
+        if (slot_flags == flags) {
+            return;
+        }
+
+        if (state.branch_depth != 0) {
+            state.changes.emplace_back(slot, slot_flags);
+        }
+        slot_flags = flags;
+    }
+
+/*
+    Push every slot changed since the given change once on the outcomes, with its flags, then undo those changes.
+
+    Parameters:
+        state: liveness state (input/output)
+        first_change: index of the first change to undo (input)
+*/
+    void _undo_changes(_livenessState& state, const size_t first_change) {
+        const uint32_t mark = ++state.last_mark;
+        for (size_t change_index = first_change; change_index < state.changes.size(); change_index++) {
+            _slotState& slot_state = state.slot_states[state.changes[change_index].first];
+            if (slot_state.mark != mark) {
+                slot_state.mark = mark;
+                state.outcomes.emplace_back(state.changes[change_index].first, slot_state.flags);
+            }
+        }
+
+//      Later changes are undone first, so each slot ends with the flags it had before its first change.
+        for (size_t change_index = state.changes.size(); change_index-- > first_change;) {
+            state.slot_states[state.changes[change_index].first].flags = state.changes[change_index].second;
+        }
+        state.changes.resize(first_change);
+    }
+
+/*
+    Merge the flags of a slot after both blocks of an 'if': live if live after either, overwritten if overwritten after both.
+
+    Parameters:
+        if_flags: flags after the 'if' block (input)
+        else_flags: flags after the 'else' block (input)
+
+    Return the merged flags.
+*/
+    inline uint8_t _merge_flags(const uint8_t if_flags, const uint8_t else_flags) noexcept {
+        return ((if_flags | else_flags) & _LIVE) | (if_flags & else_flags & _OVERWRITTEN);
+    }
+
+/*
+    Mark every variable read by the given expression as live.
+
+    Parameters:
+        value_data: expression to collect variable reads from (input)
+        state: liveness state (input/output)
+*/
+    void _collect_reads(const valueData* const value_data, _livenessState& state) {
+        switch (value_data->type) {
+            case nodeType::UnaryOp:
+                _collect_reads(static_cast<const unaryOp*>(value_data)->expression.get(), state);
+                break;
+
+            case nodeType::BinaryOp: {
+                const binaryOp* const binary_op = static_cast<const binaryOp*>(value_data);
+                _collect_reads(binary_op->expression1.get(), state);
+                _collect_reads(binary_op->expression2.get(), state);
+                break;
+            }
+
+            case nodeType::TernaryOp: {
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(value_data);
+                _collect_reads(ternary_op->expression1.get(), state);
+                _collect_reads(ternary_op->expression2.get(), state);
+                _collect_reads(ternary_op->expression3.get(), state);
+                break;
+            }
+
+            case nodeType::VarContainer: {
+                const uint32_t slot = _slot(state, static_cast<const varContainer*>(value_data)->variable);
+                _set_flags(state, slot, state.slot_states[slot].flags | _LIVE);
+                break;
+            }
+
+//          Irreducible data reads nothing.
+            default:
+                break;
+        }
+
+        return;
+    }
+
+/*
+    Determine whether the given node is a code scope with no operations.
+
+    Parameters:
+        data_node: node to check (input)
+
+    Return true if the node is an empty code scope.
+*/
+    inline const bool _empty_scope(const dataNode* const data_node) noexcept {
+        return (data_node->type == nodeType::CodeScope) && (static_cast<const codeScope*>(data_node)->curr_operation == nullptr);
+    }
+
+/*
+    Create an empty code scope, used in place of a block that had every operation removed.
+
+    Parameters:
+        line_number: line number of the removed block (input)
+
+    Return a shared pointer to the empty code scope.
+*/
+    inline shared_ptr<dataNode> _make_empty_scope(const uint32_t line_number) {
+        return make_node<codeScope>(line_number, nullptr, nullptr);
+    }
+
+/*
+    Remove dead stores from the given AST by walking it backwards and tracking which variables are live.
+    Replace the given node with an empty code scope if all of its operations are dead.
+
+    Parameters:
+        data_node: the AST to remove dead stores from (input/output)
+        state: liveness state after the node, updated to the state before the node (input/output)
+*/
+    void _eliminate_node(shared_ptr<dataNode>& data_node, _livenessState& state) {
+        switch (data_node->type) {
+            case nodeType::CodeScope: {
+                codeScope* const code_scope = static_cast<codeScope*>(data_node.get());
+
+//              An already empty scope has nothing to remove.
+                if (code_scope->curr_operation == nullptr) {
+                    return;
+                }
+
+//              Liveness flows backwards, so the remainder is processed before the current operation.
+                _eliminate_node(code_scope->remainder, state);
+                _eliminate_node(code_scope->curr_operation, state);
+
+//              Collapse the scope around any operation that was removed.
+                const bool empty_operation = _empty_scope(code_scope->curr_operation.get());
+                const bool empty_remainder = _empty_scope(code_scope->remainder.get());
+
+                if (empty_operation) {
+                    data_node = move(code_scope->remainder);
+                } else if (empty_remainder) {
+                    data_node = move(code_scope->curr_operation);
+                }
+
+                return;
+            }
+
+            case nodeType::IfBlock: {
+                ifBlock* const if_block = static_cast<ifBlock*>(data_node.get());
+
+//              A condition known before runtime leaves only one block to consider.
+                if (if_block->bool_condition->type == nodeType::BoolContainer) {
+                    if (static_cast<const boolContainer*>(if_block->bool_condition.get())->boolean) {
+                        data_node = move(if_block->code_block);
+                    } else if (if_block->contains_else) {
+                        data_node = move(if_block->else_block);
+                    } else {
+                        data_node = _make_empty_scope(if_block->line_number);
+                        return;
+                    }
+
+                    _eliminate_node(data_node, state);
+                    return;
+                }
+
+//              Each block starts from the state after the 'if' block, a missing 'else' leaves that state as is.
+//              Both blocks are undone once processed, so only the slots they changed are merged.
+                const size_t first_change = state.changes.size();
+                const size_t if_outcome = state.outcomes.size();
+                state.branch_depth++;
+                _eliminate_node(if_block->code_block, state);
+                _undo_changes(state, first_change);
+                const size_t else_outcome = state.outcomes.size();
+                if (if_block->contains_else) {
+                    _eliminate_node(if_block->else_block, state);
+                }
+                _undo_changes(state, first_change);
+                state.branch_depth--;
+
+//              A slot one block did not change keeps the flags it had after the 'if' block on that path.
+                const uint32_t if_mark = ++state.last_mark;
+                for (size_t outcome_index = if_outcome; outcome_index < else_outcome; outcome_index++) {
+                    _slotState& slot_state = state.slot_states[state.outcomes[outcome_index].first];
+                    slot_state.mark = if_mark;
+                    slot_state.branch_flags = state.outcomes[outcome_index].second;
+                }
+                const uint32_t merged_mark = ++state.last_mark;
+                for (size_t outcome_index = else_outcome; outcome_index < state.outcomes.size(); outcome_index++) {
+                    const auto [slot, flags] = state.outcomes[outcome_index];
+                    _slotState& slot_state = state.slot_states[slot];
+                    const uint8_t if_flags = (slot_state.mark == if_mark) ? slot_state.branch_flags : slot_state.flags;
+                    slot_state.mark = merged_mark;
+                    _set_flags(state, slot, _merge_flags(if_flags, flags));
+                }
+                for (size_t outcome_index = if_outcome; outcome_index < else_outcome; outcome_index++) {
+                    const auto [slot, flags] = state.outcomes[outcome_index];
+                    if (state.slot_states[slot].mark == if_mark) {
+                        _set_flags(state, slot, _merge_flags(flags, state.slot_states[slot].flags));
+                    }
+                }
+                state.outcomes.resize(if_outcome);
+
+                const bool empty_if = _empty_scope(if_block->code_block.get());
+                const bool empty_else = !if_block->contains_else || _empty_scope(if_block->else_block.get());
+
+                if (empty_else && if_block->contains_else) {
+//                  Drop an 'else' block with no remaining code.
+                    if_block->else_block = nullptr;
+                    if_block->contains_else = false;
+                } else if (empty_if && !empty_else) {
+//                  Keep only the 'else' block by negating the condition.
+                    if_block->bool_condition = make_node<unaryOp>(if_block->bool_condition->line_number, tokenKey::Not, move(if_block->bool_condition));
+                    if_block->code_block = move(if_block->else_block);
+                    if_block->contains_else = false;
+                }
+
+//              Remove the 'if' block entirely if no code is left and the condition cannot raise an error.
+                if (empty_if && empty_else) {
+                    if (!expression_may_raise(if_block->bool_condition.get())) {
+                        data_node = _make_empty_scope(if_block->line_number);
+                        return;
+                    }
+                }
+
+//              The condition is evaluated before either block.
+                _collect_reads(if_block->bool_condition.get(), state);
+                return;
+            }
+
+            case nodeType::AssignOp:
+            case nodeType::ReassignOp: {
+                const bool explicit_assign = data_node->type == nodeType::AssignOp;
+                string variable;
+                shared_ptr<valueData> expression;
+
+//              Retrieve the stored variable and its expression from either kind of assignment.
+                if (explicit_assign) {
+                    const assignOp* const assign = static_cast<const assignOp*>(data_node.get());
+                    variable = assign->variable;
+                    expression = assign->expression;
+                } else {
+                    const reassignOp* const reassign = static_cast<const reassignOp*>(data_node.get());
+                    variable = reassign->variable;
+                    expression = reassign->expression;
+                }
+
+//              Remove the store if its value is never read and computing it cannot raise an error.
+                const uint32_t slot = _slot(state, variable);
+                if (((state.slot_states[slot].flags & _LIVE) == 0) && !expression_may_raise(expression.get())) {
+                    if (state.report != nullptr) {
+                        state.report->push_back(deadStore{variable, data_node->line_number, (state.slot_states[slot].flags & _OVERWRITTEN) != 0});
+                    }
+
+                    state.removed++;
+                    data_node = _make_empty_scope(data_node->line_number);
+                } else {
+//                  The store kills the variable, then its expression reads other variables.
+                    _set_flags(state, slot, state.slot_states[slot].flags & ~_LIVE);
+                    _collect_reads(expression.get(), state);
+                }
+
+//              Before an explicit assignment the variable does not exist, so it cannot have been overwritten.
+                const uint8_t flags = state.slot_states[slot].flags;
+                _set_flags(state, slot, explicit_assign ? (flags & ~_OVERWRITTEN) : (flags | _OVERWRITTEN));
+
+                return;
+            }
+
+//          Throw an exception when a piece of data was not recognized (not implemented).
+            default:
+                throw FatalError("data not recognized during dead-store elimination", data_node->line_number);
+        }
+    }
+
+/*
+    Add every variable explicitly assigned in the given AST to the given set of variables.
+
+    Parameters:
+        data_node: AST to collect declarations from (input)
+        declared: set to add declared variables to (output)
+*/
+    void _collect_declarations(const dataNode* const data_node, set<string>& declared) {
+        switch (data_node->type) {
+            case nodeType::CodeScope: {
+                const codeScope* const code_scope = static_cast<const codeScope*>(data_node);
+                if (code_scope->curr_operation != nullptr) {
+                    _collect_declarations(code_scope->curr_operation.get(), declared);
+                    _collect_declarations(code_scope->remainder.get(), declared);
+                }
+                break;
+            }
+
+            case nodeType::IfBlock: {
+                const ifBlock* const if_block = static_cast<const ifBlock*>(data_node);
+                _collect_declarations(if_block->code_block.get(), declared);
+                if (if_block->contains_else) {
+                    _collect_declarations(if_block->else_block.get(), declared);
+                }
+                break;
+            }
+
+            case nodeType::AssignOp:
+                declared.insert(static_cast<const assignOp*>(data_node)->variable);
+                break;
+
+            default:
+                break;
+        }
+
+        return;
+    }
+
+/*
+    Erase variables that no longer have any explicit assignment from the inner scopes of the given environment.
+    Inner scopes left with no variables and no scopes of their own are removed.
+
+    Parameters:
+        scope_env: environment whose inner scopes are pruned (input/output)
+        declared: variables that are still explicitly assigned somewhere in the AST (input)
+*/
+    void _prune_inner_scopes(environment* const scope_env, const set<string>& declared) {
+        vector<shared_ptr<environment>>& inner_scopes = scope_env->inner_scopes;
+
+        for (const shared_ptr<environment>& inner_scope : inner_scopes) {
+            map<string, variableInfo>& locals = inner_scope->locals;
+            for (map<string, variableInfo>::iterator iter = locals.begin(); iter != locals.end();) {
+                iter = (declared.count(iter->first) == 0) ? locals.erase(iter) : next(iter);
+            }
+
+            _prune_inner_scopes(inner_scope.get(), declared);
+        }
+
+//      Drop scopes that hold nothing anymore.
+        inner_scopes.erase(remove_if(inner_scopes.begin(), inner_scopes.end(), [](const shared_ptr<environment>& inner_scope) {
+                               return inner_scope->locals.empty() && inner_scope->inner_scopes.empty();
+                           }), inner_scopes.end());
+
+        return;
+    }
+
+}
+
+
+const bool expression_may_raise(const valueData* const value_data) noexcept {
+    switch (value_data->type) {
+        case nodeType::UnaryOp:
+            return expression_may_raise(static_cast<const unaryOp*>(value_data)->expression.get());
+
+        case nodeType::BinaryOp: {
+            const binaryOp* const binary_op = static_cast<const binaryOp*>(value_data);
+
+            switch (binary_op->op) {
+                case tokenKey::Plus:
+                case tokenKey::Minus:
+                case tokenKey::Mult:
+                case tokenKey::Div:
+                case tokenKey::Exp:
+                    return true;
+
+                default:
+                    return expression_may_raise(binary_op->expression1.get()) || expression_may_raise(binary_op->expression2.get());
+            }
+        }
+
+        case nodeType::TernaryOp: {
+            const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(value_data);
+            return expression_may_raise(ternary_op->expression1.get()) || expression_may_raise(ternary_op->expression2.get())
+                   || expression_may_raise(ternary_op->expression3.get());
+        }
+
+        default:
+            return false;
+    }
+}
+
+const uint32_t eliminate_dead_stores(shared_ptr<dataNode>& data_node, shared_ptr<environment>& global_env, vector<deadStore>* const report) {
+    REGAL_TRACE_SPAN("eliminate_dead_stores");
+    _livenessState state;
+    set<string> declared;
+    const size_t first_record = (report != nullptr) ? report->size() : 0;
+    state.report = report;
+
+//  Global variables are the result of the program, so they are all live at the end.
+    state.slots.reserve(global_env->locals.size());
+    state.slot_states.reserve(global_env->locals.size());
+    for (const auto& [variable, info] : global_env->locals) {
+        state.slot_states[_slot(state, variable)].flags = _LIVE;
+    }
+
+    _eliminate_node(data_node, state);
+
+//  Stores were found from the end of the program, so restore their order in the report.
+    if (report != nullptr) {
+        reverse(report->begin() + first_record, report->end());
+    }
+
+//  Erase variables with no remaining assignments from the inner scopes.
+    _collect_declarations(data_node.get(), declared);
+    _prune_inner_scopes(global_env.get(), declared);
+
+    return state.removed;
+}
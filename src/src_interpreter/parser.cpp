@@ -6,10 +6,11 @@ The AST generator follows the CFG in the docs folder one to one.
 */
 
 #include "inc_interpreter/parser.hpp"
+#include "inc_internal/tracing.hpp"
 
 // Standard library aliases
 using std::string, std::list, std::array, std::shared_ptr, std::uint8_t, std::int32_t, std::int64_t, 
-      std::make_shared, std::get, std::advance, std::move, std::next;
+      std::get, std::advance, std::move, std::next;
 
 // interp_utils namespaces
 using namespace TypingUtils;
@@ -293,6 +294,7 @@ The node definitions can be found in CodeTree from interp_utils.hpp.
 */
 
 shared_ptr<dataNode> parse_file(list<token>& token_list) {
+    REGAL_TRACE_SPAN("parse_file");
 //  Handle an empty input, the lexer adds a newline by default.
     if ((token_list.size() == 1) && (_lookahead(token_list, tokenKey::Newline))) {
         exit(EXIT_SUCCESS);
@@ -303,6 +305,7 @@ shared_ptr<dataNode> parse_file(list<token>& token_list) {
 }
 
 shared_ptr<dataNode> parse_code_scope(list<token>& token_list, const int32_t min_indent) {
+    REGAL_TRACE_SPAN("parse_code_scope");
     shared_ptr<dataNode> current_operation;
     token newline_token;
 
@@ -326,7 +329,7 @@ shared_ptr<dataNode> parse_code_scope(list<token>& token_list, const int32_t min
     const shared_ptr<dataNode> code_scope = parse_code_scope(token_list, min_indent);
 
 //  Default the line number to 0 since a code scope only stores code.
-    return make_shared<codeScope>(0, current_operation, code_scope);
+    return make_node<codeScope>(0, current_operation, code_scope);
 }
 
 shared_ptr<dataNode> parse_if_block(list<token>& token_list, const int32_t min_indent) {
@@ -348,14 +351,14 @@ shared_ptr<dataNode> parse_if_block(list<token>& token_list, const int32_t min_i
 //  Check for an 'else' block.
     if (_lookahead_many(token_list, tokenKey::Else, 1) && (next_indent == min_indent)) {
         const shared_ptr<dataNode> else_block = parse_else_block(token_list, min_indent);
-        return make_shared<ifBlock>(if_linenum, expression, code_scope, else_block);
+        return make_node<ifBlock>(if_linenum, expression, code_scope, else_block);
     } 
 
 //      If 'else' was of lower indent, assume it is part of a parent scope.
 //          i.e. deal with 'else' further up in the recursion.
 //      'else' could not be higher indent or it would have thrown an exception in the parse code scope function.
 
-    return make_shared<ifBlock>(if_linenum, expression, code_scope);
+    return make_node<ifBlock>(if_linenum, expression, code_scope);
 }
 
 shared_ptr<dataNode> parse_else_block(list<token>& token_list, const int32_t min_indent) {
@@ -409,7 +412,7 @@ shared_ptr<dataNode> parse_explicit_assignment(list<token>& token_list) {
     const shared_ptr<valueData> expression = parse_expression(token_list);
 
 //  Pass the line number, variable name, and expression for assignment.
-    return make_shared<assignOp>(get<2>(variable_token), get<string>(get<1>(variable_token)), expression);
+    return make_node<assignOp>(get<2>(variable_token), get<string>(get<1>(variable_token)), expression);
 }
 
 shared_ptr<dataNode> parse_implicit_assignment(list<token>& token_list) {
@@ -424,7 +427,7 @@ shared_ptr<dataNode> parse_implicit_assignment(list<token>& token_list) {
     const shared_ptr<valueData> expression = parse_expression(token_list);
 
 //  Pass the line number, variable name, and expression for assignment.    
-    return make_shared<reassignOp>(get<2>(variable_token), get<string>(get<1>(variable_token)), expression);
+    return make_node<reassignOp>(get<2>(variable_token), get<string>(get<1>(variable_token)), expression);
 }
 
 
@@ -450,7 +453,7 @@ shared_ptr<valueData> parse_ternary_if_expression(list<token>& token_list) {
         _match_bypass(token_list, tokenKey::Else, true);
         const shared_ptr<valueData> expression2 = parse_expression(token_list);
 
-        return make_shared<ternaryOp>(if_linenum, tokenKey::If, equative_expression, expression1, expression2);
+        return make_node<ternaryOp>(if_linenum, tokenKey::If, equative_expression, expression1, expression2);
     }
 
     return equative_expression;
@@ -473,7 +476,7 @@ shared_ptr<valueData> parse_equative_expr(list<token>& token_list) {
         const shared_ptr<valueData> equative_expression = parse_equative_expr(token_list);
 
 //      Pass the operator from the operator token to be executed.
-        return make_shared<binaryOp>(get<2>(operator_token), get<0>(operator_token), or_expr, equative_expression);
+        return make_node<binaryOp>(get<2>(operator_token), get<0>(operator_token), or_expr, equative_expression);
     }
 
     return or_expr;
@@ -493,7 +496,7 @@ shared_ptr<valueData> parse_or_expression(list<token>& token_list) {
         const shared_ptr<valueData> or_expression = parse_or_expression(token_list);
 
 //      Pass the operator from the operator token to be executed.
-        return make_shared<binaryOp>(get<2>(operator_token), get<0>(operator_token), xor_expression, or_expression);
+        return make_node<binaryOp>(get<2>(operator_token), get<0>(operator_token), xor_expression, or_expression);
     }
 
     return xor_expression;
@@ -513,7 +516,7 @@ shared_ptr<valueData> parse_exclusive_or_expression(list<token>& token_list) {
         const shared_ptr<valueData> or_expression = parse_or_expression(token_list);
 
 //      Pass the operator from the operator token to be executed.
-        return make_shared<binaryOp>(get<2>(operator_token), get<0>(operator_token), and_expression, or_expression);
+        return make_node<binaryOp>(get<2>(operator_token), get<0>(operator_token), and_expression, or_expression);
     }
 
     return and_expression;
@@ -533,7 +536,7 @@ shared_ptr<valueData> parse_and_expression(list<token>& token_list) {
         const shared_ptr<valueData> and_expression = parse_and_expression(token_list);
 
 //      Pass the operator from the operator token to be executed.
-        return make_shared<binaryOp>(get<2>(operator_token), get<0>(operator_token), not_expression, and_expression);
+        return make_node<binaryOp>(get<2>(operator_token), get<0>(operator_token), not_expression, and_expression);
     }
 
     return not_expression;
@@ -552,7 +555,7 @@ shared_ptr<valueData> parse_not_expression(list<token>& token_list) {
         const shared_ptr<valueData> not_expression = parse_not_expression(token_list);
 
 //      Pass the operator from the operator token to be executed.
-        return make_shared<unaryOp>(get<2>(operator_token), get<0>(operator_token), not_expression);
+        return make_node<unaryOp>(get<2>(operator_token), get<0>(operator_token), not_expression);
     }
 
     return parse_comparative_expr(token_list);
@@ -573,7 +576,7 @@ shared_ptr<valueData> parse_comparative_expr(list<token>& token_list) {
         const shared_ptr<valueData> numeric_comp_expr = parse_comparative_expr(token_list);
 
 //      Pass the operator from the operator token to be executed.
-        return make_shared<binaryOp>(get<2>(operator_token), get<0>(operator_token), additive_expression, numeric_comp_expr);
+        return make_node<binaryOp>(get<2>(operator_token), get<0>(operator_token), additive_expression, numeric_comp_expr);
     }
 
     return additive_expression;
@@ -596,7 +599,7 @@ shared_ptr<valueData> parse_additive_expression(list<token>& token_list) {
         const shared_ptr<valueData> additive_expression = parse_additive_expression(token_list);
 
 //      Pass the operator from the operator token to be executed.
-        return make_shared<binaryOp>(get<2>(operator_token), get<0>(operator_token), multiplicative_expression, additive_expression);
+        return make_node<binaryOp>(get<2>(operator_token), get<0>(operator_token), multiplicative_expression, additive_expression);
     }
     
     return multiplicative_expression;
@@ -616,7 +619,7 @@ shared_ptr<valueData> parse_multiplicative_expression(list<token>& token_list) {
         const shared_ptr<valueData> multiplicative_expression = parse_multiplicative_expression(token_list);
 
 //      Pass the operator from the operator token to be executed.
-        return make_shared<binaryOp>(get<2>(operator_token), get<0>(operator_token), exponential_expression, multiplicative_expression);
+        return make_node<binaryOp>(get<2>(operator_token), get<0>(operator_token), exponential_expression, multiplicative_expression);
     }
     
     return exponential_expression;
@@ -633,7 +636,7 @@ shared_ptr<valueData> parse_exponential_expression(list<token>& token_list) {
 //      Parse and store the expression after '**'.
         const shared_ptr<valueData> exponential_expression = parse_exponential_expression(token_list);
 
-        return make_shared<binaryOp>(exp_linenum, tokenKey::Exp, minus_identifier_expression, exponential_expression);
+        return make_node<binaryOp>(exp_linenum, tokenKey::Exp, minus_identifier_expression, exponential_expression);
     }
 
     return minus_identifier_expression;
@@ -650,7 +653,7 @@ shared_ptr<valueData> parse_minus_identifier_expression(list<token>& token_list)
         const shared_ptr<valueData> primitive_expression = parse_primitive_expression(token_list);
 
 //      Convert the expression to 0 - expr to simulate negation.
-        return make_shared<binaryOp>(minus_linenum, tokenKey::Minus, make_shared<int32Container>(minus_linenum, 0), primitive_expression);
+        return make_node<binaryOp>(minus_linenum, tokenKey::Minus, make_node<int32Container>(minus_linenum, 0), primitive_expression);
     }
 
     return parse_primitive_expression(token_list);
@@ -665,7 +668,7 @@ shared_ptr<valueData> parse_primitive_expression(list<token>& token_list) {
         _retrieve_bypass(token_list, variable_token);
 
 //      Pass the variable name as a string.
-        return make_shared<varContainer>(get<2>(variable_token), get<string>(get<1>(variable_token)));
+        return make_node<varContainer>(get<2>(variable_token), get<string>(get<1>(variable_token)));
 
 //  Number types/tokens are defined in interp_utils.hpp.
     } else if (_lookahead_any<number_type_count>(token_list, number_tokens, true)) {
@@ -701,13 +704,13 @@ shared_ptr<irreducibleData> parse_number_expression(list<token>& token_list) {
 //  be within the signed range as this was checked during lexing.
     switch (number_type) {
         case tokenKey::Int32:
-            return make_shared<int32Container>(number_linenum, get<uint32_t>(get<1>(number_token)));
+            return make_node<int32Container>(number_linenum, get<uint32_t>(get<1>(number_token)));
         case tokenKey::Int64:
-            return make_shared<int64Container>(number_linenum, get<uint64_t>(get<1>(number_token)));
+            return make_node<int64Container>(number_linenum, get<uint64_t>(get<1>(number_token)));
         case tokenKey::Float32:
-            return make_shared<float32Container>(number_linenum, get<float>(get<1>(number_token)));
+            return make_node<float32Container>(number_linenum, get<float>(get<1>(number_token)));
         case tokenKey::Float64:
-            return make_shared<float64Container>(number_linenum, get<double>(get<1>(number_token)));
+            return make_node<float64Container>(number_linenum, get<double>(get<1>(number_token)));
         default:
             throw FatalError("unrecognized number type in number expression", number_linenum);
     }
@@ -721,5 +724,5 @@ shared_ptr<irreducibleData> parse_boolean_expression(list<token>& token_list) {
     _retrieve_bypass(token_list, bool_token);
 
 //  Pass the boolean value to the constructor.
-    return make_shared<boolContainer>(get<2>(bool_token), get<bool>(get<1>(bool_token)));
+    return make_node<boolContainer>(get<2>(bool_token), get<bool>(get<1>(bool_token)));
 }
@@ -0,0 +1,512 @@
+/*
+
+Function implementations for lowering an analyzed AST into the SSA intermediate representation.
+
+*/
+
+#include "inc_ir/ir_lowering.hpp"
+#include "inc_interpreter/optimization.hpp"
+#include "inc_internal/tracing.hpp"
+
+// Standard library aliases
+using std::map, std::vector, std::shared_ptr, std::string, std::uint32_t, std::move;
+
+// interp_utils namespaces
+using namespace TypingUtils;
+using namespace TokenDef;
+using namespace CodeTree;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// ssa namespace
+using namespace IR;
+
+
+// Lowering helper functions.
+namespace {
+
+//  State carried through the lowering of an AST.
+    struct _loweringState {
+//      the function being built
+        function& ir_function;
+//      block that new instructions are appended to
+        blockId block;
+//      current value of each variable in scope
+        map<string, valueId> variables;
+//      input instruction of each runtime variable read so far
+        map<string, valueId> inputs;
+//      environment the AST was analyzed in
+        const environment* global_env;
+    };
+
+/*
+    Append an instruction with the given operands to the current block.
+
+    Parameters:
+        state: lowering state (input/output)
+        op: opcode of the instruction (input)
+        type: type of the defined value (input)
+        operands: values read by the instruction (input)
+        line_number: line number of the instruction (input)
+
+    Return the defined value.
+*/
+    inline valueId _emit(_loweringState& state, const opcode op, const dataType type, vector<valueId>&& operands, const uint32_t line_number) {
+        return state.ir_function.append(state.block, instruction{op, type, move(operands), constantValue{0, 0.0}, "", NO_BLOCK, line_number});
+    }
+
+/*
+    Convert a value to the given type at the end of the given block, if its type differs.
+
+    Parameters:
+        ir_function: function being built (input/output)
+        block: block to append the conversion to (input)
+        value: value to convert (input)
+        type: type to convert to (input)
+
+    Return the converted value, or the given value if no conversion was needed.
+*/
+    valueId _convert_in(function& ir_function, const blockId block, const valueId value, const dataType type) {
+        if (ir_function.values[value].type == type) {
+            return value;
+        }
+
+        const uint32_t line_number = ir_function.values[value].line_number;
+        return ir_function.append(block, instruction{opcode::Convert, type, {value}, constantValue{0, 0.0}, "", NO_BLOCK, line_number});
+    }
+
+/*
+    Retrieve the current value of a variable, reading it as a runtime input if it was never assigned.
+
+    Parameters:
+        state: lowering state (input/output)
+        variable: name of the variable (input)
+        line_number: line number of the read (input)
+
+    Return the variable's value.
+*/
+    valueId _read_variable(_loweringState& state, const string& variable, const uint32_t line_number) {
+        const map<string, valueId>::const_iterator assigned = state.variables.find(variable);
+        if (assigned != state.variables.end()) {
+            return assigned->second;
+        }
+
+        const map<string, valueId>::const_iterator input = state.inputs.find(variable);
+        if (input != state.inputs.end()) {
+            return input->second;
+        }
+
+//      A runtime variable must have been declared in the environment, which records its type.
+        const map<string, dataType>::const_iterator declared = state.global_env->inputs.find(variable);
+        if (declared == state.global_env->inputs.end()) {
+            throw FatalError("variable '" + variable + "' is not a runtime variable during IR lowering", line_number);
+        }
+
+//      Inputs are read once at the start of the program.
+        instruction read{opcode::Input, declared->second, {}, constantValue{0, 0.0}, variable, NO_BLOCK, line_number};
+        const valueId value = state.ir_function.append(0, move(read));
+        state.inputs[variable] = value;
+
+        return value;
+    }
+
+/*
+    End two blocks by jumping to a new block where their control flow meets.
+
+    Parameters:
+        ir_function: function being built (input/output)
+        left_end: first predecessor of the new block (input)
+        right_end: second predecessor of the new block (input)
+
+    Return the new block.
+*/
+    blockId _join_blocks(function& ir_function, const blockId left_end, const blockId right_end) {
+        const blockId join = ir_function.add_block();
+
+        for (const blockId predecessor : {left_end, right_end}) {
+//          A predecessor that ends in a branch already targets the new block through its false target.
+            if (ir_function.blocks[predecessor].terminator != terminatorType::Branch) {
+                ir_function.blocks[predecessor].terminator = terminatorType::Jump;
+                ir_function.blocks[predecessor].true_target = join;
+            }
+        }
+        ir_function.blocks[join].predecessors = {left_end, right_end};
+
+        return join;
+    }
+
+/*
+    Create a phi instruction at the start of a join block, merging a value from each of its predecessors.
+    Values of different number types are converted to their runtime merged type in their predecessor.
+
+    Parameters:
+        ir_function: function being built (input/output)
+        join: block where the values meet (input)
+        left_value: value from the first predecessor (input)
+        right_value: value from the second predecessor (input)
+        line_number: line number of the merge (input)
+
+    Return the merged value.
+*/
+    valueId _merge_values(function& ir_function, const blockId join, valueId left_value, valueId right_value, const uint32_t line_number) {
+        if (left_value == right_value) {
+            return left_value;
+        }
+
+        const vector<blockId>& predecessors = ir_function.blocks[join].predecessors;
+        const dataType type = runtime_merged_type(ir_function.values[left_value].type, ir_function.values[right_value].type);
+
+        left_value = _convert_in(ir_function, predecessors[0], left_value, type);
+        right_value = _convert_in(ir_function, predecessors[1], right_value, type);
+
+        return ir_function.append(join, instruction{opcode::Phi, type, {left_value, right_value}, constantValue{0, 0.0}, "", NO_BLOCK, line_number});
+    }
+
+/*
+    Branch on a condition and lower a value in each of two new blocks, merging the results where they meet.
+
+    Parameters:
+        state: lowering state, left in the join block (input/output)
+        condition: boolean value to branch on (input)
+        lower_true: lowers the value used when the condition is true into the current block (input)
+        lower_false: lowers the value used when the condition is false into the current block (input)
+        line_number: line number of the conditional (input)
+
+    Return the merged value.
+*/
+    valueId _lower_conditional(_loweringState& state, const valueId condition, const std::function<valueId()>& lower_true,
+                               const std::function<valueId()>& lower_false, const uint32_t line_number) {
+        function& ir_function = state.ir_function;
+        const blockId branch_block = state.block;
+        const blockId true_block = ir_function.add_block();
+        const blockId false_block = ir_function.add_block();
+
+        ir_function.blocks[branch_block].terminator = terminatorType::Branch;
+        ir_function.blocks[branch_block].condition = condition;
+        ir_function.blocks[branch_block].true_target = true_block;
+        ir_function.blocks[branch_block].false_target = false_block;
+        ir_function.blocks[true_block].predecessors = {branch_block};
+        ir_function.blocks[false_block].predecessors = {branch_block};
+
+        state.block = true_block;
+        const valueId true_value = lower_true();
+        const blockId true_end = state.block;
+
+        state.block = false_block;
+        const valueId false_value = lower_false();
+        const blockId false_end = state.block;
+
+        state.block = _join_blocks(ir_function, true_end, false_end);
+        return _merge_values(ir_function, state.block, true_value, false_value, line_number);
+    }
+
+    valueId _lower_value(const valueData* const value_data, _loweringState& state);
+
+/*
+    Lower a binary operator into the current block.
+
+    Parameters:
+        binary_op: the operator to lower (input)
+        state: lowering state (input/output)
+
+    Return the operator's value.
+*/
+    valueId _lower_binary(const binaryOp* const binary_op, _loweringState& state) {
+        const uint32_t line_number = binary_op->line_number;
+        const valueId value1 = _lower_value(binary_op->expression1.get(), state);
+
+//      'and'/'or' only evaluate an operand that could raise an error when it decides the result.
+        const bool short_circuit = expression_may_raise(binary_op->expression2.get());
+        const auto lower_constant = [&state, line_number](const bool boolean) {
+            return state.ir_function.append(state.block, make_constant(dataType::BoolT, boolean, 0.0, line_number));
+        };
+        const auto lower_second = [binary_op, &state]() {
+            return _lower_value(binary_op->expression2.get(), state);
+        };
+
+        switch (binary_op->op) {
+            case tokenKey::And:
+            case tokenKey::AndW:
+                if (short_circuit) {
+                    return _lower_conditional(state, value1, lower_second, [&lower_constant]() { return lower_constant(false); }, line_number);
+                }
+                break;
+
+            case tokenKey::Or:
+            case tokenKey::OrW:
+                if (short_circuit) {
+                    return _lower_conditional(state, value1, [&lower_constant]() { return lower_constant(true); }, lower_second, line_number);
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        const valueId value2 = _lower_value(binary_op->expression2.get(), state);
+        const dataType type1 = state.ir_function.values[value1].type;
+        const dataType type2 = state.ir_function.values[value2].type;
+
+        opcode op;
+        dataType operand_type;
+        dataType result_type = dataType::BoolT;
+
+        switch (binary_op->op) {
+            case tokenKey::Plus:
+                op = opcode::Add;
+                operand_type = result_type = runtime_arithmetic_type(type1, type2);
+                break;
+
+            case tokenKey::Minus:
+                op = opcode::Sub;
+                operand_type = result_type = runtime_arithmetic_type(type1, type2);
+                break;
+
+            case tokenKey::Mult:
+                op = opcode::Mul;
+                operand_type = result_type = runtime_arithmetic_type(type1, type2);
+                break;
+
+//          Division and exponents always produce floats.
+            case tokenKey::Div:
+                op = opcode::Div;
+                operand_type = result_type = dataType::Float64T;
+                break;
+
+            case tokenKey::Exp:
+                op = opcode::Exp;
+                operand_type = result_type = dataType::Float64T;
+                break;
+
+            case tokenKey::And:
+            case tokenKey::AndW:
+                op = opcode::And;
+                operand_type = dataType::BoolT;
+                break;
+
+            case tokenKey::Or:
+            case tokenKey::OrW:
+                op = opcode::Or;
+                operand_type = dataType::BoolT;
+                break;
+
+            case tokenKey::Xor:
+            case tokenKey::XorW:
+                op = opcode::Xor;
+                operand_type = dataType::BoolT;
+                break;
+
+//          Comparisons convert operands only when their types differ.
+            case tokenKey::Equals:
+            case tokenKey::Is:
+                op = opcode::Eq;
+                operand_type = runtime_merged_type(type1, type2);
+                break;
+
+            case tokenKey::Greater:
+                op = opcode::Gt;
+                operand_type = runtime_merged_type(type1, type2);
+                break;
+
+            case tokenKey::Less:
+                op = opcode::Lt;
+                operand_type = runtime_merged_type(type1, type2);
+                break;
+
+            case tokenKey::GrEqual:
+                op = opcode::Ge;
+                operand_type = runtime_merged_type(type1, type2);
+                break;
+
+            case tokenKey::LessEqual:
+                op = opcode::Le;
+                operand_type = runtime_merged_type(type1, type2);
+                break;
+
+//          Throw an exception when an operator was not recognized (not implemented).
+            default:
+                throw FatalError("binary operator not recognized during IR lowering", line_number);
+        }
+
+        const valueId operand1 = _convert_in(state.ir_function, state.block, value1, operand_type);
+        const valueId operand2 = _convert_in(state.ir_function, state.block, value2, operand_type);
+
+        return _emit(state, op, result_type, {operand1, operand2}, line_number);
+    }
+
+/*
+    Lower an expression into the current block.
+
+    Parameters:
+        value_data: the expression to lower (input)
+        state: lowering state (input/output)
+
+    Return the expression's value.
+*/
+    valueId _lower_value(const valueData* const value_data, _loweringState& state) {
+        const uint32_t line_number = value_data->line_number;
+        function& ir_function = state.ir_function;
+
+        switch (value_data->type) {
+            case nodeType::Int32Container:
+                return ir_function.append(state.block, make_constant(dataType::Int32T, static_cast<const int32Container*>(value_data)->number, 0.0, line_number));
+
+            case nodeType::Int64Container:
+                return ir_function.append(state.block, make_constant(dataType::Int64T, static_cast<const int64Container*>(value_data)->number, 0.0, line_number));
+
+            case nodeType::Float32Container:
+                return ir_function.append(state.block, make_constant(dataType::Float32T, 0, static_cast<const float32Container*>(value_data)->number, line_number));
+
+            case nodeType::Float64Container:
+                return ir_function.append(state.block, make_constant(dataType::Float64T, 0, static_cast<const float64Container*>(value_data)->number, line_number));
+
+            case nodeType::BoolContainer:
+                return ir_function.append(state.block, make_constant(dataType::BoolT, static_cast<const boolContainer*>(value_data)->boolean, 0.0, line_number));
+
+            case nodeType::VarContainer:
+                return _read_variable(state, static_cast<const varContainer*>(value_data)->variable, line_number);
+
+            case nodeType::UnaryOp: {
+                const valueId operand = _lower_value(static_cast<const unaryOp*>(value_data)->expression.get(), state);
+                return _emit(state, opcode::Not, dataType::BoolT, {operand}, line_number);
+            }
+
+            case nodeType::BinaryOp:
+                return _lower_binary(static_cast<const binaryOp*>(value_data), state);
+
+            case nodeType::TernaryOp: {
+//              The second expression of a ternary operator is its condition.
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(value_data);
+                const valueId condition = _lower_value(ternary_op->expression2.get(), state);
+
+//              Branch so that an unchosen value that could raise an error is never evaluated.
+                if (expression_may_raise(ternary_op->expression1.get()) || expression_may_raise(ternary_op->expression3.get())) {
+                    return _lower_conditional(state, condition, [ternary_op, &state]() { return _lower_value(ternary_op->expression1.get(), state); },
+                                              [ternary_op, &state]() { return _lower_value(ternary_op->expression3.get(), state); }, line_number);
+                }
+
+                valueId true_value = _lower_value(ternary_op->expression1.get(), state);
+                valueId false_value = _lower_value(ternary_op->expression3.get(), state);
+                const dataType type = runtime_merged_type(ir_function.values[true_value].type, ir_function.values[false_value].type);
+
+                true_value = _convert_in(ir_function, state.block, true_value, type);
+                false_value = _convert_in(ir_function, state.block, false_value, type);
+
+                return _emit(state, opcode::Select, type, {condition, true_value, false_value}, line_number);
+            }
+
+//          Throw an exception when an expression was not recognized (not implemented).
+            default:
+                throw FatalError("expression not recognized during IR lowering", line_number);
+        }
+    }
+
+/*
+    Lower a statement or list of statements, updating the current value of assigned variables.
+
+    Parameters:
+        data_node: the AST to lower (input)
+        state: lowering state (input/output)
+*/
+    void _lower_node(const dataNode* const data_node, _loweringState& state) {
+        switch (data_node->type) {
+            case nodeType::CodeScope: {
+                const codeScope* const code_scope = static_cast<const codeScope*>(data_node);
+
+//              An empty scope has nothing to lower.
+                if (code_scope->curr_operation != nullptr) {
+                    _lower_node(code_scope->curr_operation.get(), state);
+                    _lower_node(code_scope->remainder.get(), state);
+                }
+                break;
+            }
+
+            case nodeType::AssignOp: {
+                const assignOp* const assign = static_cast<const assignOp*>(data_node);
+                state.variables[assign->variable] = _lower_value(assign->expression.get(), state);
+                break;
+            }
+
+            case nodeType::ReassignOp: {
+                const reassignOp* const reassign = static_cast<const reassignOp*>(data_node);
+                state.variables[reassign->variable] = _lower_value(reassign->expression.get(), state);
+                break;
+            }
+
+            case nodeType::IfBlock: {
+                const ifBlock* const if_block = static_cast<const ifBlock*>(data_node);
+                function& ir_function = state.ir_function;
+                const valueId condition = _lower_value(if_block->bool_condition.get(), state);
+                const blockId branch_block = state.block;
+
+//              Variables declared inside either block go out of scope when the blocks meet.
+                const map<string, valueId> variables_before = state.variables;
+
+                const blockId if_start = ir_function.add_block();
+                ir_function.blocks[if_start].predecessors = {branch_block};
+                state.block = if_start;
+                _lower_node(if_block->code_block.get(), state);
+                const blockId if_end = state.block;
+                const map<string, valueId> if_variables = move(state.variables);
+
+//              Without an 'else' block, a false condition branches straight to the join block.
+                blockId else_start = NO_BLOCK;
+                blockId else_end = branch_block;
+                state.variables = variables_before;
+                if (if_block->contains_else) {
+                    else_start = ir_function.add_block();
+                    ir_function.blocks[else_start].predecessors = {branch_block};
+                    state.block = else_start;
+                    _lower_node(if_block->else_block.get(), state);
+                    else_end = state.block;
+                }
+                const map<string, valueId> else_variables = move(state.variables);
+
+                ir_function.blocks[branch_block].terminator = terminatorType::Branch;
+                ir_function.blocks[branch_block].condition = condition;
+                ir_function.blocks[branch_block].true_target = if_start;
+
+                const blockId join = _join_blocks(ir_function, if_end, else_end);
+                ir_function.blocks[branch_block].false_target = if_block->contains_else ? else_start : join;
+
+//              Merge every variable assigned on both paths. This includes every variable in scope before the blocks,
+//              and outer variables whose dead explicit assignment was removed before both blocks overwrite them.
+                state.block = join;
+                state.variables = variables_before;
+                for (const auto& [variable, if_value] : if_variables) {
+                    const map<string, valueId>::const_iterator else_value = else_variables.find(variable);
+                    if (else_value != else_variables.end()) {
+                        state.variables[variable] = _merge_values(ir_function, join, if_value, else_value->second, if_block->line_number);
+                    }
+                }
+                break;
+            }
+
+//          Throw an exception when a piece of data was not recognized (not implemented).
+            default:
+                throw FatalError("data not recognized during IR lowering", data_node->line_number);
+        }
+
+        return;
+    }
+
+}
+
+
+function lower_to_ir(const shared_ptr<dataNode>& data_node, const shared_ptr<environment>& global_env) {
+    REGAL_TRACE_SPAN("lower_to_ir");
+    function ir_function;
+    ir_function.add_block();
+
+    _loweringState state{ir_function, 0, {}, {}, global_env.get()};
+    _lower_node(data_node.get(), state);
+
+//  The program returns from the block where it ends, with the final value of each global variable.
+    ir_function.blocks[state.block].terminator = terminatorType::Return;
+    for (const auto& [variable, info] : global_env->locals) {
+        ir_function.outputs[variable] = _read_variable(state, variable, 0);
+    }
+
+    return ir_function;
+}
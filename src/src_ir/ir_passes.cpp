@@ -0,0 +1,542 @@
+/*
+
+Function implementations for optimization passes over the SSA intermediate representation.
+
+*/
+
+#include "inc_ir/ir_passes.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <tuple>
+
+// Standard library aliases
+using std::vector, std::map, std::tuple, std::string, std::uint32_t, std::int32_t, std::int64_t, std::uint64_t, std::size_t,
+      std::bit_cast, std::swap, std::make_tuple, std::fabs;
+
+// interp_utils namespaces
+using namespace InterpreterUtils;
+using namespace TypingUtils;
+using namespace CheckedArithmetic;
+
+// ssa namespace
+using namespace IR;
+
+
+// Optimization pass helper functions.
+namespace {
+
+/*
+    Retrieve the final replacement of a value without modifying the replacement table.
+
+    Parameters:
+        replacements: replacement of each value, NO_VALUE if the value is kept (input)
+        value: value to resolve (input)
+
+    Return the value that replaces the given value.
+*/
+    inline valueId _resolve(const vector<valueId>& replacements, valueId value) noexcept {
+        while (replacements[value] != NO_VALUE) {
+            value = replacements[value];
+        }
+
+        return value;
+    }
+
+/*
+    Compute an arithmetic instruction in the given number type, failing where the computation would raise an error at runtime.
+    This function depends on a typename template for the number type of the instruction.
+
+    Parameters:
+        op: arithmetic opcode (input)
+        num1: first operand (input)
+        num2: second operand (input)
+        result: computed value (output)
+
+    Return true if the result was computed.
+*/
+    template <typename T>
+    const bool _fold_arithmetic(const opcode op, const T num1, const T num2, T& result) noexcept {
+        switch (op) {
+            case opcode::Add:
+                return checked_add(num1, num2, result);
+            case opcode::Sub:
+                return checked_sub(num1, num2, result);
+            case opcode::Mul:
+                return checked_mul(num1, num2, result);
+            default:
+                break;
+        }
+
+//      Division and exponentiation only produce floats.
+        if constexpr (std::is_same_v<T, double>) {
+            if (op == opcode::Div) {
+                return checked_div(num1, num2, result);
+            } else if (op == opcode::Exp) {
+                return checked_float_pow(num1, num2, result);
+            }
+        }
+
+        return false;
+    }
+
+/*
+    Compute an integer arithmetic instruction, failing where the computation would raise an error at runtime.
+
+    Parameters:
+        op: arithmetic opcode (input)
+        type: integer type of the result (input)
+        num1: first operand (input)
+        num2: second operand (input)
+        result: computed value (output)
+
+    Return true if the result was computed.
+*/
+    const bool _fold_integer(const opcode op, const dataType type, const int64_t num1, const int64_t num2, int64_t& result) noexcept {
+        if (type == dataType::Int32T) {
+            int32_t narrow_result;
+            if (!_fold_arithmetic<int32_t>(op, static_cast<int32_t>(num1), static_cast<int32_t>(num2), narrow_result)) {
+                return false;
+            }
+
+            result = narrow_result;
+            return true;
+        }
+
+        return _fold_arithmetic<int64_t>(op, num1, num2, result);
+    }
+
+/*
+    Compute a float arithmetic instruction, failing where the computation would raise an error at runtime.
+
+    Parameters:
+        op: arithmetic opcode (input)
+        type: float type of the result (input)
+        num1: first operand (input)
+        num2: second operand (input)
+        result: computed value (output)
+
+    Return true if the result was computed.
+*/
+    const bool _fold_float(const opcode op, const dataType type, const double num1, const double num2, double& result) noexcept {
+        if ((type == dataType::Float32T) && (op != opcode::Div) && (op != opcode::Exp)) {
+            float narrow_result;
+            if (!_fold_arithmetic<float>(op, static_cast<float>(num1), static_cast<float>(num2), narrow_result)) {
+                return false;
+            }
+
+            result = static_cast<double>(narrow_result);
+            return true;
+        }
+
+        if (!_fold_arithmetic<double>(op, num1, num2, result)) {
+            return false;
+        }
+
+        if (type == dataType::Float32T) {
+            result = static_cast<double>(static_cast<float>(result));
+            return exact(static_cast<float>(result));
+        }
+        return true;
+    }
+
+/*
+    Compare two constants of the same type.
+
+    Parameters:
+        op: comparison opcode (input)
+        type: type of both constants (input)
+        constant1: first constant (input)
+        constant2: second constant (input)
+
+    Return the result of the comparison.
+*/
+    const bool _compare(const opcode op, const dataType type, const constantValue& constant1, const constantValue& constant2) noexcept {
+//      Booleans and integers compare by their integer value.
+        const bool floats = (type == dataType::Float32T) || (type == dataType::Float64T);
+        const double float1 = floats ? constant1.float_value : 0.0;
+        const double float2 = floats ? constant2.float_value : 0.0;
+        const int64_t int1 = constant1.int_value;
+        const int64_t int2 = constant2.int_value;
+
+        switch (op) {
+            case opcode::Eq:
+                return floats ? (float1 == float2) : (int1 == int2);
+            case opcode::Gt:
+                return floats ? (float1 > float2) : (int1 > int2);
+            case opcode::Lt:
+                return floats ? (float1 < float2) : (int1 < int2);
+            case opcode::Ge:
+                return floats ? (float1 >= float2) : (int1 >= int2);
+            default:
+                return floats ? (float1 <= float2) : (int1 <= int2);
+        }
+    }
+
+/*
+    Compute an instruction whose operands are all constants.
+
+    Parameters:
+        current: instruction to compute, with resolved operands (input)
+        values: every instruction in the function (input)
+        result: computed constant (output)
+
+    Return true if the instruction was computed without raising an error.
+*/
+    const bool _fold_instruction(const instruction& current, const vector<instruction>& values, constantValue& result) noexcept {
+        for (const valueId operand : current.operands) {
+            if (values[operand].op != opcode::Const) {
+                return false;
+            }
+        }
+
+        result = constantValue{0, 0.0};
+        const dataType type = current.type;
+
+        switch (current.op) {
+            case opcode::Convert: {
+                const instruction& operand = values[current.operands[0]];
+
+                if (integer_type(operand.type) && integer_type(type)) {
+                    result.int_value = operand.constant.int_value;
+                    return (type != dataType::Int32T) || ((result.int_value >= MIN_INT32) && (result.int_value <= MAX_INT32));
+                }
+                if (integer_type(type)) {
+//                  Conversions from floats to integers are not produced by lowering.
+                    return false;
+                }
+
+                const double number = integer_type(operand.type) ? static_cast<double>(operand.constant.int_value) : operand.constant.float_value;
+                if (type == dataType::Float32T) {
+                    result.float_value = static_cast<double>(static_cast<float>(number));
+                    return fabs(number) <= MAX_ACCURATE_FLOAT32;
+                }
+                result.float_value = number;
+                return true;
+            }
+
+//          Every path into the block produces the same constant.
+            case opcode::Phi:
+                result = values[current.operands[0]].constant;
+                return std::all_of(current.operands.begin(), current.operands.end(), [&values, &result](const valueId operand) {
+                    const constantValue& constant = values[operand].constant;
+                    return (constant.int_value == result.int_value) && (bit_cast<uint64_t>(constant.float_value) == bit_cast<uint64_t>(result.float_value));
+                });
+
+            case opcode::Not:
+                result.int_value = !values[current.operands[0]].constant.int_value;
+                return true;
+
+            case opcode::And:
+            case opcode::Or:
+            case opcode::Xor: {
+                const bool bool1 = values[current.operands[0]].constant.int_value;
+                const bool bool2 = values[current.operands[1]].constant.int_value;
+                result.int_value = (current.op == opcode::And) ? (bool1 && bool2) : ((current.op == opcode::Or) ? (bool1 || bool2) : (bool1 != bool2));
+                return true;
+            }
+
+            case opcode::Add:
+            case opcode::Sub:
+            case opcode::Mul:
+            case opcode::Div:
+            case opcode::Exp: {
+                const constantValue& constant1 = values[current.operands[0]].constant;
+                const constantValue& constant2 = values[current.operands[1]].constant;
+
+                if (integer_type(type)) {
+                    return _fold_integer(current.op, type, constant1.int_value, constant2.int_value, result.int_value);
+                }
+                return _fold_float(current.op, type, constant1.float_value, constant2.float_value, result.float_value);
+            }
+
+            case opcode::Eq:
+            case opcode::Gt:
+            case opcode::Lt:
+            case opcode::Ge:
+            case opcode::Le: {
+                const instruction& operand1 = values[current.operands[0]];
+                result.int_value = _compare(current.op, operand1.type, operand1.constant, values[current.operands[1]].constant);
+                return true;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+/*
+    Remove every block that can no longer be reached from the entry block, along with its instructions and edges.
+
+    Parameters:
+        ir_function: function to clean up (input/output)
+
+    Return true if a block was removed.
+*/
+    const bool _remove_unreachable(function& ir_function) {
+        vector<bool> reached(ir_function.blocks.size(), false);
+        for (const blockId block : ir_function.reverse_postorder()) {
+            reached[block] = true;
+        }
+
+        bool changed = false;
+        for (blockId block = 0; block < ir_function.blocks.size(); block++) {
+            basicBlock& current = ir_function.blocks[block];
+            if (reached[block] || !current.reachable) {
+                continue;
+            }
+
+            for (const blockId successor : ir_function.successors(block)) {
+                ir_function.remove_edge(block, successor);
+            }
+            for (const valueId value : current.instructions) {
+                ir_function.values[value].op = opcode::Nop;
+                ir_function.values[value].operands.clear();
+            }
+
+            current.instructions.clear();
+            current.predecessors.clear();
+            current.terminator = terminatorType::Return;
+            current.condition = NO_VALUE;
+            current.reachable = false;
+            changed = true;
+        }
+
+        return changed;
+    }
+
+//  Key identifying the value computed by a pure instruction.
+    using _valueKey = tuple<opcode, dataType, vector<valueId>, int64_t, uint64_t, string>;
+
+/*
+    Number the values of the given block and of every block it dominates, depth first.
+    Instructions matching a value already numbered in a dominating block are replaced by that value.
+
+    Parameters:
+        ir_function: function being optimized (input/output)
+        block: block to number (input)
+        children: blocks immediately dominated by each block (input)
+        available: values computed in the dominating blocks, by key (input/output)
+        replacements: replacement of each value (input/output)
+
+    Return true if an instruction was replaced.
+*/
+    const bool _number_block(function& ir_function, const blockId block, const vector<vector<blockId>>& children,
+                             map<_valueKey, valueId>& available, vector<valueId>& replacements) {
+        vector<map<_valueKey, valueId>::iterator> added;
+        bool changed = false;
+
+//      Copy the instruction list, since replaced instructions are removed from it.
+        const vector<valueId> block_instructions = ir_function.blocks[block].instructions;
+        for (const valueId value : block_instructions) {
+            instruction& current = ir_function.values[value];
+            for (valueId& operand : current.operands) {
+                operand = _resolve(replacements, operand);
+            }
+
+            if (!pure_instruction(current)) {
+                continue;
+            }
+
+            vector<valueId> operands = current.operands;
+            switch (current.op) {
+//              Commutative operators compute the same value with their operands in either order.
+                case opcode::Add:
+                case opcode::Mul:
+                case opcode::And:
+                case opcode::Or:
+                case opcode::Xor:
+                case opcode::Eq:
+                    if (operands[0] > operands[1]) {
+                        swap(operands[0], operands[1]);
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            _valueKey key = make_tuple(current.op, current.type, operands, current.constant.int_value,
+                                       bit_cast<uint64_t>(current.constant.float_value), current.variable);
+            const auto [iter, inserted] = available.try_emplace(key, value);
+
+            if (inserted) {
+                added.push_back(iter);
+            } else {
+                replacements[value] = iter->second;
+                ir_function.remove_instruction(value);
+                changed = true;
+            }
+        }
+
+        for (const blockId child : children[block]) {
+            changed |= _number_block(ir_function, child, children, available, replacements);
+        }
+
+//      Values of this block are not available to blocks it does not dominate.
+        for (const map<_valueKey, valueId>::iterator& iter : added) {
+            available.erase(iter);
+        }
+
+        return changed;
+    }
+
+}
+
+
+const bool propagate_constants(function& ir_function) {
+    vector<valueId> replacements(ir_function.values.size(), NO_VALUE);
+    bool changed = false;
+
+//  Definitions come before their uses in reverse postorder.
+    for (const blockId block : ir_function.reverse_postorder()) {
+        const vector<valueId> block_instructions = ir_function.blocks[block].instructions;
+
+        for (const valueId value : block_instructions) {
+            instruction& current = ir_function.values[value];
+            for (valueId& operand : current.operands) {
+                operand = _resolve(replacements, operand);
+            }
+
+//          A phi whose operands all match, or a select on a constant or between matching values, is a copy.
+            valueId copied = NO_VALUE;
+            if (current.op == opcode::Phi) {
+                const bool same = std::all_of(current.operands.begin(), current.operands.end(), [&current](const valueId operand) {
+                    return operand == current.operands[0];
+                });
+                copied = (same && !current.operands.empty()) ? current.operands[0] : NO_VALUE;
+            } else if (current.op == opcode::Select) {
+                const instruction& condition = ir_function.values[current.operands[0]];
+                if (condition.op == opcode::Const) {
+                    copied = condition.constant.int_value ? current.operands[1] : current.operands[2];
+                } else if (current.operands[1] == current.operands[2]) {
+                    copied = current.operands[1];
+                }
+            }
+
+            if (copied != NO_VALUE) {
+                replacements[value] = copied;
+                ir_function.remove_instruction(value);
+                changed = true;
+                continue;
+            }
+
+            constantValue result;
+            if ((current.op != opcode::Const) && _fold_instruction(current, ir_function.values, result)) {
+//              Phi instructions stay at the start of their block, so a folded phi moves after them.
+                if (current.op == opcode::Phi) {
+                    vector<valueId>& instructions = ir_function.blocks[block].instructions;
+                    instructions.erase(std::find(instructions.begin(), instructions.end(), value));
+                    instructions.insert(std::find_if(instructions.begin(), instructions.end(), [&ir_function](const valueId other) {
+                        return ir_function.values[other].op != opcode::Phi;
+                    }), value);
+                }
+
+                current.op = opcode::Const;
+                current.operands.clear();
+                current.constant = result;
+                changed = true;
+            }
+        }
+    }
+
+    ir_function.replace_values(replacements);
+
+//  Branches on constant conditions always take the same target.
+    for (blockId block = 0; block < ir_function.blocks.size(); block++) {
+        basicBlock& current = ir_function.blocks[block];
+        if (!current.reachable || (current.terminator != terminatorType::Branch)) {
+            continue;
+        }
+
+        const instruction& condition = ir_function.values[current.condition];
+        if (condition.op != opcode::Const) {
+            continue;
+        }
+
+        const blockId taken = condition.constant.int_value ? current.true_target : current.false_target;
+        const blockId skipped = condition.constant.int_value ? current.false_target : current.true_target;
+
+        current.terminator = terminatorType::Jump;
+        current.condition = NO_VALUE;
+        current.true_target = taken;
+        current.false_target = NO_BLOCK;
+        if (skipped != taken) {
+            ir_function.remove_edge(block, skipped);
+        }
+        changed = true;
+    }
+
+    changed |= _remove_unreachable(ir_function);
+    return changed;
+}
+
+const bool number_values(function& ir_function) {
+    const vector<blockId> idoms = ir_function.immediate_dominators();
+    vector<vector<blockId>> children(ir_function.blocks.size());
+    vector<valueId> replacements(ir_function.values.size(), NO_VALUE);
+    map<_valueKey, valueId> available;
+
+//  Children are visited in block order, which keeps definitions before their uses.
+    for (blockId block = 1; block < ir_function.blocks.size(); block++) {
+        if (idoms[block] != NO_BLOCK) {
+            children[idoms[block]].push_back(block);
+        }
+    }
+
+    const bool changed = _number_block(ir_function, 0, children, available, replacements);
+    ir_function.replace_values(replacements);
+
+    return changed;
+}
+
+const bool eliminate_dead_code(function& ir_function) {
+    vector<bool> live(ir_function.values.size(), false);
+    vector<valueId> worklist;
+
+    const auto mark = [&live, &worklist](const valueId value) {
+        if (!live[value]) {
+            live[value] = true;
+            worklist.push_back(value);
+        }
+    };
+
+//  Values are needed by the outputs, by branches, and by instructions that could raise an error.
+    for (const auto& [variable, value] : ir_function.outputs) {
+        mark(value);
+    }
+    for (const basicBlock& block : ir_function.blocks) {
+        if (!block.reachable) {
+            continue;
+        }
+        if (block.terminator == terminatorType::Branch) {
+            mark(block.condition);
+        }
+        for (const valueId value : block.instructions) {
+            if (may_raise(ir_function.values[value])) {
+                mark(value);
+            }
+        }
+    }
+
+    while (!worklist.empty()) {
+        const valueId value = worklist.back();
+        worklist.pop_back();
+
+        for (const valueId operand : ir_function.values[value].operands) {
+            mark(operand);
+        }
+    }
+
+    bool changed = false;
+    for (basicBlock& block : ir_function.blocks) {
+        const vector<valueId> block_instructions = block.instructions;
+        for (const valueId value : block_instructions) {
+            if (!live[value]) {
+                ir_function.remove_instruction(value);
+                changed = true;
+            }
+        }
+    }
+
+    return changed;
+}
@@ -0,0 +1,64 @@
+/*
+
+Function implementations for scheduling optimization passes over the SSA intermediate representation.
+
+*/
+
+#include "inc_ir/pass_manager.hpp"
+#include "inc_ir/ir_passes.hpp"
+#include "inc_ir/range_analysis.hpp"
+#include "inc_internal/tracing.hpp"
+
+// Standard library aliases
+using std::string, std::uint32_t, std::size_t, std::move;
+
+// ssa namespace
+using namespace IR;
+
+
+void passManager::add_pass(const string& name, std::function<const bool(function&)> pass) {
+    passes.push_back(move(pass));
+    records.push_back(passRecord{name, 0, 0});
+
+    return;
+}
+
+const uint32_t passManager::run(function& ir_function, const uint32_t max_rounds) {
+    REGAL_TRACE_SPAN("passManager::run");
+    uint32_t rounds = 0;
+    bool changed = true;
+
+    while (changed && (rounds < max_rounds)) {
+        changed = false;
+        rounds++;
+
+        for (size_t index = 0; index < passes.size(); index++) {
+            records[index].runs++;
+            if (!passes[index](ir_function)) {
+                continue;
+            }
+
+            records[index].changes++;
+            changed = true;
+
+#ifndef NDEBUG
+//          Catch a pass that broke the function as soon as it happens.
+            verify_function(ir_function);
+#endif
+        }
+    }
+
+    return rounds;
+}
+
+
+passManager standard_pipeline() {
+    passManager manager;
+
+    manager.add_pass("constant-propagation", propagate_constants);
+    manager.add_pass("global-value-numbering", number_values);
+    manager.add_pass("type-narrowing", narrow_types);
+    manager.add_pass("dead-code-elimination", eliminate_dead_code);
+
+    return manager;
+}
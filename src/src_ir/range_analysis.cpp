@@ -0,0 +1,604 @@
+/*
+
+Function implementations for value-range analysis over the SSA intermediate representation.
+
+*/
+
+#include "inc_ir/range_analysis.hpp"
+
+#include <algorithm>
+
+// Standard library aliases
+using std::vector, std::pair, std::uint32_t, std::size_t, std::numeric_limits, std::min, std::max, std::min_element,
+      std::max_element, std::isnan, std::ceil, std::floor, std::trunc, std::move;
+
+// interp_utils namespaces
+using namespace InterpreterUtils;
+using namespace TypingUtils;
+
+// ssa namespace
+using namespace IR;
+
+
+// Range analysis helper functions.
+namespace {
+
+    constexpr double INF = numeric_limits<double>::infinity();
+
+//  Ranges known to hold in a block, later entries refine earlier ones.
+    using _facts = vector<pair<valueId, valueRange>>;
+
+//  State carried through the narrowing of a function.
+    struct _narrowingState {
+//      the function being narrowed
+        function& ir_function;
+//      range of each value where it is defined
+        vector<valueRange> ranges;
+//      replacement of each removed value
+        vector<valueId> replacements;
+//      true once the function has changed
+        bool changed;
+    };
+
+/*
+    Retrieve the range of every value of the given type.
+
+    Parameters:
+        type: type to retrieve the range of (input)
+
+    Return the type's range.
+*/
+    const valueRange _type_range(const dataType type) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                return valueRange{static_cast<double>(MIN_INT32), static_cast<double>(MAX_INT32), true};
+            case dataType::Int64T:
+                return valueRange{static_cast<double>(MIN_INT64), static_cast<double>(MAX_INT64), true};
+            case dataType::BoolT:
+                return valueRange{0.0, 1.0, true};
+            default:
+                return valueRange{-INF, INF, false};
+        }
+    }
+
+/*
+    Determine if every value in the given range is held exactly by the given type.
+
+    Parameters:
+        range: range to check (input)
+        type: type to check against (input)
+
+    Return true if the type holds the range.
+*/
+    inline const bool _fits(const valueRange& range, const dataType type) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                return range.integral && (range.low >= MIN_INT32) && (range.high <= MAX_INT32);
+            case dataType::Float32T:
+                return range.integral && (range.low >= MIN_ACCURATE_FLOAT32) && (range.high <= MAX_ACCURATE_FLOAT32);
+            default:
+                return true;
+        }
+    }
+
+/*
+    Retrieve the 32-bit type of a number type's kind (integer or float).
+
+    Parameters:
+        type: type to narrow (input)
+
+    Return the narrow type, or the given type if it is not a number.
+*/
+    inline const dataType _narrow_type(const dataType type) noexcept {
+        if (integer_type(type)) {
+            return dataType::Int32T;
+        }
+        return ((type == dataType::Float32T) || (type == dataType::Float64T)) ? dataType::Float32T : type;
+    }
+
+/*
+    Retrieve the 64-bit type of a number type's kind (integer or float).
+
+    Parameters:
+        type: type to widen (input)
+
+    Return the wide type, or the given type if it is not a number.
+*/
+    inline const dataType _wide_type(const dataType type) noexcept {
+        if (integer_type(type)) {
+            return dataType::Int64T;
+        }
+        return ((type == dataType::Float32T) || (type == dataType::Float64T)) ? dataType::Float64T : type;
+    }
+
+/*
+    Retrieve the range of a value in a block, using the facts known in that block.
+
+    Parameters:
+        facts: facts known in the block (input)
+        ranges: range of each value where it is defined (input)
+        value: value to retrieve the range of (input)
+
+    Return the value's range.
+*/
+    const valueRange _lookup(const _facts& facts, const vector<valueRange>& ranges, const valueId value) noexcept {
+        for (_facts::const_reverse_iterator iter = facts.rbegin(); iter != facts.rend(); iter++) {
+            if (iter->first == value) {
+                return iter->second;
+            }
+        }
+
+        return ranges[value];
+    }
+
+/*
+    Compute the range of an arithmetic result from the ranges of its operands.
+
+    Parameters:
+        op: arithmetic opcode (input)
+        range1: range of the first operand (input)
+        range2: range of the second operand (input)
+
+    Return the result's range.
+*/
+    const valueRange _arithmetic_range(const opcode op, const valueRange& range1, const valueRange& range2) noexcept {
+        bool integral = range1.integral && range2.integral;
+        double low, high;
+
+        switch (op) {
+            case opcode::Add:
+                low = range1.low + range2.low;
+                high = range1.high + range2.high;
+                break;
+
+            case opcode::Sub:
+                low = range1.low - range2.high;
+                high = range1.high - range2.low;
+                break;
+
+            case opcode::Mul:
+            case opcode::Div: {
+//              A divisor range containing 0 leaves the quotient unbounded.
+                if ((op == opcode::Div) && (range2.low <= 0.0) && (range2.high >= 0.0)) {
+                    return valueRange{-INF, INF, false};
+                }
+
+//              The extremes of a product or quotient are at the corners of the operand ranges.
+                const double corners[4] = {
+                    (op == opcode::Mul) ? range1.low * range2.low : range1.low / range2.low,
+                    (op == opcode::Mul) ? range1.low * range2.high : range1.low / range2.high,
+                    (op == opcode::Mul) ? range1.high * range2.low : range1.high / range2.low,
+                    (op == opcode::Mul) ? range1.high * range2.high : range1.high / range2.high
+                };
+                if (std::any_of(corners, corners + 4, [](const double corner) { return isnan(corner); })) {
+                    return valueRange{-INF, INF, integral && (op == opcode::Mul)};
+                }
+
+                low = *min_element(corners, corners + 4);
+                high = *max_element(corners, corners + 4);
+                integral = integral && (op == opcode::Mul);
+                break;
+            }
+
+//          Exponents are left unbounded.
+            default:
+                return valueRange{-INF, INF, false};
+        }
+
+        if (isnan(low) || isnan(high)) {
+            return valueRange{-INF, INF, integral};
+        }
+        return valueRange{low, high, integral};
+    }
+
+/*
+    Record that a value lies within the given range in the current block.
+    A value converted from another number has the same value, so the source is bounded as well.
+
+    Parameters:
+        ir_function: function being analyzed (input)
+        value: value that is bounded (input)
+        range: bounds of the value (input)
+        facts: facts known in the current block (input/output)
+        ranges: range of each value where it is defined (input)
+*/
+    void _add_fact(const function& ir_function, const valueId value, const valueRange& range, _facts& facts, const vector<valueRange>& ranges) {
+        const valueRange current = _lookup(facts, ranges, value);
+        const valueRange refined{max(range.low, current.low), min(range.high, current.high), current.integral};
+        facts.push_back({value, refined});
+
+        const instruction& defined = ir_function.values[value];
+        if (defined.op == opcode::Convert) {
+            const valueId source = defined.operands[0];
+            if (integer_type(ir_function.values[source].type)) {
+                _add_fact(ir_function, source, valueRange{ceil(refined.low), floor(refined.high), true}, facts, ranges);
+            } else {
+                _add_fact(ir_function, source, refined, facts, ranges);
+            }
+        }
+
+        return;
+    }
+
+/*
+    Record the ranges implied by a condition having the given truth value, e.g. 'x > 3' being true implies x >= 4
+    for an integer x. Only comparisons, their negations, and their conjunctions (or negated disjunctions) imply ranges.
+
+    Parameters:
+        ir_function: function being analyzed (input)
+        condition: boolean value with a known truth value (input)
+        truth: the truth value of the condition (input)
+        facts: facts known in the current block (input/output)
+        ranges: range of each value where it is defined (input)
+*/
+    void _add_condition_facts(const function& ir_function, const valueId condition, const bool truth, _facts& facts, const vector<valueRange>& ranges) {
+        const instruction& current = ir_function.values[condition];
+
+        switch (current.op) {
+            case opcode::Not:
+                _add_condition_facts(ir_function, current.operands[0], !truth, facts, ranges);
+                return;
+
+//          Both operands of a true 'and' or a false 'or' share its truth value.
+            case opcode::And:
+            case opcode::Or:
+                if (truth == (current.op == opcode::And)) {
+                    _add_condition_facts(ir_function, current.operands[0], truth, facts, ranges);
+                    _add_condition_facts(ir_function, current.operands[1], truth, facts, ranges);
+                }
+                return;
+
+            case opcode::Eq:
+            case opcode::Gt:
+            case opcode::Lt:
+            case opcode::Ge:
+            case opcode::Le:
+                break;
+
+            default:
+                return;
+        }
+
+        const valueId value1 = current.operands[0];
+        const valueId value2 = current.operands[1];
+        if (ir_function.values[value1].type == dataType::BoolT) {
+            return;
+        }
+
+//      A false comparison is the opposite comparison being true, but values that are not equal have no range.
+        opcode op = current.op;
+        if (!truth) {
+            switch (op) {
+                case opcode::Gt:
+                    op = opcode::Le;
+                    break;
+                case opcode::Lt:
+                    op = opcode::Ge;
+                    break;
+                case opcode::Ge:
+                    op = opcode::Lt;
+                    break;
+                case opcode::Le:
+                    op = opcode::Gt;
+                    break;
+                default:
+                    return;
+            }
+        }
+
+        const valueRange range1 = _lookup(facts, ranges, value1);
+        const valueRange range2 = _lookup(facts, ranges, value2);
+//      Strict comparisons between whole numbers exclude the bound.
+        const double step = (range1.integral && range2.integral) ? 1.0 : 0.0;
+        valueRange bound1 = range1;
+        valueRange bound2 = range2;
+
+        switch (op) {
+            case opcode::Gt:
+                bound1.low = range2.low + step;
+                bound2.high = range1.high - step;
+                break;
+            case opcode::Ge:
+                bound1.low = range2.low;
+                bound2.high = range1.high;
+                break;
+            case opcode::Lt:
+                bound1.high = range2.high - step;
+                bound2.low = range1.low + step;
+                break;
+            case opcode::Le:
+                bound1.high = range2.high;
+                bound2.low = range1.low;
+                break;
+            default:
+                bound1.low = bound2.low = max(range1.low, range2.low);
+                bound1.high = bound2.high = min(range1.high, range2.high);
+                break;
+        }
+
+        _add_fact(ir_function, value1, bound1, facts, ranges);
+        _add_fact(ir_function, value2, bound2, facts, ranges);
+
+        return;
+    }
+
+/*
+    Create a value that is not yet listed in any block.
+
+    Parameters:
+        state: narrowing state (input/output)
+        new_instruction: instruction defining the value (input)
+        block: block the value will be listed in (input)
+        range: range of the value (input)
+
+    Return the new value.
+*/
+    valueId _new_value(_narrowingState& state, instruction&& new_instruction, const blockId block, const valueRange& range) {
+        const valueId value = static_cast<valueId>(state.ir_function.values.size());
+
+        new_instruction.block = block;
+        state.ir_function.values.push_back(move(new_instruction));
+        state.ranges.push_back(range);
+        state.replacements.push_back(NO_VALUE);
+        state.changed = true;
+
+        return value;
+    }
+
+/*
+    Retrieve the given value as the given type, converting it if its type differs.
+    The value's range must fit the given type. Constants are recreated in the new type, and converted values
+    are converted again from their source.
+
+    Parameters:
+        state: narrowing state (input/output)
+        value: value to provide (input)
+        type: type the value is needed in (input)
+        block: block the value is needed in (input)
+        range: range of the value in that block (input)
+        listed: instructions to add a new value to, or nullptr to add it to the end of the block (output)
+
+    Return a value of the given type.
+*/
+    valueId _provide(_narrowingState& state, valueId value, const dataType type, const blockId block, const valueRange& range, vector<valueId>* const listed) {
+        if (state.ir_function.values[value].type == type) {
+            return value;
+        }
+
+        const instruction defined = state.ir_function.values[value];
+        valueId provided;
+
+        if (defined.op == opcode::Const) {
+            const bool from_integer = integer_type(defined.type);
+            const bool to_integer = integer_type(type);
+            const int64_t int_value = from_integer ? defined.constant.int_value : static_cast<int64_t>(defined.constant.float_value);
+            const double float_value = from_integer ? static_cast<double>(defined.constant.int_value) : defined.constant.float_value;
+
+            provided = _new_value(state, make_constant(type, to_integer ? int_value : 0, to_integer ? 0.0 : float_value, defined.line_number), block, range);
+        } else {
+//          Convert from the original source rather than converting twice.
+            if (defined.op == opcode::Convert) {
+                value = defined.operands[0];
+                if (state.ir_function.values[value].type == type) {
+                    return value;
+                }
+            }
+
+            provided = _new_value(state, instruction{opcode::Convert, type, {value}, constantValue{0, 0.0}, "", NO_BLOCK, defined.line_number}, block, range);
+        }
+
+        if (listed != nullptr) {
+            listed->push_back(provided);
+        } else {
+            state.ir_function.blocks[block].instructions.push_back(provided);
+        }
+
+        return provided;
+    }
+
+/*
+    Retrieve the range of an instruction's result and the type it should have.
+
+    Parameters:
+        state: narrowing state (input)
+        value: the instruction (input)
+        facts: facts known in the instruction's block (input)
+        range: range of the result (output)
+
+    Return the type the instruction should have, its current type if it cannot be narrowed.
+*/
+    const dataType _choose_type(const _narrowingState& state, const valueId value, const _facts& facts, valueRange& range) {
+        const function& ir_function = state.ir_function;
+        const instruction& current = ir_function.values[value];
+        const vector<valueId>& operands = current.operands;
+        const auto operand_range = [&](const size_t index) {
+            return _lookup(facts, state.ranges, operands[index]);
+        };
+
+        switch (current.op) {
+            case opcode::Const:
+                if (current.type == dataType::BoolT) {
+                    range = valueRange{0.0, 1.0, true};
+                } else if (integer_type(current.type)) {
+                    const double number = static_cast<double>(current.constant.int_value);
+                    range = valueRange{number, number, true};
+                } else {
+                    const double number = current.constant.float_value;
+                    range = valueRange{number, number, trunc(number) == number};
+                }
+                return current.type;
+
+            case opcode::Input:
+                range = _type_range(current.type);
+                return current.type;
+
+            case opcode::Convert: {
+                const valueRange source = operand_range(0);
+                range = valueRange{source.low, source.high, source.integral || integer_type(current.type)};
+                return current.type;
+            }
+
+            case opcode::Add:
+            case opcode::Sub:
+            case opcode::Mul:
+            case opcode::Div:
+            case opcode::Exp: {
+                const valueRange type_bounds = _type_range(_wide_type(current.type));
+                const valueRange result = _arithmetic_range(current.op, operand_range(0), operand_range(1));
+
+//              Results outside of the type raise an error, so every result that continues fits the type.
+                range = valueRange{max(result.low, type_bounds.low), min(result.high, type_bounds.high), result.integral};
+
+                const dataType narrow = _narrow_type(current.type);
+                const bool narrowable = _fits(range, narrow) && _fits(operand_range(0), narrow) && _fits(operand_range(1), narrow);
+                return narrowable ? narrow : _wide_type(current.type);
+            }
+
+            case opcode::Select: {
+                const valueRange range1 = operand_range(1);
+                const valueRange range2 = operand_range(2);
+                range = valueRange{min(range1.low, range2.low), max(range1.high, range2.high), range1.integral && range2.integral};
+
+                return _fits(range, _narrow_type(current.type)) ? _narrow_type(current.type) : _wide_type(current.type);
+            }
+
+            case opcode::Phi: {
+                range = valueRange{INF, -INF, true};
+
+//              Only the range where each operand is defined is used, as the facts of the predecessors may not dominate it.
+                for (size_t index = 0; index < operands.size(); index++) {
+                    const valueRange incoming = state.ranges[operands[index]];
+                    range = valueRange{min(range.low, incoming.low), max(range.high, incoming.high), range.integral && incoming.integral};
+                }
+
+                return _fits(range, _narrow_type(current.type)) ? _narrow_type(current.type) : _wide_type(current.type);
+            }
+
+            default:
+                range = _type_range(dataType::BoolT);
+                return current.type;
+        }
+    }
+
+}
+
+
+const bool narrow_types(function& ir_function) {
+    _narrowingState state{ir_function, vector<valueRange>(ir_function.values.size(), valueRange{-INF, INF, false}),
+                          vector<valueId>(ir_function.values.size(), NO_VALUE), false};
+    vector<_facts> facts(ir_function.blocks.size());
+    const vector<blockId> idoms = ir_function.immediate_dominators();
+
+//  Definitions and predecessors come before their uses in reverse postorder.
+    for (const blockId block : ir_function.reverse_postorder()) {
+//      Facts of dominating blocks hold here, as do the facts of the branch into this block.
+        _facts& block_facts = facts[block];
+        if (idoms[block] != NO_BLOCK) {
+            block_facts = facts[idoms[block]];
+        }
+
+        if (ir_function.blocks[block].predecessors.size() == 1) {
+            const basicBlock& predecessor = ir_function.blocks[ir_function.blocks[block].predecessors[0]];
+            if ((predecessor.terminator == terminatorType::Branch) && (predecessor.true_target != predecessor.false_target)) {
+                _add_condition_facts(ir_function, predecessor.condition, predecessor.true_target == block, block_facts, state.ranges);
+            }
+        }
+
+//      Rebuild the block's instructions, listing new conversions before the instructions that use them.
+        const vector<valueId> block_instructions = ir_function.blocks[block].instructions;
+        vector<valueId> rebuilt;
+
+        for (const valueId value : block_instructions) {
+            for (valueId& operand : ir_function.values[value].operands) {
+                while (state.replacements[operand] != NO_VALUE) {
+                    operand = state.replacements[operand];
+                }
+            }
+
+            valueRange range;
+            const dataType type = _choose_type(state, value, block_facts, range);
+            state.ranges[value] = range;
+
+            const opcode op = ir_function.values[value].op;
+            if (type != ir_function.values[value].type) {
+                ir_function.values[value].type = type;
+                state.changed = true;
+            }
+
+            switch (op) {
+//              A conversion to the type its operand already has is not needed.
+                case opcode::Convert: {
+                    const valueId operand = ir_function.values[value].operands[0];
+                    if (ir_function.values[operand].type == type) {
+                        state.replacements[value] = operand;
+                        ir_function.values[value].op = opcode::Nop;
+                        ir_function.values[value].operands.clear();
+                        state.changed = true;
+                        continue;
+                    }
+                    break;
+                }
+
+//              Phi operands are converted at the end of their predecessors.
+                case opcode::Phi: {
+                    const vector<blockId> predecessors = ir_function.blocks[block].predecessors;
+                    for (size_t index = 0; index < predecessors.size(); index++) {
+                        const valueId operand = ir_function.values[value].operands[index];
+                        const valueId provided = _provide(state, operand, type, predecessors[index], state.ranges[operand], nullptr);
+                        ir_function.values[value].operands[index] = provided;
+                    }
+                    break;
+                }
+
+                case opcode::Add:
+                case opcode::Sub:
+                case opcode::Mul:
+                case opcode::Div:
+                case opcode::Exp:
+                case opcode::Select: {
+                    const size_t first = (op == opcode::Select) ? 1 : 0;
+                    for (size_t index = first; index < ir_function.values[value].operands.size(); index++) {
+                        const valueId operand = ir_function.values[value].operands[index];
+                        const valueId provided = _provide(state, operand, type, block, _lookup(block_facts, state.ranges, operand), &rebuilt);
+                        ir_function.values[value].operands[index] = provided;
+                    }
+                    break;
+                }
+
+//              Comparisons use the narrow type when both operands fit it, otherwise the wide type.
+                case opcode::Eq:
+                case opcode::Gt:
+                case opcode::Lt:
+                case opcode::Ge:
+                case opcode::Le: {
+                    const valueId operand1 = ir_function.values[value].operands[0];
+                    const valueId operand2 = ir_function.values[value].operands[1];
+                    const dataType type1 = ir_function.values[operand1].type;
+                    const dataType type2 = ir_function.values[operand2].type;
+                    if (type1 == dataType::BoolT) {
+                        break;
+                    }
+
+                    const valueRange range1 = _lookup(block_facts, state.ranges, operand1);
+                    const valueRange range2 = _lookup(block_facts, state.ranges, operand2);
+                    const dataType narrow = _narrow_type(type1);
+                    const dataType compared = (_fits(range1, narrow) && _fits(range2, narrow)) ? narrow : ((type1 == type2) ? type1 : _wide_type(type1));
+
+                    ir_function.values[value].operands[0] = _provide(state, operand1, compared, block, range1, &rebuilt);
+                    ir_function.values[value].operands[1] = _provide(state, operand2, compared, block, range2, &rebuilt);
+                    break;
+                }
+
+                default:
+                    break;
+            }
+
+            rebuilt.push_back(value);
+        }
+
+        ir_function.blocks[block].instructions = move(rebuilt);
+    }
+
+    ir_function.replace_values(state.replacements);
+    return state.changed;
+}
@@ -0,0 +1,525 @@
+/*
+
+Function implementations for the SSA intermediate representation.
+
+*/
+
+#include "inc_ir/ssa.hpp"
+#include "inc_internal/error_handling.hpp"
+
+#include <algorithm>
+
+// Standard library aliases
+using std::vector, std::string, std::to_string, std::uint32_t, std::int64_t, std::size_t,
+      std::move, std::find, std::reverse;
+
+// interp_utils namespaces
+using namespace InterpreterUtils;
+using namespace TypingUtils;
+
+// ssa namespace
+using namespace IR;
+
+
+// SSA utility helper functions.
+namespace {
+
+/*
+    Retrieve the short IR name of a data type.
+
+    Parameters:
+        type: type to name (input)
+
+    Return the type's name.
+*/
+    const char* _type_name(const dataType type) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                return "i32";
+            case dataType::Int64T:
+                return "i64";
+            case dataType::Float32T:
+                return "f32";
+            case dataType::Float64T:
+                return "f64";
+            default:
+                return "bool";
+        }
+    }
+
+/*
+    Retrieve the name of an opcode.
+
+    Parameters:
+        op: opcode to name (input)
+
+    Return the opcode's name.
+*/
+    const char* _opcode_name(const opcode op) noexcept {
+        switch (op) {
+            case opcode::Const:
+                return "const";
+            case opcode::Input:
+                return "input";
+            case opcode::Phi:
+                return "phi";
+            case opcode::Convert:
+                return "convert";
+            case opcode::Not:
+                return "not";
+            case opcode::Add:
+                return "add";
+            case opcode::Sub:
+                return "sub";
+            case opcode::Mul:
+                return "mul";
+            case opcode::Div:
+                return "div";
+            case opcode::Exp:
+                return "exp";
+            case opcode::And:
+                return "and";
+            case opcode::Or:
+                return "or";
+            case opcode::Xor:
+                return "xor";
+            case opcode::Eq:
+                return "eq";
+            case opcode::Gt:
+                return "gt";
+            case opcode::Lt:
+                return "lt";
+            case opcode::Ge:
+                return "ge";
+            case opcode::Le:
+                return "le";
+            case opcode::Select:
+                return "select";
+            default:
+                return "nop";
+        }
+    }
+
+/*
+    Determine whether the first block dominates the second.
+
+    Parameters:
+        dominator: the possibly dominating block (input)
+        block: the possibly dominated block (input)
+        idoms: immediate dominator of each block (input)
+
+    Return true if every path from the entry to the second block passes through the first block.
+*/
+    const bool _dominates(const blockId dominator, blockId block, const vector<blockId>& idoms) noexcept {
+        while (block != NO_BLOCK) {
+            if (block == dominator) {
+                return true;
+            }
+            block = idoms[block];
+        }
+
+        return false;
+    }
+
+/*
+    Throw a fatal error for a malformed instruction.
+
+    Parameters:
+        value: the malformed value (input)
+        reason: description of the problem (input)
+        line_number: line number of the malformed instruction (input)
+*/
+    [[noreturn]] void _malformed(const valueId value, const string& reason, const uint32_t line_number) {
+        throw FatalError("malformed IR at %" + to_string(value) + ": " + reason, line_number);
+    }
+
+}
+
+
+blockId function::add_block() {
+    blocks.push_back(basicBlock{{}, {}, terminatorType::Return, NO_VALUE, NO_BLOCK, NO_BLOCK, true});
+    return static_cast<blockId>(blocks.size() - 1);
+}
+
+valueId function::append(const blockId block, instruction&& new_instruction) {
+    const valueId value = static_cast<valueId>(values.size());
+
+    new_instruction.block = block;
+    values.push_back(move(new_instruction));
+    blocks[block].instructions.push_back(value);
+
+    return value;
+}
+
+vector<blockId> function::successors(const blockId block) const {
+    const basicBlock& current = blocks[block];
+
+    switch (current.terminator) {
+        case terminatorType::Jump:
+            return {current.true_target};
+        case terminatorType::Branch:
+            return {current.true_target, current.false_target};
+        default:
+            return {};
+    }
+}
+
+vector<blockId> function::reverse_postorder() const {
+    vector<blockId> postorder;
+    vector<bool> visited(blocks.size(), false);
+//  Explicit stack of blocks and the index of the next successor to visit.
+    vector<std::pair<blockId, size_t>> stack = {{0, 0}};
+    visited[0] = true;
+
+    while (!stack.empty()) {
+        auto& [block, next_successor] = stack.back();
+        const vector<blockId> block_successors = successors(block);
+
+        if (next_successor < block_successors.size()) {
+            const blockId successor = block_successors[next_successor++];
+            if (!visited[successor]) {
+                visited[successor] = true;
+                stack.push_back({successor, 0});
+            }
+        } else {
+            postorder.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    reverse(postorder.begin(), postorder.end());
+    return postorder;
+}
+
+vector<blockId> function::immediate_dominators() const {
+    const vector<blockId> order = reverse_postorder();
+    vector<uint32_t> order_index(blocks.size(), NO_BLOCK);
+    vector<blockId> idoms(blocks.size(), NO_BLOCK);
+
+    for (uint32_t index = 0; index < order.size(); index++) {
+        order_index[order[index]] = index;
+    }
+
+//  Iterate to a fixed point, intersecting the dominators of processed predecessors (Cooper, Harvey, and Kennedy).
+    idoms[0] = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (size_t index = 1; index < order.size(); index++) {
+            const blockId block = order[index];
+            blockId new_idom = NO_BLOCK;
+
+            for (const blockId predecessor : blocks[block].predecessors) {
+                if ((order_index[predecessor] == NO_BLOCK) || (idoms[predecessor] == NO_BLOCK)) {
+                    continue;
+                }
+
+                if (new_idom == NO_BLOCK) {
+                    new_idom = predecessor;
+                    continue;
+                }
+
+//              Walk both candidates up the dominator tree until they meet.
+                blockId finger1 = predecessor;
+                blockId finger2 = new_idom;
+                while (finger1 != finger2) {
+                    while (order_index[finger1] > order_index[finger2]) {
+                        finger1 = idoms[finger1];
+                    }
+                    while (order_index[finger2] > order_index[finger1]) {
+                        finger2 = idoms[finger2];
+                    }
+                }
+                new_idom = finger1;
+            }
+
+            if (idoms[block] != new_idom) {
+                idoms[block] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+//  The entry block has no dominator.
+    idoms[0] = NO_BLOCK;
+    return idoms;
+}
+
+void function::remove_edge(const blockId from, const blockId to) {
+    vector<blockId>& predecessors = blocks[to].predecessors;
+    const vector<blockId>::iterator edge = find(predecessors.begin(), predecessors.end(), from);
+    if (edge == predecessors.end()) {
+        return;
+    }
+
+    const size_t edge_index = static_cast<size_t>(edge - predecessors.begin());
+    predecessors.erase(edge);
+
+//  Each phi has one operand per predecessor, so drop the operand of the removed edge.
+    for (const valueId value : blocks[to].instructions) {
+        instruction& phi = values[value];
+        if (phi.op != opcode::Phi) {
+            break;
+        }
+        phi.operands.erase(phi.operands.begin() + edge_index);
+    }
+
+    return;
+}
+
+void function::replace_values(vector<valueId>& replacements) {
+//  Follow chains of replacements to their end, compressing them along the way.
+    const auto resolve = [&replacements](valueId value) {
+        valueId root = value;
+        while ((replacements[root] != NO_VALUE) && (replacements[root] != root)) {
+            root = replacements[root];
+        }
+        while ((replacements[value] != NO_VALUE) && (replacements[value] != root)) {
+            const valueId next_value = replacements[value];
+            replacements[value] = root;
+            value = next_value;
+        }
+        return root;
+    };
+
+    for (instruction& current : values) {
+        for (valueId& operand : current.operands) {
+            operand = resolve(operand);
+        }
+    }
+
+    for (basicBlock& block : blocks) {
+        if (block.condition != NO_VALUE) {
+            block.condition = resolve(block.condition);
+        }
+    }
+
+    for (auto& [variable, value] : outputs) {
+        value = resolve(value);
+    }
+
+    return;
+}
+
+void function::remove_instruction(const valueId value) {
+    instruction& removed = values[value];
+    vector<valueId>& block_instructions = blocks[removed.block].instructions;
+
+    block_instructions.erase(find(block_instructions.begin(), block_instructions.end(), value));
+    removed.op = opcode::Nop;
+    removed.operands.clear();
+
+    return;
+}
+
+
+instruction make_constant(const dataType type, const int64_t int_value, const double float_value, const uint32_t line_number) {
+    return instruction{opcode::Const, type, {}, constantValue{int_value, float_value}, "", NO_BLOCK, line_number};
+}
+
+const bool may_raise(const instruction& value) noexcept {
+    switch (value.op) {
+//      Integers can overflow, floats can grow past their accurate range.
+        case opcode::Add:
+        case opcode::Sub:
+        case opcode::Mul:
+//      Division can divide by 0, exponents can also raise a negative number to a fractional power.
+        case opcode::Div:
+        case opcode::Exp:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+const bool pure_instruction(const instruction& value) noexcept {
+//  Phi instructions also depend on the block they are in, and removed instructions define nothing.
+    return (value.op != opcode::Phi) && (value.op != opcode::Nop);
+}
+
+void verify_function(const function& ir_function) {
+    const vector<blockId> idoms = ir_function.immediate_dominators();
+    vector<uint32_t> position(ir_function.values.size(), 0);
+
+//  Record the position of every instruction in its block.
+    for (const basicBlock& block : ir_function.blocks) {
+        for (uint32_t index = 0; index < block.instructions.size(); index++) {
+            position[block.instructions[index]] = index;
+        }
+    }
+
+    for (blockId block_id = 0; block_id < ir_function.blocks.size(); block_id++) {
+        const basicBlock& block = ir_function.blocks[block_id];
+        if (!block.reachable) {
+            continue;
+        }
+
+        bool phis_allowed = true;
+        for (const valueId value : block.instructions) {
+            const instruction& current = ir_function.values[value];
+
+            if (current.block != block_id) {
+                _malformed(value, "instruction is listed in the wrong block", current.line_number);
+            }
+
+            if (current.op == opcode::Phi) {
+                if (!phis_allowed) {
+                    _malformed(value, "phi follows a non-phi instruction", current.line_number);
+                }
+                if (current.operands.size() != block.predecessors.size()) {
+                    _malformed(value, "phi operands do not match block predecessors", current.line_number);
+                }
+
+                for (size_t index = 0; index < current.operands.size(); index++) {
+                    const instruction& operand = ir_function.values[current.operands[index]];
+                    if ((operand.op == opcode::Nop) || !_dominates(operand.block, block.predecessors[index], idoms)) {
+                        _malformed(value, "phi operand is not available in its predecessor", current.line_number);
+                    }
+                    if (operand.type != current.type) {
+                        _malformed(value, "phi operand type mismatch", current.line_number);
+                    }
+                }
+
+                continue;
+            }
+
+            phis_allowed = false;
+
+//          Every operand must be defined earlier in the block or in a dominating block.
+            for (const valueId operand_id : current.operands) {
+                const instruction& operand = ir_function.values[operand_id];
+                const bool defined_before = (operand.block == block_id) ? (position[operand_id] < position[value])
+                                                                         : _dominates(operand.block, block_id, idoms);
+
+                if ((operand.op == opcode::Nop) || !defined_before) {
+                    _malformed(value, "operand %" + to_string(operand_id) + " is used before it is defined", current.line_number);
+                }
+            }
+
+//          Check operand types against the instruction.
+            const vector<valueId>& operands = current.operands;
+            const auto operand_type = [&](const size_t index) {
+                return ir_function.values[operands[index]].type;
+            };
+
+            switch (current.op) {
+                case opcode::Convert:
+                    if ((current.type == dataType::BoolT) || (operand_type(0) == dataType::BoolT)) {
+                        _malformed(value, "conversion involving a boolean", current.line_number);
+                    }
+                    break;
+
+                case opcode::Add:
+                case opcode::Sub:
+                case opcode::Mul:
+                case opcode::Div:
+                case opcode::Exp:
+                    if ((operand_type(0) != current.type) || (operand_type(1) != current.type) || (current.type == dataType::BoolT)) {
+                        _malformed(value, "arithmetic operand type mismatch", current.line_number);
+                    }
+                    break;
+
+                case opcode::Not:
+                case opcode::And:
+                case opcode::Or:
+                case opcode::Xor:
+                    for (size_t index = 0; index < operands.size(); index++) {
+                        if (operand_type(index) != dataType::BoolT) {
+                            _malformed(value, "boolean operand type mismatch", current.line_number);
+                        }
+                    }
+                    break;
+
+                case opcode::Eq:
+                case opcode::Gt:
+                case opcode::Lt:
+                case opcode::Ge:
+                case opcode::Le:
+                    if ((operand_type(0) != operand_type(1)) || (current.type != dataType::BoolT)) {
+                        _malformed(value, "comparison operand type mismatch", current.line_number);
+                    }
+                    break;
+
+                case opcode::Select:
+                    if ((operand_type(0) != dataType::BoolT) || (operand_type(1) != current.type) || (operand_type(2) != current.type)) {
+                        _malformed(value, "select operand type mismatch", current.line_number);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if ((block.terminator == terminatorType::Branch) && (ir_function.values[block.condition].type != dataType::BoolT)) {
+            throw FatalError("malformed IR in block " + to_string(block_id) + ": branch condition is not a boolean", 0);
+        }
+    }
+
+    return;
+}
+
+const string display_function(const function& ir_function) {
+    string result;
+
+    for (blockId block_id = 0; block_id < ir_function.blocks.size(); block_id++) {
+        const basicBlock& block = ir_function.blocks[block_id];
+        if (!block.reachable) {
+            continue;
+        }
+
+        result += "block " + to_string(block_id);
+        if (!block.predecessors.empty()) {
+            result += " (preds";
+            for (const blockId predecessor : block.predecessors) {
+                result += " " + to_string(predecessor);
+            }
+            result += ")";
+        }
+        result += ":\n";
+
+        for (const valueId value : block.instructions) {
+            const instruction& current = ir_function.values[value];
+            result += "    %" + to_string(value) + " = " + _type_name(current.type) + " " + _opcode_name(current.op);
+
+            if (current.op == opcode::Const) {
+                if (current.type == dataType::BoolT) {
+                    result += current.constant.int_value ? " true" : " false";
+                } else if (integer_type(current.type)) {
+                    result += " " + to_string(current.constant.int_value);
+                } else {
+                    result += " " + num_to_string<double>(current.constant.float_value);
+                }
+            } else if (current.op == opcode::Input) {
+                result += " " + current.variable;
+            }
+
+            for (size_t index = 0; index < current.operands.size(); index++) {
+                result += ((index == 0) ? " %" : ", %") + to_string(current.operands[index]);
+            }
+            result += "\n";
+        }
+
+        switch (block.terminator) {
+            case terminatorType::Jump:
+                result += "    jump block " + to_string(block.true_target) + "\n";
+                break;
+            case terminatorType::Branch:
+                result += "    branch %" + to_string(block.condition) + " ? block " + to_string(block.true_target)
+                          + " : block " + to_string(block.false_target) + "\n";
+                break;
+            default:
+                result += "    return\n";
+                break;
+        }
+    }
+
+    result += "outputs:\n";
+    for (const auto& [variable, value] : ir_function.outputs) {
+        result += "    " + variable + " = %" + to_string(value) + "\n";
+    }
+
+    return result;
+}
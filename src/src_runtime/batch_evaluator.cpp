@@ -0,0 +1,928 @@
+/*
+
+Function implementations for evaluating an analyzed AST over many rows of runtime variables at once.
+
+*/
+
+#include "inc_runtime/batch_evaluator.hpp"
+#include "inc_internal/tracing.hpp"
+
+#include <cstdlib>
+#include <fstream>
+
+#ifdef REGAL_MAPPED_COLUMNS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Standard library aliases
+using std::map, std::vector, std::string, std::pair, std::unique_ptr, std::make_unique, std::uint8_t, std::uint32_t, std::int32_t, std::int64_t,
+      std::uint64_t, std::size_t, std::move;
+
+// interp_utils namespaces
+using namespace TypingUtils;
+using namespace CodeTree;
+using namespace TypeRules;
+using namespace CheckedArithmetic;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// batch_evaluator namespace
+using namespace Batch;
+
+
+// Batch evaluation helper functions.
+namespace {
+
+//  Number of rows executed together, so the lanes of a block stay in cache between the operators using them.
+    constexpr size_t _BLOCK_ROWS = 1024;
+
+//  Values of one block of rows, one lane per row, each holding the member of its static type.
+    using _lanes = vector<valueSlot>;
+
+//  State carried through the evaluation of a batch.
+    struct _batchState {
+//      lanes of each variable with each type it takes, mapped by name and type, since its type can change as it is reassigned
+        map<pair<string, dataType>, _lanes> variables;
+//      current type of each variable
+        map<string, dataType> types;
+//      lanes of temporaries and masks, reused by every block
+        vector<_lanes> scratch;
+//      number of scratch lanes in use
+        size_t scratch_used = 0;
+//      index of the block's first row
+        size_t first_row = 0;
+//      number of rows in the block
+        size_t rows = 0;
+//      number of row operations executed
+        uint64_t operations = 0;
+//      row whose error is being thrown
+        size_t failed_row = 0;
+    };
+
+/*
+    Retrieve unused scratch lanes, valid until the scratch lanes in use are released.
+
+    Parameters:
+        state: batch state (input/output)
+
+    Return the lanes.
+*/
+    valueSlot* _acquire(_batchState& state) {
+        if (state.scratch_used == state.scratch.size()) {
+            state.scratch.emplace_back(_BLOCK_ROWS);
+        }
+
+//      Moving the outer vector as it grows never moves the lanes themselves.
+        return state.scratch[state.scratch_used++].data();
+    }
+
+/*
+    Retrieve the lanes of a variable with the given type, creating them on first use.
+
+    Parameters:
+        state: batch state (input/output)
+        variable: name of the variable (input)
+        type: type of the lanes (input)
+
+    Return the lanes.
+*/
+    valueSlot* _variable_lanes(_batchState& state, const string& variable, const dataType type) {
+        _lanes& lanes = state.variables[{variable, type}];
+
+        if (lanes.empty()) {
+            lanes.resize(_BLOCK_ROWS);
+        }
+
+        return lanes.data();
+    }
+
+/*
+    Retrieve the member of a lane holding a 64-bit number.
+    This function depends on a typename template for the number, either a 64-bit integer or a 64-bit float.
+
+    Parameters:
+        slot: the lane (input)
+
+    Return the member.
+*/
+    template <typename T>
+    inline T& _member(valueSlot& slot) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            return slot.int64;
+        } else {
+            return slot.float64;
+        }
+    }
+    template <typename T>
+    inline T _member(const valueSlot& slot) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            return slot.int64;
+        } else {
+            return slot.float64;
+        }
+    }
+
+/*
+    Convert lanes of numbers to 64-bit numbers.
+    This function depends on a typename template for the 64-bit numbers.
+
+    Parameters:
+        lanes: the numbers (input)
+        type: type of the numbers (input)
+        result: the converted numbers (output)
+        rows: number of lanes (input)
+*/
+    template <typename T>
+    void _widen(const valueSlot* const lanes, const dataType type, valueSlot* const result, const size_t rows) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    _member<T>(result[lane]) = static_cast<T>(lanes[lane].int32);
+                }
+                break;
+            case dataType::Int64T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    _member<T>(result[lane]) = static_cast<T>(lanes[lane].int64);
+                }
+                break;
+            case dataType::Float32T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    _member<T>(result[lane]) = static_cast<T>(lanes[lane].float32);
+                }
+                break;
+            default:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    _member<T>(result[lane]) = static_cast<T>(lanes[lane].float64);
+                }
+                break;
+        }
+    }
+
+/*
+    Convert lanes to the given type, as convert_value converts runtime values.
+
+    Parameters:
+        lanes: the values (input)
+        from: type of the values (input)
+        to: type to convert to (input)
+        state: batch state (input/output)
+
+    Return the converted lanes, the given lanes if no conversion is needed.
+*/
+    const valueSlot* _convert(const valueSlot* const lanes, const dataType from, const dataType to, _batchState& state) {
+        if ((from == to) || (to == dataType::BoolT)) {
+            return lanes;
+        }
+
+        valueSlot* const result = _acquire(state);
+        state.operations += state.rows;
+
+//      Numbers are converted through the 64-bit type of their kind.
+        if (integer_type(to)) {
+            _widen<int64_t>(lanes, from, result, state.rows);
+            if (to == dataType::Int32T) {
+                for (size_t lane = 0; lane < state.rows; lane++) {
+                    result[lane].int32 = static_cast<int32_t>(result[lane].int64);
+                }
+            }
+        } else {
+            _widen<double>(lanes, from, result, state.rows);
+            if (to == dataType::Float32T) {
+                for (size_t lane = 0; lane < state.rows; lane++) {
+                    result[lane].float32 = static_cast<float>(result[lane].float64);
+                }
+            }
+        }
+
+        return result;
+    }
+
+/*
+    Copy lanes into other lanes, only for the rows of a mask.
+
+    Parameters:
+        lanes: the values to copy (input)
+        mask: rows to copy (input)
+        result: lanes to copy to (output)
+        rows: number of lanes (input)
+*/
+    inline void _masked_copy(const valueSlot* const lanes, const valueSlot* const mask, valueSlot* const result, const size_t rows) noexcept {
+        for (size_t lane = 0; lane < rows; lane++) {
+            if (mask[lane].boolean) {
+                result[lane] = lanes[lane];
+            }
+        }
+    }
+
+/*
+    Compute an arithmetic operation for every lane, then throw the error of the first lane of the mask that failed.
+    This function depends on a typename template for the 64-bit numbers computed.
+
+    Throw an exception if an operation of the mask's rows overflows or its operands are invalid (e.g. 2 / 0).
+
+    Parameters:
+        op: the arithmetic operator (input)
+        lanes1/2: the operands, as 64-bit numbers (input)
+        mask: rows whose operations are checked (input)
+        result: the results (output)
+        state: batch state, with the failing row if there is one (input/output)
+        line_number: line number of the operator (input)
+*/
+    template <typename T>
+    void _arithmetic(const binaryOperator op, const valueSlot* const lanes1, const valueSlot* const lanes2, const valueSlot* const mask,
+                     valueSlot* const result, _batchState& state, const uint32_t line_number) {
+        const size_t rows = state.rows;
+        bool failed = false;
+
+//      Additions and subtractions are written without branches so they vectorize, checking integers from the sign bits.
+        switch (op) {
+            case binaryOperator::Add:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    const T num1 = _member<T>(lanes1[lane]), num2 = _member<T>(lanes2[lane]);
+                    T sum;
+                    bool exact_sum;
+                    if constexpr (std::is_integral_v<T>) {
+                        sum = static_cast<T>(static_cast<uint64_t>(num1) + static_cast<uint64_t>(num2));
+                        exact_sum = (((num1 ^ sum) & (num2 ^ sum)) >= 0) && exact(sum);
+                    } else {
+                        sum = num1 + num2;
+                        exact_sum = exact(sum);
+                    }
+                    _member<T>(result[lane]) = sum;
+                    failed |= !exact_sum & mask[lane].boolean;
+                }
+                break;
+
+            case binaryOperator::Sub:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    const T num1 = _member<T>(lanes1[lane]), num2 = _member<T>(lanes2[lane]);
+                    T difference;
+                    bool exact_difference;
+                    if constexpr (std::is_integral_v<T>) {
+                        difference = static_cast<T>(static_cast<uint64_t>(num1) - static_cast<uint64_t>(num2));
+                        exact_difference = (((num1 ^ num2) & (num1 ^ difference)) >= 0) && exact(difference);
+                    } else {
+                        difference = num1 - num2;
+                        exact_difference = exact(difference);
+                    }
+                    _member<T>(result[lane]) = difference;
+                    failed |= !exact_difference & mask[lane].boolean;
+                }
+                break;
+
+            case binaryOperator::Mult:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    T product = 0;
+                    failed |= !checked_mul(_member<T>(lanes1[lane]), _member<T>(lanes2[lane]), product) & mask[lane].boolean;
+                    _member<T>(result[lane]) = product;
+                }
+                break;
+
+            default:
+                if constexpr (std::is_floating_point_v<T>) {
+                    for (size_t lane = 0; lane < rows; lane++) {
+                        T value = 0;
+                        const bool checked = (op == binaryOperator::Div) ? checked_div(lanes1[lane].float64, lanes2[lane].float64, value)
+                                                                         : checked_float_pow(lanes1[lane].float64, lanes2[lane].float64, value);
+                        failed |= !checked & mask[lane].boolean;
+                        result[lane].float64 = value;
+                    }
+                    break;
+                }
+
+//              Division and exponents always take floats.
+                throw FatalError("integer operands for a float operator during batch evaluation", line_number);
+        }
+
+        if (!failed) {
+            return;
+        }
+
+//      Find the failing row by checking the mask's rows one at a time.
+        for (size_t lane = 0; lane < rows; lane++) {
+            const T num1 = _member<T>(lanes1[lane]), num2 = _member<T>(lanes2[lane]);
+            T value = 0;
+            bool checked = true;
+
+            switch (op) {
+                case binaryOperator::Add:
+                    checked = checked_add(num1, num2, value);
+                    break;
+                case binaryOperator::Sub:
+                    checked = checked_sub(num1, num2, value);
+                    break;
+                case binaryOperator::Mult:
+                    checked = checked_mul(num1, num2, value);
+                    break;
+                default:
+                    if constexpr (std::is_floating_point_v<T>) {
+                        checked = (op == binaryOperator::Div) ? checked_div(num1, num2, value) : checked_float_pow(num1, num2, value);
+                    }
+                    break;
+            }
+
+            if (mask[lane].boolean && !checked) {
+                state.failed_row = state.first_row + lane;
+                raise_arithmetic_error<T>(op, num1, num2, line_number);
+            }
+        }
+    }
+
+/*
+    Compare lanes of numbers of the same type.
+    This function depends on a typename template for the numbers.
+
+    Parameters:
+        op: the comparison operator (input)
+        lanes1/2: the operands, as 64-bit numbers (input)
+        result: the results (output)
+        rows: number of lanes (input)
+*/
+    template <typename T>
+    void _compare(const binaryOperator op, const valueSlot* const lanes1, const valueSlot* const lanes2, valueSlot* const result, const size_t rows) noexcept {
+        switch (op) {
+            case binaryOperator::Greater:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    result[lane].boolean = _member<T>(lanes1[lane]) > _member<T>(lanes2[lane]);
+                }
+                break;
+            case binaryOperator::Less:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    result[lane].boolean = _member<T>(lanes1[lane]) < _member<T>(lanes2[lane]);
+                }
+                break;
+            case binaryOperator::Equal:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    result[lane].boolean = _member<T>(lanes1[lane]) == _member<T>(lanes2[lane]);
+                }
+                break;
+            case binaryOperator::GrEqual:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    result[lane].boolean = _member<T>(lanes1[lane]) >= _member<T>(lanes2[lane]);
+                }
+                break;
+            default:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    result[lane].boolean = _member<T>(lanes1[lane]) <= _member<T>(lanes2[lane]);
+                }
+                break;
+        }
+    }
+
+/*
+    Create the masks of the rows of a mask where lanes of booleans are true and where they are false.
+
+    Parameters:
+        mask: the rows to split (input)
+        condition: the booleans (input)
+        true_mask: rows of the mask where the booleans are true (output)
+        false_mask: rows of the mask where the booleans are false (output)
+        rows: number of lanes (input)
+*/
+    inline void _split_mask(const valueSlot* const mask, const valueSlot* const condition, valueSlot* const true_mask, valueSlot* const false_mask,
+                            const size_t rows) noexcept {
+        for (size_t lane = 0; lane < rows; lane++) {
+            true_mask[lane].boolean = mask[lane].boolean & condition[lane].boolean;
+            false_mask[lane].boolean = mask[lane].boolean & !condition[lane].boolean;
+        }
+    }
+
+    const valueSlot* _evaluate_value(const valueData* const value_data, const valueSlot* const mask, _batchState& state, dataType& type);
+
+/*
+    Evaluate a binary operator for every row of a block.
+
+    Parameters:
+        binary_op: the operator to evaluate (input)
+        mask: rows the operator applies to (input)
+        state: batch state (input/output)
+        type: the operator's type (output)
+
+    Return the operator's lanes.
+*/
+    const valueSlot* _evaluate_binary(const binaryOp* const binary_op, const valueSlot* const mask, _batchState& state, dataType& type) {
+        if (!binary_token(binary_op->op)) {
+            throw FatalError("binary operator not recognized during batch evaluation", binary_op->line_number);
+        }
+        const binaryOperator op = binary_operator(binary_op->op);
+        const size_t rows = state.rows;
+
+        dataType type1, type2;
+        const valueSlot* const lanes1 = _evaluate_value(binary_op->expression1.get(), mask, state, type1);
+
+//      'and'/'or' only evaluate the second operand for the rows where the first does not decide the result.
+        if ((op == binaryOperator::And) || (op == binaryOperator::Or)) {
+            valueSlot* const and_mask = _acquire(state);
+            valueSlot* const or_mask = _acquire(state);
+            _split_mask(mask, lanes1, and_mask, or_mask, rows);
+
+            const valueSlot* const lanes2 = _evaluate_value(binary_op->expression2.get(), (op == binaryOperator::And) ? and_mask : or_mask, state, type2);
+            valueSlot* const result = _acquire(state);
+            for (size_t lane = 0; lane < rows; lane++) {
+                result[lane].boolean = (op == binaryOperator::And) ? (lanes1[lane].boolean & lanes2[lane].boolean)
+                                                                   : (lanes1[lane].boolean | lanes2[lane].boolean);
+            }
+
+            state.operations += rows;
+            type = dataType::BoolT;
+            return result;
+        }
+
+        const valueSlot* const lanes2 = _evaluate_value(binary_op->expression2.get(), mask, state, type2);
+        valueSlot* const result = _acquire(state);
+        state.operations += rows;
+
+        switch (operator_kind(op)) {
+//          Numbers are computed in the 64-bit type of the result.
+            case operatorKind::Arithmetic:
+            case operatorKind::FloatArithmetic:
+                type = binary_rule(op, type1, type2).result;
+                if (type == dataType::Int64T) {
+                    _arithmetic<int64_t>(op, _convert(lanes1, type1, type, state), _convert(lanes2, type2, type, state), mask, result, state,
+                                         binary_op->line_number);
+                } else {
+                    _arithmetic<double>(op, _convert(lanes1, type1, type, state), _convert(lanes2, type2, type, state), mask, result, state,
+                                        binary_op->line_number);
+                }
+                return result;
+
+            case operatorKind::Logical:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    result[lane].boolean = lanes1[lane].boolean != lanes2[lane].boolean;
+                }
+                type = dataType::BoolT;
+                return result;
+
+//          Numbers are compared in their runtime merged type, as 64-bit numbers, booleans are only compared for equality.
+            default: {
+                const dataType merged_type = runtime_merged_type(type1, type2);
+
+                if (merged_type == dataType::BoolT) {
+                    for (size_t lane = 0; lane < rows; lane++) {
+                        result[lane].boolean = lanes1[lane].boolean == lanes2[lane].boolean;
+                    }
+                } else if (integer_type(merged_type)) {
+                    _compare<int64_t>(op, _convert(lanes1, type1, dataType::Int64T, state), _convert(lanes2, type2, dataType::Int64T, state), result, rows);
+                } else {
+                    _compare<double>(op, _convert(lanes1, type1, dataType::Float64T, state), _convert(lanes2, type2, dataType::Float64T, state), result, rows);
+                }
+
+                type = dataType::BoolT;
+                return result;
+            }
+        }
+    }
+
+/*
+    Evaluate an expression for every row of a block. Lanes outside the mask hold unspecified values.
+
+    Throw a FatalError if the expression is not recognized or reads a variable with no known type.
+
+    Parameters:
+        value_data: the expression to evaluate (input)
+        mask: rows the expression applies to (input)
+        state: batch state (input/output)
+        type: the expression's type (output)
+
+    Return the expression's lanes, valid until the scratch lanes in use are released.
+*/
+    const valueSlot* _evaluate_value(const valueData* const value_data, const valueSlot* const mask, _batchState& state, dataType& type) {
+        switch (value_data->type) {
+            case nodeType::VarContainer: {
+                const varContainer* const var_container = static_cast<const varContainer*>(value_data);
+                const map<string, dataType>::const_iterator var_type = state.types.find(var_container->variable);
+
+                if (var_type == state.types.end()) {
+                    throw FatalError("variable '" + var_container->variable + "' has no value during batch evaluation", var_container->line_number);
+                }
+
+                type = var_type->second;
+                return _variable_lanes(state, var_container->variable, type);
+            }
+
+            case nodeType::UnaryOp: {
+                dataType operand_type;
+                const valueSlot* const operand = _evaluate_value(static_cast<const unaryOp*>(value_data)->expression.get(), mask, state, operand_type);
+                valueSlot* const result = _acquire(state);
+
+                for (size_t lane = 0; lane < state.rows; lane++) {
+                    result[lane].boolean = !operand[lane].boolean;
+                }
+
+                state.operations += state.rows;
+                type = dataType::BoolT;
+                return result;
+            }
+
+            case nodeType::BinaryOp:
+                return _evaluate_binary(static_cast<const binaryOp*>(value_data), mask, state, type);
+
+//          The second expression of a ternary operator is its condition, and each value is only evaluated for the rows choosing it.
+            case nodeType::TernaryOp: {
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(value_data);
+                dataType condition_type, type1, type3;
+
+                const valueSlot* const condition = _evaluate_value(ternary_op->expression2.get(), mask, state, condition_type);
+                valueSlot* const true_mask = _acquire(state);
+                valueSlot* const false_mask = _acquire(state);
+                _split_mask(mask, condition, true_mask, false_mask, state.rows);
+
+                const valueSlot* lanes1 = _evaluate_value(ternary_op->expression1.get(), true_mask, state, type1);
+                const valueSlot* lanes3 = _evaluate_value(ternary_op->expression3.get(), false_mask, state, type3);
+                type = runtime_merged_type(type1, type3);
+                lanes1 = _convert(lanes1, type1, type, state);
+                lanes3 = _convert(lanes3, type3, type, state);
+
+                valueSlot* const result = _acquire(state);
+                for (size_t lane = 0; lane < state.rows; lane++) {
+                    result[lane] = condition[lane].boolean ? lanes1[lane] : lanes3[lane];
+                }
+
+                state.operations += state.rows;
+                return result;
+            }
+
+//          Irreducible data has the same value in every row.
+            default: {
+                const typedValue constant = constant_value(value_data);
+                valueSlot* const result = _acquire(state);
+
+                for (size_t lane = 0; lane < state.rows; lane++) {
+                    result[lane] = constant.value;
+                }
+
+                type = constant.type;
+                return result;
+            }
+        }
+    }
+
+/*
+    Convert the lanes of a variable to the type it is merged to, for the rows of one block of an 'if'.
+
+    Parameters:
+        variable: name of the variable (input)
+        from: type of the variable at the end of the block (input)
+        to: the merged type (input)
+        mask: rows of the block (input)
+        state: batch state (input/output)
+*/
+    void _merge_variable(const string& variable, const dataType from, const dataType to, const valueSlot* const mask, _batchState& state) {
+        const valueSlot* const converted = _convert(_variable_lanes(state, variable, from), from, to, state);
+        _masked_copy(converted, mask, _variable_lanes(state, variable, to), state.rows);
+        state.operations += state.rows;
+    }
+
+/*
+    Execute a statement or list of statements for the rows of a mask, updating the lanes of assigned variables.
+
+    Throw a FatalError if the AST contains an unrecognized node or reads a variable with no known type.
+
+    Parameters:
+        data_node: the AST to execute (input)
+        mask: rows to execute (input)
+        state: batch state (input/output)
+*/
+    void _execute_node(const dataNode* const data_node, const valueSlot* const mask, _batchState& state) {
+        const size_t scratch_mark = state.scratch_used;
+
+        switch (data_node->type) {
+            case nodeType::CodeScope: {
+                const codeScope* const code_scope = static_cast<const codeScope*>(data_node);
+
+//              An empty scope has nothing to execute.
+                if (code_scope->curr_operation != nullptr) {
+                    _execute_node(code_scope->curr_operation.get(), mask, state);
+                    _execute_node(code_scope->remainder.get(), mask, state);
+                }
+                break;
+            }
+
+            case nodeType::AssignOp:
+            case nodeType::ReassignOp: {
+                const bool assign = data_node->type == nodeType::AssignOp;
+                const string& variable = assign ? static_cast<const assignOp*>(data_node)->variable : static_cast<const reassignOp*>(data_node)->variable;
+                const valueData* const expression = assign ? static_cast<const assignOp*>(data_node)->expression.get()
+                                                           : static_cast<const reassignOp*>(data_node)->expression.get();
+
+                dataType type;
+                const valueSlot* const value = _evaluate_value(expression, mask, state, type);
+                _masked_copy(value, mask, _variable_lanes(state, variable, type), state.rows);
+                state.types[variable] = type;
+                state.operations += state.rows;
+                break;
+            }
+
+            case nodeType::IfBlock: {
+                const ifBlock* const if_block = static_cast<const ifBlock*>(data_node);
+                dataType condition_type;
+
+                const valueSlot* const condition = _evaluate_value(if_block->bool_condition.get(), mask, state, condition_type);
+                valueSlot* const if_mask = _acquire(state);
+                valueSlot* const else_mask = _acquire(state);
+                _split_mask(mask, condition, if_mask, else_mask, state.rows);
+
+//              Variables declared inside either block go out of scope when the blocks meet.
+                const map<string, dataType> types_before = state.types;
+                _execute_node(if_block->code_block.get(), if_mask, state);
+                const map<string, dataType> if_types = move(state.types);
+
+                state.types = types_before;
+                if (if_block->contains_else) {
+                    _execute_node(if_block->else_block.get(), else_mask, state);
+                }
+                const map<string, dataType> else_types = move(state.types);
+
+//              Merge every variable assigned on both paths, converting each block's rows where its type differs.
+                state.types = types_before;
+                for (const auto& [variable, if_type] : if_types) {
+                    const map<string, dataType>::const_iterator else_type = else_types.find(variable);
+                    if (else_type == else_types.end()) {
+                        continue;
+                    }
+
+                    const dataType merged_type = runtime_merged_type(if_type, else_type->second);
+                    state.types[variable] = merged_type;
+
+                    if (if_type != merged_type) {
+                        _merge_variable(variable, if_type, merged_type, if_mask, state);
+                    }
+                    if (else_type->second != merged_type) {
+                        _merge_variable(variable, else_type->second, merged_type, else_mask, state);
+                    }
+                }
+                break;
+            }
+
+//          Throw an exception when a piece of data was not recognized (not implemented).
+            default:
+                throw FatalError("data not recognized during batch evaluation", data_node->line_number);
+        }
+
+//      Temporaries only live until the end of their statement.
+        state.scratch_used = scratch_mark;
+        return;
+    }
+
+/*
+    Copy values between a column and lanes.
+
+    Parameters:
+        data: the column's values (input/output)
+        type: type of the values (input)
+        first_row: index of the first row to copy (input)
+        lanes: the lanes (input/output)
+        rows: number of rows to copy (input)
+*/
+    void _load_column(const void* const data, const dataType type, const size_t first_row, valueSlot* const lanes, const size_t rows) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    lanes[lane].int32 = static_cast<const int32_t*>(data)[first_row + lane];
+                }
+                break;
+            case dataType::Int64T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    lanes[lane].int64 = static_cast<const int64_t*>(data)[first_row + lane];
+                }
+                break;
+            case dataType::Float32T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    lanes[lane].float32 = static_cast<const float*>(data)[first_row + lane];
+                }
+                break;
+            case dataType::Float64T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    lanes[lane].float64 = static_cast<const double*>(data)[first_row + lane];
+                }
+                break;
+            default:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    lanes[lane].boolean = static_cast<const uint8_t*>(data)[first_row + lane] != 0;
+                }
+                break;
+        }
+    }
+    void _store_column(void* const data, const dataType type, const size_t first_row, const valueSlot* const lanes, const size_t rows) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    static_cast<int32_t*>(data)[first_row + lane] = lanes[lane].int32;
+                }
+                break;
+            case dataType::Int64T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    static_cast<int64_t*>(data)[first_row + lane] = lanes[lane].int64;
+                }
+                break;
+            case dataType::Float32T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    static_cast<float*>(data)[first_row + lane] = lanes[lane].float32;
+                }
+                break;
+            case dataType::Float64T:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    static_cast<double*>(data)[first_row + lane] = lanes[lane].float64;
+                }
+                break;
+            default:
+                for (size_t lane = 0; lane < rows; lane++) {
+                    static_cast<uint8_t*>(data)[first_row + lane] = lanes[lane].boolean ? 1 : 0;
+                }
+                break;
+        }
+    }
+
+/*
+    Find the column of a variable, checking its type and number of rows.
+
+    Throw an IncorrectInputError if the variable has no column, or a column of a different type or number of rows.
+
+    Parameters:
+        columns: columns mapped by variable name (input)
+        variable: name of the variable (input)
+        type: type the column must have (input)
+        rows: number of rows the column must have (input)
+
+    Return the column.
+*/
+    const column& _find_column(const map<string, column>& columns, const string& variable, const dataType type, const size_t rows) {
+        const map<string, column>::const_iterator found = columns.find(variable);
+
+        if (found == columns.end()) {
+            throw IncorrectInputError("variable \'" + variable + "\' was given no column", 0);
+        }
+        if (found->second.type != type) {
+            throw TypeMismatchError("column of variable \'" + variable + "\' expected type " + display_type(type, 0)
+                                    + " but received type " + display_type(found->second.type, 0), 0);
+        }
+        if (found->second.rows != rows) {
+            throw IncorrectInputError("column of variable \'" + variable + "\' has " + std::to_string(found->second.rows)
+                                      + " rows, other columns have " + std::to_string(rows), 0);
+        }
+
+        return found->second;
+    }
+
+//  Open flags and permissions of column files.
+#ifdef REGAL_MAPPED_COLUMNS
+    constexpr int _READ_FLAGS = O_RDONLY;
+    constexpr int _WRITE_FLAGS = O_RDWR | O_CREAT | O_TRUNC;
+    constexpr mode_t _WRITE_MODE = 0644;
+#endif
+
+}
+
+
+columnFile::~columnFile() {
+#ifdef REGAL_MAPPED_COLUMNS
+    if (memory != nullptr) {
+        munmap(memory, memory_size);
+    }
+#else
+//  Written columns are saved here, since their memory is not the file's.
+    if (writable) {
+        std::ofstream file(path, std::ios::binary);
+        file.write(static_cast<const char*>(memory), static_cast<std::streamsize>(memory_size));
+    }
+    std::free(memory);
+#endif
+}
+
+unique_ptr<columnFile> open_column_file(const string& path, const dataType type) {
+    const size_t value_size = value_sizes[static_cast<size_t>(type)];
+    size_t memory_size = 0;
+    void* memory = nullptr;
+
+#ifdef REGAL_MAPPED_COLUMNS
+    const int file = open(path.c_str(), _READ_FLAGS);
+    struct stat file_info;
+    if ((file < 0) || (fstat(file, &file_info) != 0)) {
+        if (file >= 0) {
+            close(file);
+        }
+        throw IncorrectInputError("could not read column file \'" + path + "\'", 0);
+    }
+
+//  An empty file has no memory to map.
+    memory_size = static_cast<size_t>(file_info.st_size);
+    if (memory_size != 0) {
+        memory = mmap(nullptr, memory_size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    close(file);
+    if (memory == MAP_FAILED) {
+        throw IncorrectInputError("could not map column file \'" + path + "\'", 0);
+    }
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw IncorrectInputError("could not read column file \'" + path + "\'", 0);
+    }
+    memory_size = static_cast<size_t>(file.tellg());
+    memory = std::malloc(memory_size + 1);
+    file.seekg(0);
+    file.read(static_cast<char*>(memory), static_cast<std::streamsize>(memory_size));
+#endif
+
+    unique_ptr<columnFile> opened = make_unique<columnFile>(column{type, memory, memory_size / value_size}, memory, memory_size, path, false);
+    if (memory_size % value_size != 0) {
+        throw IncorrectInputError("column file \'" + path + "\' does not hold a whole number of " + display_type(type, 0) + " values", 0);
+    }
+
+    return opened;
+}
+
+unique_ptr<columnFile> create_column_file(const string& path, const dataType type, const size_t rows) {
+    const size_t memory_size = rows * value_sizes[static_cast<size_t>(type)];
+    void* memory = nullptr;
+
+#ifdef REGAL_MAPPED_COLUMNS
+    const int file = open(path.c_str(), _WRITE_FLAGS, _WRITE_MODE);
+    if ((file < 0) || (ftruncate(file, static_cast<off_t>(memory_size)) != 0)) {
+        if (file >= 0) {
+            close(file);
+        }
+        throw IncorrectInputError("could not create column file \'" + path + "\'", 0);
+    }
+
+//  The mapping is shared, so writing the column writes the file.
+    if (memory_size != 0) {
+        memory = mmap(nullptr, memory_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    }
+    close(file);
+    if (memory == MAP_FAILED) {
+        throw IncorrectInputError("could not map column file \'" + path + "\'", 0);
+    }
+#else
+    memory = std::calloc(memory_size + 1, 1);
+#endif
+
+    return make_unique<columnFile>(column{type, memory, rows}, memory, memory_size, path, true);
+}
+
+uint64_t evaluate_batch(const std::shared_ptr<dataNode>& data_node, const std::shared_ptr<environment>& global_env,
+                        const map<string, column>& inputs, const map<string, column>& outputs, size_t& failed_row) {
+    REGAL_TRACE_SPAN("evaluate_batch");
+    _batchState state;
+
+//  Every column has the rows of the first runtime variable's column.
+    size_t rows = 0;
+    if (!global_env->inputs.empty() && inputs.contains(global_env->inputs.begin()->first)) {
+        rows = inputs.find(global_env->inputs.begin()->first)->second.rows;
+    }
+
+    vector<pair<string, const column*>> input_columns, output_columns;
+    for (const auto& [variable, declared_type] : global_env->inputs) {
+        input_columns.emplace_back(variable, &_find_column(inputs, variable, declared_type, rows));
+    }
+    for (const auto& [variable, info] : global_env->locals) {
+        if (!info.optimize_value) {
+            output_columns.emplace_back(variable, &_find_column(outputs, variable, info.type, rows));
+        }
+    }
+
+    try {
+        for (state.first_row = 0; state.first_row < rows; state.first_row += _BLOCK_ROWS) {
+            state.rows = std::min(_BLOCK_ROWS, rows - state.first_row);
+            state.scratch_used = 0;
+            state.types.clear();
+
+//          Runtime variables start with their rows' values, every row of the block runs.
+            for (const auto& [variable, input] : input_columns) {
+                _load_column(input->data, input->type, state.first_row, _variable_lanes(state, variable, input->type), state.rows);
+                state.types[variable] = input->type;
+            }
+            valueSlot* const mask = _acquire(state);
+            for (size_t lane = 0; lane < state.rows; lane++) {
+                mask[lane].boolean = true;
+            }
+
+            _execute_node(data_node.get(), mask, state);
+
+//          The result is the final value of each variable not known pre-runtime, with the type analysis gave it.
+            for (const auto& [variable, output] : output_columns) {
+                const map<string, dataType>::const_iterator type = state.types.find(variable);
+                if (type == state.types.end()) {
+                    throw FatalError("variable \'" + variable + "\' has no value after batch evaluation", 0);
+                }
+
+                const valueSlot* const lanes = _convert(_variable_lanes(state, variable, type->second), type->second, output->type, state);
+                _store_column(output->data, output->type, state.first_row, lanes, state.rows);
+            }
+        }
+
+//  Report the row of the error as it is thrown.
+    } catch (const ExecutionError&) {
+        failed_row = state.failed_row;
+        throw;
+    }
+
+    return state.operations;
+}
@@ -0,0 +1,353 @@
+/*
+
+Function implementations for serializing and displaying register-based bytecode.
+
+*/
+
+#include "inc_runtime/bytecode.hpp"
+
+#include <bit>
+
+// Standard library aliases
+using std::map, std::vector, std::string, std::string_view, std::uint8_t, std::uint32_t, std::uint64_t, std::bit_cast;
+
+// interp_utils namespace
+using namespace TypingUtils;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// bytecode namespace
+using namespace Bytecode;
+
+
+// Serialization helper functions.
+namespace {
+
+/*
+    Append an unsigned integer to serialized bytes in little-endian order.
+    This function depends on a typename template for the unsigned integer.
+
+    Parameters:
+        bytes: the serialized bytes (input/output)
+        number: the integer to append (input)
+*/
+    template <typename T>
+    inline void _write_number(string& bytes, const T number) noexcept {
+        for (std::size_t byte_index = 0; byte_index < sizeof(T); byte_index++) {
+            bytes.push_back(static_cast<char>((number >> (8 * byte_index)) & 0xFF));
+        }
+    }
+
+/*
+    Append a string to serialized bytes, preceded by its length.
+
+    Parameters:
+        bytes: the serialized bytes (input/output)
+        text: the string to append (input)
+*/
+    inline void _write_string(string& bytes, const string& text) noexcept {
+        _write_number<uint32_t>(bytes, static_cast<uint32_t>(text.size()));
+        bytes += text;
+    }
+
+//  Position in serialized bytes being read.
+    struct _byteReader {
+        const string& bytes;
+        std::size_t position = 0;
+    };
+
+/*
+    Read an unsigned integer stored in little-endian order.
+    This function depends on a typename template for the unsigned integer.
+
+    Throw an IncorrectInputError if the bytes end before the integer.
+
+    Parameters:
+        reader: position in the bytes, moved past the integer (input/output)
+
+    Return the read integer.
+*/
+    template <typename T>
+    T _read_number(_byteReader& reader) {
+        if (reader.bytes.size() - reader.position < sizeof(T)) {
+            throw IncorrectInputError("truncated bytecode", 0);
+        }
+
+        T number = 0;
+        for (std::size_t byte_index = 0; byte_index < sizeof(T); byte_index++) {
+            number |= static_cast<T>(static_cast<uint8_t>(reader.bytes[reader.position++])) << (8 * byte_index);
+        }
+
+        return number;
+    }
+
+/*
+    Read a string preceded by its length.
+
+    Throw an IncorrectInputError if the bytes end before the string.
+
+    Parameters:
+        reader: position in the bytes, moved past the string (input/output)
+
+    Return the read string.
+*/
+    string _read_string(_byteReader& reader) {
+        const uint32_t length = _read_number<uint32_t>(reader);
+        if (reader.bytes.size() - reader.position < length) {
+            throw IncorrectInputError("truncated bytecode", 0);
+        }
+
+        const string text = reader.bytes.substr(reader.position, length);
+        reader.position += length;
+        return text;
+    }
+
+/*
+    Read a data type.
+
+    Throw an IncorrectInputError if the byte is not a data type.
+
+    Parameters:
+        reader: position in the bytes, moved past the type (input/output)
+
+    Return the read type.
+*/
+    dataType _read_type(_byteReader& reader) {
+        const uint8_t type = _read_number<uint8_t>(reader);
+        if (type > static_cast<uint8_t>(dataType::BoolT)) {
+            throw IncorrectInputError("unknown type in bytecode", 0);
+        }
+
+        return static_cast<dataType>(type);
+    }
+
+/*
+    Read a register index.
+
+    Throw an IncorrectInputError if the index is outside the registers.
+
+    Parameters:
+        reader: position in the bytes, moved past the index (input/output)
+        register_count: number of registers (input)
+
+    Return the read index.
+*/
+    uint32_t _read_register(_byteReader& reader, const uint32_t register_count) {
+        const uint32_t index = _read_number<uint32_t>(reader);
+        if (index >= register_count) {
+            throw IncorrectInputError("register " + std::to_string(index) + " outside the bytecode's registers", 0);
+        }
+
+        return index;
+    }
+
+/*
+    Create a runtime value of the given type from its bits.
+
+    Parameters:
+        type: type of the value (input)
+        bits: bits of the value (input)
+
+    Return the created value.
+*/
+    typedValue _bits_value(const dataType type, const uint64_t bits) noexcept {
+        typedValue value{type, valueSlot{}};
+
+        switch (type) {
+            case dataType::Int32T:
+                value.value.int32 = bit_cast<std::int32_t>(static_cast<uint32_t>(bits));
+                break;
+            case dataType::Int64T:
+                value.value.int64 = bit_cast<std::int64_t>(bits);
+                break;
+            case dataType::Float32T:
+                value.value.float32 = bit_cast<float>(static_cast<uint32_t>(bits));
+                break;
+            case dataType::Float64T:
+                value.value.float64 = bit_cast<double>(bits);
+                break;
+            default:
+                value.value.boolean = bits != 0;
+                break;
+        }
+
+        return value;
+    }
+
+}
+
+
+uint64_t value_bits(const typedValue& value) noexcept {
+    switch (value.type) {
+        case dataType::Int32T:
+            return bit_cast<uint32_t>(value.value.int32);
+        case dataType::Int64T:
+            return bit_cast<uint64_t>(value.value.int64);
+        case dataType::Float32T:
+            return bit_cast<uint32_t>(value.value.float32);
+        case dataType::Float64T:
+            return bit_cast<uint64_t>(value.value.float64);
+        default:
+            return value.value.boolean ? 1 : 0;
+    }
+}
+
+string serialize_program(const program& compiled) noexcept {
+    string bytes(BYTECODE_MAGIC);
+    _write_number<uint32_t>(bytes, BYTECODE_VERSION);
+    _write_number<uint32_t>(bytes, compiled.register_count);
+
+    _write_number<uint32_t>(bytes, static_cast<uint32_t>(compiled.constants.size()));
+    for (const typedValue& constant : compiled.constants) {
+        _write_number<uint8_t>(bytes, static_cast<uint8_t>(constant.type));
+        _write_number<uint64_t>(bytes, value_bits(constant));
+    }
+
+    _write_number<uint32_t>(bytes, static_cast<uint32_t>(compiled.code.size()));
+    for (std::size_t code_index = 0; code_index < compiled.code.size(); code_index++) {
+        const instruction& curr_instruction = compiled.code[code_index];
+        _write_number<uint8_t>(bytes, static_cast<uint8_t>(curr_instruction.op));
+        _write_number<uint32_t>(bytes, curr_instruction.dst);
+        _write_number<uint32_t>(bytes, curr_instruction.src1);
+        _write_number<uint32_t>(bytes, curr_instruction.src2);
+        _write_number<uint32_t>(bytes, compiled.line_numbers[code_index]);
+    }
+
+    _write_number<uint32_t>(bytes, static_cast<uint32_t>(compiled.inputs.size()));
+    for (const auto& [variable, location] : compiled.inputs) {
+        _write_string(bytes, variable);
+        _write_number<uint32_t>(bytes, location.index);
+        _write_number<uint8_t>(bytes, static_cast<uint8_t>(location.type));
+    }
+
+    _write_number<uint32_t>(bytes, static_cast<uint32_t>(compiled.outputs.size()));
+    for (const auto& [variable, location] : compiled.outputs) {
+        _write_string(bytes, variable);
+        _write_number<uint32_t>(bytes, location.index);
+        _write_number<uint8_t>(bytes, static_cast<uint8_t>(location.register_type));
+        _write_number<uint8_t>(bytes, static_cast<uint8_t>(location.type));
+    }
+
+    return bytes;
+}
+
+program deserialize_program(const string& bytes) {
+    _byteReader reader{bytes};
+    program compiled;
+
+    if (string_view(bytes).substr(0, BYTECODE_MAGIC.size()) != BYTECODE_MAGIC) {
+        throw IncorrectInputError("expected serialized bytecode", 0);
+    }
+    reader.position = BYTECODE_MAGIC.size();
+
+    const uint32_t version = _read_number<uint32_t>(reader);
+    if (version != BYTECODE_VERSION) {
+        throw IncorrectInputError("bytecode version " + std::to_string(version) + " does not match version " + std::to_string(BYTECODE_VERSION), 0);
+    }
+    compiled.register_count = _read_number<uint32_t>(reader);
+
+//  Constants are loaded into the first registers.
+    const uint32_t constant_count = _read_number<uint32_t>(reader);
+    if (constant_count > compiled.register_count) {
+        throw IncorrectInputError("more bytecode constants than registers", 0);
+    }
+    for (uint32_t constant_index = 0; constant_index < constant_count; constant_index++) {
+        const dataType type = _read_type(reader);
+        compiled.constants.push_back(_bits_value(type, _read_number<uint64_t>(reader)));
+    }
+
+    const uint32_t code_size = _read_number<uint32_t>(reader);
+    for (uint32_t code_index = 0; code_index < code_size; code_index++) {
+        const uint8_t op = _read_number<uint8_t>(reader);
+        if (op >= opcode_count) {
+            throw IncorrectInputError("unknown bytecode operation " + std::to_string(op), 0);
+        }
+
+        instruction curr_instruction{static_cast<opcode>(op), 0, 0, 0};
+        const opcodeInfo& info = opcode_info(curr_instruction.op);
+        uint32_t* const operands[] = {&curr_instruction.dst, &curr_instruction.src1, &curr_instruction.src2};
+        const operandKind kinds[] = {info.dst, info.src1, info.src2};
+
+        for (std::size_t operand_index = 0; operand_index < 3; operand_index++) {
+            switch (kinds[operand_index]) {
+                case operandKind::Register:
+                    *operands[operand_index] = _read_register(reader, compiled.register_count);
+                    break;
+
+                case operandKind::Target:
+                    *operands[operand_index] = _read_number<uint32_t>(reader);
+                    if (*operands[operand_index] >= code_size) {
+                        throw IncorrectInputError("bytecode jump outside the code", 0);
+                    }
+                    break;
+
+                default:
+                    *operands[operand_index] = _read_number<uint32_t>(reader);
+                    break;
+            }
+        }
+
+        compiled.code.push_back(curr_instruction);
+        compiled.line_numbers.push_back(_read_number<uint32_t>(reader));
+    }
+
+//  Execution stops at the halt, it can never run past the end of the code.
+    if (compiled.code.empty() || (compiled.code.back().op != opcode::Halt)) {
+        throw IncorrectInputError("bytecode does not end with a halt", 0);
+    }
+
+    const uint32_t input_count = _read_number<uint32_t>(reader);
+    for (uint32_t input_index = 0; input_index < input_count; input_index++) {
+        const string variable = _read_string(reader);
+        const uint32_t index = _read_register(reader, compiled.register_count);
+        if (index < constant_count) {
+            throw IncorrectInputError("runtime variable \'" + variable + "\' is loaded into a constant register", 0);
+        }
+
+        compiled.inputs[variable] = variableRegister{index, _read_type(reader)};
+    }
+
+    const uint32_t output_count = _read_number<uint32_t>(reader);
+    for (uint32_t output_index = 0; output_index < output_count; output_index++) {
+        const string variable = _read_string(reader);
+        const uint32_t index = _read_register(reader, compiled.register_count);
+        const dataType register_type = _read_type(reader);
+        compiled.outputs[variable] = outputRegister{index, register_type, _read_type(reader)};
+    }
+
+    if (reader.position != bytes.size()) {
+        throw IncorrectInputError("unexpected bytes after bytecode", 0);
+    }
+
+    return compiled;
+}
+
+const string display_program(const program& compiled) noexcept {
+    string display_str = "Constants:";
+    for (std::size_t constant_index = 0; constant_index < compiled.constants.size(); constant_index++) {
+        display_str += "\n   r" + std::to_string(constant_index) + ": " + display_value(compiled.constants[constant_index]);
+    }
+
+    display_str += "\nCode:";
+    for (std::size_t code_index = 0; code_index < compiled.code.size(); code_index++) {
+        const instruction& curr_instruction = compiled.code[code_index];
+        const opcodeInfo& info = opcode_info(curr_instruction.op);
+        display_str += "\n   " + std::to_string(code_index) + ": " + string(info.name);
+
+//      Registers are displayed as 'r<index>', jump targets as '@<index>', immediates as '#<number>'.
+        const uint32_t operands[] = {curr_instruction.dst, curr_instruction.src1, curr_instruction.src2};
+        const operandKind kinds[] = {info.dst, info.src1, info.src2};
+        for (std::size_t operand_index = 0; operand_index < 3; operand_index++) {
+            if (kinds[operand_index] == operandKind::Register) {
+                display_str += " r" + std::to_string(operands[operand_index]);
+            } else if (kinds[operand_index] == operandKind::Target) {
+                display_str += " @" + std::to_string(operands[operand_index]);
+            } else if (kinds[operand_index] == operandKind::Immediate) {
+                display_str += " #" + std::to_string(static_cast<std::int32_t>(operands[operand_index]));
+            }
+        }
+    }
+
+    return display_str;
+}
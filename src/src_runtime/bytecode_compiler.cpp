@@ -0,0 +1,776 @@
+/*
+
+Function implementations for compiling an analyzed AST into register-based bytecode, through the optimized SSA intermediate representation.
+
+*/
+
+#include "inc_runtime/bytecode_compiler.hpp"
+#include "inc_ir/ir_lowering.hpp"
+#include "inc_ir/pass_manager.hpp"
+#include "inc_internal/tracing.hpp"
+
+#include <queue>
+
+// Standard library aliases
+using std::map, std::vector, std::shared_ptr, std::string, std::pair, std::uint32_t, std::int32_t, std::int64_t, std::uint64_t, std::size_t, std::move;
+
+// interp_utils namespaces
+using namespace InterpreterUtils;
+using namespace TypingUtils;
+using namespace CodeTree;
+using namespace TypeRules;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// bytecode namespace
+using namespace Bytecode;
+
+
+// Compilation helper functions.
+namespace {
+
+//  Registers are numbered per kind while compiling and placed after compilation: constants first, then runtime variables, then temporaries.
+//  The kind of a register is kept in the top bits of its number.
+    constexpr uint32_t _TEMPORARY_TAG = 1U << 30;
+    constexpr uint32_t _CONSTANT_TAG = 1U << 31;
+    constexpr uint32_t _REGISTER_MASK = _TEMPORARY_TAG - 1;
+//  No register, for a value that is not defined yet.
+    constexpr uint32_t _NO_REGISTER = std::numeric_limits<uint32_t>::max();
+//  Point after the last instruction, where the outputs are read.
+    constexpr uint32_t _END_POINT = std::numeric_limits<uint32_t>::max();
+
+//  Each instruction and each block end has a position in the compiled code. Its operands are read at the point twice
+//  its position, and its result written at the next point, so the result can reuse the register of an operand read last.
+
+//  State carried through the compilation of an IR function.
+    struct _compilerState {
+//      optimized function being compiled
+        const IR::function& ir_function;
+//      program being compiled
+        program compiled;
+//      register of each constant, mapped by type and bits
+        map<pair<dataType, uint64_t>, uint32_t> constants;
+//      true to fuse common instruction sequences into superinstructions
+        bool superinstructions;
+//      register of each value, _NO_REGISTER until it is defined
+        vector<uint32_t> registers;
+//      number of reads of each value by instructions, branches and outputs
+        vector<uint32_t> use_counts;
+//      point of the last read of each value
+        vector<uint32_t> last_reads;
+//      position of each instruction, and of the end of each block
+        vector<uint32_t> positions;
+        vector<uint32_t> block_ends;
+//      true for the comparisons compiled into the jump of the branch reading them
+        vector<bool> fused;
+//      value whose register each value is written to, NO_VALUE for a value with a register of its own
+        vector<IR::valueId> coalesced;
+//      temporaries holding a value, ordered by the point of the value's last read
+        std::priority_queue<pair<uint32_t, uint32_t>, vector<pair<uint32_t, uint32_t>>, std::greater<>> live_temporaries;
+//      temporaries no longer holding a value
+        vector<uint32_t> free_temporaries;
+//      number of temporaries
+        uint32_t temporary_count = 0;
+//      first instruction of each block, and the jumps to each block to point at it
+        vector<uint32_t> block_starts;
+        vector<pair<uint32_t, IR::blockId>> block_jumps;
+    };
+
+/*
+    Retrieve the register of a constant, creating it on first use.
+
+    Parameters:
+        state: compiler state (input/output)
+        value: the constant (input)
+
+    Return the constant's register.
+*/
+    uint32_t _constant_register(_compilerState& state, const typedValue& value) {
+        const auto [constant, created] = state.constants.emplace(pair(value.type, value_bits(value)),
+                                                                 _CONSTANT_TAG | static_cast<uint32_t>(state.compiled.constants.size()));
+
+        if (created) {
+            state.compiled.constants.push_back(value);
+        }
+
+        return constant->second;
+    }
+
+/*
+    Create the runtime value of a constant instruction.
+
+    Parameters:
+        constant: the constant instruction (input)
+
+    Return the constant's runtime value.
+*/
+    typedValue _constant(const IR::instruction& constant) noexcept {
+        typedValue value{constant.type, valueSlot{}};
+        switch (constant.type) {
+            case dataType::Int32T:
+                value.value.int32 = static_cast<int32_t>(constant.constant.int_value);
+                break;
+            case dataType::Int64T:
+                value.value.int64 = constant.constant.int_value;
+                break;
+            case dataType::Float32T:
+                value.value.float32 = static_cast<float>(constant.constant.float_value);
+                break;
+            case dataType::Float64T:
+                value.value.float64 = constant.constant.float_value;
+                break;
+            default:
+                value.value.boolean = (constant.constant.int_value != 0);
+                break;
+        }
+
+        return value;
+    }
+
+/*
+    Retrieve the register holding a value.
+
+    Throw a FatalError if the value is read before it is defined.
+
+    Parameters:
+        state: compiler state (input)
+        value: the value (input)
+
+    Return the value's register.
+*/
+    uint32_t _register(const _compilerState& state, const IR::valueId value) {
+        if (state.registers[value] == _NO_REGISTER) {
+            throw FatalError("value %" + std::to_string(value) + " is read before it is defined during compilation", state.ir_function.values[value].line_number);
+        }
+
+        return state.registers[value];
+    }
+
+/*
+    Give a value a temporary register, reusing a temporary whose value was last read before the given point.
+
+    Parameters:
+        state: compiler state (input/output)
+        value: the defined value (input)
+        point: point where the value is first written (input)
+
+    Return the value's register.
+*/
+    uint32_t _define(_compilerState& state, const IR::valueId value, const uint32_t point) {
+//      A coalesced value is written to the register of its phi, or of the condition it selects with.
+        const IR::valueId owner = state.coalesced[value];
+        if (owner != IR::NO_VALUE) {
+            state.registers[value] = (state.registers[owner] == _NO_REGISTER) ? _define(state, owner, point) : state.registers[owner];
+            return state.registers[value];
+        }
+
+        while (!state.live_temporaries.empty() && (state.live_temporaries.top().first < point)) {
+            state.free_temporaries.push_back(state.live_temporaries.top().second);
+            state.live_temporaries.pop();
+        }
+
+        uint32_t temporary;
+        if (state.free_temporaries.empty()) {
+            temporary = _TEMPORARY_TAG | state.temporary_count++;
+        } else {
+            temporary = state.free_temporaries.back();
+            state.free_temporaries.pop_back();
+        }
+
+        state.registers[value] = temporary;
+        state.live_temporaries.emplace(std::max(state.last_reads[value], point), temporary);
+        return temporary;
+    }
+
+/*
+    Append an instruction to the compiled code.
+
+    Parameters:
+        state: compiler state (input/output)
+        op: operation code (input)
+        dst/src1/src2: operands (input)
+        line_number: line number of the operation (input)
+
+    Return the index of the instruction.
+*/
+    uint32_t _emit(_compilerState& state, const opcode op, const uint32_t dst, const uint32_t src1, const uint32_t src2, const uint32_t line_number) {
+        state.compiled.code.push_back(instruction{op, dst, src1, src2});
+        state.compiled.line_numbers.push_back(line_number);
+        return static_cast<uint32_t>(state.compiled.code.size() - 1);
+    }
+
+/*
+    Make a jump continue at the next instruction to be compiled.
+
+    Parameters:
+        state: compiler state (input/output)
+        jump_index: index of the jump (input)
+*/
+    inline void _patch_jump(_compilerState& state, const uint32_t jump_index) noexcept {
+        state.compiled.code[jump_index].dst = static_cast<uint32_t>(state.compiled.code.size());
+    }
+
+/*
+    Append a jump to the start of a block, which is pointed at the block once every block is compiled.
+
+    Parameters:
+        state: compiler state (input/output)
+        op: operation code of the jump (input)
+        src1/src2: operands of a conditional jump (input)
+        target: block to jump to (input)
+        line_number: line number of the jump (input)
+*/
+    void _emit_block_jump(_compilerState& state, const opcode op, const uint32_t src1, const uint32_t src2, const IR::blockId target, const uint32_t line_number) {
+        state.block_jumps.emplace_back(_emit(state, op, 0, src1, src2, line_number), target);
+    }
+
+/*
+    Retrieve the operation code converting a number of one type to another.
+
+    Throw a FatalError for a conversion the bytecode has no instruction for.
+
+    Parameters:
+        source_type: type of the number (input)
+        type: type to convert to (input)
+        line_number: line number of the conversion (input)
+
+    Return the conversion's operation code.
+*/
+    opcode _conversion_opcode(const dataType source_type, const dataType type, const uint32_t line_number) {
+        constexpr std::array<pair<pair<dataType, dataType>, opcode>, 8> conversions = {{
+            {{dataType::Int32T, dataType::Int64T}, opcode::ConvI32I64}, {{dataType::Int32T, dataType::Float64T}, opcode::ConvI32F64},
+            {{dataType::Int64T, dataType::Float64T}, opcode::ConvI64F64}, {{dataType::Float32T, dataType::Float64T}, opcode::ConvF32F64},
+            {{dataType::Int64T, dataType::Int32T}, opcode::ConvI64I32}, {{dataType::Int32T, dataType::Float32T}, opcode::ConvI32F32},
+            {{dataType::Int64T, dataType::Float32T}, opcode::ConvI64F32}, {{dataType::Float64T, dataType::Float32T}, opcode::ConvF64F32}
+        }};
+
+        for (const auto& [types, op] : conversions) {
+            if (types == pair(source_type, type)) {
+                return op;
+            }
+        }
+
+        throw FatalError("unsupported conversion during compilation", line_number);
+    }
+
+/*
+    Retrieve the comparison operator of a comparison instruction.
+
+    Parameters:
+        op: opcode of the comparison (input)
+
+    Return the comparison operator.
+*/
+    constexpr binaryOperator _comparison_operator(const IR::opcode op) noexcept {
+        switch (op) {
+            case IR::opcode::Gt:
+                return binaryOperator::Greater;
+            case IR::opcode::Lt:
+                return binaryOperator::Less;
+            case IR::opcode::Ge:
+                return binaryOperator::GrEqual;
+            case IR::opcode::Le:
+                return binaryOperator::LessEqual;
+            default:
+                return binaryOperator::Equal;
+        }
+    }
+
+/*
+    Determine if an instruction is a comparison of numbers, which can be fused into the jump of a branch.
+
+    Parameters:
+        ir_function: the function (input)
+        value: the instruction (input)
+
+    Return true if the instruction compares numbers.
+*/
+    inline bool _number_comparison(const IR::function& ir_function, const IR::valueId value) noexcept {
+        const IR::instruction& curr = ir_function.values[value];
+        return ((curr.op == IR::opcode::Eq) || (curr.op == IR::opcode::Gt) || (curr.op == IR::opcode::Lt) || (curr.op == IR::opcode::Ge)
+                || (curr.op == IR::opcode::Le)) && number_type(ir_function.values[curr.operands[0]].type);
+    }
+
+/*
+    Order the reachable blocks so every block comes after its predecessors and the true target of a branch follows
+    the branch where it can, so only the false path jumps.
+
+    Parameters:
+        ir_function: the function (input)
+
+    Return the blocks in code order.
+*/
+    vector<IR::blockId> _code_layout(const IR::function& ir_function) {
+//      A reverse postorder visiting false targets first lists true targets first, with an explicit stack as in IR::function.
+        vector<IR::blockId> postorder;
+        vector<bool> visited(ir_function.blocks.size(), false);
+        vector<pair<IR::blockId, size_t>> stack = {{0, 0}};
+        visited[0] = true;
+
+        while (!stack.empty()) {
+            auto& [block, next_successor] = stack.back();
+            vector<IR::blockId> successors = ir_function.successors(block);
+            std::reverse(successors.begin(), successors.end());
+
+            if (next_successor < successors.size()) {
+                const IR::blockId successor = successors[next_successor++];
+                if (!visited[successor]) {
+                    visited[successor] = true;
+                    stack.push_back({successor, 0});
+                }
+            } else {
+                postorder.push_back(block);
+                stack.pop_back();
+            }
+        }
+
+        std::reverse(postorder.begin(), postorder.end());
+        return postorder;
+    }
+
+/*
+    Record a read of a value at the given point.
+
+    Parameters:
+        state: compiler state (input/output)
+        value: the read value (input)
+        point: point of the read (input)
+*/
+    inline void _read(_compilerState& state, const IR::valueId value, const uint32_t point) noexcept {
+        state.last_reads[value] = std::max(state.last_reads[value], point);
+    }
+
+/*
+    Determine if a value can be written to the register of another value, since an instruction of its own block defines it.
+
+    Parameters:
+        state: compiler state (input)
+        value: the value (input)
+
+    Return true if the value can be coalesced.
+*/
+    inline bool _coalescible(const _compilerState& state, const IR::valueId value) noexcept {
+        const IR::opcode op = state.ir_function.values[value].op;
+        return (op != IR::opcode::Input) && (op != IR::opcode::Phi) && (state.registers[value] == _NO_REGISTER) && !state.fused[value];
+    }
+
+/*
+    Give a position to every instruction that needs code and to the end of every block, recording the last read of each value.
+    Constants, and conversions of constants, are given constant registers instead. A value only read by a phi along an edge
+    from its own block is coalesced with the phi, and a select, 'and' or 'or' with a condition only it reads is coalesced
+    with the condition, so neither needs a move.
+
+    Parameters:
+        state: compiler state (input/output)
+        layout: the blocks in code order (input)
+*/
+    void _plan_positions(_compilerState& state, const vector<IR::blockId>& layout) {
+        const IR::function& ir_function = state.ir_function;
+        uint32_t position = 0;
+        vector<IR::valueId> selects;
+
+//      Count the reads of each value, to find the comparisons only read by the branch that follows them.
+        for (const IR::blockId block : layout) {
+            for (const IR::valueId value : ir_function.blocks[block].instructions) {
+                for (const IR::valueId operand : ir_function.values[value].operands) {
+                    state.use_counts[operand]++;
+                }
+            }
+            if (ir_function.blocks[block].terminator == IR::terminatorType::Branch) {
+                state.use_counts[ir_function.blocks[block].condition]++;
+            }
+        }
+        for (const auto& [variable, value] : ir_function.outputs) {
+            state.use_counts[value]++;
+        }
+
+        for (const IR::blockId block : layout) {
+            const IR::basicBlock& curr_block = ir_function.blocks[block];
+            const IR::valueId condition = curr_block.condition;
+            const bool fused_condition = state.superinstructions && (curr_block.terminator == IR::terminatorType::Branch)
+                                         && (state.use_counts[condition] == 1) && (ir_function.values[condition].block == block)
+                                         && _number_comparison(ir_function, condition);
+
+            for (const IR::valueId value : curr_block.instructions) {
+                const IR::instruction& curr = ir_function.values[value];
+
+                if (curr.op == IR::opcode::Const) {
+                    state.registers[value] = _constant_register(state, _constant(curr));
+                    continue;
+                } else if ((curr.op == IR::opcode::Convert) && (ir_function.values[curr.operands[0]].op == IR::opcode::Const)) {
+                    state.registers[value] = _constant_register(state, convert_value(_constant(ir_function.values[curr.operands[0]]), curr.type));
+                    continue;
+                } else if ((curr.op == IR::opcode::Input) || (curr.op == IR::opcode::Phi)) {
+                    continue;
+                } else if (fused_condition && (value == condition)) {
+                    state.fused[value] = true;
+                    continue;
+                }
+
+                state.positions[value] = position;
+                for (const IR::valueId operand : curr.operands) {
+                    _read(state, operand, 2 * position);
+                }
+                position++;
+
+                if (((curr.op == IR::opcode::And) || (curr.op == IR::opcode::Or) || (curr.op == IR::opcode::Select))
+                    && (state.use_counts[curr.operands[0]] == 1) && _coalescible(state, curr.operands[0])) {
+                    state.coalesced[value] = curr.operands[0];
+                    selects.push_back(value);
+                }
+            }
+
+//          The branch reads its condition, or the operands of the comparison fused into its jump,
+//          and each edge to a block with phis reads the phi operands of that edge.
+            state.block_ends[block] = position;
+            if (fused_condition) {
+                for (const IR::valueId operand : ir_function.values[condition].operands) {
+                    _read(state, operand, 2 * position);
+                }
+            } else if (curr_block.terminator == IR::terminatorType::Branch) {
+                _read(state, condition, 2 * position);
+            }
+
+            for (const IR::blockId successor : ir_function.successors(block)) {
+                const vector<IR::blockId>& predecessors = ir_function.blocks[successor].predecessors;
+                const size_t edge = static_cast<size_t>(std::find(predecessors.begin(), predecessors.end(), block) - predecessors.begin());
+
+                for (const IR::valueId value : ir_function.blocks[successor].instructions) {
+                    if (ir_function.values[value].op != IR::opcode::Phi) {
+                        break;
+                    }
+                    const IR::valueId operand = ir_function.values[value].operands[edge];
+                    _read(state, operand, 2 * position);
+                    _read(state, value, 2 * position);
+
+                    if ((state.use_counts[operand] == 1) && (ir_function.values[operand].block == block) && _coalescible(state, operand)
+                        && (state.coalesced[operand] == IR::NO_VALUE)) {
+                        state.coalesced[operand] = value;
+                    }
+                }
+            }
+            position++;
+        }
+
+//      Outputs are read after the last instruction.
+        for (const auto& [variable, value] : ir_function.outputs) {
+            state.last_reads[value] = _END_POINT;
+        }
+
+//      A condition keeps its register until the last read of the selects coalesced with it, the last select first for chains of them.
+        for (vector<IR::valueId>::const_reverse_iterator select = selects.crbegin(); select != selects.crend(); select++) {
+            const IR::valueId condition = state.coalesced[*select];
+            state.last_reads[condition] = std::max(state.last_reads[condition], state.last_reads[*select]);
+        }
+    }
+
+/*
+    Compile an instruction.
+
+    Throw a FatalError if the instruction is not recognized or has types the bytecode has no instruction for.
+
+    Parameters:
+        state: compiler state (input/output)
+        value: the instruction (input)
+*/
+    void _compile_instruction(_compilerState& state, const IR::valueId value) {
+        const IR::instruction& curr = state.ir_function.values[value];
+        const uint32_t line_number = curr.line_number;
+        const uint32_t point = 2 * state.positions[value];
+        const dataType operand_type = curr.operands.empty() ? curr.type : state.ir_function.values[curr.operands[0]].type;
+
+        vector<uint32_t> sources;
+        for (const IR::valueId operand : curr.operands) {
+            sources.push_back(_register(state, operand));
+        }
+
+        switch (curr.op) {
+            case IR::opcode::Convert:
+                _emit(state, _conversion_opcode(operand_type, curr.type, line_number), _define(state, value, point + 1), sources[0], 0, line_number);
+                break;
+
+            case IR::opcode::Not:
+                _emit(state, opcode::Not, _define(state, value, point + 1), sources[0], 0, line_number);
+                break;
+
+            case IR::opcode::Add:
+            case IR::opcode::Sub:
+            case IR::opcode::Mul:
+            case IR::opcode::Div:
+            case IR::opcode::Exp: {
+                constexpr std::array<std::array<opcode, 5>, number_type_count> arithmetic_ops = {{
+                    {opcode::AddI32, opcode::SubI32, opcode::MulI32, opcode::Halt, opcode::Halt},
+                    {opcode::AddI64, opcode::SubI64, opcode::MulI64, opcode::Halt, opcode::Halt},
+                    {opcode::AddF32, opcode::SubF32, opcode::MulF32, opcode::Halt, opcode::Halt},
+                    {opcode::AddF64, opcode::SubF64, opcode::MulF64, opcode::DivF64, opcode::ExpF64}
+                }};
+                const size_t op_index = static_cast<size_t>(curr.op) - static_cast<size_t>(IR::opcode::Add);
+                opcode instruction_op = number_type(curr.type) ? arithmetic_ops[static_cast<size_t>(curr.type)][op_index] : opcode::Halt;
+                uint32_t src2 = sources[1];
+
+                if (instruction_op == opcode::Halt) {
+                    throw FatalError("arithmetic type not supported during compilation", line_number);
+                }
+
+//              Adding or subtracting a constant that fits 32 bits keeps the constant in the instruction.
+                if (state.superinstructions && (curr.type == dataType::Int64T) && ((curr.op == IR::opcode::Add) || (curr.op == IR::opcode::Sub))
+                    && ((src2 & _CONSTANT_TAG) != 0)) {
+                    const int64_t number = state.compiled.constants[src2 & _REGISTER_MASK].value.int64;
+
+                    if ((number >= std::numeric_limits<int32_t>::min()) && (number <= std::numeric_limits<int32_t>::max())) {
+                        instruction_op = (curr.op == IR::opcode::Add) ? opcode::AddImmI64 : opcode::SubImmI64;
+                        src2 = static_cast<uint32_t>(static_cast<int32_t>(number));
+                    }
+                }
+
+                _emit(state, instruction_op, _define(state, value, point + 1), sources[0], src2, line_number);
+                break;
+            }
+
+            case IR::opcode::Xor:
+                _emit(state, opcode::XorBool, _define(state, value, point + 1), sources[0], sources[1], line_number);
+                break;
+
+//          Numbers are compared in their type, booleans are only compared for equality.
+            case IR::opcode::Eq:
+            case IR::opcode::Gt:
+            case IR::opcode::Lt:
+            case IR::opcode::Ge:
+            case IR::opcode::Le: {
+                const opcode instruction_op = (operand_type == dataType::BoolT) ? opcode::EqualBool
+                                                                                 : comparison_opcode(opcode::GreaterI32, _comparison_operator(curr.op), operand_type);
+                _emit(state, instruction_op, _define(state, value, point + 1), sources[0], sources[1], line_number);
+                break;
+            }
+
+//          'and'/'or' and selects write their result before reading every operand, so it is written at the point the operands are read.
+//          With superinstructions they are a select on the condition, otherwise the condition jumps past the value not chosen.
+            case IR::opcode::And:
+            case IR::opcode::Or:
+            case IR::opcode::Select: {
+                const uint32_t dst = _define(state, value, point);
+                uint32_t chosen, otherwise;
+                if (curr.op == IR::opcode::And) {
+                    chosen = sources[1];
+                    otherwise = _constant_register(state, _constant(make_constant(dataType::BoolT, false, 0.0, line_number)));
+                } else if (curr.op == IR::opcode::Or) {
+                    chosen = _constant_register(state, _constant(make_constant(dataType::BoolT, true, 0.0, line_number)));
+                    otherwise = sources[1];
+                } else {
+                    chosen = sources[1];
+                    otherwise = sources[2];
+                }
+
+                if (dst != sources[0]) {
+                    _emit(state, opcode::Move, dst, sources[0], 0, line_number);
+                }
+                if (state.superinstructions) {
+                    _emit(state, opcode::Select, dst, chosen, otherwise, line_number);
+                } else {
+                    const uint32_t false_jump = _emit(state, opcode::JumpIfFalse, 0, dst, 0, line_number);
+                    _emit(state, opcode::Move, dst, chosen, 0, line_number);
+                    const uint32_t end_jump = _emit(state, opcode::Jump, 0, 0, 0, line_number);
+                    _patch_jump(state, false_jump);
+                    _emit(state, opcode::Move, dst, otherwise, 0, line_number);
+                    _patch_jump(state, end_jump);
+                }
+                break;
+            }
+
+//          Throw an exception when an instruction was not recognized (not implemented).
+            default:
+                throw FatalError("instruction not recognized during compilation", line_number);
+        }
+    }
+
+/*
+    Compile the moves into the phis of a block, along the edge from one of its predecessors.
+    The phis are written at the point their operands are read, so no move overwrites the operand of another.
+
+    Parameters:
+        state: compiler state (input/output)
+        block: the predecessor (input)
+        successor: the block with the phis (input)
+*/
+    void _compile_phi_moves(_compilerState& state, const IR::blockId block, const IR::blockId successor) {
+        const IR::function& ir_function = state.ir_function;
+        const vector<IR::blockId>& predecessors = ir_function.blocks[successor].predecessors;
+        const size_t edge = static_cast<size_t>(std::find(predecessors.begin(), predecessors.end(), block) - predecessors.begin());
+        const uint32_t point = 2 * state.block_ends[block];
+
+        for (const IR::valueId value : ir_function.blocks[successor].instructions) {
+            const IR::instruction& phi = ir_function.values[value];
+            if (phi.op != IR::opcode::Phi) {
+                break;
+            }
+
+            const uint32_t source = _register(state, phi.operands[edge]);
+            const uint32_t dst = (state.registers[value] == _NO_REGISTER) ? _define(state, value, point) : state.registers[value];
+            if (source != dst) {
+                _emit(state, opcode::Move, dst, source, 0, phi.line_number);
+            }
+        }
+    }
+
+/*
+    Compile the end of a block. A branch writes the phis of its false target before jumping, and those of its true target after,
+    since only the path taken continues to read them.
+
+    Parameters:
+        state: compiler state (input/output)
+        block: the block (input)
+        next_block: block compiled after it, IR::NO_BLOCK for the last block (input)
+*/
+    void _compile_terminator(_compilerState& state, const IR::blockId block, const IR::blockId next_block) {
+        const IR::basicBlock& curr_block = state.ir_function.blocks[block];
+
+        switch (curr_block.terminator) {
+            case IR::terminatorType::Return:
+                _emit(state, opcode::Halt, 0, 0, 0, 0);
+                break;
+
+            case IR::terminatorType::Jump:
+                _compile_phi_moves(state, block, curr_block.true_target);
+                if (curr_block.true_target != next_block) {
+                    _emit_block_jump(state, opcode::Jump, 0, 0, curr_block.true_target, 0);
+                }
+                break;
+
+            case IR::terminatorType::Branch: {
+                const IR::instruction& condition = state.ir_function.values[curr_block.condition];
+                _compile_phi_moves(state, block, curr_block.false_target);
+
+                if (state.fused[curr_block.condition]) {
+                    const opcode op = comparison_opcode(opcode::JumpUnlessGreaterI32, _comparison_operator(condition.op), state.ir_function.values[condition.operands[0]].type);
+                    _emit_block_jump(state, op, _register(state, condition.operands[0]), _register(state, condition.operands[1]), curr_block.false_target,
+                                     condition.line_number);
+                } else {
+                    _emit_block_jump(state, opcode::JumpIfFalse, _register(state, curr_block.condition), 0, curr_block.false_target, condition.line_number);
+                }
+
+                _compile_phi_moves(state, block, curr_block.true_target);
+                if (curr_block.true_target != next_block) {
+                    _emit_block_jump(state, opcode::Jump, 0, 0, curr_block.true_target, condition.line_number);
+                }
+                break;
+            }
+        }
+    }
+
+/*
+    Place every register of the compiled program now the number of each kind is known,
+    removing the constants that were only converted while compiling and are never read.
+
+    Parameters:
+        state: compiler state (input/output)
+*/
+    void _place_registers(_compilerState& state) {
+        program& compiled = state.compiled;
+        vector<uint32_t*> operands;
+
+//      Collect every register operand, with the constant registers in use.
+        vector<bool> used_constants(compiled.constants.size(), false);
+        for (instruction& curr_instruction : compiled.code) {
+            const opcodeInfo& info = opcode_info(curr_instruction.op);
+
+            for (const auto& [kind, operand] : {pair(info.dst, &curr_instruction.dst), pair(info.src1, &curr_instruction.src1),
+                                                pair(info.src2, &curr_instruction.src2)}) {
+                if (kind == operandKind::Register) {
+                    operands.push_back(operand);
+                }
+            }
+        }
+        for (auto& [variable, location] : compiled.inputs) {
+            operands.push_back(&location.index);
+        }
+        for (auto& [variable, location] : compiled.outputs) {
+            operands.push_back(&location.index);
+        }
+        for (const uint32_t* const operand : operands) {
+            if ((*operand & _CONSTANT_TAG) != 0) {
+                used_constants[*operand & _REGISTER_MASK] = true;
+            }
+        }
+
+//      Keep the constants in use, in their original order.
+        vector<uint32_t> constant_indices(compiled.constants.size(), 0);
+        vector<typedValue> constants;
+        for (size_t constant_index = 0; constant_index < compiled.constants.size(); constant_index++) {
+            if (used_constants[constant_index]) {
+                constant_indices[constant_index] = static_cast<uint32_t>(constants.size());
+                constants.push_back(compiled.constants[constant_index]);
+            }
+        }
+        compiled.constants = move(constants);
+
+        const uint32_t variable_offset = static_cast<uint32_t>(compiled.constants.size());
+        const uint32_t temporary_offset = variable_offset + static_cast<uint32_t>(compiled.inputs.size());
+        for (uint32_t* const operand : operands) {
+            if ((*operand & _CONSTANT_TAG) != 0) {
+                *operand = constant_indices[*operand & _REGISTER_MASK];
+            } else if ((*operand & _TEMPORARY_TAG) != 0) {
+                *operand = temporary_offset + (*operand & _REGISTER_MASK);
+            } else {
+                *operand += variable_offset;
+            }
+        }
+
+        compiled.register_count = temporary_offset + state.temporary_count;
+        return;
+    }
+
+}
+
+
+program compile_program(const shared_ptr<dataNode>& data_node, const shared_ptr<environment>& global_env, const bool superinstructions) {
+    REGAL_TRACE_SPAN("compile_program");
+    IR::function ir_function = lower_to_ir(data_node, global_env);
+    standard_pipeline().run(ir_function);
+
+    const size_t value_count = ir_function.values.size();
+    _compilerState state{ir_function, program{}, {}, superinstructions, vector<uint32_t>(value_count, _NO_REGISTER), vector<uint32_t>(value_count, 0),
+                         vector<uint32_t>(value_count, 0), vector<uint32_t>(value_count, 0), vector<uint32_t>(ir_function.blocks.size(), 0),
+                         vector<bool>(value_count, false), vector<IR::valueId>(value_count, IR::NO_VALUE), {}, {}, 0, vector<uint32_t>(ir_function.blocks.size(), 0), {}};
+
+//  Runtime variables start in their registers with their declared types, whether or not the program still reads them.
+    for (const auto& [variable, declared_type] : global_env->inputs) {
+        const uint32_t index = static_cast<uint32_t>(state.compiled.inputs.size());
+        state.compiled.inputs[variable] = variableRegister{index, declared_type};
+    }
+    for (IR::valueId value = 0; value < value_count; value++) {
+        if (ir_function.values[value].op == IR::opcode::Input) {
+            state.registers[value] = state.compiled.inputs.at(ir_function.values[value].variable).index;
+        }
+    }
+
+    const vector<IR::blockId> layout = _code_layout(ir_function);
+    _plan_positions(state, layout);
+
+    for (size_t index = 0; index < layout.size(); index++) {
+        const IR::blockId block = layout[index];
+        state.block_starts[block] = static_cast<uint32_t>(state.compiled.code.size());
+
+        for (const IR::valueId value : ir_function.blocks[block].instructions) {
+            if ((state.registers[value] == _NO_REGISTER) && (ir_function.values[value].op != IR::opcode::Phi) && !state.fused[value]) {
+                _compile_instruction(state, value);
+            }
+        }
+        _compile_terminator(state, block, (index + 1 < layout.size()) ? layout[index + 1] : IR::NO_BLOCK);
+    }
+    for (const auto& [jump_index, target] : state.block_jumps) {
+        state.compiled.code[jump_index].dst = state.block_starts[target];
+    }
+
+//  The result is the final value of each global variable, converted from the type of its register to the type analysis gave it.
+    for (const auto& [variable, info] : global_env->locals) {
+        const IR::valueId value = ir_function.outputs.at(variable);
+        state.compiled.outputs[variable] = outputRegister{_register(state, value), ir_function.values[value].type, info.type};
+    }
+
+    _place_registers(state);
+    return state.compiled;
+}
@@ -0,0 +1,759 @@
+/*
+
+Function implementations for transpiling an analyzed AST into a standalone C++ translation unit.
+
+*/
+
+#include "inc_runtime/cpp_emitter.hpp"
+#include "inc_internal/tracing.hpp"
+
+#include <set>
+#include <array>
+#include <cstdio>
+
+#include "inc_stdlib/stdio.hpp"
+
+// Standard library aliases
+using std::map, std::set, std::pair, std::shared_ptr, std::string, std::string_view, std::uint32_t, std::move;
+
+// interp_utils namespaces
+using namespace TypingUtils;
+using namespace CodeTree;
+using namespace TypeRules;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// runtime_value namespace
+using namespace Runtime;
+
+
+// Transpilation helper functions.
+namespace {
+
+//  Start of every translation unit: the checked arithmetic, displays and argument parsing the program uses.
+//  Each function matches its counterpart in the interpreter (checked_arithmetic.hpp, raise_arithmetic_error, num_to_string).
+    constexpr string_view _CPP_PRELUDE = R"cpp(#include <charconv>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+// Largest accurate float, integers are symmetric so their smallest value is never exact.
+constexpr double REGAL_MAX_FLOAT64 = 9007199254740992.0;
+constexpr std::int64_t REGAL_MAX_INT64 = std::numeric_limits<std::int64_t>::max();
+
+// Display a value as the interpreter does: floats with the shortest decimals that round-trip, but at least one decimal.
+template <typename T>
+inline std::string regal_display(const T value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return value ? "true" : "false";
+    } else if constexpr (std::is_integral_v<T>) {
+        return std::to_string(value);
+    } else {
+        char number_chars[330];
+        std::string number_str(number_chars, std::to_chars(number_chars, number_chars + sizeof(number_chars), value, std::chars_format::fixed).ptr);
+        if (std::isfinite(value) && (number_str.find('.') == std::string::npos)) {
+            number_str += ".0";
+        }
+        return number_str;
+    }
+}
+
+[[noreturn]] inline void regal_fail(const std::string& message, const std::uint32_t line_number) {
+    throw std::runtime_error("[" + std::to_string(line_number) + "]: " + message);
+}
+
+inline bool regal_exact(const std::int64_t number) {
+    return number != std::numeric_limits<std::int64_t>::min();
+}
+
+inline bool regal_exact(const double number) {
+    return (number >= -REGAL_MAX_FLOAT64) && (number <= REGAL_MAX_FLOAT64);
+}
+
+inline std::int64_t regal_add(const std::int64_t num1, const std::int64_t num2, const std::uint32_t line_number) {
+    std::int64_t result;
+    if (__builtin_add_overflow(num1, num2, &result) || !regal_exact(result)) {
+        regal_fail("overflow when adding " + regal_display(num1) + " to " + regal_display(num2), line_number);
+    }
+    return result;
+}
+
+inline std::int64_t regal_sub(const std::int64_t num1, const std::int64_t num2, const std::uint32_t line_number) {
+    std::int64_t result;
+    if (__builtin_sub_overflow(num1, num2, &result) || !regal_exact(result)) {
+        regal_fail("overflow when subtracting " + regal_display(num1) + " from " + regal_display(num2), line_number);
+    }
+    return result;
+}
+
+inline bool regal_checked_mul(const std::int64_t num1, const std::int64_t num2, std::int64_t& result) {
+    const __int128 product = static_cast<__int128>(num1) * static_cast<__int128>(num2);
+    if ((product < -static_cast<__int128>(REGAL_MAX_INT64)) || (product > static_cast<__int128>(REGAL_MAX_INT64))) {
+        return false;
+    }
+    result = static_cast<std::int64_t>(product);
+    return true;
+}
+
+inline std::int64_t regal_mul(const std::int64_t num1, const std::int64_t num2, const std::uint32_t line_number) {
+    std::int64_t result = 0;
+    if (!regal_checked_mul(num1, num2, result)) {
+        regal_fail("overflow when multiplying " + regal_display(num1) + " with " + regal_display(num2), line_number);
+    }
+    return result;
+}
+
+inline double regal_add(const double num1, const double num2, const std::uint32_t line_number) {
+    const double result = num1 + num2;
+    if (!regal_exact(result)) {
+        regal_fail("overflow when adding " + regal_display(num1) + " to " + regal_display(num2), line_number);
+    }
+    return result;
+}
+
+inline double regal_sub(const double num1, const double num2, const std::uint32_t line_number) {
+    const double result = num1 - num2;
+    if (!regal_exact(result)) {
+        regal_fail("overflow when subtracting " + regal_display(num1) + " from " + regal_display(num2), line_number);
+    }
+    return result;
+}
+
+inline double regal_mul(const double num1, const double num2, const std::uint32_t line_number) {
+    const double result = num1 * num2;
+    if (!regal_exact(result)) {
+        regal_fail("overflow when multiplying " + regal_display(num1) + " with " + regal_display(num2), line_number);
+    }
+    return result;
+}
+
+inline double regal_div(const double num1, const double num2, const std::uint32_t line_number) {
+    if (num2 == 0) {
+        regal_fail("dividing " + regal_display(num1) + " by 0", line_number);
+    }
+    const double result = num1 / num2;
+    if (!regal_exact(result)) {
+        regal_fail("overflow when dividing " + regal_display(num1) + " by " + regal_display(num2), line_number);
+    }
+    return result;
+}
+
+// Whole-number powers of whole numbers are computed exactly by squaring.
+inline bool regal_checked_pow(std::int64_t base, std::int64_t exponent, std::int64_t& result) {
+    std::int64_t power = 1;
+    while (exponent != 0) {
+        if (((exponent & 1) != 0) && !regal_checked_mul(power, base, power)) {
+            return false;
+        }
+        exponent >>= 1;
+        if ((exponent != 0) && !regal_checked_mul(base, base, base)) {
+            return false;
+        }
+    }
+    result = power;
+    return true;
+}
+
+inline double regal_pow(const double base, const double exponent, const std::uint32_t line_number) {
+    const bool whole_exponent = std::trunc(exponent) == exponent;
+    bool exact = !(((base < 0.0) && !whole_exponent) || ((base == 0.0) && (exponent < 0.0)));
+    double result = 0.0;
+
+    if (exact && whole_exponent && (exponent >= 0.0) && (exponent < static_cast<double>(REGAL_MAX_INT64)) && (std::trunc(base) == base)
+        && regal_exact(base)) {
+        std::int64_t power = 0;
+        exact = regal_checked_pow(static_cast<std::int64_t>(base), static_cast<std::int64_t>(exponent), power);
+        result = static_cast<double>(power);
+    } else if (exact) {
+        result = std::pow(base, exponent);
+    }
+
+    if (!exact || !regal_exact(result)) {
+        if ((base < 0) && !whole_exponent) {
+            regal_fail("invalid negative base with non-integer exponent: " + regal_display(base) + "^" + regal_display(exponent), line_number);
+        }
+        regal_fail("overflow from " + regal_display(base) + "^" + regal_display(exponent), line_number);
+    }
+    return result;
+}
+
+// Read the value of a runtime variable, written as the interpreter reads a number literal: an optional '-', then digits with
+// at most one '.'. Numbers are converted to the variable's type as the interpreter converts them, and rejected if they do not fit it.
+template <typename T>
+inline bool regal_parse(const char* const text, T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        if ((std::strcmp(text, "true") != 0) && (std::strcmp(text, "false") != 0)) {
+            return false;
+        }
+        value = std::strcmp(text, "true") == 0;
+        return true;
+    } else {
+        const char* const digits = (*text == '-') ? text + 1 : text;
+        std::size_t length = 0;
+        std::size_t points = 0;
+        for (; digits[length] != '\0'; length++) {
+            if (digits[length] == '.') {
+                points++;
+            } else if ((digits[length] < '0') || (digits[length] > '9')) {
+                return false;
+            }
+        }
+        if ((length == points) || (points > 1)) {
+            return false;
+        }
+
+//      Integers are symmetric, so their smallest value is out of range as the interpreter's.
+        char* end;
+        errno = 0;
+        if (points == 0) {
+            const long long whole = std::strtoll(text, &end, 10);
+            if ((errno != 0) || !regal_exact(static_cast<std::int64_t>(whole))) {
+                return false;
+            }
+            if constexpr (std::is_integral_v<T>) {
+                if ((whole > std::numeric_limits<T>::max()) || (whole < -std::numeric_limits<T>::max())) {
+                    return false;
+                }
+            }
+            value = static_cast<T>(whole);
+            return true;
+        }
+
+        const double number = std::strtod(text, &end);
+        if (errno != 0) {
+            return false;
+        }
+//      An integer is never given a fraction, the interpreter rejects such a value as not combining with its type.
+        if constexpr (std::is_integral_v<T>) {
+            if ((std::trunc(number) != number) || (std::abs(number) >= std::ldexp(1.0, std::numeric_limits<T>::digits))) {
+                return false;
+            }
+            value = static_cast<T>(number);
+        } else {
+            value = static_cast<T>(number);
+            if (!std::isfinite(value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+}
+)cpp";
+
+//  State carried through the transpilation of an AST.
+    struct _emitterState {
+//      statements being emitted
+        string code;
+//      indentation of the statements being emitted
+        string indent;
+//      current type of each variable
+        map<string, dataType> types;
+//      typed locals used by the statements, declared at the start of the program
+        set<pair<string, dataType>> locals;
+//      number of temporaries created
+        uint32_t temporary_count = 0;
+    };
+
+/*
+    Retrieve the C++ type of a data type.
+
+    Parameters:
+        type: the data type (input)
+
+    Return the name of the C++ type.
+*/
+    string _cpp_type(const dataType type) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                return "std::int32_t";
+            case dataType::Int64T:
+                return "std::int64_t";
+            case dataType::Float32T:
+                return "float";
+            case dataType::Float64T:
+                return "double";
+            default:
+                return "bool";
+        }
+    }
+
+/*
+    Retrieve the name of a variable's local of the given type, recording that the local is used.
+
+    Parameters:
+        state: transpilation state (input/output)
+        variable: name of the variable (input)
+        type: type of the local (input)
+
+    Return the local's name.
+*/
+    string _local_name(_emitterState& state, const string& variable, const dataType type) {
+        constexpr std::array<string_view, number_type_count + 1> suffixes = {"i32", "i64", "f32", "f64", "b"};
+
+        state.locals.emplace(variable, type);
+        return "v_" + variable + "_" + string(suffixes[static_cast<std::size_t>(type)]);
+    }
+
+/*
+    Create a C++ literal with the exact value of an irreducible data container. Floats are written in hexadecimal.
+
+    Parameters:
+        value_data: the container (input)
+        type: the container's type (output)
+
+    Return the literal.
+*/
+    string _literal(const valueData* const value_data, dataType& type) {
+        const typedValue value = constant_value(value_data);
+        type = value.type;
+
+        char float_str[64];
+        switch (value.type) {
+            case dataType::Int32T:
+                return "std::int32_t{" + std::to_string(value.value.int32) + "}";
+            case dataType::Int64T:
+                return "std::int64_t{" + std::to_string(value.value.int64) + "}";
+            case dataType::Float32T:
+                std::snprintf(float_str, sizeof(float_str), "%a", static_cast<double>(value.value.float32));
+                return "(" + string(float_str) + "f)";
+            case dataType::Float64T:
+                std::snprintf(float_str, sizeof(float_str), "%a", value.value.float64);
+                return "(" + string(float_str) + ")";
+            default:
+                return value.value.boolean ? "true" : "false";
+        }
+    }
+
+/*
+    Convert a C++ expression to the given type, as convert_value converts runtime values.
+
+    Parameters:
+        expression: the expression (input)
+        from: the expression's type (input)
+        to: type to convert to (input)
+
+    Return the converted expression.
+*/
+    string _convert(const string& expression, const dataType from, const dataType to) {
+        if ((from == to) || (to == dataType::BoolT)) {
+            return expression;
+        }
+
+//      Numbers are converted through the 64-bit type of their kind, as at runtime.
+        const dataType wide_type = integer_type(to) ? dataType::Int64T : dataType::Float64T;
+        string converted = (from == wide_type) ? expression : "static_cast<" + _cpp_type(wide_type) + ">(" + expression + ")";
+        return (to == wide_type) ? converted : "static_cast<" + _cpp_type(to) + ">(" + converted + ")";
+    }
+
+/*
+    Append a statement to the emitted code.
+
+    Parameters:
+        state: transpilation state (input/output)
+        statement: the statement (input)
+*/
+    inline void _emit_statement(_emitterState& state, const string& statement) {
+        state.code += state.indent + statement + "\n";
+    }
+
+/*
+    Create a new temporary.
+
+    Parameters:
+        state: transpilation state (input/output)
+
+    Return the temporary's name.
+*/
+    inline string _temporary(_emitterState& state) {
+        return "t" + std::to_string(state.temporary_count++);
+    }
+
+/*
+    Compute the runtime type of an expression.
+
+    Throw a FatalError if the expression is not recognized or reads a variable with no known type.
+
+    Parameters:
+        value_data: the expression (input)
+        types: current type of each variable (input)
+
+    Return the expression's type.
+*/
+    dataType _expression_type(const valueData* const value_data, const map<string, dataType>& types) {
+        switch (value_data->type) {
+            case nodeType::VarContainer: {
+                const varContainer* const var_container = static_cast<const varContainer*>(value_data);
+                const map<string, dataType>::const_iterator type = types.find(var_container->variable);
+
+                if (type == types.end()) {
+                    throw FatalError("variable '" + var_container->variable + "' has no value during transpilation", var_container->line_number);
+                }
+                return type->second;
+            }
+
+            case nodeType::UnaryOp:
+                return dataType::BoolT;
+
+            case nodeType::BinaryOp: {
+                const binaryOp* const binary_op = static_cast<const binaryOp*>(value_data);
+                if (!binary_token(binary_op->op)) {
+                    throw FatalError("binary operator not recognized during transpilation", binary_op->line_number);
+                }
+
+                return binary_rule(binary_operator(binary_op->op), _expression_type(binary_op->expression1.get(), types),
+                                   _expression_type(binary_op->expression2.get(), types)).result;
+            }
+
+            case nodeType::TernaryOp: {
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(value_data);
+                return runtime_merged_type(_expression_type(ternary_op->expression1.get(), types), _expression_type(ternary_op->expression3.get(), types));
+            }
+
+//          Irreducible data has the type of its container.
+            default:
+                return constant_value(value_data).type;
+        }
+    }
+
+/*
+    Emit the statements computing an expression, in evaluation order, and create the C++ expression of its value.
+    Operations that can not fail are kept in the expression, those that can are computed into temporaries.
+
+    Throw a FatalError if the expression is not recognized or reads a variable with no known type.
+
+    Parameters:
+        value_data: the expression (input)
+        state: transpilation state (input/output)
+        type: the expression's type (output)
+
+    Return the C++ expression of the value.
+*/
+    string _emit_value(const valueData* const value_data, _emitterState& state, dataType& type) {
+        switch (value_data->type) {
+            case nodeType::VarContainer:
+                type = _expression_type(value_data, state.types);
+                return _local_name(state, static_cast<const varContainer*>(value_data)->variable, type);
+
+            case nodeType::UnaryOp: {
+                dataType operand_type;
+                const string operand = _emit_value(static_cast<const unaryOp*>(value_data)->expression.get(), state, operand_type);
+                type = dataType::BoolT;
+                return "(!" + operand + ")";
+            }
+
+            case nodeType::BinaryOp: {
+                const binaryOp* const binary_op = static_cast<const binaryOp*>(value_data);
+                if (!binary_token(binary_op->op)) {
+                    throw FatalError("binary operator not recognized during transpilation", binary_op->line_number);
+                }
+                const binaryOperator op = binary_operator(binary_op->op);
+
+                dataType type1, type2;
+                const string operand1 = _emit_value(binary_op->expression1.get(), state, type1);
+
+//              'and'/'or' only compute the second operand when the first does not decide the result.
+                if ((op == binaryOperator::And) || (op == binaryOperator::Or)) {
+                    const string result = _temporary(state);
+                    _emit_statement(state, "bool " + result + " = " + operand1 + ";");
+                    _emit_statement(state, string("if (") + ((op == binaryOperator::And) ? "" : "!") + result + ") {");
+
+                    state.indent += "    ";
+                    const string operand2 = _emit_value(binary_op->expression2.get(), state, type2);
+                    _emit_statement(state, result + " = " + operand2 + ";");
+                    state.indent.resize(state.indent.size() - 4);
+
+                    _emit_statement(state, "}");
+                    type = dataType::BoolT;
+                    return result;
+                }
+
+                const string operand2 = _emit_value(binary_op->expression2.get(), state, type2);
+                switch (operator_kind(op)) {
+                    case operatorKind::Arithmetic:
+                    case operatorKind::FloatArithmetic: {
+                        constexpr std::array<string_view, 5> functions = {"regal_add", "regal_sub", "regal_mul", "regal_div", "regal_pow"};
+
+                        type = binary_rule(op, type1, type2).result;
+                        const string result = _temporary(state);
+                        _emit_statement(state, "const " + _cpp_type(type) + " " + result + " = " + string(functions[static_cast<std::size_t>(op)]) + "("
+                                               + _convert(operand1, type1, type) + ", " + _convert(operand2, type2, type) + ", "
+                                               + std::to_string(binary_op->line_number) + ");");
+                        return result;
+                    }
+
+                    case operatorKind::Logical:
+                        type = dataType::BoolT;
+                        return "(" + operand1 + " != " + operand2 + ")";
+
+//                  Numbers are compared in their runtime merged type, as 64-bit numbers.
+                    default: {
+                        constexpr std::array<string_view, 5> comparisons = {" > ", " < ", " == ", " >= ", " <= "};
+
+                        const dataType merged_type = runtime_merged_type(type1, type2);
+                        const dataType compared_type = (merged_type == dataType::BoolT) ? dataType::BoolT
+                                                                                         : (integer_type(merged_type) ? dataType::Int64T : dataType::Float64T);
+                        type = dataType::BoolT;
+                        return "(" + _convert(operand1, type1, compared_type)
+                               + string(comparisons[static_cast<std::size_t>(op) - static_cast<std::size_t>(binaryOperator::Greater)])
+                               + _convert(operand2, type2, compared_type) + ")";
+                    }
+                }
+            }
+
+//          The second expression of a ternary operator is its condition, and only the chosen value is computed.
+            case nodeType::TernaryOp: {
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(value_data);
+                type = _expression_type(ternary_op, state.types);
+
+                dataType condition_type, chosen_type;
+                const string condition = _emit_value(ternary_op->expression2.get(), state, condition_type);
+                const string result = _temporary(state);
+                _emit_statement(state, _cpp_type(type) + " " + result + ";");
+                _emit_statement(state, "if (" + condition + ") {");
+
+                state.indent += "    ";
+                string chosen = _emit_value(ternary_op->expression1.get(), state, chosen_type);
+                _emit_statement(state, result + " = " + _convert(chosen, chosen_type, type) + ";");
+                state.indent.resize(state.indent.size() - 4);
+                _emit_statement(state, "} else {");
+
+                state.indent += "    ";
+                chosen = _emit_value(ternary_op->expression3.get(), state, chosen_type);
+                _emit_statement(state, result + " = " + _convert(chosen, chosen_type, type) + ";");
+                state.indent.resize(state.indent.size() - 4);
+                _emit_statement(state, "}");
+
+                return result;
+            }
+
+//          Irreducible data is its own value.
+            default:
+                return _literal(value_data, type);
+        }
+    }
+
+/*
+    Emit the statements of a block, in the given indentation, and retrieve them apart from the other statements.
+
+    Parameters:
+        data_node: the block (input)
+        state: transpilation state, with the types updated to the types after the block (input/output)
+
+    Return the block's statements.
+*/
+    void _emit_node(const dataNode* const data_node, _emitterState& state);
+    string _emit_block(const dataNode* const data_node, _emitterState& state) {
+        string outer_code = move(state.code);
+        state.code.clear();
+        state.indent += "    ";
+
+        _emit_node(data_node, state);
+
+        state.indent.resize(state.indent.size() - 4);
+        string block_code = move(state.code);
+        state.code = move(outer_code);
+        return block_code;
+    }
+
+/*
+    Emit the statements of a statement or list of statements.
+
+    Throw a FatalError if the AST contains an unrecognized node or reads a variable with no known type.
+
+    Parameters:
+        data_node: the AST to emit (input)
+        state: transpilation state (input/output)
+*/
+    void _emit_node(const dataNode* const data_node, _emitterState& state) {
+        switch (data_node->type) {
+            case nodeType::CodeScope: {
+                const codeScope* const code_scope = static_cast<const codeScope*>(data_node);
+
+//              An empty scope has nothing to emit.
+                if (code_scope->curr_operation != nullptr) {
+                    _emit_node(code_scope->curr_operation.get(), state);
+                    _emit_node(code_scope->remainder.get(), state);
+                }
+                break;
+            }
+
+            case nodeType::AssignOp:
+            case nodeType::ReassignOp: {
+                const bool assign = data_node->type == nodeType::AssignOp;
+                const string& variable = assign ? static_cast<const assignOp*>(data_node)->variable : static_cast<const reassignOp*>(data_node)->variable;
+                const valueData* const expression = assign ? static_cast<const assignOp*>(data_node)->expression.get()
+                                                           : static_cast<const reassignOp*>(data_node)->expression.get();
+
+                dataType type;
+                const string value = _emit_value(expression, state, type);
+                _emit_statement(state, _local_name(state, variable, type) + " = " + value + ";");
+                state.types[variable] = type;
+                break;
+            }
+
+            case nodeType::IfBlock: {
+                const ifBlock* const if_block = static_cast<const ifBlock*>(data_node);
+                dataType condition_type;
+                const string condition = _emit_value(if_block->bool_condition.get(), state, condition_type);
+
+//              Variables declared inside either block go out of scope when the blocks meet.
+                const map<string, dataType> types_before = state.types;
+                string if_code = _emit_block(if_block->code_block.get(), state);
+                const map<string, dataType> if_types = move(state.types);
+
+                state.types = types_before;
+                string else_code = if_block->contains_else ? _emit_block(if_block->else_block.get(), state) : "";
+                const map<string, dataType> else_types = move(state.types);
+
+//              Merge every variable assigned on both paths, converting it at the end of each block where its type differs.
+                state.types = types_before;
+                for (const auto& [variable, if_type] : if_types) {
+                    const map<string, dataType>::const_iterator else_type = else_types.find(variable);
+                    if (else_type == else_types.end()) {
+                        continue;
+                    }
+
+                    const dataType merged_type = runtime_merged_type(if_type, else_type->second);
+                    state.types[variable] = merged_type;
+
+                    const string merged_local = _local_name(state, variable, merged_type);
+                    if (if_type != merged_type) {
+                        if_code += state.indent + "    " + merged_local + " = " + _convert(_local_name(state, variable, if_type), if_type, merged_type) + ";\n";
+                    }
+                    if (else_type->second != merged_type) {
+                        else_code += state.indent + "    " + merged_local + " = "
+                                     + _convert(_local_name(state, variable, else_type->second), else_type->second, merged_type) + ";\n";
+                    }
+                }
+
+                _emit_statement(state, "if (" + condition + ") {");
+                state.code += if_code;
+                if (!else_code.empty()) {
+                    _emit_statement(state, "} else {");
+                    state.code += else_code;
+                }
+                _emit_statement(state, "}");
+                break;
+            }
+
+//          Throw an exception when a piece of data was not recognized (not implemented).
+            default:
+                throw FatalError("data not recognized during transpilation", data_node->line_number);
+        }
+
+        return;
+    }
+
+}
+
+
+string emit_cpp(const shared_ptr<dataNode>& data_node, const shared_ptr<environment>& global_env) {
+    REGAL_TRACE_SPAN("emit_cpp");
+    _emitterState state;
+    state.indent = "    ";
+
+//  Runtime variables start with their given values, in their declared types.
+    string inputs_code = "struct regal_inputs {\n";
+    for (const auto& [variable, declared_type] : global_env->inputs) {
+        inputs_code += "    " + _cpp_type(declared_type) + " v_" + variable + "{};\n";
+        _emit_statement(state, _local_name(state, variable, declared_type) + " = inputs.v_" + variable + ";");
+        state.types[variable] = declared_type;
+    }
+    inputs_code += "};\n";
+
+    _emit_node(data_node.get(), state);
+
+//  The outputs are the variables not known pre-runtime, converted to the type analysis gave them.
+//  Constants are displayed as analysis displays them, so their display strings are emitted directly.
+    string outputs_code = "struct regal_outputs {\n";
+    string display_code = "    std::string display = \"Constants:\";\n";
+    _emit_statement(state, "regal_outputs outputs;");
+    for (const auto& [variable, info] : global_env->locals) {
+        if (info.optimize_value) {
+            display_code += "    display += \"\\n   " + display_type(info.type, 0) + " " + variable + ": "
+                            + to_string(static_cast<irreducibleData*>(info.value.get())) + "\";\n";
+            continue;
+        }
+
+        const map<string, dataType>::const_iterator type = state.types.find(variable);
+        if (type == state.types.end()) {
+            throw FatalError("variable \'" + variable + "\' has no value after transpilation", 0);
+        }
+
+        outputs_code += "    " + _cpp_type(info.type) + " v_" + variable + "{};\n";
+        _emit_statement(state, "outputs.v_" + variable + " = " + _convert(_local_name(state, variable, type->second), type->second, info.type) + ";");
+        display_code += "    display += \"\\n   " + display_type(info.type, 0) + " " + variable + ": \" + regal_display(outputs.v_" + variable + ");\n";
+    }
+    outputs_code += "};\n";
+    _emit_statement(state, "return outputs;");
+
+//  Every local is declared at the start of the program, so it is in scope wherever the blocks of an 'if' meet.
+    string locals_code;
+    for (const auto& [variable, type] : state.locals) {
+        locals_code += "    [[maybe_unused]] " + _cpp_type(type) + " " + _local_name(state, variable, type) + "{};\n";
+    }
+
+//  Each runtime variable is read from an argument 'name=value', and must be given.
+    string parse_code;
+    string given_code;
+    for (const auto& [variable, declared_type] : global_env->inputs) {
+        parse_code += "        } else if (variable == \"" + variable + "\") {\n"
+                      "            valid = regal_parse(value, inputs.v_" + variable + ");\n"
+                      "            given_" + variable + " = true;\n";
+        given_code += "    bool given_" + variable + " = false;\n";
+    }
+    string missing_code;
+    for (const auto& [variable, declared_type] : global_env->inputs) {
+        missing_code += "    if (!given_" + variable + ") {\n"
+                        "        std::fputs(\"[0]: runtime variable \'" + variable + "\' was given no value\", stderr);\n"
+                        "        return EXIT_FAILURE;\n"
+                        "    }\n";
+    }
+
+    return "// Generated from a Regal program. Run as './program [name=value]...', giving each runtime variable a value.\n\n"
+           + string(_CPP_PRELUDE) + "\n"
+           + "// Values of the runtime variables, with their declared types.\n" + inputs_code + "\n"
+           + "// Final values of the variables not known pre-runtime, with the types analysis gave them.\n" + outputs_code + "\n"
+           + "// Execute the program. Throw a std::runtime_error with the interpreter's message if an operation fails.\n"
+           + "regal_outputs regal_run(const regal_inputs& inputs) {\n" + locals_code + "\n" + state.code + "}\n\n"
+           + "// Read the runtime variables from the arguments, run the program and display its variables as the interpreter does.\n"
+           + "int main(int argc, char* argv[]) {\n"
+           + "    regal_inputs inputs;\n" + given_code
+           + "    for (int arg_index = 1; arg_index < argc; arg_index++) {\n"
+           + "        const char* const bind = std::strchr(argv[arg_index], '=');\n"
+           + "        const std::string variable = (bind == nullptr) ? \"\" : std::string(argv[arg_index], static_cast<std::size_t>(bind - argv[arg_index]));\n"
+           + "        const char* const value = (bind == nullptr) ? \"\" : bind + 1;\n"
+           + "        bool valid = false;\n\n"
+           + "        if (bind == nullptr) {\n"
+           + parse_code
+           + "        }\n"
+           + "        if (!valid) {\n"
+           + "            std::fprintf(stderr, \"invalid runtime variable argument '%s'\", argv[arg_index]);\n"
+           + "            return EXIT_FAILURE;\n"
+           + "        }\n"
+           + "    }\n"
+           + missing_code + "\n"
+           + "    regal_outputs outputs;\n"
+           + "    try {\n"
+           + "        outputs = regal_run(inputs);\n"
+           + "    } catch (const std::exception& e) {\n"
+           + "        std::fputs(e.what(), stderr);\n"
+           + "        return EXIT_FAILURE;\n"
+           + "    }\n\n"
+           + display_code
+           + "    std::puts(display.c_str());\n"
+           + "    return 0;\n"
+           + "}\n";
+}
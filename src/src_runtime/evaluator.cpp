@@ -0,0 +1,551 @@
+/*
+
+Function implementations for evaluating an analyzed AST at runtime.
+
+*/
+
+#include "inc_runtime/evaluator.hpp"
+#include "inc_internal/tracing.hpp"
+#include "inc_internal/line_profile.hpp"
+
+#include <optional>
+#include <unordered_map>
+
+// Standard library aliases
+using std::map, std::unordered_map, std::vector, std::optional, std::shared_ptr, std::string, std::pair, std::uint32_t, std::int32_t, std::int64_t,
+      std::size_t, std::move;
+
+// interp_utils namespaces
+using namespace InterpreterUtils;
+using namespace TypingUtils;
+using namespace TokenDef;
+using namespace CodeTree;
+using namespace TypeRules;
+using namespace CheckedArithmetic;
+
+// semantic_analysis namespace
+using namespace DataStorage;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// boxed_value namespace
+using namespace ValueBoxing;
+
+
+// Evaluation helper functions.
+namespace {
+
+//  State carried through the evaluation of an AST.
+    struct _evaluationState {
+//      current value of each variable, indexed by the slot analysis gave it
+        vector<boxedValue> values;
+//      arena of the 64-bit integers too wide to box directly, reserved before evaluation
+        wideIntegers wide;
+//      number of values that may need the arena: each 64-bit integer computed, at most once since programs have no loops
+        size_t wide_values = 0;
+//      variables converted to their runtime merged type where the blocks of each 'if' meet, with that type
+        unordered_map<const ifBlock*, vector<pair<uint32_t, dataType>>> merges;
+//      runtime merged type of the values of each ternary operator
+        unordered_map<const ternaryOp*, dataType> ternary_types;
+    };
+
+//  Current type of each variable while preparing an evaluation, indexed by slot, empty before the variable is assigned.
+//  Changes made inside the blocks of an 'if' are logged with the types they replaced, so each block is undone to start
+//  the next one from the same types, and only the slots the blocks changed are merged, instead of copying every type.
+    struct _slotTypes {
+//      current type of each slot
+        vector<optional<dataType>> types;
+//      type of each slot after an 'if' block, while the slot is marked merging the blocks
+        vector<optional<dataType>> branch_types;
+//      last mark given to each slot, to visit it once per pass over the changes
+        vector<uint32_t> marks;
+//      slot and previous type of each change made inside an 'if' block, in order
+        vector<pair<uint32_t, optional<dataType>>> changes;
+//      slot and type of each slot changed by the blocks of the 'if' blocks being merged, as a stack
+        vector<pair<uint32_t, optional<dataType>>> outcomes;
+//      number of 'if' blocks being prepared, changes are only logged inside one
+        uint32_t branch_depth = 0;
+//      last mark given
+        uint32_t last_mark = 0;
+
+        inline explicit _slotTypes(const size_t slot_count)
+            : types(slot_count), branch_types(slot_count), marks(slot_count, 0) {}
+    };
+
+/*
+    Set the type of a slot, logging the change inside an 'if' block.
+
+    Parameters:
+        types: current type of each variable (input/output)
+        slot: the slot (input)
+        type: the slot's new type (input)
+*/
+    inline void _set_type(_slotTypes& types, const uint32_t slot, const optional<dataType> type) {
+        if (types.types[slot] == type) {
+            return;
+        }
+
+        if (types.branch_depth != 0) {
+            types.changes.emplace_back(slot, types.types[slot]);
+        }
+        types.types[slot] = type;
+    }
+
+/*
+    Push every slot changed since the given change once on the outcomes, with its type, then undo those changes.
+
+    Parameters:
+        types: current type of each variable (input/output)
+        first_change: index of the first change to undo (input)
+*/
+    void _undo_changes(_slotTypes& types, const size_t first_change) {
+        const uint32_t mark = ++types.last_mark;
+        for (size_t change_index = first_change; change_index < types.changes.size(); change_index++) {
+            const uint32_t slot = types.changes[change_index].first;
+            if (types.marks[slot] != mark) {
+                types.marks[slot] = mark;
+                types.outcomes.emplace_back(slot, types.types[slot]);
+            }
+        }
+
+//      Later changes are undone first, so each slot ends with the type it had before its first change.
+        for (size_t change_index = types.changes.size(); change_index-- > first_change;) {
+            types.types[types.changes[change_index].first] = types.changes[change_index].second;
+        }
+        types.changes.resize(first_change);
+    }
+
+/*
+    Compute the runtime type of an expression, recording the type of each ternary operator in it
+    and counting the 64-bit integers it may compute.
+
+    Throw a FatalError if the expression is not recognized or reads a variable with no known type.
+
+    Parameters:
+        value_data: the expression (input)
+        types: current type of each variable (input)
+        state: evaluation state to record ternary types in (input/output)
+
+    Return the expression's type.
+*/
+    dataType _expression_type(const valueData* const value_data, const _slotTypes& types, _evaluationState& state) {
+        switch (value_data->type) {
+            case nodeType::Int32Container:
+                return dataType::Int32T;
+            case nodeType::Int64Container:
+                return dataType::Int64T;
+            case nodeType::Float32Container:
+                return dataType::Float32T;
+            case nodeType::Float64Container:
+                return dataType::Float64T;
+            case nodeType::BoolContainer:
+                return dataType::BoolT;
+
+            case nodeType::VarContainer: {
+                const varContainer* const var_container = static_cast<const varContainer*>(value_data);
+
+                if ((var_container->slot >= types.types.size()) || !types.types[var_container->slot]) {
+                    throw FatalError("variable '" + var_container->variable + "' has no value during evaluation", var_container->line_number);
+                }
+
+                return *types.types[var_container->slot];
+            }
+
+            case nodeType::UnaryOp:
+                _expression_type(static_cast<const unaryOp*>(value_data)->expression.get(), types, state);
+                return dataType::BoolT;
+
+//          Operators left in the AST were not folded, so their results have the rule's runtime type.
+            case nodeType::BinaryOp: {
+                const binaryOp* const binary_op = static_cast<const binaryOp*>(value_data);
+                const dataType type1 = _expression_type(binary_op->expression1.get(), types, state);
+                const dataType type2 = _expression_type(binary_op->expression2.get(), types, state);
+
+                if (!binary_token(binary_op->op)) {
+                    throw FatalError("binary operator not recognized during evaluation", binary_op->line_number);
+                }
+
+                const dataType type = binary_rule(binary_operator(binary_op->op), type1, type2).result;
+                state.wide_values += (type == dataType::Int64T) ? 1 : 0;
+                return type;
+            }
+
+            case nodeType::TernaryOp: {
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(value_data);
+                const dataType type1 = _expression_type(ternary_op->expression1.get(), types, state);
+                _expression_type(ternary_op->expression2.get(), types, state);
+                const dataType type3 = _expression_type(ternary_op->expression3.get(), types, state);
+
+                const dataType type = runtime_merged_type(type1, type3);
+                state.ternary_types[ternary_op] = type;
+                state.wide_values += (type == dataType::Int64T) ? 1 : 0;
+                return type;
+            }
+
+//          Throw an exception when an expression was not recognized (not implemented).
+            default:
+                throw FatalError("expression not recognized during evaluation", value_data->line_number);
+        }
+    }
+
+/*
+    Compute the types that variables are merged to where the blocks of each 'if' meet, following the types of variables
+    through the AST, and count the 64-bit integers the AST may compute.
+
+    Parameters:
+        data_node: the AST to prepare (input)
+        types: current type of each variable, updated to the types after the AST (input/output)
+        state: evaluation state (input/output)
+*/
+    void _prepare_node(const dataNode* const data_node, _slotTypes& types, _evaluationState& state) {
+        switch (data_node->type) {
+            case nodeType::CodeScope: {
+                const codeScope* const code_scope = static_cast<const codeScope*>(data_node);
+
+//              An empty scope has nothing to prepare.
+                if (code_scope->curr_operation != nullptr) {
+                    _prepare_node(code_scope->curr_operation.get(), types, state);
+                    _prepare_node(code_scope->remainder.get(), types, state);
+                }
+                break;
+            }
+
+            case nodeType::AssignOp: {
+                const assignOp* const assign = static_cast<const assignOp*>(data_node);
+                _set_type(types, assign->slot, _expression_type(assign->expression.get(), types, state));
+                break;
+            }
+
+            case nodeType::ReassignOp: {
+                const reassignOp* const reassign = static_cast<const reassignOp*>(data_node);
+                _set_type(types, reassign->slot, _expression_type(reassign->expression.get(), types, state));
+                break;
+            }
+
+            case nodeType::IfBlock: {
+                const ifBlock* const if_block = static_cast<const ifBlock*>(data_node);
+                _expression_type(if_block->bool_condition.get(), types, state);
+
+//              Each block starts from the types before the 'if', a missing 'else' leaves them as they are.
+//              Both blocks are undone once prepared, so only the slots they changed are merged.
+                const size_t first_change = types.changes.size();
+                const size_t if_outcome = types.outcomes.size();
+                types.branch_depth++;
+                _prepare_node(if_block->code_block.get(), types, state);
+                _undo_changes(types, first_change);
+                const size_t else_outcome = types.outcomes.size();
+                if (if_block->contains_else) {
+                    _prepare_node(if_block->else_block.get(), types, state);
+                }
+                _undo_changes(types, first_change);
+                types.branch_depth--;
+
+//              Merge every variable assigned on both paths, as in IR lowering. A slot one block did not change keeps
+//              its type before the 'if' on that path, and variables declared inside either block go out of scope.
+                vector<pair<uint32_t, dataType>>& merges = state.merges[if_block];
+                const auto merge = [&](const uint32_t slot, const optional<dataType> if_type, const optional<dataType> else_type) {
+                    if (!if_type || !else_type) {
+                        return;
+                    }
+
+                    const dataType merged_type = runtime_merged_type(*if_type, *else_type);
+                    _set_type(types, slot, merged_type);
+
+//                  Only a variable whose type differs between the paths needs converting.
+                    if (*if_type != *else_type) {
+                        merges.emplace_back(slot, merged_type);
+                        state.wide_values += (merged_type == dataType::Int64T) ? 1 : 0;
+                    }
+                };
+
+                const uint32_t if_mark = ++types.last_mark;
+                for (size_t outcome_index = if_outcome; outcome_index < else_outcome; outcome_index++) {
+                    const uint32_t slot = types.outcomes[outcome_index].first;
+                    types.marks[slot] = if_mark;
+                    types.branch_types[slot] = types.outcomes[outcome_index].second;
+                }
+                const uint32_t merged_mark = ++types.last_mark;
+                for (size_t outcome_index = else_outcome; outcome_index < types.outcomes.size(); outcome_index++) {
+                    const auto [slot, else_type] = types.outcomes[outcome_index];
+                    const optional<dataType> if_type = (types.marks[slot] == if_mark) ? types.branch_types[slot] : types.types[slot];
+                    types.marks[slot] = merged_mark;
+                    merge(slot, if_type, else_type);
+                }
+                for (size_t outcome_index = if_outcome; outcome_index < else_outcome; outcome_index++) {
+                    const auto [slot, if_type] = types.outcomes[outcome_index];
+                    if (types.marks[slot] == if_mark) {
+                        merge(slot, if_type, types.types[slot]);
+                    }
+                }
+                types.outcomes.resize(if_outcome);
+                break;
+            }
+
+//          Throw an exception when a piece of data was not recognized (not implemented).
+            default:
+                throw FatalError("data not recognized during evaluation", data_node->line_number);
+        }
+
+        return;
+    }
+
+/*
+    Compute an arithmetic operation on two numbers of the same type, checking it as analysis does.
+    This function depends on a typename template for the numbers.
+
+    Throw an exception if the operation overflows or its operands are invalid (e.g. 2 / 0).
+
+    Parameters:
+        op: the arithmetic operator (input)
+        num1/2: the operands (input)
+        line_number: line number of the operator (input)
+
+    Return the result.
+*/
+    template <typename T>
+    T _compute_arithmetic(const binaryOperator op, const T num1, const T num2, const uint32_t line_number) {
+        T result = 0;
+        bool checked = false;
+
+        switch (op) {
+            case binaryOperator::Add:
+                checked = checked_add(num1, num2, result);
+                break;
+            case binaryOperator::Sub:
+                checked = checked_sub(num1, num2, result);
+                break;
+            case binaryOperator::Mult:
+                checked = checked_mul(num1, num2, result);
+                break;
+
+            default:
+                if constexpr (std::is_floating_point_v<T>) {
+                    checked = (op == binaryOperator::Div) ? checked_div(num1, num2, result) : checked_float_pow(num1, num2, result);
+                    break;
+                }
+
+//              Division and exponents always take floats.
+                throw FatalError("integer operands for a float operator during evaluation", line_number);
+        }
+
+        if (!checked) {
+            raise_arithmetic_error<T>(op, num1, num2, line_number);
+        }
+
+        return result;
+    }
+
+/*
+    Compare two numbers of the same type.
+    This function depends on a typename template for the numbers.
+
+    Parameters:
+        op: the comparison operator (input)
+        num1/2: the operands (input)
+
+    Return the result of the comparison.
+*/
+    template <typename T>
+    inline bool _compare(const binaryOperator op, const T num1, const T num2) noexcept {
+        switch (op) {
+            case binaryOperator::Greater:
+                return num1 > num2;
+            case binaryOperator::Less:
+                return num1 < num2;
+            case binaryOperator::Equal:
+                return num1 == num2;
+            case binaryOperator::GrEqual:
+                return num1 >= num2;
+            default:
+                return num1 <= num2;
+        }
+    }
+
+    boxedValue _evaluate_value(const valueData* const value_data, _evaluationState& state);
+
+/*
+    Evaluate a binary operator.
+
+    Parameters:
+        binary_op: the operator to evaluate (input)
+        state: evaluation state (input/output)
+
+    Return the operator's value.
+*/
+    boxedValue _evaluate_binary(const binaryOp* const binary_op, _evaluationState& state) {
+        const binaryOperator op = binary_operator(binary_op->op);
+        const boxedValue value1 = _evaluate_value(binary_op->expression1.get(), state);
+
+//      'and'/'or' only evaluate the second operand when the first does not decide the result.
+        if ((op == binaryOperator::And) && !value1.boolean()) {
+            return boxedValue::from_bool(false);
+        } else if ((op == binaryOperator::Or) && value1.boolean()) {
+            return boxedValue::from_bool(true);
+        }
+
+        const boxedValue value2 = _evaluate_value(binary_op->expression2.get(), state);
+
+        switch (operator_kind(op)) {
+//          Numbers are computed in the 64-bit type of the result, converted as runtime values are.
+            case operatorKind::Arithmetic:
+            case operatorKind::FloatArithmetic:
+                if (binary_rule(op, value1.type(), value2.type()).result == dataType::Int64T) {
+                    return boxedValue::from_int64(_compute_arithmetic<int64_t>(op, value1.number<int64_t>(), value2.number<int64_t>(),
+                                                                               binary_op->line_number), state.wide);
+                }
+                return boxedValue::from_float64(_compute_arithmetic<double>(op, value1.number<double>(), value2.number<double>(),
+                                                                            binary_op->line_number));
+
+            case operatorKind::Logical:
+                return boxedValue::from_bool((op == binaryOperator::Xor) ? (value1.boolean() != value2.boolean()) : value2.boolean());
+
+//          Numbers are compared in their runtime merged type, booleans are only compared for equality.
+            default: {
+                const dataType type = runtime_merged_type(value1.type(), value2.type());
+
+                if (type == dataType::BoolT) {
+                    return boxedValue::from_bool(value1.boolean() == value2.boolean());
+                } else if (integer_type(type)) {
+                    return boxedValue::from_bool(_compare<int64_t>(op, value1.number<int64_t>(), value2.number<int64_t>()));
+                }
+                return boxedValue::from_bool(_compare<double>(op, value1.number<double>(), value2.number<double>()));
+            }
+        }
+    }
+
+/*
+    Evaluate an expression.
+
+    Parameters:
+        value_data: the expression to evaluate (input)
+        state: evaluation state (input/output)
+
+    Return the expression's value.
+*/
+    boxedValue _evaluate_value(const valueData* const value_data, _evaluationState& state) {
+        switch (value_data->type) {
+            case nodeType::VarContainer:
+                return state.values[static_cast<const varContainer*>(value_data)->slot];
+
+            case nodeType::UnaryOp:
+                return boxedValue::from_bool(!_evaluate_value(static_cast<const unaryOp*>(value_data)->expression.get(), state).boolean());
+
+            case nodeType::BinaryOp:
+                return _evaluate_binary(static_cast<const binaryOp*>(value_data), state);
+
+            case nodeType::TernaryOp: {
+//              The second expression of a ternary operator is its condition, and only the chosen value is evaluated.
+                const ternaryOp* const ternary_op = static_cast<const ternaryOp*>(value_data);
+                const bool condition = _evaluate_value(ternary_op->expression2.get(), state).boolean();
+                const boxedValue chosen = _evaluate_value(condition ? ternary_op->expression1.get() : ternary_op->expression3.get(), state);
+
+                return convert_boxed(chosen, state.ternary_types.find(ternary_op)->second, state.wide);
+            }
+
+//          Irreducible data is its own value, boxed without copying since the AST outlives the evaluation.
+            default:
+                return box_constant(value_data);
+        }
+    }
+
+/*
+    Execute a statement or list of statements, updating the values of assigned variables.
+
+    Parameters:
+        data_node: the AST to execute (input)
+        state: evaluation state (input/output)
+*/
+    void _evaluate_node(const dataNode* const data_node, _evaluationState& state) {
+        const Metrics::lineScope line_scope(data_node->line_number);
+
+        switch (data_node->type) {
+            case nodeType::CodeScope: {
+                const codeScope* const code_scope = static_cast<const codeScope*>(data_node);
+
+//              An empty scope has nothing to execute.
+                if (code_scope->curr_operation != nullptr) {
+                    _evaluate_node(code_scope->curr_operation.get(), state);
+                    _evaluate_node(code_scope->remainder.get(), state);
+                }
+                break;
+            }
+
+            case nodeType::AssignOp: {
+                const assignOp* const assign = static_cast<const assignOp*>(data_node);
+                const boxedValue value = _evaluate_value(assign->expression.get(), state);
+                state.values[assign->slot] = value;
+                break;
+            }
+
+            case nodeType::ReassignOp: {
+                const reassignOp* const reassign = static_cast<const reassignOp*>(data_node);
+                const boxedValue value = _evaluate_value(reassign->expression.get(), state);
+                state.values[reassign->slot] = value;
+                break;
+            }
+
+            case nodeType::IfBlock: {
+                const ifBlock* const if_block = static_cast<const ifBlock*>(data_node);
+
+                if (_evaluate_value(if_block->bool_condition.get(), state).boolean()) {
+                    _evaluate_node(if_block->code_block.get(), state);
+                } else if (if_block->contains_else) {
+                    _evaluate_node(if_block->else_block.get(), state);
+                }
+
+//              Give the variables assigned on both paths the same type, whichever path ran.
+                for (const auto& [slot, type] : state.merges.find(if_block)->second) {
+                    state.values[slot] = convert_boxed(state.values[slot], type, state.wide);
+                }
+                break;
+            }
+
+//          Throw an exception when a piece of data was not recognized (not implemented).
+            default:
+                throw FatalError("data not recognized during evaluation", data_node->line_number);
+        }
+
+        return;
+    }
+
+}
+
+
+map<string, typedValue> evaluate_program(const shared_ptr<dataNode>& data_node, const shared_ptr<environment>& global_env,
+                                         const map<string, typedValue>& inputs) {
+    REGAL_TRACE_SPAN("evaluate_program");
+    _evaluationState state;
+    _slotTypes types(global_env->slot_count);
+    state.values.resize(global_env->slot_count);
+
+//  Runtime variables have their declared types, every other variable is typed through the AST.
+    for (const auto& [variable, declared_type] : global_env->inputs) {
+        types.types[global_env->locals.at(variable).slot] = declared_type;
+        state.wide_values += (declared_type == dataType::Int64T) ? 1 : 0;
+    }
+    _prepare_node(data_node.get(), types, state);
+    state.wide.reserve(state.wide_values);
+
+//  Runtime variables start with their given values, converted to their declared types.
+    for (const auto& [variable, declared_type] : global_env->inputs) {
+        state.values[global_env->locals.at(variable).slot] = box_value(input_value(inputs, variable, declared_type), state.wide);
+    }
+    _evaluate_node(data_node.get(), state);
+
+//  The result is the final value of each global variable, constants are known without evaluation.
+    map<string, typedValue> result;
+    for (const auto& [variable, info] : global_env->locals) {
+        if (info.optimize_value) {
+            result.emplace(variable, constant_value(info.value.get()));
+            continue;
+        }
+
+        if (!types.types[info.slot]) {
+            throw FatalError("variable \'" + variable + "\' has no value after evaluation", 0);
+        }
+        result.emplace(variable, convert_value(unbox_value(state.values[info.slot]), info.type));
+    }
+
+    return result;
+}
@@ -0,0 +1,732 @@
+/*
+
+Function implementations for compiling register-based bytecode into x86-64 machine code.
+
+*/
+
+#include "inc_runtime/native_compiler.hpp"
+#include "inc_runtime/virtual_machine.hpp"
+#include "inc_internal/tracing.hpp"
+
+#ifdef REGAL_NATIVE_CODE
+#include <sys/mman.h>
+#include <cstring>
+#include <bit>
+#endif
+
+// Standard library aliases
+using std::map, std::vector, std::string, std::pair, std::unique_ptr, std::initializer_list, std::uint8_t, std::uint32_t, std::int32_t,
+      std::int64_t, std::uint64_t;
+
+// interp_utils namespaces
+using namespace TypingUtils;
+using namespace TypeRules;
+using namespace CheckedArithmetic;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// bytecode namespace
+using namespace Bytecode;
+
+// native_compiler namespace
+using namespace Native;
+
+
+// Machine code helper functions.
+namespace {
+
+#ifdef REGAL_NATIVE_CODE
+//  Largest number of registers whose byte offsets fit a 32-bit signed displacement.
+    constexpr uint32_t _MAX_NATIVE_REGISTERS = 1U << 28;
+
+//  Numbers of the x86-64 registers used by the machine code, the same for general-purpose and SSE registers.
+//  rbx holds the address of the registers for the whole program, since calls preserve it.
+//  xmm2 and xmm3 hold the largest and smallest accurate float, to check float results.
+    constexpr uint8_t _RAX = 0, _RCX = 1, _RDX = 2, _RDI = 7;
+    constexpr uint8_t _XMM0 = 0, _XMM1 = 1;
+
+//  Condition codes of x86-64 conditional jumps and sets. A condition is negated by flipping its lowest bit.
+    enum class _condition : uint8_t {
+        Overflow = 0x0,
+        Below = 0x2,
+        AboveEqual = 0x3,
+        Equal = 0x4,
+        NotEqual = 0x5,
+        BelowEqual = 0x6,
+        Above = 0x7,
+        Parity = 0xA,
+        NoParity = 0xB,
+        Less = 0xC,
+        GrEqual = 0xD,
+        LessEqual = 0xE,
+        Greater = 0xF
+    };
+
+//  Machine code being compiled, with the jumps whose targets are only known once every instruction is compiled.
+    struct _machineCode {
+//      the machine code
+        vector<uint8_t> bytes;
+//      offset of the machine code of each bytecode instruction
+        vector<std::size_t> instruction_offsets;
+//      offsets of 32-bit jump displacements to each bytecode instruction's machine code
+        vector<pair<std::size_t, uint32_t>> jumps;
+//      offsets of 32-bit jump displacements to the error stub of each bytecode instruction
+        vector<pair<std::size_t, uint32_t>> error_jumps;
+    };
+
+/*
+    Append bytes to machine code.
+
+    Parameters:
+        code: the machine code (input/output)
+        bytes: the bytes to append (input)
+*/
+    inline void _emit(_machineCode& code, const initializer_list<uint8_t> bytes) noexcept {
+        code.bytes.insert(code.bytes.end(), bytes);
+    }
+
+/*
+    Append an integer to machine code in little-endian order.
+    This function depends on a typename template for the integer.
+
+    Parameters:
+        code: the machine code (input/output)
+        number: the integer to append (input)
+*/
+    template <typename T>
+    inline void _emit_number(_machineCode& code, const T number) noexcept {
+        for (std::size_t byte_index = 0; byte_index < sizeof(T); byte_index++) {
+            code.bytes.push_back(static_cast<uint8_t>((static_cast<uint64_t>(number) >> (8 * byte_index)) & 0xFF));
+        }
+    }
+
+/*
+    Append an instruction whose memory operand is a bytecode register, addressed from rbx with a 32-bit displacement.
+
+    Parameters:
+        code: the machine code (input/output)
+        opcode_bytes: prefixes and operation code of the instruction (input)
+        reg: x86-64 register operand, or operation code extension, of the instruction (input)
+        register_index: index of the bytecode register (input)
+*/
+    inline void _emit_memory(_machineCode& code, const initializer_list<uint8_t> opcode_bytes, const uint8_t reg, const uint32_t register_index) noexcept {
+        _emit(code, opcode_bytes);
+        _emit(code, {static_cast<uint8_t>(0x80 | (reg << 3) | 0x03)});
+        _emit_number<uint32_t>(code, register_index * sizeof(valueSlot));
+    }
+
+/*
+    Append a jump to the machine code of a bytecode instruction, unconditional or taken if the given condition holds.
+
+    Parameters:
+        code: the machine code (input/output)
+        target: index of the bytecode instruction to jump to (input)
+        condition: condition of the jump, nullptr if unconditional (input)
+*/
+    void _emit_jump(_machineCode& code, const uint32_t target, const _condition* const condition = nullptr) noexcept {
+        if (condition == nullptr) {
+            _emit(code, {0xE9});
+        } else {
+            _emit(code, {0x0F, static_cast<uint8_t>(0x80 | static_cast<uint8_t>(*condition))});
+        }
+
+        code.jumps.emplace_back(code.bytes.size(), target);
+        _emit_number<uint32_t>(code, 0);
+    }
+
+/*
+    Append a jump to the error stub of a bytecode instruction, taken if the given condition holds.
+
+    Parameters:
+        code: the machine code (input/output)
+        condition: condition of the jump (input)
+        code_index: index of the failing bytecode instruction (input)
+*/
+    void _emit_error_jump(_machineCode& code, const _condition condition, const uint32_t code_index) noexcept {
+        _emit(code, {0x0F, static_cast<uint8_t>(0x80 | static_cast<uint8_t>(condition))});
+        code.error_jumps.emplace_back(code.bytes.size(), code_index);
+        _emit_number<uint32_t>(code, 0);
+    }
+
+/*
+    Append an instruction loading a bytecode register into an x86-64 register.
+    Integers and booleans are loaded into general-purpose registers (booleans zero-extended), floats into SSE registers.
+
+    Parameters:
+        code: the machine code (input/output)
+        type: type of the bytecode register (input)
+        reg: the x86-64 register (input)
+        register_index: index of the bytecode register (input)
+*/
+    void _emit_load(_machineCode& code, const dataType type, const uint8_t reg, const uint32_t register_index) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                _emit_memory(code, {0x8B}, reg, register_index);
+                break;
+            case dataType::Int64T:
+                _emit_memory(code, {0x48, 0x8B}, reg, register_index);
+                break;
+            case dataType::Float32T:
+                _emit_memory(code, {0xF3, 0x0F, 0x10}, reg, register_index);
+                break;
+            case dataType::Float64T:
+                _emit_memory(code, {0xF2, 0x0F, 0x10}, reg, register_index);
+                break;
+            default:
+                _emit_memory(code, {0x0F, 0xB6}, reg, register_index);
+                break;
+        }
+    }
+
+/*
+    Append an instruction storing an x86-64 register into a bytecode register, the inverse of _emit_load.
+
+    Parameters:
+        code: the machine code (input/output)
+        type: type of the bytecode register (input)
+        reg: the x86-64 register (input)
+        register_index: index of the bytecode register (input)
+*/
+    void _emit_store(_machineCode& code, const dataType type, const uint8_t reg, const uint32_t register_index) noexcept {
+        switch (type) {
+            case dataType::Int32T:
+                _emit_memory(code, {0x89}, reg, register_index);
+                break;
+            case dataType::Int64T:
+                _emit_memory(code, {0x48, 0x89}, reg, register_index);
+                break;
+            case dataType::Float32T:
+                _emit_memory(code, {0xF3, 0x0F, 0x11}, reg, register_index);
+                break;
+            case dataType::Float64T:
+                _emit_memory(code, {0xF2, 0x0F, 0x11}, reg, register_index);
+                break;
+            default:
+                _emit_memory(code, {0x88}, reg, register_index);
+                break;
+        }
+    }
+
+/*
+    Append instructions loading the accurate float limits into xmm2 and xmm3.
+
+    Parameters:
+        code: the machine code (input/output)
+*/
+    void _emit_float_limits(_machineCode& code) noexcept {
+//      mov rax, imm64; movq xmm2, rax
+        _emit(code, {0x48, 0xB8});
+        _emit_number<uint64_t>(code, std::bit_cast<uint64_t>(max_magnitude<double>));
+        _emit(code, {0x66, 0x48, 0x0F, 0x6E, 0xD0});
+//      mov rax, imm64; movq xmm3, rax
+        _emit(code, {0x48, 0xB8});
+        _emit_number<uint64_t>(code, std::bit_cast<uint64_t>(-max_magnitude<double>));
+        _emit(code, {0x66, 0x48, 0x0F, 0x6E, 0xD8});
+    }
+
+/*
+    Append instructions checking that the 64-bit integer in rax is exact (not the unused smallest value),
+    jumping to the error stub of the instruction if it is not. The smallest value is the only one whose negation overflows.
+
+    Parameters:
+        code: the machine code (input/output)
+        code_index: index of the bytecode instruction (input)
+*/
+    void _emit_exact_integer(_machineCode& code, const uint32_t code_index) noexcept {
+//      mov rcx, rax; neg rcx
+        _emit(code, {0x48, 0x89, 0xC1, 0x48, 0xF7, 0xD9});
+        _emit_error_jump(code, _condition::Overflow, code_index);
+    }
+
+/*
+    Append instructions checking that the float in xmm0 is within the accurate float limits, jumping to the error stub
+    of the instruction if it is not. Comparisons with NaN are unordered and set the carry flag, so NaN also fails.
+
+    Parameters:
+        code: the machine code (input/output)
+        code_index: index of the bytecode instruction (input)
+*/
+    void _emit_exact_float(_machineCode& code, const uint32_t code_index) noexcept {
+//      ucomisd xmm2, xmm0
+        _emit(code, {0x66, 0x0F, 0x2E, 0xD0});
+        _emit_error_jump(code, _condition::Below, code_index);
+//      ucomisd xmm0, xmm3
+        _emit(code, {0x66, 0x0F, 0x2E, 0xC3});
+        _emit_error_jump(code, _condition::Below, code_index);
+    }
+
+/*
+    Append instructions checking that the 32-bit float in xmm0 is within the accurate 32-bit float limits, jumping to the
+    error stub of the instruction if it is not. The limits are loaded into xmm1, as xmm2 and xmm3 hold the 64-bit limits.
+
+    Parameters:
+        code: the machine code (input/output)
+        code_index: index of the bytecode instruction (input)
+*/
+    void _emit_exact_float32(_machineCode& code, const uint32_t code_index) noexcept {
+//      mov eax, imm32; movd xmm1, eax; ucomiss xmm1, xmm0
+        _emit(code, {0xB8});
+        _emit_number<uint32_t>(code, std::bit_cast<uint32_t>(max_magnitude<float>));
+        _emit(code, {0x66, 0x0F, 0x6E, 0xC8, 0x0F, 0x2E, 0xC8});
+        _emit_error_jump(code, _condition::Below, code_index);
+//      mov eax, imm32; movd xmm1, eax; ucomiss xmm0, xmm1
+        _emit(code, {0xB8});
+        _emit_number<uint32_t>(code, std::bit_cast<uint32_t>(-max_magnitude<float>));
+        _emit(code, {0x66, 0x0F, 0x6E, 0xC8, 0x0F, 0x2E, 0xC1});
+        _emit_error_jump(code, _condition::Below, code_index);
+    }
+
+/*
+    Compute a checked float power for the machine code, which calls it with the System V calling convention.
+
+    Parameters:
+        base: the base (input)
+        exponent: the exponent (input)
+        result: register to store the power in, only written if the power is exact (output)
+
+    Return true if the power is exact.
+*/
+    bool _native_pow(const double base, const double exponent, double* const result) noexcept {
+        double power;
+        if (!checked_float_pow(base, exponent, power)) {
+            return false;
+        }
+
+        *result = power;
+        return true;
+    }
+
+/*
+    Append instructions comparing the two source registers of a comparison instruction, setting the x86-64 flags.
+    Floats are compared with ucomiss/ucomisd, which only sets the flags of unsigned comparisons, so 'less' comparisons
+    swap their operands and become 'greater' comparisons, for NaN to be false as it is in C++.
+
+    Parameters:
+        code: the machine code (input/output)
+        curr: the comparison instruction (input)
+        type: type of the compared registers (input)
+        op: the comparison operator (input)
+
+    Return the condition that holds if the comparison is true. Float equality also needs the parity flag cleared (ordered).
+*/
+    _condition _emit_compare(_machineCode& code, const instruction& curr, const dataType type, const binaryOperator op) noexcept {
+        if ((type == dataType::Int32T) || (type == dataType::Int64T)) {
+            _emit_load(code, type, _RAX, curr.src1);
+            if (type == dataType::Int32T) {
+                _emit_memory(code, {0x3B}, _RAX, curr.src2);
+            } else {
+                _emit_memory(code, {0x48, 0x3B}, _RAX, curr.src2);
+            }
+
+            switch (op) {
+                case binaryOperator::Greater:
+                    return _condition::Greater;
+                case binaryOperator::Less:
+                    return _condition::Less;
+                case binaryOperator::Equal:
+                    return _condition::Equal;
+                case binaryOperator::GrEqual:
+                    return _condition::GrEqual;
+                default:
+                    return _condition::LessEqual;
+            }
+        }
+
+        const bool swapped = (op == binaryOperator::Less) || (op == binaryOperator::LessEqual);
+        _emit_load(code, type, _XMM0, swapped ? curr.src2 : curr.src1);
+        if (type == dataType::Float32T) {
+            _emit_memory(code, {0x0F, 0x2E}, _XMM0, swapped ? curr.src1 : curr.src2);
+        } else {
+            _emit_memory(code, {0x66, 0x0F, 0x2E}, _XMM0, swapped ? curr.src1 : curr.src2);
+        }
+
+        switch (op) {
+            case binaryOperator::Greater:
+            case binaryOperator::Less:
+                return _condition::Above;
+            case binaryOperator::Equal:
+                return _condition::Equal;
+            default:
+                return _condition::AboveEqual;
+        }
+    }
+
+/*
+    Append the machine code of a bytecode instruction.
+
+    Parameters:
+        code: the machine code (input/output)
+        curr: the instruction (input)
+        code_index: index of the instruction (input)
+*/
+    void _compile_instruction(_machineCode& code, const instruction& curr, const uint32_t code_index) noexcept {
+        const std::size_t op_index = static_cast<std::size_t>(curr.op);
+
+//      Typed comparisons, and the superinstructions jumping when they are false.
+        const bool comparison = (curr.op >= opcode::GreaterI32) && (curr.op <= opcode::LessEqualF64);
+        const bool comparison_jump = (curr.op >= opcode::JumpUnlessGreaterI32) && (curr.op <= opcode::JumpUnlessLessEqualF64);
+        if (comparison || comparison_jump) {
+            const std::size_t comparison_index = op_index - static_cast<std::size_t>(comparison ? opcode::GreaterI32 : opcode::JumpUnlessGreaterI32);
+            const dataType type = static_cast<dataType>(comparison_index / comparison_count);
+            const binaryOperator op = static_cast<binaryOperator>(static_cast<std::size_t>(binaryOperator::Greater) + comparison_index % comparison_count);
+            const bool float_equal = (op == binaryOperator::Equal) && ((type == dataType::Float32T) || (type == dataType::Float64T));
+            const _condition condition = _emit_compare(code, curr, type, op);
+
+            if (comparison) {
+//              setcc al, and for float equality: setnp cl; and al, cl
+                _emit(code, {0x0F, static_cast<uint8_t>(0x90 | static_cast<uint8_t>(condition)), 0xC0});
+                if (float_equal) {
+                    _emit(code, {0x0F, 0x9B, 0xC1, 0x20, 0xC8});
+                }
+                _emit_store(code, dataType::BoolT, _RAX, curr.dst);
+            } else {
+                const _condition negated = static_cast<_condition>(static_cast<uint8_t>(condition) ^ 1);
+                _emit_jump(code, curr.dst, &negated);
+                if (float_equal) {
+                    const _condition unordered = _condition::Parity;
+                    _emit_jump(code, curr.dst, &unordered);
+                }
+            }
+            return;
+        }
+
+        switch (curr.op) {
+            case opcode::Move:
+                _emit_load(code, dataType::Int64T, _RAX, curr.src1);
+                _emit_store(code, dataType::Int64T, _RAX, curr.dst);
+                break;
+
+//          movsxd rax, [src]
+            case opcode::ConvI32I64:
+                _emit_memory(code, {0x48, 0x63}, _RAX, curr.src1);
+                _emit_store(code, dataType::Int64T, _RAX, curr.dst);
+                break;
+//          cvtsi2sd xmm0, dword [src]
+            case opcode::ConvI32F64:
+                _emit_memory(code, {0xF2, 0x0F, 0x2A}, _XMM0, curr.src1);
+                _emit_store(code, dataType::Float64T, _XMM0, curr.dst);
+                break;
+//          cvtsi2sd xmm0, qword [src]
+            case opcode::ConvI64F64:
+                _emit_memory(code, {0xF2, 0x48, 0x0F, 0x2A}, _XMM0, curr.src1);
+                _emit_store(code, dataType::Float64T, _XMM0, curr.dst);
+                break;
+//          cvtss2sd xmm0, [src]
+            case opcode::ConvF32F64:
+                _emit_memory(code, {0xF3, 0x0F, 0x5A}, _XMM0, curr.src1);
+                _emit_store(code, dataType::Float64T, _XMM0, curr.dst);
+                break;
+//          mov eax, dword [src], the low half of the integer
+            case opcode::ConvI64I32:
+                _emit_load(code, dataType::Int32T, _RAX, curr.src1);
+                _emit_store(code, dataType::Int32T, _RAX, curr.dst);
+                break;
+//          cvtsi2ss xmm0, dword [src]
+            case opcode::ConvI32F32:
+                _emit_memory(code, {0xF3, 0x0F, 0x2A}, _XMM0, curr.src1);
+                _emit_store(code, dataType::Float32T, _XMM0, curr.dst);
+                break;
+//          cvtsi2ss xmm0, qword [src]
+            case opcode::ConvI64F32:
+                _emit_memory(code, {0xF3, 0x48, 0x0F, 0x2A}, _XMM0, curr.src1);
+                _emit_store(code, dataType::Float32T, _XMM0, curr.dst);
+                break;
+//          cvtsd2ss xmm0, [src]
+            case opcode::ConvF64F32:
+                _emit_memory(code, {0xF2, 0x0F, 0x5A}, _XMM0, curr.src1);
+                _emit_store(code, dataType::Float32T, _XMM0, curr.dst);
+                break;
+
+//          Integer arithmetic overflows if the hardware result overflows or is the unused smallest value.
+//          add/sub/imul rax, [src2]
+            case opcode::AddI64:
+            case opcode::SubI64:
+            case opcode::MulI64:
+                _emit_load(code, dataType::Int64T, _RAX, curr.src1);
+                if (curr.op == opcode::AddI64) {
+                    _emit_memory(code, {0x48, 0x03}, _RAX, curr.src2);
+                } else if (curr.op == opcode::SubI64) {
+                    _emit_memory(code, {0x48, 0x2B}, _RAX, curr.src2);
+                } else {
+                    _emit_memory(code, {0x48, 0x0F, 0xAF}, _RAX, curr.src2);
+                }
+                _emit_error_jump(code, _condition::Overflow, code_index);
+                _emit_exact_integer(code, code_index);
+                _emit_store(code, dataType::Int64T, _RAX, curr.dst);
+                break;
+//          add/sub/imul eax, [src2], then the smallest value is checked as for 64-bit integers: mov ecx, eax; neg ecx
+            case opcode::AddI32:
+            case opcode::SubI32:
+            case opcode::MulI32:
+                _emit_load(code, dataType::Int32T, _RAX, curr.src1);
+                if (curr.op == opcode::AddI32) {
+                    _emit_memory(code, {0x03}, _RAX, curr.src2);
+                } else if (curr.op == opcode::SubI32) {
+                    _emit_memory(code, {0x2B}, _RAX, curr.src2);
+                } else {
+                    _emit_memory(code, {0x0F, 0xAF}, _RAX, curr.src2);
+                }
+                _emit_error_jump(code, _condition::Overflow, code_index);
+                _emit(code, {0x89, 0xC1, 0xF7, 0xD9});
+                _emit_error_jump(code, _condition::Overflow, code_index);
+                _emit_store(code, dataType::Int32T, _RAX, curr.dst);
+                break;
+//          add/sub rax, imm32
+            case opcode::AddImmI64:
+            case opcode::SubImmI64:
+                _emit_load(code, dataType::Int64T, _RAX, curr.src1);
+                _emit(code, {0x48, static_cast<uint8_t>((curr.op == opcode::AddImmI64) ? 0x05 : 0x2D)});
+                _emit_number<uint32_t>(code, curr.src2);
+                _emit_error_jump(code, _condition::Overflow, code_index);
+                _emit_exact_integer(code, code_index);
+                _emit_store(code, dataType::Int64T, _RAX, curr.dst);
+                break;
+
+//          addsd/subsd/mulsd xmm0, [src2]
+            case opcode::AddF64:
+            case opcode::SubF64:
+            case opcode::MulF64:
+                _emit_load(code, dataType::Float64T, _XMM0, curr.src1);
+                _emit_memory(code, {0xF2, 0x0F, static_cast<uint8_t>((curr.op == opcode::AddF64) ? 0x58 : ((curr.op == opcode::SubF64) ? 0x5C : 0x59))},
+                             _XMM0, curr.src2);
+                _emit_exact_float(code, code_index);
+                _emit_store(code, dataType::Float64T, _XMM0, curr.dst);
+                break;
+//          addss/subss/mulss xmm0, [src2]
+            case opcode::AddF32:
+            case opcode::SubF32:
+            case opcode::MulF32:
+                _emit_load(code, dataType::Float32T, _XMM0, curr.src1);
+                _emit_memory(code, {0xF3, 0x0F, static_cast<uint8_t>((curr.op == opcode::AddF32) ? 0x58 : ((curr.op == opcode::SubF32) ? 0x5C : 0x59))},
+                             _XMM0, curr.src2);
+                _emit_exact_float32(code, code_index);
+                _emit_store(code, dataType::Float32T, _XMM0, curr.dst);
+                break;
+//          Division fails for a divisor equal to 0, but not NaN (unordered): xorpd xmm4, xmm4; ucomisd xmm1, xmm4; jp +6; je error; divsd xmm0, xmm1
+            case opcode::DivF64:
+                _emit_load(code, dataType::Float64T, _XMM0, curr.src1);
+                _emit_load(code, dataType::Float64T, _XMM1, curr.src2);
+                _emit(code, {0x66, 0x0F, 0x57, 0xE4, 0x66, 0x0F, 0x2E, 0xCC, 0x7A, 0x06});
+                _emit_error_jump(code, _condition::Equal, code_index);
+                _emit(code, {0xF2, 0x0F, 0x5E, 0xC1});
+                _emit_exact_float(code, code_index);
+                _emit_store(code, dataType::Float64T, _XMM0, curr.dst);
+                break;
+//          Powers call _native_pow, which writes the destination itself: lea rdi, [dst]; mov rax, imm64; call rax; test al, al
+//          Calls do not preserve xmm2 and xmm3, so the float limits are loaded again.
+            case opcode::ExpF64:
+                _emit_load(code, dataType::Float64T, _XMM0, curr.src1);
+                _emit_load(code, dataType::Float64T, _XMM1, curr.src2);
+                _emit_memory(code, {0x48, 0x8D}, _RDI, curr.dst);
+                _emit(code, {0x48, 0xB8});
+                _emit_number<uint64_t>(code, reinterpret_cast<uint64_t>(&_native_pow));
+                _emit(code, {0xFF, 0xD0, 0x84, 0xC0});
+                _emit_error_jump(code, _condition::Equal, code_index);
+                _emit_float_limits(code);
+                break;
+
+//          cmp al, cl; sete al
+            case opcode::EqualBool:
+                _emit_load(code, dataType::BoolT, _RAX, curr.src1);
+                _emit_load(code, dataType::BoolT, _RCX, curr.src2);
+                _emit(code, {0x38, 0xC8, 0x0F, 0x94, 0xC0});
+                _emit_store(code, dataType::BoolT, _RAX, curr.dst);
+                break;
+//          xor al, cl
+            case opcode::XorBool:
+                _emit_load(code, dataType::BoolT, _RAX, curr.src1);
+                _emit_load(code, dataType::BoolT, _RCX, curr.src2);
+                _emit(code, {0x30, 0xC8});
+                _emit_store(code, dataType::BoolT, _RAX, curr.dst);
+                break;
+//          xor al, 1
+            case opcode::Not:
+                _emit_load(code, dataType::BoolT, _RAX, curr.src1);
+                _emit(code, {0x34, 0x01});
+                _emit_store(code, dataType::BoolT, _RAX, curr.dst);
+                break;
+
+            case opcode::Jump:
+                _emit_jump(code, curr.dst);
+                break;
+//          cmp byte [src1], 0
+            case opcode::JumpIfFalse:
+            case opcode::JumpIfTrue: {
+                _emit_memory(code, {0x80}, 7, curr.src1);
+                _emit(code, {0x00});
+                const _condition condition = (curr.op == opcode::JumpIfFalse) ? _condition::Equal : _condition::NotEqual;
+                _emit_jump(code, curr.dst, &condition);
+                break;
+            }
+//          xor eax, eax; pop rbx; ret
+            case opcode::Halt:
+                _emit(code, {0x31, 0xC0, 0x5B, 0xC3});
+                break;
+
+//          test edx, edx; cmovz rax, rcx
+            case opcode::Select:
+                _emit_load(code, dataType::BoolT, _RDX, curr.dst);
+                _emit_load(code, dataType::Int64T, _RAX, curr.src1);
+                _emit_load(code, dataType::Int64T, _RCX, curr.src2);
+                _emit(code, {0x85, 0xD2, 0x48, 0x0F, 0x44, 0xC1});
+                _emit_store(code, dataType::Int64T, _RAX, curr.dst);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+/*
+    Set the 32-bit displacement of a jump to the given offset.
+
+    Parameters:
+        code: the machine code (input/output)
+        position: offset of the displacement (input)
+        target: offset to jump to (input)
+*/
+    inline void _patch_jump(_machineCode& code, const std::size_t position, const std::size_t target) noexcept {
+        const uint32_t displacement = static_cast<uint32_t>(static_cast<int32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(position + 4)));
+        for (std::size_t byte_index = 0; byte_index < 4; byte_index++) {
+            code.bytes[position + byte_index] = static_cast<uint8_t>((displacement >> (8 * byte_index)) & 0xFF);
+        }
+    }
+#endif
+
+/*
+    Raise the error of a failed arithmetic instruction. The machine code never writes the destination of a failing
+    instruction, so its operands are still in the registers.
+
+    Throw an exception for the failed instruction.
+
+    Parameters:
+        compiled: the executed bytecode (input)
+        registers: the registers when the instruction failed (input)
+        code_index: index of the failed instruction (input)
+*/
+    [[noreturn]] void _raise_native_error(const program& compiled, const vector<valueSlot>& registers, const uint32_t code_index) {
+        const instruction& curr = compiled.code[code_index];
+        const uint32_t line_number = compiled.line_numbers[code_index];
+
+        switch (curr.op) {
+            case opcode::AddI64:
+                raise_arithmetic_error<int64_t>(binaryOperator::Add, registers[curr.src1].int64, registers[curr.src2].int64, line_number);
+            case opcode::SubI64:
+                raise_arithmetic_error<int64_t>(binaryOperator::Sub, registers[curr.src1].int64, registers[curr.src2].int64, line_number);
+            case opcode::MulI64:
+                raise_arithmetic_error<int64_t>(binaryOperator::Mult, registers[curr.src1].int64, registers[curr.src2].int64, line_number);
+            case opcode::AddImmI64:
+                raise_arithmetic_error<int64_t>(binaryOperator::Add, registers[curr.src1].int64, static_cast<int32_t>(curr.src2), line_number);
+            case opcode::SubImmI64:
+                raise_arithmetic_error<int64_t>(binaryOperator::Sub, registers[curr.src1].int64, static_cast<int32_t>(curr.src2), line_number);
+            case opcode::AddI32:
+                raise_arithmetic_error<int32_t>(binaryOperator::Add, registers[curr.src1].int32, registers[curr.src2].int32, line_number);
+            case opcode::SubI32:
+                raise_arithmetic_error<int32_t>(binaryOperator::Sub, registers[curr.src1].int32, registers[curr.src2].int32, line_number);
+            case opcode::MulI32:
+                raise_arithmetic_error<int32_t>(binaryOperator::Mult, registers[curr.src1].int32, registers[curr.src2].int32, line_number);
+            case opcode::AddF32:
+                raise_arithmetic_error<float>(binaryOperator::Add, registers[curr.src1].float32, registers[curr.src2].float32, line_number);
+            case opcode::SubF32:
+                raise_arithmetic_error<float>(binaryOperator::Sub, registers[curr.src1].float32, registers[curr.src2].float32, line_number);
+            case opcode::MulF32:
+                raise_arithmetic_error<float>(binaryOperator::Mult, registers[curr.src1].float32, registers[curr.src2].float32, line_number);
+            case opcode::AddF64:
+                raise_arithmetic_error<double>(binaryOperator::Add, registers[curr.src1].float64, registers[curr.src2].float64, line_number);
+            case opcode::SubF64:
+                raise_arithmetic_error<double>(binaryOperator::Sub, registers[curr.src1].float64, registers[curr.src2].float64, line_number);
+            case opcode::MulF64:
+                raise_arithmetic_error<double>(binaryOperator::Mult, registers[curr.src1].float64, registers[curr.src2].float64, line_number);
+            case opcode::DivF64:
+                raise_arithmetic_error<double>(binaryOperator::Div, registers[curr.src1].float64, registers[curr.src2].float64, line_number);
+            case opcode::ExpF64:
+                raise_arithmetic_error<double>(binaryOperator::Exp, registers[curr.src1].float64, registers[curr.src2].float64, line_number);
+            default:
+                throw FatalError("native code failed at an instruction that can not fail", line_number);
+        }
+    }
+
+}
+
+
+nativeProgram::~nativeProgram() {
+#ifdef REGAL_NATIVE_CODE
+    munmap(code, code_size);
+#endif
+}
+
+uint32_t nativeProgram::run(valueSlot* const registers) const noexcept {
+#ifdef REGAL_NATIVE_CODE
+//  The machine code is a System V function taking the address of the registers.
+    return reinterpret_cast<uint32_t (*)(valueSlot*)>(code)(registers);
+#else
+    static_cast<void>(registers);
+    return 0;
+#endif
+}
+
+unique_ptr<nativeProgram> compile_native(const program& compiled) {
+    REGAL_TRACE_SPAN("compile_native");
+#ifdef REGAL_NATIVE_CODE
+    if (compiled.register_count > _MAX_NATIVE_REGISTERS) {
+        return nullptr;
+    }
+
+//  Prologue: push rbx; mov rbx, rdi, then the float limits.
+    _machineCode code;
+    _emit(code, {0x53, 0x48, 0x89, 0xFB});
+    _emit_float_limits(code);
+
+    for (uint32_t code_index = 0; code_index < compiled.code.size(); code_index++) {
+        code.instruction_offsets.push_back(code.bytes.size());
+        _compile_instruction(code, compiled.code[code_index], code_index);
+    }
+    for (const auto& [position, target] : code.jumps) {
+        _patch_jump(code, position, code.instruction_offsets[target]);
+    }
+
+//  Each failing instruction has one error stub after the code, returning its index plus 1: mov eax, imm32; pop rbx; ret
+    map<uint32_t, std::size_t> error_stubs;
+    for (const auto& [position, code_index] : code.error_jumps) {
+        if (!error_stubs.contains(code_index)) {
+            error_stubs[code_index] = code.bytes.size();
+            _emit(code, {0xB8});
+            _emit_number<uint32_t>(code, code_index + 1);
+            _emit(code, {0x5B, 0xC3});
+        }
+        _patch_jump(code, position, error_stubs[code_index]);
+    }
+
+//  The memory is only made executable once the code is written to it, so it is never writable and executable at once.
+    const std::size_t code_size = code.bytes.size();
+    void* const memory = mmap(nullptr, code_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+
+    std::memcpy(memory, code.bytes.data(), code_size);
+    if (mprotect(memory, code_size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, code_size);
+        return nullptr;
+    }
+
+    return std::make_unique<nativeProgram>(compiled, memory, code_size);
+#else
+    static_cast<void>(compiled);
+    return nullptr;
+#endif
+}
+
+map<string, typedValue> execute_native(const nativeProgram& native, const map<string, typedValue>& inputs) {
+    REGAL_TRACE_SPAN("execute_native");
+    const program& compiled = native.bytecode();
+    vector<valueSlot> registers = load_registers(compiled, inputs);
+
+    const uint32_t failed = native.run(registers.data());
+    if (failed != 0) {
+        _raise_native_error(compiled, registers, failed - 1);
+    }
+
+    return read_outputs(compiled, registers);
+}
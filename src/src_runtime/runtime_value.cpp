@@ -0,0 +1,234 @@
+/*
+
+Function implementations for values at runtime, shared by every execution engine.
+
+*/
+
+#include "inc_runtime/runtime_value.hpp"
+
+// Standard library aliases
+using std::map, std::string, std::uint32_t, std::int32_t, std::int64_t;
+
+// interp_utils namespaces
+using namespace InterpreterUtils;
+using namespace TypingUtils;
+using namespace TokenDef;
+using namespace CodeTree;
+using namespace TypeRules;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// boxed_value namespace
+using namespace ValueBoxing;
+
+// output_buffer namespace
+using namespace StandardIO;
+
+
+// Runtime value helper functions.
+namespace {
+
+/*
+    Create a runtime value of the given number type from a number.
+    This function depends on a typename template for the given number.
+
+    Parameters:
+        type: type of the value to create (input)
+        number: the value's number (input)
+
+    Return the created value.
+*/
+    template <typename T>
+    inline typedValue _make_number(const dataType type, const T number) noexcept {
+        typedValue result{type, valueSlot{}};
+
+        switch (type) {
+            case dataType::Int32T:
+                result.value.int32 = static_cast<int32_t>(number);
+                break;
+            case dataType::Int64T:
+                result.value.int64 = static_cast<int64_t>(number);
+                break;
+            case dataType::Float32T:
+                result.value.float32 = static_cast<float>(number);
+                break;
+            default:
+                result.value.float64 = static_cast<double>(number);
+                break;
+        }
+
+        return result;
+    }
+
+/*
+    Retrieve the number held by a runtime number value, converted to the given typename template.
+
+    Parameters:
+        number: the runtime number (input)
+
+    Return the converted number.
+*/
+    template <typename T>
+    inline T _number(const typedValue& number) noexcept {
+        switch (number.type) {
+            case dataType::Int32T:
+                return static_cast<T>(number.value.int32);
+            case dataType::Int64T:
+                return static_cast<T>(number.value.int64);
+            case dataType::Float32T:
+                return static_cast<T>(number.value.float32);
+            default:
+                return static_cast<T>(number.value.float64);
+        }
+    }
+
+}
+
+
+typedValue constant_value(const valueData* const value_data) {
+    return unbox_value(box_constant(value_data));
+}
+
+const string display_value(const typedValue& value) noexcept {
+    switch (value.type) {
+        case dataType::Int32T:
+            return num_to_string<int32_t>(value.value.int32);
+        case dataType::Int64T:
+            return num_to_string<int64_t>(value.value.int64);
+        case dataType::Float32T:
+            return num_to_string<float>(value.value.float32);
+        case dataType::Float64T:
+            return num_to_string<double>(value.value.float64);
+        default:
+            return value.value.boolean ? BOOL_TRUE_TOKEN : BOOL_FALSE_TOKEN;
+    }
+}
+
+outputBuffer& write_value(outputBuffer& output, const typedValue& value) {
+    switch (value.type) {
+        case dataType::Int32T:
+            return output.write_number<int32_t>(value.value.int32);
+        case dataType::Int64T:
+            return output.write_number<int64_t>(value.value.int64);
+        case dataType::Float32T:
+            return output.write_number<float>(value.value.float32);
+        case dataType::Float64T:
+            return output.write_number<double>(value.value.float64);
+        default:
+            return output.write(value.value.boolean ? BOOL_TRUE_TOKEN : BOOL_FALSE_TOKEN);
+    }
+}
+
+typedValue convert_value(const typedValue& value, const dataType type) noexcept {
+    if ((value.type == type) || (type == dataType::BoolT)) {
+        return value;
+    }
+
+    return integer_type(type) ? _make_number(type, _number<int64_t>(value)) : _make_number(type, _number<double>(value));
+}
+
+boxedValue box_value(const typedValue& value, wideIntegers& wide) {
+    switch (value.type) {
+        case dataType::Int32T:
+            return boxedValue::from_int32(value.value.int32);
+        case dataType::Int64T:
+            return boxedValue::from_int64(value.value.int64, wide);
+        case dataType::Float32T:
+            return boxedValue::from_float32(value.value.float32);
+        case dataType::Float64T:
+            return boxedValue::from_float64(value.value.float64);
+        default:
+            return boxedValue::from_bool(value.value.boolean);
+    }
+}
+
+typedValue unbox_value(const boxedValue value) noexcept {
+    typedValue result{value.type(), valueSlot{}};
+
+    switch (result.type) {
+        case dataType::Int32T:
+            result.value.int32 = value.int32();
+            break;
+        case dataType::Int64T:
+            result.value.int64 = value.int64();
+            break;
+        case dataType::Float32T:
+            result.value.float32 = value.float32();
+            break;
+        case dataType::Float64T:
+            result.value.float64 = value.float64();
+            break;
+        default:
+            result.value.boolean = value.boolean();
+            break;
+    }
+
+    return result;
+}
+
+boxedValue convert_boxed(const boxedValue value, const dataType type, wideIntegers& wide) {
+    if ((value.type() == type) || (type == dataType::BoolT)) {
+        return value;
+    }
+
+//  Numbers are converted through the 64-bit type of their kind, as runtime values are.
+    switch (type) {
+        case dataType::Int32T:
+            return boxedValue::from_int32(static_cast<int32_t>(value.number<int64_t>()));
+        case dataType::Int64T:
+            return boxedValue::from_int64(value.number<int64_t>(), wide);
+        case dataType::Float32T:
+            return boxedValue::from_float32(static_cast<float>(value.number<double>()));
+        default:
+            return boxedValue::from_float64(value.number<double>());
+    }
+}
+
+typedValue input_value(const map<string, typedValue>& inputs, const string& variable, const dataType declared_type) {
+    const map<string, typedValue>::const_iterator input = inputs.find(variable);
+    if (input == inputs.end()) {
+        throw ExecutionError("runtime variable \'" + variable + "\' was given no value", 0);
+    }
+
+    if (!combinable_types(declared_type, input->second.type)) {
+        throw TypeMismatchError("runtime variable \'" + variable + "\' expected type " + display_type(declared_type, 0)
+                                + " but received type " + display_type(input->second.type, 0), 0);
+    }
+
+    return convert_value(input->second, declared_type);
+}
+
+template <typename T>
+void raise_arithmetic_error(const binaryOperator op, const T num1, const T num2, const uint32_t line_number) {
+    switch (op) {
+        case binaryOperator::Add:
+            throw OverflowError("overflow when adding " + num_to_string<T>(num1) + " to " + num_to_string<T>(num2), line_number);
+        case binaryOperator::Sub:
+            throw OverflowError("overflow when subtracting " + num_to_string<T>(num1) + " from " + num_to_string<T>(num2), line_number);
+        case binaryOperator::Mult:
+            throw OverflowError("overflow when multiplying " + num_to_string<T>(num1) + " with " + num_to_string<T>(num2), line_number);
+
+        case binaryOperator::Div:
+            if (num2 == 0) {
+                throw ExecutionError("dividing " + num_to_string<T>(num1) + " by 0", line_number);
+            }
+            throw OverflowError("overflow when dividing " + num_to_string<T>(num1) + " by " + num_to_string<T>(num2), line_number);
+
+        case binaryOperator::Exp:
+            if ((num1 < 0) && (std::trunc(static_cast<double>(num2)) != static_cast<double>(num2))) {
+                throw ExecutionError("invalid negative base with non-integer exponent: " + num_to_string<T>(num1)
+                                     + "^" + num_to_string<T>(num2), line_number);
+            }
+            throw OverflowError("overflow from " + num_to_string<T>(num1) + "^" + num_to_string<T>(num2), line_number);
+
+//      Throw an exception when the operator is not arithmetic.
+        default:
+            throw FatalError("arithmetic error raised for a non-arithmetic operator", line_number);
+    }
+}
+
+template void raise_arithmetic_error<int32_t>(const binaryOperator, const int32_t, const int32_t, const uint32_t);
+template void raise_arithmetic_error<int64_t>(const binaryOperator, const int64_t, const int64_t, const uint32_t);
+template void raise_arithmetic_error<float>(const binaryOperator, const float, const float, const uint32_t);
+template void raise_arithmetic_error<double>(const binaryOperator, const double, const double, const uint32_t);
@@ -0,0 +1,536 @@
+/*
+
+Function implementations for executing register-based bytecode.
+
+*/
+
+#include "inc_runtime/virtual_machine.hpp"
+#include "inc_internal/tracing.hpp"
+
+// Standard library aliases
+using std::map, std::vector, std::string, std::uint32_t, std::int32_t, std::int64_t, std::is_same_v;
+
+// interp_utils namespaces
+using namespace TypingUtils;
+using namespace TypeRules;
+using namespace CheckedArithmetic;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// bytecode namespace
+using namespace Bytecode;
+
+
+// Every operation code, in the order of the opcode enum. The threaded dispatch table is generated from this list.
+#define VM_OPCODES(X) \
+    X(Move) X(ConvI32I64) X(ConvI32F64) X(ConvI64F64) X(ConvF32F64) X(ConvI64I32) \
+    X(ConvI32F32) X(ConvI64F32) X(ConvF64F32) X(AddI64) X(SubI64) X(MulI64) \
+    X(AddF64) X(SubF64) X(MulF64) X(DivF64) X(ExpF64) X(AddI32) \
+    X(SubI32) X(MulI32) X(AddF32) X(SubF32) X(MulF32) X(GreaterI32) X(LessI32) X(EqualI32) X(GrEqualI32) X(LessEqualI32) \
+    X(GreaterI64) X(LessI64) X(EqualI64) X(GrEqualI64) X(LessEqualI64) X(GreaterF32) \
+    X(LessF32) X(EqualF32) X(GrEqualF32) X(LessEqualF32) X(GreaterF64) X(LessF64) \
+    X(EqualF64) X(GrEqualF64) X(LessEqualF64) X(EqualBool) X(XorBool) X(Not) \
+    X(Jump) X(JumpIfFalse) X(JumpIfTrue) X(Halt) X(AddImmI64) X(SubImmI64) \
+    X(JumpUnlessGreaterI32) X(JumpUnlessLessI32) X(JumpUnlessEqualI32) X(JumpUnlessGrEqualI32) X(JumpUnlessLessEqualI32) X(JumpUnlessGreaterI64) \
+    X(JumpUnlessLessI64) X(JumpUnlessEqualI64) X(JumpUnlessGrEqualI64) X(JumpUnlessLessEqualI64) X(JumpUnlessGreaterF32) X(JumpUnlessLessF32) \
+    X(JumpUnlessEqualF32) X(JumpUnlessGrEqualF32) X(JumpUnlessLessEqualF32) X(JumpUnlessGreaterF64) X(JumpUnlessLessF64) X(JumpUnlessEqualF64) \
+    X(JumpUnlessGrEqualF64) X(JumpUnlessLessEqualF64) X(Select)
+
+
+// Execution helper functions.
+namespace {
+
+//  Check that the listed operation codes match the opcode enum, so the dispatch table jumps to the right handlers.
+#define VM_OPCODE_VALUE(name) opcode::name,
+    constexpr opcode _listed_opcodes[] = {VM_OPCODES(VM_OPCODE_VALUE)};
+#undef VM_OPCODE_VALUE
+
+    constexpr bool _opcodes_listed_in_order() noexcept {
+        for (std::size_t op_index = 0; op_index < std::size(_listed_opcodes); op_index++) {
+            if (static_cast<std::size_t>(_listed_opcodes[op_index]) != op_index) {
+                return false;
+            }
+        }
+
+        return std::size(_listed_opcodes) == opcode_count;
+    }
+    static_assert(_opcodes_listed_in_order(), "VM_OPCODES must list every operation code in order");
+
+/*
+    Retrieve the member of a register that holds the given typename template.
+
+    Parameters:
+        slot: the register (input)
+
+    Return a reference to the register's member.
+*/
+    template <typename T>
+    inline T& _member(valueSlot& slot) noexcept {
+        if constexpr (is_same_v<T, int32_t>) {
+            return slot.int32;
+        } else if constexpr (is_same_v<T, int64_t>) {
+            return slot.int64;
+        } else if constexpr (is_same_v<T, float>) {
+            return slot.float32;
+        } else if constexpr (is_same_v<T, double>) {
+            return slot.float64;
+        } else {
+            return slot.boolean;
+        }
+    }
+
+/*
+    Execute a conversion instruction, converting its source register into its destination register.
+    This function depends on typename templates for the source and destination numbers.
+
+    Parameters:
+        registers: the registers (input/output)
+        curr: the instruction (input)
+*/
+    template <typename From, typename To>
+    inline void _convert(valueSlot* const registers, const instruction* const curr) noexcept {
+        const From number = _member<From>(registers[curr->src1]);
+        _member<To>(registers[curr->dst]) = static_cast<To>(number);
+    }
+
+/*
+    Compute a checked arithmetic operation into a register.
+    This function depends on a typename template for the numbers and a template for the operator.
+
+    Throw an exception if the operation overflows or its operands are invalid (e.g. 2 / 0).
+
+    Parameters:
+        dst: register to store the result in (output)
+        num1/2: the operands (input)
+        line_number: line number of the instruction, only read on an error (input)
+*/
+    template <typename T, binaryOperator op>
+    inline void _checked_into(valueSlot& dst, const T num1, const T num2, const uint32_t* const line_number) {
+        T result = 0;
+        bool checked;
+
+        if constexpr (op == binaryOperator::Add) {
+            checked = checked_add(num1, num2, result);
+        } else if constexpr (op == binaryOperator::Sub) {
+            checked = checked_sub(num1, num2, result);
+        } else if constexpr (op == binaryOperator::Mult) {
+            checked = checked_mul(num1, num2, result);
+        } else if constexpr (op == binaryOperator::Div) {
+            checked = checked_div(num1, num2, result);
+        } else {
+            checked = checked_float_pow(num1, num2, result);
+        }
+
+        if (!checked) [[unlikely]] {
+            raise_arithmetic_error<T>(op, num1, num2, *line_number);
+        }
+        _member<T>(dst) = result;
+    }
+
+/*
+    Execute a checked arithmetic instruction.
+    This function depends on a typename template for the numbers and a template for the operator.
+
+    Throw an exception if the operation overflows or its operands are invalid (e.g. 2 / 0).
+
+    Parameters:
+        registers: the registers (input/output)
+        curr: the instruction (input)
+        line_number: line number of the instruction, only read on an error (input)
+*/
+    template <typename T, binaryOperator op>
+    inline void _arithmetic(valueSlot* const registers, const instruction* const curr, const uint32_t* const line_number) {
+//      The destination can be an operand, so both are read first.
+        const T num1 = _member<T>(registers[curr->src1]);
+        const T num2 = _member<T>(registers[curr->src2]);
+        _checked_into<T, op>(registers[curr->dst], num1, num2, line_number);
+    }
+
+/*
+    Execute a checked 64-bit integer instruction whose second operand is a 32-bit immediate.
+    This function depends on a template for the operator.
+
+    Throw an OverflowError if the operation overflows.
+
+    Parameters:
+        registers: the registers (input/output)
+        curr: the instruction (input)
+        line_number: line number of the instruction, only read on an error (input)
+*/
+    template <binaryOperator op>
+    inline void _arithmetic_immediate(valueSlot* const registers, const instruction* const curr, const uint32_t* const line_number) {
+        const int64_t num1 = registers[curr->src1].int64;
+        _checked_into<int64_t, op>(registers[curr->dst], num1, static_cast<int64_t>(static_cast<int32_t>(curr->src2)), line_number);
+    }
+
+/*
+    Compare two registers.
+    This function depends on a typename template for the compared values and a template for the operator.
+
+    Parameters:
+        registers: the registers (input)
+        curr: the instruction, comparing its source registers (input)
+
+    Return the result of the comparison.
+*/
+    template <typename T, binaryOperator op>
+    inline bool _compare(valueSlot* const registers, const instruction* const curr) noexcept {
+        const T value1 = _member<T>(registers[curr->src1]);
+        const T value2 = _member<T>(registers[curr->src2]);
+
+        if constexpr (op == binaryOperator::Greater) {
+            return value1 > value2;
+        } else if constexpr (op == binaryOperator::Less) {
+            return value1 < value2;
+        } else if constexpr (op == binaryOperator::Equal) {
+            return value1 == value2;
+        } else if constexpr (op == binaryOperator::GrEqual) {
+            return value1 >= value2;
+        } else {
+            return value1 <= value2;
+        }
+    }
+
+/*
+    Execute instructions until the program halts.
+    Every handler ends by dispatching the next instruction. With threaded dispatch, each handler jumps straight to the
+    handler of the next instruction through a table of label addresses, so every handler has its own indirect branch
+    for the branch predictor to learn. Otherwise the handlers return to a single switch.
+    This function depends on a template for the dispatch.
+
+    Parameters:
+        compiled: the program to execute (input)
+        registers: the registers, with the constants and runtime variables loaded (input/output)
+*/
+    template <bool threaded>
+    void _run(const program& compiled, valueSlot* const registers) {
+        const instruction* const code = compiled.code.data();
+        const uint32_t* const line_numbers = compiled.line_numbers.data();
+        const instruction* next = code;
+        const instruction* curr;
+
+#ifdef REGAL_THREADED_DISPATCH
+#define VM_CASE(name) case opcode::name: op_##name:
+#define VM_LABEL_ADDRESS(name) &&op_##name,
+        static void* const labels[] = {VM_OPCODES(VM_LABEL_ADDRESS)};
+#undef VM_LABEL_ADDRESS
+#define VM_NEXT if constexpr (threaded) { curr = next++; goto *labels[static_cast<std::size_t>(curr->op)]; } break
+#else
+#define VM_CASE(name) case opcode::name:
+#define VM_NEXT break
+#endif
+
+        while (true) {
+            curr = next++;
+
+            switch (curr->op) {
+                VM_CASE(Move)
+                    registers[curr->dst] = registers[curr->src1];
+                    VM_NEXT;
+                VM_CASE(ConvI32I64)
+                    _convert<int32_t, int64_t>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(ConvI32F64)
+                    _convert<int32_t, double>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(ConvI64F64)
+                    _convert<int64_t, double>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(ConvF32F64)
+                    _convert<float, double>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(ConvI64I32)
+                    _convert<int64_t, int32_t>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(ConvI32F32)
+                    _convert<int32_t, float>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(ConvI64F32)
+                    _convert<int64_t, float>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(ConvF64F32)
+                    _convert<double, float>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(AddI64)
+                    _arithmetic<int64_t, binaryOperator::Add>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(SubI64)
+                    _arithmetic<int64_t, binaryOperator::Sub>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(MulI64)
+                    _arithmetic<int64_t, binaryOperator::Mult>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(AddF64)
+                    _arithmetic<double, binaryOperator::Add>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(SubF64)
+                    _arithmetic<double, binaryOperator::Sub>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(MulF64)
+                    _arithmetic<double, binaryOperator::Mult>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(DivF64)
+                    _arithmetic<double, binaryOperator::Div>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(ExpF64)
+                    _arithmetic<double, binaryOperator::Exp>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(AddI32)
+                    _arithmetic<int32_t, binaryOperator::Add>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(SubI32)
+                    _arithmetic<int32_t, binaryOperator::Sub>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(MulI32)
+                    _arithmetic<int32_t, binaryOperator::Mult>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(AddF32)
+                    _arithmetic<float, binaryOperator::Add>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(SubF32)
+                    _arithmetic<float, binaryOperator::Sub>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(MulF32)
+                    _arithmetic<float, binaryOperator::Mult>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(GreaterI32)
+                    registers[curr->dst].boolean = _compare<int32_t, binaryOperator::Greater>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(LessI32)
+                    registers[curr->dst].boolean = _compare<int32_t, binaryOperator::Less>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(EqualI32)
+                    registers[curr->dst].boolean = _compare<int32_t, binaryOperator::Equal>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(GrEqualI32)
+                    registers[curr->dst].boolean = _compare<int32_t, binaryOperator::GrEqual>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(LessEqualI32)
+                    registers[curr->dst].boolean = _compare<int32_t, binaryOperator::LessEqual>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(GreaterI64)
+                    registers[curr->dst].boolean = _compare<int64_t, binaryOperator::Greater>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(LessI64)
+                    registers[curr->dst].boolean = _compare<int64_t, binaryOperator::Less>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(EqualI64)
+                    registers[curr->dst].boolean = _compare<int64_t, binaryOperator::Equal>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(GrEqualI64)
+                    registers[curr->dst].boolean = _compare<int64_t, binaryOperator::GrEqual>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(LessEqualI64)
+                    registers[curr->dst].boolean = _compare<int64_t, binaryOperator::LessEqual>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(GreaterF32)
+                    registers[curr->dst].boolean = _compare<float, binaryOperator::Greater>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(LessF32)
+                    registers[curr->dst].boolean = _compare<float, binaryOperator::Less>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(EqualF32)
+                    registers[curr->dst].boolean = _compare<float, binaryOperator::Equal>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(GrEqualF32)
+                    registers[curr->dst].boolean = _compare<float, binaryOperator::GrEqual>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(LessEqualF32)
+                    registers[curr->dst].boolean = _compare<float, binaryOperator::LessEqual>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(GreaterF64)
+                    registers[curr->dst].boolean = _compare<double, binaryOperator::Greater>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(LessF64)
+                    registers[curr->dst].boolean = _compare<double, binaryOperator::Less>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(EqualF64)
+                    registers[curr->dst].boolean = _compare<double, binaryOperator::Equal>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(GrEqualF64)
+                    registers[curr->dst].boolean = _compare<double, binaryOperator::GrEqual>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(LessEqualF64)
+                    registers[curr->dst].boolean = _compare<double, binaryOperator::LessEqual>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(EqualBool)
+                    registers[curr->dst].boolean = _compare<bool, binaryOperator::Equal>(registers, curr);
+                    VM_NEXT;
+                VM_CASE(XorBool)
+                    registers[curr->dst].boolean = registers[curr->src1].boolean != registers[curr->src2].boolean;
+                    VM_NEXT;
+                VM_CASE(Not)
+                    registers[curr->dst].boolean = !registers[curr->src1].boolean;
+                    VM_NEXT;
+                VM_CASE(Jump)
+                    next = code + curr->dst;
+                    VM_NEXT;
+                VM_CASE(JumpIfFalse)
+                    if (!registers[curr->src1].boolean) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpIfTrue)
+                    if (registers[curr->src1].boolean) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(Halt)
+                    return;
+                VM_CASE(AddImmI64)
+                    _arithmetic_immediate<binaryOperator::Add>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(SubImmI64)
+                    _arithmetic_immediate<binaryOperator::Sub>(registers, curr, line_numbers + (curr - code));
+                    VM_NEXT;
+                VM_CASE(JumpUnlessGreaterI32)
+                    if (!_compare<int32_t, binaryOperator::Greater>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessLessI32)
+                    if (!_compare<int32_t, binaryOperator::Less>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessEqualI32)
+                    if (!_compare<int32_t, binaryOperator::Equal>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessGrEqualI32)
+                    if (!_compare<int32_t, binaryOperator::GrEqual>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessLessEqualI32)
+                    if (!_compare<int32_t, binaryOperator::LessEqual>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessGreaterI64)
+                    if (!_compare<int64_t, binaryOperator::Greater>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessLessI64)
+                    if (!_compare<int64_t, binaryOperator::Less>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessEqualI64)
+                    if (!_compare<int64_t, binaryOperator::Equal>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessGrEqualI64)
+                    if (!_compare<int64_t, binaryOperator::GrEqual>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessLessEqualI64)
+                    if (!_compare<int64_t, binaryOperator::LessEqual>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessGreaterF32)
+                    if (!_compare<float, binaryOperator::Greater>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessLessF32)
+                    if (!_compare<float, binaryOperator::Less>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessEqualF32)
+                    if (!_compare<float, binaryOperator::Equal>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessGrEqualF32)
+                    if (!_compare<float, binaryOperator::GrEqual>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessLessEqualF32)
+                    if (!_compare<float, binaryOperator::LessEqual>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessGreaterF64)
+                    if (!_compare<double, binaryOperator::Greater>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessLessF64)
+                    if (!_compare<double, binaryOperator::Less>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessEqualF64)
+                    if (!_compare<double, binaryOperator::Equal>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessGrEqualF64)
+                    if (!_compare<double, binaryOperator::GrEqual>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(JumpUnlessLessEqualF64)
+                    if (!_compare<double, binaryOperator::LessEqual>(registers, curr)) {
+                        next = code + curr->dst;
+                    }
+                    VM_NEXT;
+                VM_CASE(Select)
+                    registers[curr->dst] = registers[curr->dst].boolean ? registers[curr->src1] : registers[curr->src2];
+                    VM_NEXT;
+            }
+        }
+
+#undef VM_CASE
+#undef VM_NEXT
+    }
+
+}
+
+
+vector<valueSlot> load_registers(const program& compiled, const map<string, typedValue>& inputs) {
+    vector<valueSlot> registers(compiled.register_count);
+
+//  Constants are loaded into the first registers, runtime variables into theirs with their declared types.
+    for (std::size_t constant_index = 0; constant_index < compiled.constants.size(); constant_index++) {
+        registers[constant_index] = compiled.constants[constant_index].value;
+    }
+    for (const auto& [variable, location] : compiled.inputs) {
+        registers[location.index] = input_value(inputs, variable, location.type).value;
+    }
+
+    return registers;
+}
+
+map<string, typedValue> read_outputs(const program& compiled, const vector<valueSlot>& registers) noexcept {
+//  Every variable is converted to the type analysis gave it.
+    map<string, typedValue> result;
+    for (const auto& [variable, location] : compiled.outputs) {
+        result.emplace(variable, convert_value(typedValue{location.register_type, registers[location.index]}, location.type));
+    }
+
+    return result;
+}
+
+map<string, typedValue> execute_program(const program& compiled, const map<string, typedValue>& inputs, const dispatchMode dispatch) {
+    REGAL_TRACE_SPAN("execute_program");
+    vector<valueSlot> registers = load_registers(compiled, inputs);
+
+//  Threaded dispatch falls back to the switch where computed goto is not available.
+    if ((dispatch == dispatchMode::Threaded) && threaded_dispatch) {
+        _run<true>(compiled, registers.data());
+    } else {
+        _run<false>(compiled, registers.data());
+    }
+
+    return read_outputs(compiled, registers);
+}
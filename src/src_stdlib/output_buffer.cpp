@@ -0,0 +1,72 @@
+/*
+
+Buffered output implementations.
+
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "inc_stdlib/output_buffer.hpp"
+
+// Standard library aliases
+using std::string_view, std::ostream, std::int32_t, std::int64_t, std::size_t, std::streamsize;
+
+// interp_utils namespaces
+using namespace CodeTree;
+using namespace TokenDef;
+
+// output_buffer namespace
+using namespace StandardIO;
+
+
+// A number must always fit in the buffer, so the buffer is never smaller than the longest number.
+outputBuffer::outputBuffer(ostream& sink, const size_t capacity)
+    : sink(sink),
+      buffer(std::max(capacity, InterpreterUtils::MAX_NUMBER_CHARS)) {}
+
+outputBuffer::~outputBuffer() noexcept {
+    try {
+        flush();
+    } catch (...) {}
+}
+
+void outputBuffer::spill() {
+    if (used != 0) {
+        sink.write(buffer.data(), static_cast<streamsize>(used));
+        used = 0;
+    }
+}
+
+outputBuffer& outputBuffer::write(const string_view text) {
+//  Text longer than the buffer is not copied, the pending text is written before it to keep the order.
+    if (text.size() > buffer.size()) {
+        spill();
+        sink.write(text.data(), static_cast<streamsize>(text.size()));
+        return *this;
+    }
+
+    std::memcpy(reserve(text.size()), text.data(), text.size());
+    used += text.size();
+    return *this;
+}
+
+outputBuffer& outputBuffer::write_value(const irreducibleData* const data) {
+    switch (data->type) {
+        case nodeType::Int32Container:
+            return write_number<int32_t>(static_cast<const int32Container*>(data)->number);
+        case nodeType::Int64Container:
+            return write_number<int64_t>(static_cast<const int64Container*>(data)->number);
+        case nodeType::Float32Container:
+            return write_number<float>(static_cast<const float32Container*>(data)->number);
+        case nodeType::Float64Container:
+            return write_number<double>(static_cast<const float64Container*>(data)->number);
+        default:
+            return write(static_cast<const boolContainer*>(data)->boolean ? BOOL_TRUE_TOKEN : BOOL_FALSE_TOKEN);
+    }
+}
+
+void outputBuffer::flush() {
+    spill();
+    sink.flush();
+}
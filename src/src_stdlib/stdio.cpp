@@ -7,14 +7,25 @@ Standard I/O function implementations.
 #include "inc_stdlib/stdio.hpp"
 
 // Standard library aliases
-using std::string, std::shared_ptr, std::is_base_of_v, std::visit, std::cout, std::endl;
+using std::string_view, std::cout;
 
 // interp_utils namespace
 using namespace CodeTree;
 
+// output_buffer namespace
+using namespace StandardIO;
 
-inline void print(const irreducibleData* const data, const string prefix, const string suffix) noexcept {
-    cout << prefix << to_string(data) << suffix << endl;
 
-    return;
-}
\ No newline at end of file
+outputBuffer& standard_output() {
+//  Constructed on first use, after std::cout, so that it is destroyed and flushed before std::cout.
+    static outputBuffer output(cout);
+    return output;
+}
+
+void flush_output() {
+    standard_output().flush();
+}
+
+void print(const irreducibleData* const data, const string_view prefix, const string_view suffix) {
+    standard_output().write(prefix).write_value(data).write(suffix).write('\n');
+}
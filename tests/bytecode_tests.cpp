@@ -0,0 +1,224 @@
+/*
+
+Tests of the 32-bit conversions and arithmetic of the bytecode, on the virtual machine and in machine code,
+and of compiling programs whose known ranges narrow their arithmetic to 32 bits.
+
+*/
+
+#include "test_checks.hpp"
+#include "inc_runtime/virtual_machine.hpp"
+#include "inc_runtime/native_compiler.hpp"
+#include "inc_runtime/bytecode_compiler.hpp"
+#include "inc_runtime/evaluator.hpp"
+
+// Standard library aliases
+using std::string, std::map, std::vector, std::unique_ptr, std::int32_t, std::int64_t, std::uint32_t;
+
+// interp_utils namespace
+using namespace TypingUtils;
+
+// runtime_value namespace
+using namespace Runtime;
+
+// bytecode namespace
+using namespace Bytecode;
+
+// test_checks namespace
+using namespace Testing;
+
+
+namespace {
+
+/*
+    Create a runtime value of the given typename template.
+
+    Parameters:
+        number: the value (input)
+
+    Return the runtime value.
+*/
+    template <typename T>
+    typedValue _value(const T number) noexcept {
+        typedValue result{dataType::BoolT, {}};
+        if constexpr (std::is_same_v<T, int32_t>) {
+            result = typedValue{dataType::Int32T, {}};
+            result.value.int32 = number;
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            result = typedValue{dataType::Int64T, {}};
+            result.value.int64 = number;
+        } else if constexpr (std::is_same_v<T, float>) {
+            result = typedValue{dataType::Float32T, {}};
+            result.value.float32 = number;
+        } else {
+            result = typedValue{dataType::Float64T, {}};
+            result.value.float64 = number;
+        }
+
+        return result;
+    }
+
+/*
+    Create a program running one instruction on constant registers, with its destination as the output 'r'.
+
+    Parameters:
+        op: operation code of the instruction (input)
+        operands: the constants it reads, one or two (input)
+        result_type: type of the destination register (input)
+
+    Return the program.
+*/
+    program _single_instruction(const opcode op, const vector<typedValue>& operands, const dataType result_type) {
+        program compiled;
+        compiled.constants = operands;
+        const uint32_t dst = static_cast<uint32_t>(operands.size());
+        compiled.code = {instruction{op, dst, 0, (operands.size() > 1) ? 1U : 0U}, instruction{opcode::Halt, 0, 0, 0}};
+        compiled.line_numbers = {7, 7};
+        compiled.register_count = dst + 1;
+        compiled.outputs["r"] = outputRegister{dst, result_type, result_type};
+        return compiled;
+    }
+
+/*
+    Run a program on every engine that can run it, checking its output 'r' or the message of the error it raises.
+
+    Parameters:
+        compiled: the program (input)
+        expected: the expected output, as a runtime value displayed by display_value, or the expected error message (input)
+        description: what the program checks (input)
+*/
+    void _check_engines(const program& compiled, const string& expected, const string& description) {
+        const auto outcome = [&](const auto& run) {
+            try {
+                const map<string, typedValue> outputs = run();
+                return display_value(outputs.at("r"));
+            } catch (const std::exception& error) {
+                return string(error.what());
+            }
+        };
+
+        check_equal(outcome([&] { return execute_program(compiled, {}); }), expected, description + " on the virtual machine");
+        check_equal(outcome([&] { return execute_program(compiled, {}, dispatchMode::Switch); }), expected, description + " with switch dispatch");
+
+        const unique_ptr<Native::nativeProgram> native = compile_native(compiled);
+        if (native) {
+            check_equal(outcome([&] { return execute_native(*native, {}); }), expected, description + " in machine code");
+        }
+    }
+
+/*
+    Create a display string for the values of every variable after an execution.
+
+    Parameters:
+        values: the values, mapped by name (input)
+
+    Return the created display string.
+*/
+    string _display_values(const map<string, typedValue>& values) {
+        string result;
+        for (const auto& [variable, value] : values) {
+            result += variable + " = " + display_value(value) + "\n";
+        }
+
+        return result;
+    }
+
+/*
+    Determine if a compiled program contains an instruction with the given operation code.
+
+    Parameters:
+        compiled: the program (input)
+        op: the operation code (input)
+
+    Return true if the program contains the instruction.
+*/
+    bool _contains(const program& compiled, const opcode op) noexcept {
+        return std::any_of(compiled.code.begin(), compiled.code.end(), [op](const instruction& curr) { return curr.op == op; });
+    }
+
+//  Conversions to 32-bit types keep every value their range allows.
+    void _test_conversions() {
+        _check_engines(_single_instruction(opcode::ConvI64I32, {_value<int64_t>(-123456)}, dataType::Int32T), "-123456", "64 to 32-bit integer");
+        _check_engines(_single_instruction(opcode::ConvI32F32, {_value<int32_t>(-16777216)}, dataType::Float32T), "-16777216.0", "32-bit integer to float");
+        _check_engines(_single_instruction(opcode::ConvI64F32, {_value<int64_t>(40000)}, dataType::Float32T), "40000.0", "64-bit integer to 32-bit float");
+        _check_engines(_single_instruction(opcode::ConvF64F32, {_value<double>(-2.5)}, dataType::Float32T), "-2.5", "64 to 32-bit float");
+    }
+
+//  32-bit arithmetic is checked as 64-bit arithmetic is, in the range of its type.
+    void _test_arithmetic() {
+        _check_engines(_single_instruction(opcode::AddI32, {_value<int32_t>(2000000000), _value<int32_t>(-7)}, dataType::Int32T), "1999999993", "32-bit integer addition");
+        _check_engines(_single_instruction(opcode::SubI32, {_value<int32_t>(-5), _value<int32_t>(12)}, dataType::Int32T), "-17", "32-bit integer subtraction");
+        _check_engines(_single_instruction(opcode::MulI32, {_value<int32_t>(-46340), _value<int32_t>(46340)}, dataType::Int32T), "-2147395600", "32-bit integer multiplication");
+        _check_engines(_single_instruction(opcode::AddF32, {_value<float>(1.5F), _value<float>(2.25F)}, dataType::Float32T), "3.75", "32-bit float addition");
+        _check_engines(_single_instruction(opcode::SubF32, {_value<float>(1.5F), _value<float>(4.0F)}, dataType::Float32T), "-2.5", "32-bit float subtraction");
+        _check_engines(_single_instruction(opcode::MulF32, {_value<float>(-3.0F), _value<float>(4096.0F)}, dataType::Float32T), "-12288.0", "32-bit float multiplication");
+
+        _check_engines(_single_instruction(opcode::AddI32, {_value<int32_t>(2147483647), _value<int32_t>(1)}, dataType::Int32T),
+                       "[7]: overflow when adding 2147483647 to 1", "32-bit integer addition overflowing");
+        _check_engines(_single_instruction(opcode::SubI32, {_value<int32_t>(-2147483647), _value<int32_t>(1)}, dataType::Int32T),
+                       "[7]: overflow when subtracting -2147483647 from 1", "32-bit integer subtraction reaching the unused smallest value");
+        _check_engines(_single_instruction(opcode::MulI32, {_value<int32_t>(65536), _value<int32_t>(65536)}, dataType::Int32T),
+                       "[7]: overflow when multiplying 65536 with 65536", "32-bit integer multiplication overflowing");
+        _check_engines(_single_instruction(opcode::MulF32, {_value<float>(16384.0F), _value<float>(2048.0F)}, dataType::Float32T),
+                       "[7]: overflow when multiplying 16384.0 with 2048.0", "32-bit float multiplication leaving the accurate floats");
+    }
+
+
+//  A compiled program narrows arithmetic whose range an enclosing condition bounds, and gives the results evaluating it gives,
+//  with and without superinstructions, whether or not the input is in the range.
+    void _test_compiled_narrowing() {
+        const analyzedProgram analyzed = analyze_source("let y = 0\nlet z = 0.0\nif x > 0 and x < 100\n    y = x * 3 + 7\n"
+                                                        "    z = (1.0 if x > 50 else 2.0) * 4.0\nlet w = y - x\n", {{"x", dataType::Int64T}});
+
+        for (const bool superinstructions : {true, false}) {
+            const program compiled = compile_program(analyzed.parsed_code, analyzed.env, superinstructions);
+            const string mode = superinstructions ? " with superinstructions" : " without superinstructions";
+            check(_contains(compiled, opcode::ConvI64I32) && _contains(compiled, opcode::MulI32) && _contains(compiled, opcode::AddI32),
+                  "integer arithmetic of a known range compiles to 32-bit instructions" + mode);
+            check(_contains(compiled, opcode::MulF32), "float arithmetic of a known integral range compiles to 32-bit instructions" + mode);
+            check(_contains(compiled, opcode::SubI64), "arithmetic outside the known range stays 64-bit" + mode);
+
+            const unique_ptr<Native::nativeProgram> native = compile_native(compiled);
+            for (const int64_t number : {int64_t{-4}, int64_t{1}, int64_t{42}, int64_t{99}, int64_t{3000000000}, int64_t{1000000000000000}}) {
+                const map<string, typedValue> inputs = {{"x", _value(number)}};
+                const string expected = _display_values(evaluate_program(analyzed.parsed_code, analyzed.env, inputs));
+                const string description = "program with x = " + std::to_string(number) + mode;
+
+                check_equal(_display_values(execute_program(compiled, inputs)), expected, description + " on the virtual machine");
+                if (native) {
+                    check_equal(_display_values(execute_native(*native, inputs)), expected, description + " in machine code");
+                }
+            }
+        }
+    }
+
+
+//  A variable given another type in only one block of a nested 'if' is converted where the blocks meet, whichever block ran,
+//  so the arithmetic after it has the same type on every engine.
+    void _test_one_sided_merge() {
+        const analyzedProgram analyzed = analyze_source("let v = y\nif c\n    v = x\nelse\n    v = x - v * v\n    if c\n        v = x / x\n    v = v - y\n",
+                                                        {{"x", dataType::Int64T}, {"y", dataType::Int64T}, {"c", dataType::BoolT}});
+        const program compiled = compile_program(analyzed.parsed_code, analyzed.env, true);
+        const map<string, typedValue> inputs = {{"x", _value<int64_t>(3)}, {"y", _value<int64_t>(3000000000)}, {"c", typedValue{dataType::BoolT, {}}}};
+        const auto outcome = [](const auto& run) {
+            try {
+                return _display_values(run());
+            } catch (const std::exception& error) {
+                return string(error.what());
+            }
+        };
+
+        check_equal(outcome([&] { return evaluate_program(analyzed.parsed_code, analyzed.env, inputs); }),
+                    outcome([&] { return execute_program(compiled, inputs); }), "variable converted in only one block of a nested 'if'");
+    }
+
+}
+
+
+int main() {
+    _test_conversions();
+    _test_arithmetic();
+    _test_compiled_narrowing();
+    _test_one_sided_merge();
+
+    return finish("bytecode_tests");
+}
@@ -0,0 +1,120 @@
+/*
+
+Tests of lowering analyzed programs to the SSA intermediate representation and of the standard pipeline of passes.
+
+*/
+
+#include "test_checks.hpp"
+#include "inc_ir/ir_lowering.hpp"
+#include "inc_ir/pass_manager.hpp"
+
+// Standard library aliases
+using std::string, std::map, std::vector, std::int64_t, std::uint32_t, std::size_t;
+
+// interp_utils namespace
+using namespace TypingUtils;
+
+// test_checks namespace
+using namespace Testing;
+
+
+namespace {
+
+/*
+    Lower a program to the IR and optimize it with the standard pipeline, checking the function is well formed.
+
+    Parameters:
+        source: the program's source (input)
+        runtime_variables: type of each runtime variable (input)
+
+    Return the optimized function.
+*/
+    IR::function _optimized(const string& source, const map<string, dataType>& runtime_variables) {
+        const analyzedProgram program = analyze_source(source, runtime_variables);
+        IR::function ir_function = lower_to_ir(program.parsed_code, program.env);
+        standard_pipeline().run(ir_function);
+
+        try {
+            verify_function(ir_function);
+        } catch (const std::exception& error) {
+            check(false, "optimized IR of \'" + source + "\' is well formed: " + error.what());
+        }
+        return ir_function;
+    }
+
+/*
+    Collect the types of the reachable instructions with the given opcode, in block order.
+
+    Parameters:
+        ir_function: the function (input)
+        op: the opcode (input)
+
+    Return the type of each instruction.
+*/
+    vector<dataType> _types_of(const IR::function& ir_function, const IR::opcode op) {
+        vector<dataType> types;
+        for (const IR::basicBlock& block : ir_function.blocks) {
+            for (const IR::valueId value : block.instructions) {
+                if (block.reachable && (ir_function.values[value].op == op)) {
+                    types.push_back(ir_function.values[value].type);
+                }
+            }
+        }
+
+        return types;
+    }
+
+//  Every variable is an output, and a program analysis knows entirely lowers to constants.
+    void _test_constant_outputs() {
+        const IR::function ir_function = _optimized("let a = 1 + 2\nlet b = a * 3\n", {});
+
+        check_equal<size_t>(ir_function.outputs.size(), 2, "outputs of a constant program");
+        for (const auto& [variable, expected] : map<string, int64_t>{{"a", 3}, {"b", 9}}) {
+            const IR::instruction& output = ir_function.values[ir_function.outputs.at(variable)];
+            check(output.op == IR::opcode::Const, "output \'" + variable + "\' is a constant");
+            check_equal(output.constant.int_value, expected, "value of output \'" + variable + "\'");
+        }
+    }
+
+//  Arithmetic on values whose range fits 32 bits is narrowed, division and values of unknown range stay 64-bit.
+    void _test_narrowing() {
+        const IR::function narrowed = _optimized("let a = 3 if x > 0 else 4\nlet b = a * 5 + 1\nlet c = b / 2\n", {{"x", dataType::Int32T}});
+        check(_types_of(narrowed, IR::opcode::Mul) == vector<dataType>{dataType::Int32T}, "multiplication of a known range is 32-bit");
+        check(_types_of(narrowed, IR::opcode::Add) == vector<dataType>{dataType::Int32T}, "addition of a known range is 32-bit");
+        check(_types_of(narrowed, IR::opcode::Div) == vector<dataType>{dataType::Float64T}, "division stays 64-bit");
+
+        const IR::function unknown = _optimized("let a = x * 2\n", {{"x", dataType::Int64T}});
+        check(_types_of(unknown, IR::opcode::Mul) == vector<dataType>{dataType::Int64T}, "multiplication of an unknown range stays 64-bit");
+
+        const IR::function floats = _optimized("let a = 1.0 if x > 0 else 2.0\nlet b = a * 3.0\n", {{"x", dataType::Int32T}});
+        check(_types_of(floats, IR::opcode::Mul) == vector<dataType>{dataType::Float32T}, "float multiplication of a known integral range is 32-bit");
+    }
+
+//  Variables reassigned in a block are merged with a phi where the blocks meet.
+    void _test_branch_merge() {
+        const IR::function ir_function = _optimized("let a = x * 2\nlet b = 1\nif a > 3\n    b = a + 1\n", {{"x", dataType::Int64T}});
+        check_equal<size_t>(_types_of(ir_function, IR::opcode::Phi).size(), 1, "phis merging the 'if' block");
+        check(ir_function.values[ir_function.outputs.at("b")].op == IR::opcode::Phi, "output \'b\' is the phi");
+    }
+
+//  The pipeline stops at a fixed point, so running it again changes nothing.
+    void _test_fixed_point() {
+        IR::function ir_function = _optimized("let a = 3 if x > 0 else 4\nlet b = a * 5 + 1\nif b > 12\n    a = b - x\n", {{"x", dataType::Int32T}});
+        IR::passManager pipeline = standard_pipeline();
+        check_equal<uint32_t>(pipeline.run(ir_function), 1, "rounds of a second run of the pipeline");
+        for (const IR::passRecord& record : pipeline.records) {
+            check_equal<uint32_t>(record.changes, 0, "changes of \'" + record.name + "\' on a second run");
+        }
+    }
+
+}
+
+
+int main() {
+    _test_constant_outputs();
+    _test_narrowing();
+    _test_branch_merge();
+    _test_fixed_point();
+
+    return finish("ir_tests");
+}
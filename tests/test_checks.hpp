@@ -0,0 +1,113 @@
+/*
+
+Checks shared by the test programs. Each program runs its checks, reports every check that failed to stderr, and exits
+with a nonzero status if any did, so ctest reports it as failed.
+
+*/
+
+#ifndef TEST_CHECKS_HPP
+#define TEST_CHECKS_HPP
+
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "inc_interpreter/lexer.hpp"
+#include "inc_interpreter/parser.hpp"
+#include "inc_interpreter/semantic_analysis.hpp"
+#include "inc_interpreter/optimization.hpp"
+
+
+// Checks of the test programs.
+namespace Testing {
+
+//  Number of checks that failed so far.
+    inline int failures = 0;
+
+/*
+    Check that a condition holds, reporting the check if it does not.
+
+    Parameters:
+        condition: the condition (input)
+        description: what the condition checks (input)
+*/
+    inline void check(const bool condition, const std::string& description) {
+        if (!condition) {
+            failures++;
+            std::cerr << "FAILED: " << description << "\n";
+        }
+    }
+
+/*
+    Check that a value equals its expected value, reporting both if it does not.
+
+    Parameters:
+        actual: the value (input)
+        expected: the expected value (input)
+        description: what the value is (input)
+*/
+    template <typename T>
+    void check_equal(const T& actual, const T& expected, const std::string& description) {
+        if (!(actual == expected)) {
+            failures++;
+            std::cerr << "FAILED: " << description << "\n    expected: " << expected << "\n    actual:   " << actual << "\n";
+        }
+    }
+
+//  Program analyzed as the interpreter analyzes it.
+    struct analyzedProgram {
+//      analyzed AST, nullptr for a program without statements
+        std::shared_ptr<CodeTree::dataNode> parsed_code;
+//      environment the AST was analyzed in
+        std::shared_ptr<DataStorage::environment> env;
+    };
+
+/*
+    Lex, parse and analyze source with the given runtime variables declared, then remove its dead stores.
+    Throw the error of the phase that fails.
+
+    Parameters:
+        source: the program's source (input)
+        runtime_variables: type of each runtime variable (input)
+
+    Return the analyzed program.
+*/
+    inline analyzedProgram analyze_source(std::string source, const std::map<std::string, TypingUtils::dataType>& runtime_variables = {}) {
+        analyzedProgram program{nullptr, std::make_shared<DataStorage::environment>()};
+        for (const auto& [variable, type] : runtime_variables) {
+            declare_runtime_variable(program.env, variable, type);
+        }
+
+        std::list<TokenDef::token> token_list = lex_string(source);
+        if ((token_list.size() == 1) && (std::get<0>(token_list.front()) == TokenDef::tokenKey::Newline)) {
+            return program;
+        }
+
+        program.parsed_code = parse_file(token_list);
+        analyze_data_node(program.parsed_code, program.env);
+        eliminate_dead_stores(program.parsed_code, program.env);
+        return program;
+    }
+
+/*
+    Report the number of failed checks.
+
+    Parameters:
+        program: name of the test program (input)
+
+    Return the exit status of the test program.
+*/
+    inline int finish(const std::string& program) {
+        if (failures != 0) {
+            std::cerr << program << ": " << failures << " checks failed\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+}
+
+#endif